@@ -71,6 +71,6 @@ elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "[aA][aA][rR][cC][hH]|[aA][rR][mM]")
 endif()
 
 # We do not support amd64 asm yet
-if(X86_64 AND (ENABLE_ASM_CORE OR ENABLE_ASM_SCALERS OR ENABLE_MMX))
-    message(FATAL_ERROR "The options ASM_CORE, ASM_SCALERS and MMX are not supported on X86_64 yet.")
+if(X86_64 AND (ENABLE_ASM_CORE OR ENABLE_ASM_SCALERS))
+    message(FATAL_ERROR "The options ASM_CORE and ASM_SCALERS are not supported on X86_64 yet.")
 endif()
@@ -50,12 +50,10 @@ option(ENABLE_ASM "Enable x86 ASM related options" OFF)
 option(ENABLE_ASM_CORE "Enable x86 ASM CPU cores (EXPERIMENTAL)" OFF)
 
 set(ASM_SCALERS_DEFAULT ${ENABLE_ASM})
-set(MMX_DEFAULT ${ENABLE_ASM})
 
 option(ENABLE_ASM_SCALERS "Enable x86 ASM graphic filters" ${ASM_SCALERS_DEFAULT})
 
 include(CMakeDependentOption)
-cmake_dependent_option(ENABLE_MMX "Enable MMX" ${MMX_DEFAULT} "ENABLE_ASM_SCALERS" OFF)
 
 option(ENABLE_LIRC "Enable LIRC support" OFF)
 
@@ -106,6 +104,7 @@ if(NOT TRANSLATIONS_ONLY AND (NOT DEFINED ENABLE_FFMPEG OR ENABLE_FFMPEG) AND (N
     endif()
 endif()
 option(ENABLE_FFMPEG "Enable ffmpeg A/V recording" ${FFMPEG_DEFAULT})
+cmake_dependent_option(ENABLE_HEADLESS_ENCODER "Build vbam-encode, the headless A/V recorder" ON "ENABLE_FFMPEG" OFF)
 
 # Online Updates
 set(ONLINEUPDATES_DEFAULT OFF)
@@ -125,6 +124,10 @@ option(ENABLE_LTO "Compile with Link Time Optimization" ${LTO_DEFAULT})
 
 option(ENABLE_GBA_LOGGING "Enable extended GBA logging" ON)
 
+option(ENABLE_MEMORY_STATS "Count GBA memory accesses and cycles per region and page" OFF)
+
+option(ENABLE_TRACE "Support GBA execution traces and build vbam-trace" OFF)
+
 option(UPSTREAM_RELEASE "do some optimizations and release automation tasks" OFF)
 
 if(WIN32)
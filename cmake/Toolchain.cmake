@@ -36,8 +36,12 @@ if(ENABLE_GBA_LOGGING)
     add_compile_definitions(GBA_LOGGING )
 endif()
 
-if(ENABLE_MMX)
-    add_compile_definitions(MMX)
+if(ENABLE_MEMORY_STATS)
+    add_compile_definitions(VBAM_ENABLE_MEMORY_STATS)
+endif()
+
+if(ENABLE_TRACE)
+    add_compile_definitions(VBAM_ENABLE_TRACE)
 endif()
 
 
@@ -1,8 +1,12 @@
 #include "components/av_recording/av_recording.h"
 
+#include <chrono>
+
 #define STREAM_FRAME_RATE 60
 #define STREAM_PIXEL_FORMAT AV_PIX_FMT_YUV420P
 #define IN_SOUND_FORMAT AV_SAMPLE_FMT_S16
+// about half a second of video at 60fps
+#define DEFAULT_QUEUE_SIZE 32
 
 namespace {
 
@@ -274,7 +278,10 @@ recording::MediaRet recording::MediaRecorder::setup_video_stream(int width, int
     st = avformat_new_stream(oc, NULL);
     if (!st) return MRET_ERR_NOMEM;
     st->id = oc->nb_streams - 1;
-    st->time_base = { 1, STREAM_FRAME_RATE };
+    // one tick per frame; some codecs (MPEG-4) reject time bases with
+    // a denominator over 16 bits, so approximate exact rates if needed
+    av_reduce(&st->time_base.num, &st->time_base.den,
+              frameRate.den, frameRate.num, 65535);
     // video codec
     vcodec = avcodec_find_encoder(fmt->video_codec);
     if (!vcodec) return MRET_ERR_FMTGUESS;
@@ -285,7 +292,12 @@ recording::MediaRet recording::MediaRecorder::setup_video_stream(int width, int
     enc->width = width;
     enc->height = height;
     enc->time_base = st->time_base;
+    enc->framerate = av_inv_q(st->time_base);
     enc->gop_size = 12;
+    // let libavcodec pick frame or slice threading, whichever the
+    // codec supports
+    enc->thread_count = encoderThreads;
+    enc->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
     enc->pix_fmt = STREAM_PIXEL_FORMAT;
     if (oc->oformat->flags & AVFMT_GLOBALHEADER)
         enc->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -296,13 +308,6 @@ recording::MediaRet recording::MediaRecorder::setup_video_stream(int width, int
     // open and use codec on stream
     if (avcodec_open2(enc, vcodec, NULL) < 0) return MRET_ERR_NOCODEC;
     if (avcodec_parameters_from_context(st->codecpar, enc) < 0) return MRET_ERR_BUFSIZE;
-    // frame for input
-    frameIn = av_frame_alloc();
-    if (!frameIn) return MRET_ERR_NOMEM;
-    frameIn->format = pixfmt;
-    frameIn->width  = width;
-    frameIn->height = height;
-    if (av_frame_get_buffer(frameIn, 32) < 0) return MRET_ERR_NOMEM;
     // frame for output
     frameOut = av_frame_alloc();
     if (!frameOut) return MRET_ERR_NOMEM;
@@ -327,8 +332,119 @@ recording::MediaRet recording::MediaRecorder::finish_setup(const char *fname)
     return MRET_OK;
 }
 
+recording::MediaRet recording::MediaRecorder::setup_encoder_queue()
+{
+    jobs.resize(queueSize);
+    for (EncoderJob &job : jobs)
+    {
+        job.isVideo = false;
+        job.video = NULL;
+        job.pts = 0;
+        if (audioOnlyRecording)
+            continue;
+        // input frame pool, one per slot; filled by AddFrame()
+        job.video = av_frame_alloc();
+        if (!job.video) return MRET_ERR_NOMEM;
+        job.video->format = pixfmt;
+        job.video->width  = enc->width;
+        job.video->height = enc->height;
+        if (av_frame_get_buffer(job.video, 32) < 0) return MRET_ERR_NOMEM;
+    }
+    jobHead = jobCount = 0;
+    stopEncoder = false;
+    encoderError = MRET_OK;
+    stats = EncoderStats();
+    encoderThread = std::thread(&MediaRecorder::encoder_loop, this);
+    return MRET_OK;
+}
+
+void recording::MediaRecorder::stop_encoder_queue()
+{
+    if (encoderThread.joinable())
+    {
+        // let the encoder drain whatever is queued, then exit
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            stopEncoder = true;
+        }
+        queueNotEmpty.notify_all();
+        encoderThread.join();
+    }
+    for (EncoderJob &job : jobs)
+    {
+        if (job.video)
+            av_frame_free(&job.video);
+    }
+    jobs.clear();
+    jobHead = jobCount = 0;
+}
+
+recording::MediaRecorder::EncoderJob *recording::MediaRecorder::acquire_job(std::unique_lock<std::mutex> &lock, bool isVideo)
+{
+    if (jobCount == (int)jobs.size())
+    {
+        if (isVideo && dropPolicy == DROP_VIDEO)
+        {
+            stats.videoFramesDropped++;
+            return NULL;
+        }
+        auto start = std::chrono::steady_clock::now();
+        queueNotFull.wait(lock, [this] { return jobCount < (int)jobs.size(); });
+        stats.producerStalls++;
+        stats.producerStallUsec += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    EncoderJob *job = &jobs[(jobHead + jobCount) % jobs.size()];
+    job->isVideo = isVideo;
+    return job;
+}
+
+void recording::MediaRecorder::encoder_loop()
+{
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(queueLock);
+        queueNotEmpty.wait(lock, [this] { return jobCount > 0 || stopEncoder; });
+        if (jobCount == 0)
+            break; // stop requested and queue drained
+        // the job at jobHead stays reserved until we are done with it
+        EncoderJob &job = jobs[jobHead];
+        bool failed = encoderError != MRET_OK;
+        lock.unlock();
+
+        MediaRet ret = MRET_OK;
+        // after an error, just drain the queue; the caller gets the error
+        // from its next AddFrame() and is expected to Stop()
+        if (!failed)
+        {
+            if (job.isVideo)
+                ret = encode_video(job.video, job.pts);
+            else
+                ret = encode_audio(job.audio.data(), job.audio.size() * sizeof(uint16_t));
+        }
+
+        lock.lock();
+        if (ret != MRET_OK && encoderError == MRET_OK)
+            encoderError = ret;
+        jobHead = (jobHead + 1) % jobs.size();
+        jobCount--;
+        stats.queueDepth = jobCount;
+        lock.unlock();
+        queueNotFull.notify_one();
+    }
+}
+
+recording::EncoderStats recording::MediaRecorder::GetStats()
+{
+    std::lock_guard<std::mutex> lock(queueLock);
+    return stats;
+}
+
 recording::MediaRecorder::MediaRecorder() : isRecording(false),
-    sampleRate(44100), oc(NULL), fmt(NULL), audioOnlyRecording(false)
+    sampleRate(44100), oc(NULL), fmt(NULL), audioOnlyRecording(false),
+    frameRate({ STREAM_FRAME_RATE, 1 }), encoderThreads(1),
+    queueSize(DEFAULT_QUEUE_SIZE), jobHead(0), jobCount(0), stopEncoder(false),
+    encoderError(MRET_OK), dropPolicy(DROP_NONE), stats()
 {
     // pic info
     pixfmt = AV_PIX_FMT_NONE;
@@ -340,7 +456,7 @@ recording::MediaRecorder::MediaRecorder() : isRecording(false),
     vcodec = NULL;
     enc = NULL;
     npts = 0;
-    frameIn = frameOut = NULL;
+    frameOut = NULL;
     // audio setup
     swr = NULL;
     acodec = NULL;
@@ -395,28 +511,61 @@ recording::MediaRet recording::MediaRecorder::Record(const char *fname, int widt
         Stop(false);
         return ret;
     }
+    // encoder thread
+    ret = setup_encoder_queue();
+    if (ret != MRET_OK)
+    {
+        Stop(false);
+        return ret;
+    }
     return MRET_OK;
 }
 
 recording::MediaRet recording::MediaRecorder::AddFrame(const uint8_t *vid)
+{
+    return AddFrame(vid, npts);
+}
+
+recording::MediaRet recording::MediaRecorder::AddFrame(const uint8_t *vid, int64_t pts)
 {
     if (!isRecording) return MRET_OK;
+    std::unique_lock<std::mutex> lock(queueLock);
+    if (encoderError != MRET_OK) return encoderError;
+    // pts advances even for dropped frames, so timing is preserved
+    npts = pts + 1;
+    EncoderJob *job = acquire_job(lock, true);
+    if (!job) return MRET_OK;
+    // copy current pic into the pooled input frame, skipping the border
+    av_image_copy_plane(job->video->data[0], job->video->linesize[0],
+                        vid + tbord * (linesize + pixsize * rbord),
+                        linesize + pixsize * rbord, linesize, enc->height);
+    job->pts = pts;
+    jobCount++;
+    stats.videoFramesQueued++;
+    stats.queueDepth = jobCount;
+    if (jobCount > stats.maxQueueDepth)
+        stats.maxQueueDepth = jobCount;
+    lock.unlock();
+    queueNotEmpty.notify_one();
+    return MRET_OK;
+}
+
+// runs on the encoder thread
+recording::MediaRet recording::MediaRecorder::encode_video(AVFrame *in, int64_t pts)
+{
     // fill and encode frame variables
     int got_packet = 0, ret = 0;
     ScopedAVPacket pkt;
     pkt->data = NULL;
     pkt->size = 0;
-    // fill frame with current pic
-    ret = av_image_fill_arrays(frameIn->data, frameIn->linesize,
-                               (uint8_t *)vid + tbord * (linesize + pixsize * rbord),
-                               pixfmt, enc->width + rbord, enc->height, 1);
-    if (ret < 0) return MRET_ERR_RECORDING;
+    // the codec may still hold a reference to the previous frame
+    if (av_frame_make_writable(frameOut) < 0) return MRET_ERR_NOMEM;
     // convert from input format to output
-    sws_scale(sws, (const uint8_t * const *) frameIn->data,
-              frameIn->linesize, 0, enc->height, frameOut->data,
+    sws_scale(sws, (const uint8_t * const *) in->data,
+              in->linesize, 0, enc->height, frameOut->data,
               frameOut->linesize);
     // set valid pts for frame
-    frameOut->pts = npts++;
+    frameOut->pts = pts;
     // finally, encode frame
     got_packet = avcodec_receive_packet(enc, pkt.get());
     ret = avcodec_send_frame(enc, frameOut);
@@ -436,6 +585,8 @@ recording::MediaRet recording::MediaRecorder::AddFrame(const uint8_t *vid)
 
 void recording::MediaRecorder::Stop(bool initSuccess)
 {
+    // finish encoding queued frames before writing the trailer
+    stop_encoder_queue();
     if (oc)
     {
         // write the trailer; must be called before av_codec_close()
@@ -462,11 +613,6 @@ void recording::MediaRecorder::Stop(bool initSuccess)
     {
         vcodec = NULL;
     }
-    if (frameIn)
-    {
-        av_frame_free(&frameIn);
-        frameIn = NULL;
-    }
     if (frameOut)
     {
         av_frame_free(&frameOut);
@@ -563,6 +709,13 @@ recording::MediaRet recording::MediaRecorder::Record(const char *fname)
         Stop(false);
         return ret;
     }
+    // encoder thread
+    ret = setup_encoder_queue();
+    if (ret != MRET_OK)
+    {
+        Stop(false);
+        return ret;
+    }
     return MRET_OK;
 }
 
@@ -571,6 +724,23 @@ recording::MediaRet recording::MediaRecorder::Record(const char *fname)
 recording::MediaRet recording::MediaRecorder::AddFrame(const uint16_t *aud, int length)
 {
     if (!isRecording) return MRET_OK;
+    std::unique_lock<std::mutex> lock(queueLock);
+    if (encoderError != MRET_OK) return encoderError;
+    EncoderJob *job = acquire_job(lock, false);
+    job->audio.assign(aud, aud + length / sizeof *aud);
+    jobCount++;
+    stats.audioChunksQueued++;
+    stats.queueDepth = jobCount;
+    if (jobCount > stats.maxQueueDepth)
+        stats.maxQueueDepth = jobCount;
+    lock.unlock();
+    queueNotEmpty.notify_one();
+    return MRET_OK;
+}
+
+// runs on the encoder thread
+recording::MediaRet recording::MediaRecorder::encode_audio(const uint16_t *aud, int length)
+{
     AVCodecContext *c = aenc;
     int samples_size = av_samples_get_buffer_size(NULL, 2, audioframeTmp->nb_samples, IN_SOUND_FORMAT, 1);
 
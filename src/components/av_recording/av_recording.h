@@ -28,6 +28,9 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace recording {
@@ -51,6 +54,23 @@ enum MediaRet {
         MRET_ERR_BUFSIZE    // buffer overflow (fatal)
 };
 
+// what AddFrame() does with video when the encoder queue is full
+enum DropPolicy {
+        DROP_NONE,          // wait for the encoder thread (lossless; default)
+        DROP_VIDEO          // drop the new video frame; audio is never dropped
+};
+
+// encoder queue statistics, used to report back-pressure to the user
+struct EncoderStats {
+        uint64_t videoFramesQueued;  // video frames handed to the encoder
+        uint64_t videoFramesDropped; // video frames dropped by DROP_VIDEO
+        uint64_t audioChunksQueued;  // audio chunks handed to the encoder
+        uint64_t producerStalls;     // times AddFrame() waited for a free slot
+        uint64_t producerStallUsec;  // total time spent waiting, in usec
+        int queueDepth;              // jobs currently queued or encoding
+        int maxQueueDepth;           // high-water mark of queueDepth
+};
+
 class MediaRecorder
 {
         public:
@@ -70,7 +90,12 @@ class MediaRecorder
         // add a frame of video; width+height+depth already given
         // assumes a 1-pixel border on top & right
         // always assumes being passed 1/60th of a second of video
+        // the frame is copied into the encoder queue; encoding happens on
+        // a separate thread, so errors may be reported by a later call
         MediaRet AddFrame(const uint8_t *vid);
+        // same, with an explicit presentation timestamp counted in frames
+        // of the rate given to SetFrameRate(); pts must be increasing
+        MediaRet AddFrame(const uint8_t *vid, int64_t pts);
         // add a frame of audio; uses current sample rate to know length
         // always assumes being passed 1/60th of a second of audio;
         // single sample, though (we need one for each channel).
@@ -81,6 +106,30 @@ class MediaRecorder
         {
                 sampleRate = newSampleRate;
         }
+        // video frame rate as a fraction (e.g. 16777216/280896 for the
+        // exact GBA rate); takes effect on the next Record()
+        void SetFrameRate(int num, int den)
+        {
+                frameRate = { num, den };
+        }
+        // threads used by libavcodec frame/slice threading; 0 picks one
+        // per core; takes effect on the next Record()
+        void SetEncoderThreads(int newEncoderThreads)
+        {
+                encoderThreads = newEncoderThreads;
+        }
+        // number of frames the encoder queue can hold; takes effect on
+        // the next Record()
+        void SetQueueSize(int newQueueSize)
+        {
+                queueSize = newQueueSize > 0 ? newQueueSize : 1;
+        }
+        void SetDropPolicy(DropPolicy newDropPolicy)
+        {
+                std::lock_guard<std::mutex> lock(queueLock);
+                dropPolicy = newDropPolicy;
+        }
+        EncoderStats GetStats();
 
         private:
         bool isRecording;
@@ -97,7 +146,8 @@ class MediaRecorder
         const AVCodec *vcodec;
         AVCodecContext *enc;
         int64_t npts; // for video frame pts
-        AVFrame *frameIn;
+        AVRational frameRate;
+        int encoderThreads;
         AVFrame *frameOut;
         // audio
         bool audioOnlyRecording;
@@ -113,12 +163,37 @@ class MediaRecorder
         int posInAudioBuffer;
         int samplesInAudioBuffer;
         int audioBufferSize;
+        // encoder queue: a ring of jobs filled by AddFrame() and drained
+        // by encoderThread; video jobs own a pooled input AVFrame each
+        struct EncoderJob {
+                bool isVideo;
+                AVFrame *video;
+                int64_t pts;
+                std::vector<uint16_t> audio;
+        };
+        std::vector<EncoderJob> jobs;
+        int queueSize;
+        int jobHead, jobCount;
+        bool stopEncoder;
+        MediaRet encoderError;
+        DropPolicy dropPolicy;
+        EncoderStats stats;
+        std::mutex queueLock;
+        std::condition_variable queueNotEmpty, queueNotFull;
+        std::thread encoderThread;
 
         MediaRet setup_common(const char *fname);
         MediaRet setup_video_stream_info(int width, int height, int depth);
         MediaRet setup_video_stream(int width, int height);
         MediaRet setup_audio_stream();
         MediaRet finish_setup(const char *fname);
+        MediaRet setup_encoder_queue();
+        void stop_encoder_queue();
+        // reserve the next free job slot; called with queueLock held
+        EncoderJob *acquire_job(std::unique_lock<std::mutex> &lock, bool isVideo);
+        void encoder_loop();
+        MediaRet encode_video(AVFrame *in, int64_t pts);
+        MediaRet encode_audio(const uint16_t *aud, int length);
         // flush last frames to avoid
         // "X frames left in the queue on closing"
         void flush_frames();
@@ -0,0 +1,177 @@
+#include "components/filters/filters.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "components/filters/internal/xBRZ/xbrz.h"
+#include "components/filters/internal/xbrzfilter.h"
+#include "core/base/job_pool.h"
+#include "core/base/system.h"
+
+int RGB_LOW_BITS_MASK = 0x821;
+
+namespace {
+
+// An odd size, so the vector kernels also run their scalar row tails.
+constexpr int kWidth = 61;
+constexpr int kHeight = 37;
+// The core draws 32-bit frames with 1 pixel and 16-bit frames with 2 pixels
+// of border at the end of every line.
+constexpr uint32_t kPitch32 = (kWidth + 1) * 4;
+constexpr uint32_t kPitch16 = (kWidth + 2) * 2;
+
+typedef void (*FilterFn)(uint8_t*, uint32_t, uint8_t*, uint8_t*, uint32_t, int, int);
+
+// The frames have a line of padding above them and more below, as 2xSaI reads
+// the line above and the two lines below each line.
+struct Frames {
+    std::vector<uint16_t> pix16;
+    std::vector<uint32_t> pix32;
+
+    uint8_t* Frame16() const { return (uint8_t*)(pix16.data() + kPitch16 / 2); }
+    uint8_t* Frame32() const { return (uint8_t*)(pix32.data() + kPitch32 / 4); }
+};
+
+// Blocks of flat colour with some noise, and some colours that differ only
+// in their low bits, so both the equal and the "similar" cases are hit.
+const Frames& TestFrames() {
+    static const Frames frames = [] {
+        static const uint32_t kPalette[6] = {0x000000, 0xf8f8f8, 0xf80000,
+                                             0x00fc00, 0x1010f8, 0x886644};
+        uint32_t lcg = 12345;
+        auto next = [&lcg] {
+            lcg = lcg * 1103515245u + 12345u;
+            return lcg >> 8;
+        };
+        Frames f;
+        f.pix32.resize((kWidth + 1) * (kHeight + 4));
+        f.pix16.resize((kWidth + 2) * (kHeight + 4));
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < kWidth; x++) {
+                uint32_t c = kPalette[((x / 3) ^ (y / 4) ^ ((x + y) / 5)) % 6];
+                if (next() % 7 == 0)
+                    c = next() & 0xffffff;
+                if (next() % 11 == 0)
+                    c = (c & 0xf8f8f8) | (next() & 0x070707);
+                f.pix32[(y + 1) * (kWidth + 1) + x] = c;
+                f.pix16[(y + 1) * (kWidth + 2) + x] =
+                    ((c >> 19) & 0x1f) << 11 | ((c >> 10) & 0x3f) << 5 | ((c >> 3) & 0x1f);
+            }
+        }
+        return f;
+    }();
+    return frames;
+}
+
+std::vector<uint8_t> Filter(FilterImplementation impl, FilterFn filter, int bpp, int scale) {
+    EXPECT_TRUE(FilterSetImplementation(impl));
+    // Also calls hq2x_init(bpp).
+    systemColorDepth = bpp;
+    Init_2xSaI(565);
+    const Frames& frames = TestFrames();
+    const uint32_t dstPitch = kWidth * scale * bpp / 8;
+    std::vector<uint8_t> output(dstPitch * kHeight * scale);
+    // SuperEagle copies the frame into the delta buffer.
+    std::vector<uint8_t> delta(kPitch32 * kHeight);
+    if (bpp == 16)
+        filter(frames.Frame16(), kPitch16, delta.data(), output.data(), dstPitch, kWidth, kHeight);
+    else
+        filter(frames.Frame32(), kPitch32, delta.data(), output.data(), dstPitch, kWidth, kHeight);
+    return output;
+}
+
+// FNV-1a.
+uint64_t Hash(const std::vector<uint8_t>& data) {
+    uint64_t hash = 1469598103934665603ull;
+    for (uint8_t b : data) {
+        hash ^= b;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+struct FilterCase {
+    const char* name;
+    FilterFn filter;
+    int bpp;
+    int scale;
+    // The hash of the output of the scalar code before it was vectorized.
+    uint64_t hash;
+};
+
+const FilterCase kFilterCases[] = {
+    {"hq2x", hq2x, 16, 2, 0xa9405a3b765b6408ull},
+    {"hq2x32", hq2x32, 32, 2, 0xbf7bb3f4aae592c3ull},
+    {"lq2x", lq2x, 16, 2, 0xbb65d27e8bdc7b9bull},
+    {"lq2x32", lq2x32, 32, 2, 0x24c01cbec7e14fd4ull},
+    {"hq3x16", hq3x16, 16, 3, 0xbdac39bc51ed61b5ull},
+    {"hq3x32", hq3x32, 32, 3, 0xe5c1ca9c324297e5ull},
+    {"hq4x16", hq4x16, 16, 4, 0xdffb8eacaf5634bcull},
+    {"hq4x32", hq4x32, 32, 4, 0xf60a39d0c1cdf18eull},
+    {"AdMame2x", AdMame2x, 16, 2, 0x527f606ad9500e0dull},
+    {"AdMame2x32", AdMame2x32, 32, 2, 0x110526417477d2e3ull},
+    {"_2xSaI", _2xSaI, 16, 2, 0x7db9dcd16647f366ull},
+    {"_2xSaI32", _2xSaI32, 32, 2, 0xdd29d3be741957e6ull},
+    {"Super2xSaI", Super2xSaI, 16, 2, 0x3a50d8bc429240edull},
+    {"Super2xSaI32", Super2xSaI32, 32, 2, 0xecd858cd4a19d766ull},
+    {"SuperEagle", SuperEagle, 16, 2, 0x43c7999c6a57c4f5ull},
+    {"SuperEagle32", SuperEagle32, 32, 2, 0x710619170951bf5cull},
+};
+
+class FiltersTest : public ::testing::TestWithParam<FilterImplementation> {
+protected:
+    void SetUp() override {
+        if (!FilterImplementationAvailable(GetParam()))
+            GTEST_SKIP() << FilterImplementationName(GetParam()) << " is not available";
+    }
+    void TearDown() override { FilterSetImplementation(FILTER_IMPL_SCALAR); }
+};
+
+TEST_P(FiltersTest, MatchesReference) {
+    for (const FilterCase& test : kFilterCases) {
+        SCOPED_TRACE(test.name);
+        EXPECT_EQ(Hash(Filter(GetParam(), test.filter, test.bpp, test.scale)), test.hash);
+    }
+}
+
+TEST_P(FiltersTest, MatchesScalar) {
+    for (const FilterCase& test : kFilterCases) {
+        SCOPED_TRACE(test.name);
+        EXPECT_EQ(Filter(GetParam(), test.filter, test.bpp, test.scale),
+                  Filter(FILTER_IMPL_SCALAR, test.filter, test.bpp, test.scale));
+    }
+}
+
+// The xBRZ filters split the frame into jobs over two passes; this must give
+// the same result as scaling the frame in one go, whether the jobs run inline
+// or on the workers of the pool.
+TEST(XbrzTest, MatchesSinglePass) {
+    static const FilterFn kXbrz[] = {xbrz2x32, xbrz3x32, xbrz4x32, xbrz5x32, xbrz6x32};
+    const Frames& frames = TestFrames();
+    JobPool pool(3);
+    for (int scale = 2; scale <= 6; scale++) {
+        SCOPED_TRACE(scale);
+        const uint32_t dstPitch = kWidth * scale * 4;
+        std::vector<uint8_t> expected(dstPitch * kHeight * scale);
+        xbrz::scale(scale, (const uint32_t*)frames.Frame32(), (uint32_t*)expected.data(), kWidth, kHeight,
+                    xbrz::ColorFormat::RGB, kPitch32, dstPitch);
+        EXPECT_EQ(Filter(FILTER_IMPL_SCALAR, kXbrz[scale - 2], 32, scale), expected);
+
+        std::vector<uint8_t> output(expected.size());
+        filters::internal::XbrzScale(pool, scale, frames.Frame32(), kPitch32, output.data(), dstPitch, kWidth,
+                                     kHeight);
+        EXPECT_EQ(output, expected);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Implementations,
+                         FiltersTest,
+                         ::testing::Values(FILTER_IMPL_SCALAR, FILTER_IMPL_SSE2, FILTER_IMPL_AVX2),
+                         [](const ::testing::TestParamInfo<FilterImplementation>& info) {
+                             return std::string(FilterImplementationName(info.param));
+                         });
+
+}  // namespace
@@ -7,12 +7,28 @@
 // those that take delta take 1 src line of pixels, rounded up to uint32_t size
 // initial value appears to be all-0xff
 
+// SIMD code paths of hq2x, lq2x, hq3x, hq4x, AdMame2x and the 2xSaI family.
+// The best one supported by the CPU is selected at startup; all of them
+// produce the same output.
+enum FilterImplementation {
+    FILTER_IMPL_SCALAR,
+    FILTER_IMPL_SSE2,
+    FILTER_IMPL_AVX2,
+    FILTER_IMPL_COUNT
+};
+
+// Returns false if `impl` is not compiled in or not supported by the CPU.
+bool FilterSetImplementation(FilterImplementation impl);
+FilterImplementation FilterGetImplementation();
+bool FilterImplementationAvailable(FilterImplementation impl);
+const char* FilterImplementationName(FilterImplementation impl);
+
 void Pixelate32(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
 void Pixelate(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
 // next 3*2 use Init_2xSaI(555|565) and do not take into account
 int Init_2xSaI(uint32_t BitFormat);
 // endianness or bit shift variables in init.
-// next 4*2 may be MMX-accelerated
+// flat areas of next 3*2 are found with the vector code
 void _2xSaI32(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
 void _2xSaI(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
 // void Scale_2xSaI(uint8_t *src, uint32_t spitch, uint8_t *, uint8_t *dst, uint32_t dstp, int w, int h);
@@ -20,6 +36,7 @@ void Super2xSaI32(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, u
 void Super2xSaI(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
 void SuperEagle32(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
 void SuperEagle(uint8_t* src, uint32_t spitch, uint8_t* delta, uint8_t* dst, uint32_t dstp, int w, int h);
+// next 2 are vectorized when the CPU allows it
 void AdMame2x32(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
 void AdMame2x(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
 // next 4 convert to rgb24 in internal buffers first, and then back again
@@ -36,6 +53,7 @@ void ScanlinesTV32(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32
 extern int RGB_LOW_BITS_MASK;
 void ScanlinesTV(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
 // next 2 require calling hq2x_init first and whenever bpp changes
+// pattern detection of next 4 and of hq3x/hq4x is vectorized
 void hq2x_init(unsigned bpp);
 void hq2x32(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
 void hq2x(uint8_t* src, uint32_t spitch, uint8_t*, uint8_t* dst, uint32_t dstp, int w, int h);
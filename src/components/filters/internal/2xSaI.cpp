@@ -1,31 +1,8 @@
 #include "core/base/system.h"
+#include "components/filters/internal/filters_simd.h"
 
 extern int RGB_LOW_BITS_MASK;
 
-extern "C"
-{
-
-#ifdef MMX
-  void _2xSaILine (uint8_t *srcPtr, uint8_t *deltaPtr, uint32_t srcPitch,
-                   uint32_t width, uint8_t *dstPtr, uint32_t dstPitch);
-  void _2xSaISuperEagleLine (uint8_t *srcPtr, uint8_t *deltaPtr,
-                             uint32_t srcPitch, uint32_t width,
-                             uint8_t *dstPtr, uint32_t dstPitch);
-  void _2xSaISuper2xSaILine (uint8_t *srcPtr, uint8_t *deltaPtr,
-                             uint32_t srcPitch, uint32_t width,
-                             uint8_t *dstPtr, uint32_t dstPitch);
-    void Init_2xSaIMMX (uint32_t BitFormat);
-  void BilinearMMX (uint16_t * A, uint16_t * B, uint16_t * C, uint16_t * D,
-                    uint16_t * dx, uint16_t * dy, uint8_t *dP);
-  void BilinearMMXGrid0 (uint16_t * A, uint16_t * B, uint16_t * C, uint16_t * D,
-                         uint16_t * dx, uint16_t * dy, uint8_t *dP);
-  void BilinearMMXGrid1 (uint16_t * A, uint16_t * B, uint16_t * C, uint16_t * D,
-                         uint16_t * dx, uint16_t * dy, uint8_t *dP);
-  void EndMMX ();
-
-  bool cpu_mmx = 1;
-#endif
-}
 static uint32_t colorMask = 0xF7DEF7DE;
 static uint32_t lowPixelMask = 0x08210821;
 static uint32_t qcolorMask = 0xE79CE79C;
@@ -33,8 +10,6 @@ static uint32_t qlowpixelMask = 0x18631863;
 static uint32_t redblueMask = 0xF81F;
 static uint32_t greenMask = 0x7E0;
 
-uint32_t qRGB_COLOR_MASK[2] = { 0xF7DEF7DE, 0xF7DEF7DE };
-
 extern void hq2x_init(unsigned);
 
 int Init_2xSaI(uint32_t BitFormat)
@@ -47,7 +22,6 @@ int Init_2xSaI(uint32_t BitFormat)
       qlowpixelMask = 0x18631863;
       redblueMask = 0xF81F;
       greenMask = 0x7E0;
-      qRGB_COLOR_MASK[0] = qRGB_COLOR_MASK[1] = 0xF7DEF7DE;
       hq2x_init(16);
       RGB_LOW_BITS_MASK = 0x0821;
     } else if (BitFormat == 555) {
@@ -57,7 +31,6 @@ int Init_2xSaI(uint32_t BitFormat)
       qlowpixelMask = 0x0C630C63;
       redblueMask = 0x7C1F;
       greenMask = 0x3E0;
-      qRGB_COLOR_MASK[0] = qRGB_COLOR_MASK[1] = 0x7BDE7BDE;
       hq2x_init(15);
       RGB_LOW_BITS_MASK = 0x0421;
     } else {
@@ -68,16 +41,11 @@ int Init_2xSaI(uint32_t BitFormat)
     lowPixelMask = 0x010101;
     qcolorMask = 0xfcfcfc;
     qlowpixelMask = 0x030303;
-    qRGB_COLOR_MASK[0] = qRGB_COLOR_MASK[1] = 0xfefefe;
     hq2x_init(32);
     RGB_LOW_BITS_MASK = 0x010101;
   } else
     return 0;
 
-#ifdef MMX
-    Init_2xSaIMMX (BitFormat);
-#endif
-
   return 1;
 }
 
@@ -227,140 +195,140 @@ void Super2xSaI (uint8_t *srcPtr, uint32_t srcPitch,
   uint8_t  *dP;
   uint32_t inc_bP;
   uint32_t Nextline = srcPitch >> 1;
-#ifdef MMX
-  if (cpu_mmx) {
-    for (; height; height--) {
-      _2xSaISuper2xSaILine (srcPtr, deltaPtr, srcPitch, width,
-                            dstPtr, dstPitch);
-      srcPtr += srcPitch;
-      dstPtr += dstPitch * 2;
-      deltaPtr += srcPitch;
-    }
-  } else
-#endif
-    {
-      inc_bP = 1;
-
-      for (; height; height--) {
-        bP = (uint16_t *) srcPtr;
-        dP = (uint8_t *) dstPtr;
-
-        for (uint32_t finish = width; finish; finish -= inc_bP) {
-          uint32_t color4, color5, color6;
-          uint32_t color1, color2, color3;
-          uint32_t colorA0, colorA1, colorA2, colorA3,
-            colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
-          uint32_t product1a, product1b, product2a, product2b;
-
-          //---------------------------------------    B1 B2
-          //                                         4  5  6 S2
-          //                                         1  2  3 S1
-          //                                           A1 A2
-
-          colorB0 = *(bP - Nextline - 1);
-          colorB1 = *(bP - Nextline);
-          colorB2 = *(bP - Nextline + 1);
-          colorB3 = *(bP - Nextline + 2);
-
-          color4 = *(bP - 1);
-          color5 = *(bP);
-          color6 = *(bP + 1);
-          colorS2 = *(bP + 2);
-
-          color1 = *(bP + Nextline - 1);
-          color2 = *(bP + Nextline);
-          color3 = *(bP + Nextline + 1);
-          colorS1 = *(bP + Nextline + 2);
-
-          colorA0 = *(bP + Nextline + Nextline - 1);
-          colorA1 = *(bP + Nextline + Nextline);
-          colorA2 = *(bP + Nextline + Nextline + 1);
-          colorA3 = *(bP + Nextline + Nextline + 2);
-
-          //--------------------------------------
-          if (color2 == color6 && color5 != color3) {
-            product2b = product1b = color2;
-          } else if (color5 == color3 && color2 != color6) {
-            product2b = product1b = color5;
-          } else if (color5 == color3 && color2 == color6) {
-            int r = 0;
-
-            r += GetResult (color6, color5, color1, colorA1);
-            r += GetResult (color6, color5, color4, colorB1);
-            r += GetResult (color6, color5, colorA2, colorS1);
-            r += GetResult (color6, color5, colorB2, colorS2);
-
-            if (r > 0)
-              product2b = product1b = color6;
-            else if (r < 0)
-              product2b = product1b = color5;
-            else {
-              product2b = product1b = INTERPOLATE (color5, color6);
-            }
-          } else {
-            if (color6 == color3 && color3 == colorA1
-                && color2 != colorA2 && color3 != colorA0)
-              product2b =
-                Q_INTERPOLATE (color3, color3, color3, color2);
-            else if (color5 == color2 && color2 == colorA2
-                     && colorA1 != color3 && color2 != colorA3)
-              product2b =
-                Q_INTERPOLATE (color2, color2, color2, color3);
-            else
-              product2b = INTERPOLATE (color2, color3);
-
-            if (color6 == color3 && color6 == colorB1
-                && color5 != colorB2 && color6 != colorB0)
-              product1b =
-                Q_INTERPOLATE (color6, color6, color6, color5);
-            else if (color5 == color2 && color5 == colorB2
-                     && colorB1 != color6 && color5 != colorB3)
-              product1b =
-                Q_INTERPOLATE (color6, color5, color5, color5);
-            else
-              product1b = INTERPOLATE (color5, color6);
-          }
+  inc_bP = 1;
+
+  for (; height; height--) {
+    bP = (uint16_t *) srcPtr;
+    dP = (uint8_t *) dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat16 (bP, bP + Nextline, width);
+
+    for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // 5, 6, 2 and 3 are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        uint32_t color = *bP;
+
+        color |= color << 16;
+        *((uint32_t *) dP) = color;
+        *((uint32_t *) (dP + dstPitch)) = color;
+        bP += inc_bP;
+        dP += sizeof (uint32_t);
+        continue;
+      }
+
+      uint32_t color4, color5, color6;
+      uint32_t color1, color2, color3;
+      uint32_t colorA0, colorA1, colorA2, colorA3,
+        colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
+      uint32_t product1a, product1b, product2a, product2b;
+
+      //---------------------------------------    B1 B2
+      //                                         4  5  6 S2
+      //                                         1  2  3 S1
+      //                                           A1 A2
+
+      colorB0 = *(bP - Nextline - 1);
+      colorB1 = *(bP - Nextline);
+      colorB2 = *(bP - Nextline + 1);
+      colorB3 = *(bP - Nextline + 2);
+
+      color4 = *(bP - 1);
+      color5 = *(bP);
+      color6 = *(bP + 1);
+      colorS2 = *(bP + 2);
+
+      color1 = *(bP + Nextline - 1);
+      color2 = *(bP + Nextline);
+      color3 = *(bP + Nextline + 1);
+      colorS1 = *(bP + Nextline + 2);
+
+      colorA0 = *(bP + Nextline + Nextline - 1);
+      colorA1 = *(bP + Nextline + Nextline);
+      colorA2 = *(bP + Nextline + Nextline + 1);
+      colorA3 = *(bP + Nextline + Nextline + 2);
+
+      //--------------------------------------
+      if (color2 == color6 && color5 != color3) {
+        product2b = product1b = color2;
+      } else if (color5 == color3 && color2 != color6) {
+        product2b = product1b = color5;
+      } else if (color5 == color3 && color2 == color6) {
+        int r = 0;
+
+        r += GetResult (color6, color5, color1, colorA1);
+        r += GetResult (color6, color5, color4, colorB1);
+        r += GetResult (color6, color5, colorA2, colorS1);
+        r += GetResult (color6, color5, colorB2, colorS2);
+
+        if (r > 0)
+          product2b = product1b = color6;
+        else if (r < 0)
+          product2b = product1b = color5;
+        else {
+          product2b = product1b = INTERPOLATE (color5, color6);
+        }
+      } else {
+        if (color6 == color3 && color3 == colorA1
+            && color2 != colorA2 && color3 != colorA0)
+          product2b =
+            Q_INTERPOLATE (color3, color3, color3, color2);
+        else if (color5 == color2 && color2 == colorA2
+                 && colorA1 != color3 && color2 != colorA3)
+          product2b =
+            Q_INTERPOLATE (color2, color2, color2, color3);
+        else
+          product2b = INTERPOLATE (color2, color3);
+
+        if (color6 == color3 && color6 == colorB1
+            && color5 != colorB2 && color6 != colorB0)
+          product1b =
+            Q_INTERPOLATE (color6, color6, color6, color5);
+        else if (color5 == color2 && color5 == colorB2
+                 && colorB1 != color6 && color5 != colorB3)
+          product1b =
+            Q_INTERPOLATE (color6, color5, color5, color5);
+        else
+          product1b = INTERPOLATE (color5, color6);
+      }
+
+      if (color5 == color3 && color2 != color6 && color4 == color5
+          && color5 != colorA2)
+        product2a = INTERPOLATE (color2, color5);
+      else
+        if (color5 == color1 && color6 == color5
+            && color4 != color2 && color5 != colorA0)
+          product2a = INTERPOLATE (color2, color5);
+        else
+          product2a = color2;
 
-          if (color5 == color3 && color2 != color6 && color4 == color5
-              && color5 != colorA2)
-            product2a = INTERPOLATE (color2, color5);
-          else
-            if (color5 == color1 && color6 == color5
-                && color4 != color2 && color5 != colorA0)
-              product2a = INTERPOLATE (color2, color5);
-            else
-              product2a = color2;
-
-          if (color2 == color6 && color5 != color3 && color1 == color2
-              && color2 != colorB2)
-            product1a = INTERPOLATE (color2, color5);
-          else
-            if (color4 == color2 && color3 == color2
-                && color1 != color5 && color2 != colorB0)
-              product1a = INTERPOLATE (color2, color5);
-            else
-              product1a = color5;
+      if (color2 == color6 && color5 != color3 && color1 == color2
+          && color2 != colorB2)
+        product1a = INTERPOLATE (color2, color5);
+      else
+        if (color4 == color2 && color3 == color2
+            && color1 != color5 && color2 != colorB0)
+          product1a = INTERPOLATE (color2, color5);
+        else
+          product1a = color5;
 
 #ifdef WORDS_BIGENDIAN
-          product1a = (product1a << 16) | product1b;
-          product2a = (product2a << 16) | product2b;
+      product1a = (product1a << 16) | product1b;
+      product2a = (product2a << 16) | product2b;
 #else
-          product1a = product1a | (product1b << 16);
-          product2a = product2a | (product2b << 16);
+      product1a = product1a | (product1b << 16);
+      product2a = product2a | (product2b << 16);
 #endif
 
-          *((uint32_t *) dP) = product1a;
-          *((uint32_t *) (dP + dstPitch)) = product2a;
+      *((uint32_t *) dP) = product1a;
+      *((uint32_t *) (dP + dstPitch)) = product2a;
 
-          bP += inc_bP;
-          dP += sizeof (uint32_t);
-        }                       // end of for ( finish= width etc..)
+      bP += inc_bP;
+      dP += sizeof (uint32_t);
+    }                       // end of for ( finish= width etc..)
 
-        srcPtr   += srcPitch;
-        dstPtr   += dstPitch << 1;
-        deltaPtr += srcPitch;
-      }                 // endof: for (; height; height--)
-    }
+    srcPtr   += srcPitch;
+    dstPtr   += dstPitch << 1;
+    deltaPtr += srcPitch;
+  }                 // endof: for (; height; height--)
 }
 
 void Super2xSaI32 (uint8_t *srcPtr, uint32_t srcPitch,
@@ -376,8 +344,18 @@ void Super2xSaI32 (uint8_t *srcPtr, uint32_t srcPitch,
   for (; height; height--) {
     bP = (uint32_t *) srcPtr;
     dP = (uint32_t *) dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat32 (bP, bP + Nextline, width);
 
     for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // 5, 6, 2 and 3 are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        *(dP) = *(dP + 1) = *bP;
+        *(dP + (dstPitch >> 2)) = *(dP + (dstPitch >> 2) + 1) = *bP;
+        bP += inc_bP;
+        dP += 2;
+        continue;
+      }
+
       uint32_t color4, color5, color6;
       uint32_t color1, color2, color3;
       uint32_t colorA0, colorA1, colorA2, colorA3,
@@ -495,143 +473,145 @@ void SuperEagle (uint8_t *srcPtr, uint32_t srcPitch, uint8_t *deltaPtr,
   uint16_t *xP;
   uint32_t inc_bP;
 
-#ifdef MMX
-  if (cpu_mmx) {
-    for (; height; height--) {
-      _2xSaISuperEagleLine (srcPtr, deltaPtr, srcPitch, width,
-                            dstPtr, dstPitch);
-      srcPtr += srcPitch;
-      dstPtr += dstPitch * 2;
-      deltaPtr += srcPitch;
-    }
-  } else
-#endif
-  {
-    inc_bP = 1;
-
-    uint32_t Nextline = srcPitch >> 1;
-
-    for (; height; height--) {
-      bP = (uint16_t *) srcPtr;
-      xP = (uint16_t *) deltaPtr;
-      dP = dstPtr;
-      for (uint32_t finish = width; finish; finish -= inc_bP) {
-        uint32_t color4, color5, color6;
-        uint32_t color1, color2, color3;
-        uint32_t colorA1, colorA2, colorB1, colorB2, colorS1, colorS2;
-        uint32_t product1a, product1b, product2a, product2b;
-
-        colorB1 = *(bP - Nextline);
-        colorB2 = *(bP - Nextline + 1);
-
-        color4 = *(bP - 1);
-        color5 = *(bP);
-        color6 = *(bP + 1);
-        colorS2 = *(bP + 2);
-
-        color1 = *(bP + Nextline - 1);
-        color2 = *(bP + Nextline);
-        color3 = *(bP + Nextline + 1);
-        colorS1 = *(bP + Nextline + 2);
-
-        colorA1 = *(bP + Nextline + Nextline);
-        colorA2 = *(bP + Nextline + Nextline + 1);
-
-        // --------------------------------------
-        if (color2 == color6 && color5 != color3) {
-          product1b = product2a = color2;
-          if ((color1 == color2) || (color6 == colorB2)) {
-            product1a = INTERPOLATE (color2, color5);
-            product1a = INTERPOLATE (color2, product1a);
-            //                       product1a = color2;
-          } else {
-            product1a = INTERPOLATE (color5, color6);
-          }
+  inc_bP = 1;
 
-          if ((color6 == colorS2) || (color2 == colorA1)) {
-            product2b = INTERPOLATE (color2, color3);
-            product2b = INTERPOLATE (color2, product2b);
-            //                       product2b = color2;
-          } else {
-            product2b = INTERPOLATE (color2, color3);
-          }
-        } else if (color5 == color3 && color2 != color6) {
-          product2b = product1a = color5;
+  uint32_t Nextline = srcPitch >> 1;
 
-          if ((colorB1 == color5) || (color3 == colorS1)) {
-            product1b = INTERPOLATE (color5, color6);
-            product1b = INTERPOLATE (color5, product1b);
-            //                       product1b = color5;
-          } else {
-            product1b = INTERPOLATE (color5, color6);
-          }
+  for (; height; height--) {
+    bP = (uint16_t *) srcPtr;
+    xP = (uint16_t *) deltaPtr;
+    dP = dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat16 (bP, bP + Nextline, width);
+    for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // 5, 6, 2 and 3 are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        uint32_t color = *bP;
+
+        color |= color << 16;
+        *((uint32_t *) dP) = color;
+        *((uint32_t *) (dP + dstPitch)) = color;
+        *xP = *bP;
+        xP += inc_bP;
+        bP += inc_bP;
+        dP += sizeof (uint32_t);
+        continue;
+      }
 
-          if ((color3 == colorA2) || (color4 == color5)) {
-            product2a = INTERPOLATE (color5, color2);
-            product2a = INTERPOLATE (color5, product2a);
-            //                       product2a = color5;
-          } else {
-            product2a = INTERPOLATE (color2, color3);
-          }
+      uint32_t color4, color5, color6;
+      uint32_t color1, color2, color3;
+      uint32_t colorA1, colorA2, colorB1, colorB2, colorS1, colorS2;
+      uint32_t product1a, product1b, product2a, product2b;
 
-        } else if (color5 == color3 && color2 == color6) {
-          int r = 0;
+      colorB1 = *(bP - Nextline);
+      colorB2 = *(bP - Nextline + 1);
 
-          r += GetResult (color6, color5, color1, colorA1);
-          r += GetResult (color6, color5, color4, colorB1);
-          r += GetResult (color6, color5, colorA2, colorS1);
-          r += GetResult (color6, color5, colorB2, colorS2);
-
-          if (r > 0) {
-            product1b = product2a = color2;
-            product1a = product2b = INTERPOLATE (color5, color6);
-          } else if (r < 0) {
-            product2b = product1a = color5;
-            product1b = product2a = INTERPOLATE (color5, color6);
-          } else {
-            product2b = product1a = color5;
-            product1b = product2a = color2;
-          }
+      color4 = *(bP - 1);
+      color5 = *(bP);
+      color6 = *(bP + 1);
+      colorS2 = *(bP + 2);
+
+      color1 = *(bP + Nextline - 1);
+      color2 = *(bP + Nextline);
+      color3 = *(bP + Nextline + 1);
+      colorS1 = *(bP + Nextline + 2);
+
+      colorA1 = *(bP + Nextline + Nextline);
+      colorA2 = *(bP + Nextline + Nextline + 1);
+
+      // --------------------------------------
+      if (color2 == color6 && color5 != color3) {
+        product1b = product2a = color2;
+        if ((color1 == color2) || (color6 == colorB2)) {
+          product1a = INTERPOLATE (color2, color5);
+          product1a = INTERPOLATE (color2, product1a);
+          //                       product1a = color2;
         } else {
-          product2b = product1a = INTERPOLATE (color2, color6);
-          product2b =
-            Q_INTERPOLATE (color3, color3, color3, product2b);
-          product1a =
-            Q_INTERPOLATE (color5, color5, color5, product1a);
+          product1a = INTERPOLATE (color5, color6);
+        }
 
-          product2a = product1b = INTERPOLATE (color5, color3);
-          product2a =
-            Q_INTERPOLATE (color2, color2, color2, product2a);
-          product1b =
-            Q_INTERPOLATE (color6, color6, color6, product1b);
+        if ((color6 == colorS2) || (color2 == colorA1)) {
+          product2b = INTERPOLATE (color2, color3);
+          product2b = INTERPOLATE (color2, product2b);
+          //                       product2b = color2;
+        } else {
+          product2b = INTERPOLATE (color2, color3);
+        }
+      } else if (color5 == color3 && color2 != color6) {
+        product2b = product1a = color5;
+
+        if ((colorB1 == color5) || (color3 == colorS1)) {
+          product1b = INTERPOLATE (color5, color6);
+          product1b = INTERPOLATE (color5, product1b);
+          //                       product1b = color5;
+        } else {
+          product1b = INTERPOLATE (color5, color6);
+        }
+
+        if ((color3 == colorA2) || (color4 == color5)) {
+          product2a = INTERPOLATE (color5, color2);
+          product2a = INTERPOLATE (color5, product2a);
+          //                       product2a = color5;
+        } else {
+          product2a = INTERPOLATE (color2, color3);
+        }
 
-          //                    product1a = color5;
-          //                    product1b = color6;
-          //                    product2a = color2;
-          //                    product2b = color3;
+      } else if (color5 == color3 && color2 == color6) {
+        int r = 0;
+
+        r += GetResult (color6, color5, color1, colorA1);
+        r += GetResult (color6, color5, color4, colorB1);
+        r += GetResult (color6, color5, colorA2, colorS1);
+        r += GetResult (color6, color5, colorB2, colorS2);
+
+        if (r > 0) {
+          product1b = product2a = color2;
+          product1a = product2b = INTERPOLATE (color5, color6);
+        } else if (r < 0) {
+          product2b = product1a = color5;
+          product1b = product2a = INTERPOLATE (color5, color6);
+        } else {
+          product2b = product1a = color5;
+          product1b = product2a = color2;
         }
+      } else {
+        product2b = product1a = INTERPOLATE (color2, color6);
+        product2b =
+          Q_INTERPOLATE (color3, color3, color3, product2b);
+        product1a =
+          Q_INTERPOLATE (color5, color5, color5, product1a);
+
+        product2a = product1b = INTERPOLATE (color5, color3);
+        product2a =
+          Q_INTERPOLATE (color2, color2, color2, product2a);
+        product1b =
+          Q_INTERPOLATE (color6, color6, color6, product1b);
+
+        //                    product1a = color5;
+        //                    product1b = color6;
+        //                    product2a = color2;
+        //                    product2b = color3;
+      }
 #ifdef WORDS_BIGENDIAN
-        product1a = (product1a << 16) | product1b;
-        product2a = (product2a << 16) | product2b;
+      product1a = (product1a << 16) | product1b;
+      product2a = (product2a << 16) | product2b;
 #else
-        product1a = product1a | (product1b << 16);
-        product2a = product2a | (product2b << 16);
+      product1a = product1a | (product1b << 16);
+      product2a = product2a | (product2b << 16);
 #endif
 
-        *((uint32_t *) dP) = product1a;
-        *((uint32_t *) (dP + dstPitch)) = product2a;
-        *xP = color5;
+      *((uint32_t *) dP) = product1a;
+      *((uint32_t *) (dP + dstPitch)) = product2a;
+      *xP = color5;
 
-        bP += inc_bP;
-        xP += inc_bP;
-        dP += sizeof (uint32_t);
-      }                 // end of for ( finish= width etc..)
+      bP += inc_bP;
+      xP += inc_bP;
+      dP += sizeof (uint32_t);
+    }                 // end of for ( finish= width etc..)
 
-      srcPtr += srcPitch;
-      dstPtr += dstPitch << 1;
-      deltaPtr += srcPitch;
-    }                   // endof: for (height; height; height--)
-  }
+    srcPtr += srcPitch;
+    dstPtr += dstPitch << 1;
+    deltaPtr += srcPitch;
+  }                   // endof: for (height; height; height--)
 }
 
 void SuperEagle32 (uint8_t *srcPtr, uint32_t srcPitch, uint8_t *deltaPtr,
@@ -650,7 +630,19 @@ void SuperEagle32 (uint8_t *srcPtr, uint32_t srcPitch, uint8_t *deltaPtr,
     bP = (uint32_t *) srcPtr;
     xP = (uint32_t *) deltaPtr;
     dP = (uint32_t *)dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat32 (bP, bP + Nextline, width);
     for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // 5, 6, 2 and 3 are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        *(dP) = *(dP + 1) = *bP;
+        *(dP + (dstPitch >> 2)) = *(dP + (dstPitch >> 2) + 1) = *bP;
+        *xP = *bP;
+        xP += inc_bP;
+        bP += inc_bP;
+        dP += 2;
+        continue;
+      }
+
       uint32_t color4, color5, color6;
       uint32_t color1, color2, color3;
       uint32_t colorA1, colorA2, colorB1, colorB2, colorS1, colorS2;
@@ -769,171 +761,171 @@ void _2xSaI (uint8_t *srcPtr, uint32_t srcPitch, uint8_t *deltaPtr,
   uint16_t *bP;
   uint32_t inc_bP;
 
-#ifdef MMX
-  if (cpu_mmx) {
-    for (; height; height -= 1) {
-      _2xSaILine (srcPtr, deltaPtr, srcPitch, width, dstPtr, dstPitch);
-      srcPtr += srcPitch;
-      dstPtr += dstPitch * 2;
-      deltaPtr += srcPitch;
-    }
-  } else
-#endif
-  {
-    inc_bP = 1;
-
-    uint32_t Nextline = srcPitch >> 1;
-
-    for (; height; height--) {
-      bP = (uint16_t *) srcPtr;
-      dP = dstPtr;
-
-      for (uint32_t finish = width; finish; finish -= inc_bP) {
-
-        uint32_t colorA, colorB;
-        uint32_t colorC, colorD,
-          colorE, colorF, colorG, colorH,
-          colorI, colorJ, colorK, colorL,
-
-          colorM, colorN, colorO, colorP;
-        uint32_t product, product1, product2;
-
-        //---------------------------------------
-        // Map of the pixels:                    I|E F|J
-        //                                       G|A B|K
-        //                                       H|C D|L
-        //                                       M|N O|P
-        colorI = *(bP - Nextline - 1);
-        colorE = *(bP - Nextline);
-        colorF = *(bP - Nextline + 1);
-        colorJ = *(bP - Nextline + 2);
-
-        colorG = *(bP - 1);
-        colorA = *(bP);
-        colorB = *(bP + 1);
-        colorK = *(bP + 2);
-
-        colorH = *(bP + Nextline - 1);
-        colorC = *(bP + Nextline);
-        colorD = *(bP + Nextline + 1);
-        colorL = *(bP + Nextline + 2);
-
-        colorM = *(bP + Nextline + Nextline - 1);
-        colorN = *(bP + Nextline + Nextline);
-        colorO = *(bP + Nextline + Nextline + 1);
-        colorP = *(bP + Nextline + Nextline + 2);
-
-        if ((colorA == colorD) && (colorB != colorC)) {
-          if (((colorA == colorE) && (colorB == colorL)) ||
-              ((colorA == colorC) && (colorA == colorF)
-               && (colorB != colorE) && (colorB == colorJ))) {
-            product = colorA;
-          } else {
-            product = INTERPOLATE (colorA, colorB);
-          }
+  inc_bP = 1;
 
-          if (((colorA == colorG) && (colorC == colorO)) ||
-              ((colorA == colorB) && (colorA == colorH)
-               && (colorG != colorC) && (colorC == colorM))) {
-            product1 = colorA;
-          } else {
-            product1 = INTERPOLATE (colorA, colorC);
-          }
+  uint32_t Nextline = srcPitch >> 1;
+
+  for (; height; height--) {
+    bP = (uint16_t *) srcPtr;
+    dP = dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat16 (bP, bP + Nextline, width);
+
+    for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // A, B, C and D are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        uint32_t color = *bP;
+
+        color |= color << 16;
+        *((uint32_t *) dP) = color;
+        *((uint32_t *) (dP + dstPitch)) = color;
+        bP += inc_bP;
+        dP += sizeof (uint32_t);
+        continue;
+      }
+
+      uint32_t colorA, colorB;
+      uint32_t colorC, colorD,
+        colorE, colorF, colorG, colorH,
+        colorI, colorJ, colorK, colorL,
+
+        colorM, colorN, colorO, colorP;
+      uint32_t product, product1, product2;
+
+      //---------------------------------------
+      // Map of the pixels:                    I|E F|J
+      //                                       G|A B|K
+      //                                       H|C D|L
+      //                                       M|N O|P
+      colorI = *(bP - Nextline - 1);
+      colorE = *(bP - Nextline);
+      colorF = *(bP - Nextline + 1);
+      colorJ = *(bP - Nextline + 2);
+
+      colorG = *(bP - 1);
+      colorA = *(bP);
+      colorB = *(bP + 1);
+      colorK = *(bP + 2);
+
+      colorH = *(bP + Nextline - 1);
+      colorC = *(bP + Nextline);
+      colorD = *(bP + Nextline + 1);
+      colorL = *(bP + Nextline + 2);
+
+      colorM = *(bP + Nextline + Nextline - 1);
+      colorN = *(bP + Nextline + Nextline);
+      colorO = *(bP + Nextline + Nextline + 1);
+      colorP = *(bP + Nextline + Nextline + 2);
+
+      if ((colorA == colorD) && (colorB != colorC)) {
+        if (((colorA == colorE) && (colorB == colorL)) ||
+            ((colorA == colorC) && (colorA == colorF)
+             && (colorB != colorE) && (colorB == colorJ))) {
+          product = colorA;
+        } else {
+          product = INTERPOLATE (colorA, colorB);
+        }
+
+        if (((colorA == colorG) && (colorC == colorO)) ||
+            ((colorA == colorB) && (colorA == colorH)
+             && (colorG != colorC) && (colorC == colorM))) {
+          product1 = colorA;
+        } else {
+          product1 = INTERPOLATE (colorA, colorC);
+        }
+        product2 = colorA;
+      } else if ((colorB == colorC) && (colorA != colorD)) {
+        if (((colorB == colorF) && (colorA == colorH)) ||
+            ((colorB == colorE) && (colorB == colorD)
+             && (colorA != colorF) && (colorA == colorI))) {
+          product = colorB;
+        } else {
+          product = INTERPOLATE (colorA, colorB);
+        }
+
+        if (((colorC == colorH) && (colorA == colorF)) ||
+            ((colorC == colorG) && (colorC == colorD)
+             && (colorA != colorH) && (colorA == colorI))) {
+          product1 = colorC;
+        } else {
+          product1 = INTERPOLATE (colorA, colorC);
+        }
+        product2 = colorB;
+      } else if ((colorA == colorD) && (colorB == colorC)) {
+        if (colorA == colorB) {
+          product = colorA;
+          product1 = colorA;
           product2 = colorA;
-        } else if ((colorB == colorC) && (colorA != colorD)) {
-          if (((colorB == colorF) && (colorA == colorH)) ||
-              ((colorB == colorE) && (colorB == colorD)
-               && (colorA != colorF) && (colorA == colorI))) {
-            product = colorB;
-          } else {
-            product = INTERPOLATE (colorA, colorB);
-          }
+        } else {
+          int r = 0;
 
-          if (((colorC == colorH) && (colorA == colorF)) ||
-              ((colorC == colorG) && (colorC == colorD)
-               && (colorA != colorH) && (colorA == colorI))) {
-            product1 = colorC;
-          } else {
-            product1 = INTERPOLATE (colorA, colorC);
-          }
-          product2 = colorB;
-        } else if ((colorA == colorD) && (colorB == colorC)) {
-          if (colorA == colorB) {
-            product = colorA;
-            product1 = colorA;
+          product1 = INTERPOLATE (colorA, colorC);
+          product = INTERPOLATE (colorA, colorB);
+
+          r +=
+            GetResult1 (colorA, colorB, colorG, colorE,
+                        colorI);
+          r +=
+            GetResult2 (colorB, colorA, colorK, colorF,
+                        colorJ);
+          r +=
+            GetResult2 (colorB, colorA, colorH, colorN,
+                        colorM);
+          r +=
+            GetResult1 (colorA, colorB, colorL, colorO,
+                        colorP);
+
+          if (r > 0)
             product2 = colorA;
-          } else {
-            int r = 0;
-
-            product1 = INTERPOLATE (colorA, colorC);
-            product = INTERPOLATE (colorA, colorB);
-
-            r +=
-              GetResult1 (colorA, colorB, colorG, colorE,
-                          colorI);
-            r +=
-              GetResult2 (colorB, colorA, colorK, colorF,
-                          colorJ);
-            r +=
-              GetResult2 (colorB, colorA, colorH, colorN,
-                          colorM);
-            r +=
-              GetResult1 (colorA, colorB, colorL, colorO,
-                          colorP);
-
-            if (r > 0)
-              product2 = colorA;
-            else if (r < 0)
-              product2 = colorB;
-            else {
-              product2 =
-                Q_INTERPOLATE (colorA, colorB, colorC,
-                               colorD);
-            }
+          else if (r < 0)
+            product2 = colorB;
+          else {
+            product2 =
+              Q_INTERPOLATE (colorA, colorB, colorC,
+                             colorD);
           }
+        }
+      } else {
+        product2 = Q_INTERPOLATE (colorA, colorB, colorC, colorD);
+
+        if ((colorA == colorC) && (colorA == colorF)
+            && (colorB != colorE) && (colorB == colorJ)) {
+          product = colorA;
+        } else if ((colorB == colorE) && (colorB == colorD)
+                   && (colorA != colorF) && (colorA == colorI)) {
+          product = colorB;
         } else {
-          product2 = Q_INTERPOLATE (colorA, colorB, colorC, colorD);
-
-          if ((colorA == colorC) && (colorA == colorF)
-              && (colorB != colorE) && (colorB == colorJ)) {
-            product = colorA;
-          } else if ((colorB == colorE) && (colorB == colorD)
-                     && (colorA != colorF) && (colorA == colorI)) {
-            product = colorB;
-          } else {
-            product = INTERPOLATE (colorA, colorB);
-          }
+          product = INTERPOLATE (colorA, colorB);
+        }
 
-          if ((colorA == colorB) && (colorA == colorH)
-              && (colorG != colorC) && (colorC == colorM)) {
-            product1 = colorA;
-          } else if ((colorC == colorG) && (colorC == colorD)
-                     && (colorA != colorH) && (colorA == colorI)) {
-            product1 = colorC;
-          } else {
-            product1 = INTERPOLATE (colorA, colorC);
-          }
+        if ((colorA == colorB) && (colorA == colorH)
+            && (colorG != colorC) && (colorC == colorM)) {
+          product1 = colorA;
+        } else if ((colorC == colorG) && (colorC == colorD)
+                   && (colorA != colorH) && (colorA == colorI)) {
+          product1 = colorC;
+        } else {
+          product1 = INTERPOLATE (colorA, colorC);
         }
+      }
 
 #ifdef WORDS_BIGENDIAN
-        product = (colorA << 16) | product ;
-        product1 = (product1 << 16) | product2 ;
+      product = (colorA << 16) | product ;
+      product1 = (product1 << 16) | product2 ;
 #else
-        product = colorA | (product << 16);
-        product1 = product1 | (product2 << 16);
+      product = colorA | (product << 16);
+      product1 = product1 | (product2 << 16);
 #endif
-        *((int32_t *) dP) = product;
-        *((uint32_t *) (dP + dstPitch)) = product1;
+      *((int32_t *) dP) = product;
+      *((uint32_t *) (dP + dstPitch)) = product1;
 
-        bP += inc_bP;
-        dP += sizeof (uint32_t);
-      }                 // end of for ( finish= width etc..)
+      bP += inc_bP;
+      dP += sizeof (uint32_t);
+    }                 // end of for ( finish= width etc..)
 
-      srcPtr += srcPitch;
-      dstPtr += dstPitch << 1;
-      deltaPtr += srcPitch;
-    }                   // endof: for (height; height; height--)
-  }
+    srcPtr += srcPitch;
+    dstPtr += dstPitch << 1;
+    deltaPtr += srcPitch;
+  }                   // endof: for (height; height; height--)
 }
 
 void _2xSaI32 (uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */,
@@ -948,8 +940,18 @@ void _2xSaI32 (uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */,
   for (; height; height--) {
     bP = (uint32_t *) srcPtr;
     dP = (uint32_t *) dstPtr;
+    const uint8_t *flat = filters::internal::ComputeFlat32 (bP, bP + Nextline, width);
 
     for (uint32_t finish = width; finish; finish -= inc_bP) {
+      // A, B, C and D are one colour, which all the cases below repeat
+      if (flat[width - finish]) {
+        *(dP) = *(dP + 1) = *bP;
+        *(dP + (dstPitch >> 2)) = *(dP + (dstPitch >> 2) + 1) = *bP;
+        bP += inc_bP;
+        dP += 2;
+        continue;
+      }
+
       uint32_t colorA, colorB;
       uint32_t colorC, colorD,
         colorE, colorF, colorG, colorH,
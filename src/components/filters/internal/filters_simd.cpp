@@ -0,0 +1,785 @@
+#include "components/filters/internal/filters_simd.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "core/base/cpu_features.h"
+
+#if defined(VBAM_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace filters {
+namespace internal {
+
+namespace {
+
+// Every key row has one replicated pixel on each side, and enough zero
+// padding at the end for the vector kernels to run over whole vectors.
+constexpr int kRowPadding = 16;
+
+struct Workspace {
+    std::vector<uint32_t> keys[3];
+    std::vector<uint32_t> patterns;
+    std::vector<uint8_t> flat;
+
+    // Returns the first pixel of each key row.
+    void Prepare(int count, uint32_t* rows[3]) {
+        const size_t size = count + 2 + kRowPadding;
+        for (int i = 0; i < 3; i++) {
+            if (keys[i].size() < size)
+                keys[i].resize(size);
+            rows[i] = keys[i].data() + 1;
+        }
+        if (patterns.size() < (size_t)(count + kRowPadding))
+            patterns.resize(count + kRowPadding);
+    }
+};
+
+thread_local Workspace workspace;
+
+void PadRow(uint32_t* row, int count) {
+    row[-1] = row[0];
+    row[count] = row[count - 1];
+}
+
+struct Kernels {
+    void (*keys16)(PatternMetric metric, bool rgb555, const uint16_t* src, int count, uint32_t* keys);
+    void (*keys32)(PatternMetric metric, const uint32_t* src, int count, uint32_t* keys);
+    // Computes at least `count` patterns; the key rows must be padded.
+    void (*patterns)(PatternMetric metric,
+                     const uint32_t* above,
+                     const uint32_t* row,
+                     const uint32_t* below,
+                     int count,
+                     uint32_t* out);
+    void (*scale2x16)(uint16_t* dst,
+                      const uint16_t* src0,
+                      const uint16_t* src1,
+                      const uint16_t* src2,
+                      unsigned count);
+    void (*scale2x32)(uint32_t* dst,
+                      const uint32_t* src0,
+                      const uint32_t* src1,
+                      const uint32_t* src2,
+                      unsigned count);
+    void (*flat16)(const uint16_t* row, const uint16_t* below, int count, uint8_t* out);
+    void (*flat32)(const uint32_t* row, const uint32_t* below, int count, uint8_t* out);
+};
+
+/***************************************************************************/
+/* Scalar */
+
+void Keys16Scalar(PatternMetric metric, bool rgb555, const uint16_t* src, int count, uint32_t* keys) {
+    switch (metric) {
+        case PatternMetric::kHq2x:
+            for (int i = 0; i < count; i++)
+                keys[i] = Expand16(src[i], rgb555);
+            break;
+        case PatternMetric::kLq2x:
+            for (int i = 0; i < count; i++)
+                keys[i] = src[i];
+            break;
+        case PatternMetric::kHq3x:
+            for (int i = 0; i < count; i++)
+                keys[i] = HqYuv(Expand16(src[i], rgb555));
+            break;
+    }
+}
+
+void Keys32Scalar(PatternMetric metric, const uint32_t* src, int count, uint32_t* keys) {
+    switch (metric) {
+        case PatternMetric::kHq2x:
+            for (int i = 0; i < count; i++)
+                keys[i] = src[i] & 0xFFFFFF;
+            break;
+        case PatternMetric::kLq2x:
+            memcpy(keys, src, count * sizeof(uint32_t));
+            break;
+        case PatternMetric::kHq3x:
+            for (int i = 0; i < count; i++)
+                keys[i] = HqYuv(src[i]);
+            break;
+    }
+}
+
+struct Hq2xDiffScalar {
+    bool operator()(uint32_t a, uint32_t b) const { return Hq2xDiff(a, b); }
+};
+
+struct Lq2xDiffScalar {
+    bool operator()(uint32_t a, uint32_t b) const { return a != b; }
+};
+
+struct HqYuvDiffScalar {
+    bool operator()(uint32_t a, uint32_t b) const { return HqYuvDiff(a, b); }
+};
+
+template <typename Diff>
+void PatternRowScalar(const uint32_t* above,
+                      const uint32_t* row,
+                      const uint32_t* below,
+                      int begin,
+                      int end,
+                      uint32_t* out) {
+    for (int i = begin; i < end; i++)
+        out[i] = PatternScalar(above + i, row + i, below + i, Diff());
+}
+
+void PatternRowScalar(PatternMetric metric,
+                      const uint32_t* above,
+                      const uint32_t* row,
+                      const uint32_t* below,
+                      int begin,
+                      int end,
+                      uint32_t* out) {
+    switch (metric) {
+        case PatternMetric::kHq2x:
+            PatternRowScalar<Hq2xDiffScalar>(above, row, below, begin, end, out);
+            break;
+        case PatternMetric::kLq2x:
+            PatternRowScalar<Lq2xDiffScalar>(above, row, below, begin, end, out);
+            break;
+        case PatternMetric::kHq3x:
+            PatternRowScalar<HqYuvDiffScalar>(above, row, below, begin, end, out);
+            break;
+    }
+}
+
+void PatternsScalar(PatternMetric metric,
+                    const uint32_t* above,
+                    const uint32_t* row,
+                    const uint32_t* below,
+                    int count,
+                    uint32_t* out) {
+    PatternRowScalar(metric, above, row, below, 0, count, out);
+}
+
+template <typename T>
+void Scale2xScalar(T* dst, const T* src0, const T* src1, const T* src2, unsigned count) {
+    Scale2xEdgesScalar(dst, src0, src1, src2, count);
+    Scale2xCentralScalar(dst, src0, src1, src2, 1, count - 1);
+}
+
+template <typename T>
+void FlatRowScalar(const T* row, const T* below, int count, uint8_t* out) {
+    FlatScalar(row, below, 0, count, out);
+}
+
+const Kernels kScalarKernels = {Keys16Scalar,
+                                Keys32Scalar,
+                                PatternsScalar,
+                                Scale2xScalar<uint16_t>,
+                                Scale2xScalar<uint32_t>,
+                                FlatRowScalar<uint16_t>,
+                                FlatRowScalar<uint32_t>};
+
+#if defined(VBAM_SIMD_X86)
+
+/***************************************************************************/
+/* SSE2, 4 pixels per step (8 for 16-bit Scale2x) */
+
+VBAM_TARGET_SSE2 inline __m128i Yuv128(__m128i rgb) {
+    const __m128i ff = _mm_set1_epi32(0xFF);
+    const __m128i b = _mm_and_si128(rgb, ff);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(rgb, 8), ff);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(rgb, 16), ff);
+    const __m128i y = _mm_slli_epi32(_mm_add_epi32(_mm_add_epi32(r, g), b), 14);
+    const __m128i u = _mm_slli_epi32(_mm_add_epi32(_mm_sub_epi32(r, b), _mm_set1_epi32(512)), 4);
+    const __m128i v = _mm_add_epi32(
+        _mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(g, g), r), b), 3),
+        _mm_set1_epi32(128));
+    return _mm_add_epi32(_mm_add_epi32(y, u), v);
+}
+
+VBAM_TARGET_SSE2 inline __m128i Expand128(__m128i p, bool rgb555) {
+    const __m128i b = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x1F)), 3);
+    if (rgb555) {
+        const __m128i g = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x3E0)), 6);
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x7C00)), 9);
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+    const __m128i g = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0x7E0)), 5);
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 8);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+VBAM_TARGET_SSE2 void Keys16Sse2(PatternMetric metric,
+                                 bool rgb555,
+                                 const uint16_t* src,
+                                 int count,
+                                 uint32_t* keys) {
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi16(p, zero);
+        __m128i hi = _mm_unpackhi_epi16(p, zero);
+        if (metric != PatternMetric::kLq2x) {
+            lo = Expand128(lo, rgb555);
+            hi = Expand128(hi, rgb555);
+        }
+        if (metric == PatternMetric::kHq3x) {
+            lo = Yuv128(lo);
+            hi = Yuv128(hi);
+        }
+        _mm_storeu_si128((__m128i*)(keys + i), lo);
+        _mm_storeu_si128((__m128i*)(keys + i + 4), hi);
+    }
+    Keys16Scalar(metric, rgb555, src + i, count - i, keys + i);
+}
+
+VBAM_TARGET_SSE2 void Keys32Sse2(PatternMetric metric, const uint32_t* src, int count, uint32_t* keys) {
+    if (metric == PatternMetric::kLq2x) {
+        memcpy(keys, src, count * sizeof(uint32_t));
+        return;
+    }
+    const __m128i rgb = _mm_set1_epi32(0xFFFFFF);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+        p = metric == PatternMetric::kHq3x ? Yuv128(p) : _mm_and_si128(p, rgb);
+        _mm_storeu_si128((__m128i*)(keys + i), p);
+    }
+    Keys32Scalar(metric, src + i, count - i, keys + i);
+}
+
+VBAM_TARGET_SSE2 inline __m128i OutOfRange128(__m128i x, int limit) {
+    return _mm_or_si128(_mm_cmpgt_epi32(x, _mm_set1_epi32(limit)),
+                        _mm_cmplt_epi32(x, _mm_set1_epi32(-limit)));
+}
+
+struct Hq2xDiffSse2 {
+    VBAM_TARGET_SSE2 __m128i operator()(__m128i a, __m128i b) const {
+        const __m128i ff = _mm_set1_epi32(0xFF);
+        const __m128i db = _mm_sub_epi32(_mm_and_si128(a, ff), _mm_and_si128(b, ff));
+        const __m128i dg = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(a, 8), ff),
+                                         _mm_and_si128(_mm_srli_epi32(b, 8), ff));
+        const __m128i dr = _mm_sub_epi32(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16));
+        const __m128i y = _mm_add_epi32(_mm_add_epi32(dr, dg), db);
+        const __m128i u = _mm_sub_epi32(dr, db);
+        const __m128i v = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(dg, dg), dr), db);
+        return _mm_or_si128(_mm_or_si128(OutOfRange128(y, 0xC0), OutOfRange128(u, 0x1C)),
+                            OutOfRange128(v, 0x30));
+    }
+};
+
+struct Lq2xDiffSse2 {
+    VBAM_TARGET_SSE2 __m128i operator()(__m128i a, __m128i b) const {
+        return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+    }
+};
+
+struct HqYuvDiffSse2 {
+    VBAM_TARGET_SSE2 static __m128i Field(__m128i a, __m128i b, int mask, int limit) {
+        const __m128i m = _mm_set1_epi32(mask);
+        const __m128i d = _mm_sub_epi32(_mm_and_si128(a, m), _mm_and_si128(b, m));
+        return _mm_cmpgt_epi32(_mm_and_si128(d, _mm_set1_epi32(0x7FFFFFFF)), _mm_set1_epi32(limit));
+    }
+    VBAM_TARGET_SSE2 __m128i operator()(__m128i a, __m128i b) const {
+        return _mm_or_si128(
+            _mm_or_si128(Field(a, b, 0x00FF0000, 0x00300000), Field(a, b, 0x0000FF00, 0x00000700)),
+            Field(a, b, 0x000000FF, 0x00000006));
+    }
+};
+
+template <typename Diff>
+VBAM_TARGET_SSE2 void PatternRowSse2(const uint32_t* above,
+                                     const uint32_t* row,
+                                     const uint32_t* below,
+                                     int count,
+                                     uint32_t* out) {
+    const Diff diff;
+#define LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define BIT(mask, bit) _mm_and_si128(mask, _mm_set1_epi32(bit))
+    for (int i = 0; i < count; i += 4) {
+        const __m128i n = LOAD(above + i);
+        const __m128i w = LOAD(row + i - 1);
+        const __m128i c = LOAD(row + i);
+        const __m128i e = LOAD(row + i + 1);
+        const __m128i s = LOAD(below + i);
+        __m128i pattern = BIT(diff(c, LOAD(above + i - 1)), kPatternNW);
+        pattern = _mm_or_si128(pattern, BIT(diff(c, n), kPatternN));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, LOAD(above + i + 1)), kPatternNE));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, w), kPatternW));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, e), kPatternE));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, LOAD(below + i - 1)), kPatternSW));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, s), kPatternS));
+        pattern = _mm_or_si128(pattern, BIT(diff(c, LOAD(below + i + 1)), kPatternSE));
+        pattern = _mm_or_si128(pattern, BIT(diff(n, e), kPatternNToE));
+        pattern = _mm_or_si128(pattern, BIT(diff(e, s), kPatternEToS));
+        pattern = _mm_or_si128(pattern, BIT(diff(s, w), kPatternSToW));
+        pattern = _mm_or_si128(pattern, BIT(diff(w, n), kPatternWToN));
+        _mm_storeu_si128((__m128i*)(out + i), pattern);
+    }
+#undef LOAD
+#undef BIT
+}
+
+VBAM_TARGET_SSE2 void PatternsSse2(PatternMetric metric,
+                                   const uint32_t* above,
+                                   const uint32_t* row,
+                                   const uint32_t* below,
+                                   int count,
+                                   uint32_t* out) {
+    switch (metric) {
+        case PatternMetric::kHq2x:
+            PatternRowSse2<Hq2xDiffSse2>(above, row, below, count, out);
+            break;
+        case PatternMetric::kLq2x:
+            PatternRowSse2<Lq2xDiffSse2>(above, row, below, count, out);
+            break;
+        case PatternMetric::kHq3x:
+            PatternRowSse2<HqYuvDiffSse2>(above, row, below, count, out);
+            break;
+    }
+}
+
+VBAM_TARGET_SSE2 inline __m128i Select128(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+VBAM_TARGET_SSE2 void Scale2x16Sse2(uint16_t* dst,
+                                    const uint16_t* src0,
+                                    const uint16_t* src1,
+                                    const uint16_t* src2,
+                                    unsigned count) {
+    Scale2xEdgesScalar(dst, src0, src1, src2, count);
+    unsigned i = 1;
+    for (; i + 8 < count; i += 8) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(src0 + i));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(src2 + i));
+        const __m128i l = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+        const __m128i e = _mm_loadu_si128((const __m128i*)(src1 + i));
+        const __m128i r = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+        const __m128i cond = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(a, c), _mm_cmpeq_epi16(l, r)),
+                                              _mm_set1_epi16(-1));
+        const __m128i d0 = Select128(_mm_and_si128(cond, _mm_cmpeq_epi16(l, a)), a, e);
+        const __m128i d1 = Select128(_mm_and_si128(cond, _mm_cmpeq_epi16(r, a)), a, e);
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi16(d0, d1));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 8), _mm_unpackhi_epi16(d0, d1));
+    }
+    Scale2xCentralScalar(dst, src0, src1, src2, i, count - 1);
+}
+
+VBAM_TARGET_SSE2 void Scale2x32Sse2(uint32_t* dst,
+                                    const uint32_t* src0,
+                                    const uint32_t* src1,
+                                    const uint32_t* src2,
+                                    unsigned count) {
+    Scale2xEdgesScalar(dst, src0, src1, src2, count);
+    unsigned i = 1;
+    for (; i + 4 < count; i += 4) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(src0 + i));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(src2 + i));
+        const __m128i l = _mm_loadu_si128((const __m128i*)(src1 + i - 1));
+        const __m128i e = _mm_loadu_si128((const __m128i*)(src1 + i));
+        const __m128i r = _mm_loadu_si128((const __m128i*)(src1 + i + 1));
+        const __m128i cond = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(a, c), _mm_cmpeq_epi32(l, r)),
+                                              _mm_set1_epi32(-1));
+        const __m128i d0 = Select128(_mm_and_si128(cond, _mm_cmpeq_epi32(l, a)), a, e);
+        const __m128i d1 = Select128(_mm_and_si128(cond, _mm_cmpeq_epi32(r, a)), a, e);
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi32(d0, d1));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 4), _mm_unpackhi_epi32(d0, d1));
+    }
+    Scale2xCentralScalar(dst, src0, src1, src2, i, count - 1);
+}
+
+VBAM_TARGET_SSE2 void Flat16Sse2(const uint16_t* row, const uint16_t* below, int count, uint8_t* out) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(row + i));
+        const __m128i e = _mm_loadu_si128((const __m128i*)(row + i + 1));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(below + i));
+        const __m128i se = _mm_loadu_si128((const __m128i*)(below + i + 1));
+        const __m128i flat = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi16(c, e), _mm_cmpeq_epi16(c, s)),
+                                           _mm_cmpeq_epi16(c, se));
+        _mm_storel_epi64((__m128i*)(out + i), _mm_packs_epi16(flat, flat));
+    }
+    FlatScalar(row, below, i, count, out);
+}
+
+VBAM_TARGET_SSE2 void Flat32Sse2(const uint32_t* row, const uint32_t* below, int count, uint8_t* out) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(row + i));
+        const __m128i e = _mm_loadu_si128((const __m128i*)(row + i + 1));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(below + i));
+        const __m128i se = _mm_loadu_si128((const __m128i*)(below + i + 1));
+        __m128i flat = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(c, e), _mm_cmpeq_epi32(c, s)),
+                                     _mm_cmpeq_epi32(c, se));
+        flat = _mm_packs_epi32(flat, flat);
+        const int bytes = _mm_cvtsi128_si32(_mm_packs_epi16(flat, flat));
+        memcpy(out + i, &bytes, 4);
+    }
+    FlatScalar(row, below, i, count, out);
+}
+
+const Kernels kSse2Kernels = {Keys16Sse2,    Keys32Sse2, PatternsSse2, Scale2x16Sse2,
+                              Scale2x32Sse2, Flat16Sse2, Flat32Sse2};
+
+/***************************************************************************/
+/* AVX2, 8 pixels per step (16 for 16-bit Scale2x) */
+
+VBAM_TARGET_AVX2 inline __m256i Yuv256(__m256i rgb) {
+    const __m256i ff = _mm256_set1_epi32(0xFF);
+    const __m256i b = _mm256_and_si256(rgb, ff);
+    const __m256i g = _mm256_and_si256(_mm256_srli_epi32(rgb, 8), ff);
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(rgb, 16), ff);
+    const __m256i y = _mm256_slli_epi32(_mm256_add_epi32(_mm256_add_epi32(r, g), b), 14);
+    const __m256i u =
+        _mm256_slli_epi32(_mm256_add_epi32(_mm256_sub_epi32(r, b), _mm256_set1_epi32(512)), 4);
+    const __m256i v = _mm256_add_epi32(
+        _mm256_srai_epi32(_mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(g, g), r), b), 3),
+        _mm256_set1_epi32(128));
+    return _mm256_add_epi32(_mm256_add_epi32(y, u), v);
+}
+
+VBAM_TARGET_AVX2 inline __m256i Expand256(__m256i p, bool rgb555) {
+    const __m256i b = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x1F)), 3);
+    if (rgb555) {
+        const __m256i g = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x3E0)), 6);
+        const __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x7C00)), 9);
+        return _mm256_or_si256(_mm256_or_si256(r, g), b);
+    }
+    const __m256i g = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0x7E0)), 5);
+    const __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF800)), 8);
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+}
+
+VBAM_TARGET_AVX2 void Keys16Avx2(PatternMetric metric,
+                                 bool rgb555,
+                                 const uint16_t* src,
+                                 int count,
+                                 uint32_t* keys) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        if (metric != PatternMetric::kLq2x)
+            p = Expand256(p, rgb555);
+        if (metric == PatternMetric::kHq3x)
+            p = Yuv256(p);
+        _mm256_storeu_si256((__m256i*)(keys + i), p);
+    }
+    Keys16Scalar(metric, rgb555, src + i, count - i, keys + i);
+}
+
+VBAM_TARGET_AVX2 void Keys32Avx2(PatternMetric metric, const uint32_t* src, int count, uint32_t* keys) {
+    if (metric == PatternMetric::kLq2x) {
+        memcpy(keys, src, count * sizeof(uint32_t));
+        return;
+    }
+    const __m256i rgb = _mm256_set1_epi32(0xFFFFFF);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+        p = metric == PatternMetric::kHq3x ? Yuv256(p) : _mm256_and_si256(p, rgb);
+        _mm256_storeu_si256((__m256i*)(keys + i), p);
+    }
+    Keys32Scalar(metric, src + i, count - i, keys + i);
+}
+
+VBAM_TARGET_AVX2 inline __m256i OutOfRange256(__m256i x, int limit) {
+    return _mm256_or_si256(_mm256_cmpgt_epi32(x, _mm256_set1_epi32(limit)),
+                           _mm256_cmpgt_epi32(_mm256_set1_epi32(-limit), x));
+}
+
+struct Hq2xDiffAvx2 {
+    VBAM_TARGET_AVX2 __m256i operator()(__m256i a, __m256i b) const {
+        const __m256i ff = _mm256_set1_epi32(0xFF);
+        const __m256i db = _mm256_sub_epi32(_mm256_and_si256(a, ff), _mm256_and_si256(b, ff));
+        const __m256i dg = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 8), ff),
+                                            _mm256_and_si256(_mm256_srli_epi32(b, 8), ff));
+        const __m256i dr = _mm256_sub_epi32(_mm256_srli_epi32(a, 16), _mm256_srli_epi32(b, 16));
+        const __m256i y = _mm256_add_epi32(_mm256_add_epi32(dr, dg), db);
+        const __m256i u = _mm256_sub_epi32(dr, db);
+        const __m256i v = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(dg, dg), dr), db);
+        return _mm256_or_si256(_mm256_or_si256(OutOfRange256(y, 0xC0), OutOfRange256(u, 0x1C)),
+                               OutOfRange256(v, 0x30));
+    }
+};
+
+struct Lq2xDiffAvx2 {
+    VBAM_TARGET_AVX2 __m256i operator()(__m256i a, __m256i b) const {
+        return _mm256_xor_si256(_mm256_cmpeq_epi32(a, b), _mm256_set1_epi32(-1));
+    }
+};
+
+struct HqYuvDiffAvx2 {
+    VBAM_TARGET_AVX2 static __m256i Field(__m256i a, __m256i b, int mask, int limit) {
+        const __m256i m = _mm256_set1_epi32(mask);
+        const __m256i d = _mm256_sub_epi32(_mm256_and_si256(a, m), _mm256_and_si256(b, m));
+        return _mm256_cmpgt_epi32(_mm256_and_si256(d, _mm256_set1_epi32(0x7FFFFFFF)),
+                                  _mm256_set1_epi32(limit));
+    }
+    VBAM_TARGET_AVX2 __m256i operator()(__m256i a, __m256i b) const {
+        return _mm256_or_si256(_mm256_or_si256(Field(a, b, 0x00FF0000, 0x00300000),
+                                               Field(a, b, 0x0000FF00, 0x00000700)),
+                               Field(a, b, 0x000000FF, 0x00000006));
+    }
+};
+
+template <typename Diff>
+VBAM_TARGET_AVX2 void PatternRowAvx2(const uint32_t* above,
+                                     const uint32_t* row,
+                                     const uint32_t* below,
+                                     int count,
+                                     uint32_t* out) {
+    const Diff diff;
+#define LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define BIT(mask, bit) _mm256_and_si256(mask, _mm256_set1_epi32(bit))
+    for (int i = 0; i < count; i += 8) {
+        const __m256i n = LOAD(above + i);
+        const __m256i w = LOAD(row + i - 1);
+        const __m256i c = LOAD(row + i);
+        const __m256i e = LOAD(row + i + 1);
+        const __m256i s = LOAD(below + i);
+        __m256i pattern = BIT(diff(c, LOAD(above + i - 1)), kPatternNW);
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, n), kPatternN));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, LOAD(above + i + 1)), kPatternNE));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, w), kPatternW));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, e), kPatternE));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, LOAD(below + i - 1)), kPatternSW));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, s), kPatternS));
+        pattern = _mm256_or_si256(pattern, BIT(diff(c, LOAD(below + i + 1)), kPatternSE));
+        pattern = _mm256_or_si256(pattern, BIT(diff(n, e), kPatternNToE));
+        pattern = _mm256_or_si256(pattern, BIT(diff(e, s), kPatternEToS));
+        pattern = _mm256_or_si256(pattern, BIT(diff(s, w), kPatternSToW));
+        pattern = _mm256_or_si256(pattern, BIT(diff(w, n), kPatternWToN));
+        _mm256_storeu_si256((__m256i*)(out + i), pattern);
+    }
+#undef LOAD
+#undef BIT
+}
+
+VBAM_TARGET_AVX2 void PatternsAvx2(PatternMetric metric,
+                                   const uint32_t* above,
+                                   const uint32_t* row,
+                                   const uint32_t* below,
+                                   int count,
+                                   uint32_t* out) {
+    switch (metric) {
+        case PatternMetric::kHq2x:
+            PatternRowAvx2<Hq2xDiffAvx2>(above, row, below, count, out);
+            break;
+        case PatternMetric::kLq2x:
+            PatternRowAvx2<Lq2xDiffAvx2>(above, row, below, count, out);
+            break;
+        case PatternMetric::kHq3x:
+            PatternRowAvx2<HqYuvDiffAvx2>(above, row, below, count, out);
+            break;
+    }
+}
+
+VBAM_TARGET_AVX2 void Scale2x16Avx2(uint16_t* dst,
+                                    const uint16_t* src0,
+                                    const uint16_t* src1,
+                                    const uint16_t* src2,
+                                    unsigned count) {
+    Scale2xEdgesScalar(dst, src0, src1, src2, count);
+    unsigned i = 1;
+    for (; i + 16 < count; i += 16) {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(src0 + i));
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(src2 + i));
+        const __m256i l = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+        const __m256i e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+        const __m256i r = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+        const __m256i cond = _mm256_andnot_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi16(a, c), _mm256_cmpeq_epi16(l, r)), _mm256_set1_epi16(-1));
+        const __m256i d0 = _mm256_blendv_epi8(e, a, _mm256_and_si256(cond, _mm256_cmpeq_epi16(l, a)));
+        const __m256i d1 = _mm256_blendv_epi8(e, a, _mm256_and_si256(cond, _mm256_cmpeq_epi16(r, a)));
+        const __m256i lo = _mm256_unpacklo_epi16(d0, d1);
+        const __m256i hi = _mm256_unpackhi_epi16(d0, d1);
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    Scale2xCentralScalar(dst, src0, src1, src2, i, count - 1);
+}
+
+VBAM_TARGET_AVX2 void Scale2x32Avx2(uint32_t* dst,
+                                    const uint32_t* src0,
+                                    const uint32_t* src1,
+                                    const uint32_t* src2,
+                                    unsigned count) {
+    Scale2xEdgesScalar(dst, src0, src1, src2, count);
+    unsigned i = 1;
+    for (; i + 8 < count; i += 8) {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(src0 + i));
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(src2 + i));
+        const __m256i l = _mm256_loadu_si256((const __m256i*)(src1 + i - 1));
+        const __m256i e = _mm256_loadu_si256((const __m256i*)(src1 + i));
+        const __m256i r = _mm256_loadu_si256((const __m256i*)(src1 + i + 1));
+        const __m256i cond = _mm256_andnot_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi32(a, c), _mm256_cmpeq_epi32(l, r)), _mm256_set1_epi32(-1));
+        const __m256i d0 = _mm256_blendv_epi8(e, a, _mm256_and_si256(cond, _mm256_cmpeq_epi32(l, a)));
+        const __m256i d1 = _mm256_blendv_epi8(e, a, _mm256_and_si256(cond, _mm256_cmpeq_epi32(r, a)));
+        const __m256i lo = _mm256_unpacklo_epi32(d0, d1);
+        const __m256i hi = _mm256_unpackhi_epi32(d0, d1);
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    Scale2xCentralScalar(dst, src0, src1, src2, i, count - 1);
+}
+
+VBAM_TARGET_AVX2 void Flat16Avx2(const uint16_t* row, const uint16_t* below, int count, uint8_t* out) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(row + i));
+        const __m256i e = _mm256_loadu_si256((const __m256i*)(row + i + 1));
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(below + i));
+        const __m256i se = _mm256_loadu_si256((const __m256i*)(below + i + 1));
+        const __m256i flat = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpeq_epi16(c, e), _mm256_cmpeq_epi16(c, s)), _mm256_cmpeq_epi16(c, se));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi16(_mm256_castsi256_si128(flat),
+                                                              _mm256_extracti128_si256(flat, 1)));
+    }
+    FlatScalar(row, below, i, count, out);
+}
+
+VBAM_TARGET_AVX2 void Flat32Avx2(const uint32_t* row, const uint32_t* below, int count, uint8_t* out) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(row + i));
+        const __m256i e = _mm256_loadu_si256((const __m256i*)(row + i + 1));
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(below + i));
+        const __m256i se = _mm256_loadu_si256((const __m256i*)(below + i + 1));
+        const __m256i flat = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpeq_epi32(c, e), _mm256_cmpeq_epi32(c, s)), _mm256_cmpeq_epi32(c, se));
+        const __m128i words =
+            _mm_packs_epi32(_mm256_castsi256_si128(flat), _mm256_extracti128_si256(flat, 1));
+        _mm_storel_epi64((__m128i*)(out + i), _mm_packs_epi16(words, words));
+    }
+    FlatScalar(row, below, i, count, out);
+}
+
+const Kernels kAvx2Kernels = {Keys16Avx2,    Keys32Avx2, PatternsAvx2, Scale2x16Avx2,
+                              Scale2x32Avx2, Flat16Avx2, Flat32Avx2};
+
+#endif  // defined(VBAM_SIMD_X86)
+
+const Kernels* GetKernels(FilterImplementation impl) {
+    const CpuFeatures& cpu = GetCpuFeatures();
+    switch (impl) {
+        case FILTER_IMPL_SCALAR:
+            return &kScalarKernels;
+#if defined(VBAM_SIMD_X86)
+        case FILTER_IMPL_SSE2:
+            return cpu.sse2 ? &kSse2Kernels : nullptr;
+        case FILTER_IMPL_AVX2:
+            return cpu.avx2 ? &kAvx2Kernels : nullptr;
+#endif
+        default:
+            break;
+    }
+    (void)cpu;
+    return nullptr;
+}
+
+FilterImplementation BestImplementation() {
+    if (GetKernels(FILTER_IMPL_AVX2))
+        return FILTER_IMPL_AVX2;
+    if (GetKernels(FILTER_IMPL_SSE2))
+        return FILTER_IMPL_SSE2;
+    return FILTER_IMPL_SCALAR;
+}
+
+// Selected once at startup.
+std::atomic<FilterImplementation> implementation(BestImplementation());
+
+const Kernels& CurrentKernels() {
+    return *GetKernels(implementation.load(std::memory_order_relaxed));
+}
+
+const char* const kImplementationNames[FILTER_IMPL_COUNT] = {"scalar", "SSE2", "AVX2"};
+
+}  // namespace
+
+const uint32_t* ComputePatterns16(PatternMetric metric,
+                                  bool rgb555,
+                                  const uint16_t* above,
+                                  const uint16_t* row,
+                                  const uint16_t* below,
+                                  int count) {
+    const Kernels& kernels = CurrentKernels();
+    uint32_t* keys[3];
+    workspace.Prepare(count, keys);
+    const uint16_t* const src[3] = {above, row, below};
+    for (int i = 0; i < 3; i++) {
+        kernels.keys16(metric, rgb555, src[i], count, keys[i]);
+        PadRow(keys[i], count);
+    }
+    kernels.patterns(metric, keys[0], keys[1], keys[2], count, workspace.patterns.data());
+    return workspace.patterns.data();
+}
+
+const uint32_t* ComputePatterns32(PatternMetric metric,
+                                  const uint32_t* above,
+                                  const uint32_t* row,
+                                  const uint32_t* below,
+                                  int count) {
+    const Kernels& kernels = CurrentKernels();
+    uint32_t* keys[3];
+    workspace.Prepare(count, keys);
+    const uint32_t* const src[3] = {above, row, below};
+    for (int i = 0; i < 3; i++) {
+        kernels.keys32(metric, src[i], count, keys[i]);
+        PadRow(keys[i], count);
+    }
+    kernels.patterns(metric, keys[0], keys[1], keys[2], count, workspace.patterns.data());
+    return workspace.patterns.data();
+}
+
+void Scale2xRow16(uint16_t* dst,
+                  const uint16_t* src0,
+                  const uint16_t* src1,
+                  const uint16_t* src2,
+                  unsigned count) {
+    CurrentKernels().scale2x16(dst, src0, src1, src2, count);
+}
+
+void Scale2xRow32(uint32_t* dst,
+                  const uint32_t* src0,
+                  const uint32_t* src1,
+                  const uint32_t* src2,
+                  unsigned count) {
+    CurrentKernels().scale2x32(dst, src0, src1, src2, count);
+}
+
+const uint8_t* ComputeFlat16(const uint16_t* row, const uint16_t* below, int count) {
+    if (workspace.flat.size() < (size_t)count)
+        workspace.flat.resize(count);
+    CurrentKernels().flat16(row, below, count, workspace.flat.data());
+    return workspace.flat.data();
+}
+
+const uint8_t* ComputeFlat32(const uint32_t* row, const uint32_t* below, int count) {
+    if (workspace.flat.size() < (size_t)count)
+        workspace.flat.resize(count);
+    CurrentKernels().flat32(row, below, count, workspace.flat.data());
+    return workspace.flat.data();
+}
+
+}  // namespace internal
+}  // namespace filters
+
+bool FilterSetImplementation(FilterImplementation impl) {
+    if (!filters::internal::GetKernels(impl))
+        return false;
+    filters::internal::implementation.store(impl, std::memory_order_relaxed);
+    return true;
+}
+
+FilterImplementation FilterGetImplementation() {
+    return filters::internal::implementation.load(std::memory_order_relaxed);
+}
+
+bool FilterImplementationAvailable(FilterImplementation impl) {
+    return filters::internal::GetKernels(impl) != nullptr;
+}
+
+const char* FilterImplementationName(FilterImplementation impl) {
+    if (impl < 0 || impl >= FILTER_IMPL_COUNT)
+        return "unknown";
+    return filters::internal::kImplementationNames[impl];
+}
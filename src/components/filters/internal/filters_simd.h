@@ -0,0 +1,203 @@
+#ifndef VBAM_COMPONENTS_FILTERS_INTERNAL_FILTERS_SIMD_H_
+#define VBAM_COMPONENTS_FILTERS_INTERNAL_FILTERS_SIMD_H_
+
+// Vectorized building blocks shared by the pattern based scalers (hq2x,
+// lq2x, hq3x, hq4x), by AdMame2x and by the 2xSaI family.
+//
+// The pattern scalers look at the 3x3 neighbourhood of every source pixel
+// and pick an interpolation case from which neighbours "differ" from the
+// centre. Computing those differences dominates their run time, so it is
+// done here a whole row at a time: the rows are first converted to 32-bit
+// keys for the metric in use, then the differences of 4 (SSE2) or 8 (AVX2)
+// pixels are computed at once. The per-pixel interpolation stays scalar.
+
+#include <cstdint>
+
+#include "components/filters/filters.h"
+
+namespace filters {
+namespace internal {
+
+// Bits of a pixel pattern. The low 8 bits are set for every neighbour that
+// differs from the centre pixel, the next 4 for adjacent neighbour pairs
+// that differ from each other.
+enum : uint32_t {
+    kPatternNW = 1 << 0,
+    kPatternN = 1 << 1,
+    kPatternNE = 1 << 2,
+    kPatternW = 1 << 3,
+    kPatternE = 1 << 4,
+    kPatternSW = 1 << 5,
+    kPatternS = 1 << 6,
+    kPatternSE = 1 << 7,
+    kPatternNToE = 1 << 8,
+    kPatternEToS = 1 << 9,
+    kPatternSToW = 1 << 10,
+    kPatternWToN = 1 << 11,
+};
+
+enum class PatternMetric {
+    // hq2x: YUV thresholds on the RGB deltas.
+    kHq2x,
+    // Plain inequality.
+    kLq2x,
+    // hq3x and hq4x: thresholds on the packed YUV value of HqYuv().
+    kHq3x,
+};
+
+// Returns the patterns of the `count` pixels of `row`, given the rows above
+// and below. Pixels outside of the row are replaced by the nearest pixel of
+// the row. The returned buffer is owned by the calling thread and is valid
+// until its next call. `rgb555` selects the 16-bit pixel layout.
+const uint32_t* ComputePatterns16(PatternMetric metric,
+                                  bool rgb555,
+                                  const uint16_t* above,
+                                  const uint16_t* row,
+                                  const uint16_t* below,
+                                  int count);
+const uint32_t* ComputePatterns32(PatternMetric metric,
+                                  const uint32_t* above,
+                                  const uint32_t* row,
+                                  const uint32_t* below,
+                                  int count);
+
+// One output line of AdMame2x (Scale2x), `count` >= 2.
+void Scale2xRow16(uint16_t* dst,
+                  const uint16_t* src0,
+                  const uint16_t* src1,
+                  const uint16_t* src2,
+                  unsigned count);
+void Scale2xRow32(uint32_t* dst,
+                  const uint32_t* src0,
+                  const uint32_t* src1,
+                  const uint32_t* src2,
+                  unsigned count);
+
+// Flags the pixels of `row` that are equal to their right, lower and lower
+// right neighbours. The 2xSaI scalers only repeat such a pixel, which is most
+// of a typical frame, so they skip their per-pixel decisions for it. Reads
+// row[count] and below[count]. A flag is non-zero for a flat pixel. The
+// returned buffer is owned by the calling thread and is valid until its next
+// call.
+const uint8_t* ComputeFlat16(const uint16_t* row, const uint16_t* below, int count);
+const uint8_t* ComputeFlat32(const uint32_t* row, const uint32_t* below, int count);
+
+// Scalar reference code, also used by the vector kernels for row tails.
+
+// RGB565 or RGB555 to 0x00RRGGBB, widening the channels the way the 16-bit
+// hq2x and hq3x code always has.
+inline uint32_t Expand16(uint16_t p, bool rgb555) {
+    if (rgb555)
+        return ((p & 0x1F) << 3) | ((p & 0x3E0) << 6) | ((uint32_t)(p & 0x7C00) << 9);
+    return ((p & 0x1F) << 3) | ((p & 0x7E0) << 5) | ((uint32_t)(p & 0xF800) << 8);
+}
+
+// The packed YUV value of the hq3x/hq4x filters, from 0x00RRGGBB.
+inline uint32_t HqYuv(uint32_t rgb) {
+    const int b = rgb & 0xFF;
+    const int g = (rgb >> 8) & 0xFF;
+    const int r = (rgb >> 16) & 0xFF;
+    return (uint32_t)(((r + g + b) << 14) + ((r - b + 512) << 4) + ((2 * g - r - b) >> 3) + 128);
+}
+
+// The hq2x difference of two 0x00RRGGBB keys.
+inline bool Hq2xDiff(uint32_t a, uint32_t b) {
+    const int db = (int)(a & 0xFF) - (int)(b & 0xFF);
+    const int dg = (int)((a >> 8) & 0xFF) - (int)((b >> 8) & 0xFF);
+    const int dr = (int)((a >> 16) & 0xFF) - (int)((b >> 16) & 0xFF);
+    const int y = dr + dg + db;
+    const int u = dr - db;
+    const int v = -dr + 2 * dg - db;
+    return y < -0xC0 || y > 0xC0 || u < -0x1C || u > 0x1C || v < -0x30 || v > 0x30;
+}
+
+// The hq3x/hq4x difference of two HqYuv() keys. Note that it is not
+// symmetric: a field of `a` smaller than the same field of `b` always counts
+// as a difference.
+inline bool HqYuvDiff(uint32_t a, uint32_t b) {
+    return (((a & 0x00FF0000) - (b & 0x00FF0000)) & 0x7FFFFFFF) > 0x00300000 ||
+           (((a & 0x0000FF00) - (b & 0x0000FF00)) & 0x7FFFFFFF) > 0x00000700 ||
+           (((a & 0x000000FF) - (b & 0x000000FF)) & 0x7FFFFFFF) > 0x00000006;
+}
+
+template <typename Diff>
+inline uint32_t PatternScalar(const uint32_t* above,
+                              const uint32_t* row,
+                              const uint32_t* below,
+                              Diff diff) {
+    const uint32_t c = row[0];
+    uint32_t pattern = 0;
+    if (diff(c, above[-1]))
+        pattern |= kPatternNW;
+    if (diff(c, above[0]))
+        pattern |= kPatternN;
+    if (diff(c, above[1]))
+        pattern |= kPatternNE;
+    if (diff(c, row[-1]))
+        pattern |= kPatternW;
+    if (diff(c, row[1]))
+        pattern |= kPatternE;
+    if (diff(c, below[-1]))
+        pattern |= kPatternSW;
+    if (diff(c, below[0]))
+        pattern |= kPatternS;
+    if (diff(c, below[1]))
+        pattern |= kPatternSE;
+    if (diff(above[0], row[1]))
+        pattern |= kPatternNToE;
+    if (diff(row[1], below[0]))
+        pattern |= kPatternEToS;
+    if (diff(below[0], row[-1]))
+        pattern |= kPatternSToW;
+    if (diff(row[-1], above[0]))
+        pattern |= kPatternWToN;
+    return pattern;
+}
+
+// The central pixels [begin, end) of a Scale2x line.
+template <typename T>
+inline void Scale2xCentralScalar(T* dst,
+                                 const T* src0,
+                                 const T* src1,
+                                 const T* src2,
+                                 unsigned begin,
+                                 unsigned end) {
+    for (unsigned i = begin; i < end; i++) {
+        if (src0[i] != src2[i] && src1[i - 1] != src1[i + 1]) {
+            dst[2 * i] = src1[i - 1] == src0[i] ? src0[i] : src1[i];
+            dst[2 * i + 1] = src1[i + 1] == src0[i] ? src0[i] : src1[i];
+        } else {
+            dst[2 * i] = src1[i];
+            dst[2 * i + 1] = src1[i];
+        }
+    }
+}
+
+template <typename T>
+inline void Scale2xEdgesScalar(T* dst, const T* src0, const T* src1, const T* src2, unsigned count) {
+    /* first pixel */
+    dst[0] = src1[0];
+    if (src1[1] == src0[0] && src2[0] != src0[0])
+        dst[1] = src0[0];
+    else
+        dst[1] = src1[0];
+
+    /* last pixel */
+    const unsigned last = count - 1;
+    if (src1[last - 1] == src0[last] && src2[last] != src0[last])
+        dst[2 * last] = src0[last];
+    else
+        dst[2 * last] = src1[last];
+    dst[2 * last + 1] = src1[last];
+}
+
+template <typename T>
+inline void FlatScalar(const T* row, const T* below, int begin, int end, uint8_t* out) {
+    for (int i = begin; i < end; i++)
+        out[i] = row[i] == row[i + 1] && row[i] == below[i] && row[i] == below[i + 1];
+}
+
+}  // namespace internal
+}  // namespace filters
+
+#endif  // VBAM_COMPONENTS_FILTERS_INTERNAL_FILTERS_SIMD_H_
@@ -233,7 +233,7 @@ case 18:
 case 50: {
         PIXEL00_1M
 
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_1M
                 PIXEL12_C
@@ -257,7 +257,7 @@ case 81: {
         PIXEL10_1
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_1M
@@ -275,7 +275,7 @@ case 76: {
         PIXEL02_2
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_1M
                 PIXEL21_C
@@ -289,7 +289,7 @@ case 76: {
 }
 case 10:
 case 138: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
                 PIXEL01_C
                 PIXEL10_C
@@ -389,7 +389,7 @@ case 45: {
 case 22:
 case 54: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -413,7 +413,7 @@ case 209: {
         PIXEL10_1
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -431,7 +431,7 @@ case 108: {
         PIXEL02_2
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -445,7 +445,7 @@ case 108: {
 }
 case 11:
 case 139: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -464,7 +464,7 @@ case 139: {
 }
 case 19:
 case 51: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_1L
                 PIXEL01_C
                 PIXEL02_1M
@@ -484,7 +484,7 @@ case 51: {
 }
 case 146:
 case 178: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_1M
                 PIXEL12_C
@@ -504,7 +504,7 @@ case 178: {
 }
 case 84:
 case 85: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL02_1U
                 PIXEL12_C
                 PIXEL21_C
@@ -524,7 +524,7 @@ case 85: {
 }
 case 112:
 case 113: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL20_1L
                 PIXEL21_C
@@ -544,7 +544,7 @@ case 113: {
 }
 case 200:
 case 204: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_1M
                 PIXEL21_C
@@ -564,7 +564,7 @@ case 204: {
 }
 case 73:
 case 77: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_1U
                 PIXEL10_C
                 PIXEL20_1M
@@ -584,7 +584,7 @@ case 77: {
 }
 case 42:
 case 170: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
                 PIXEL01_C
                 PIXEL10_C
@@ -604,7 +604,7 @@ case 170: {
 }
 case 14:
 case 142: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
                 PIXEL01_C
                 PIXEL02_1R
@@ -720,7 +720,7 @@ case 25: {
 }
 case 26:
 case 31: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL10_C
         } else {
@@ -728,7 +728,7 @@ case 31: {
                 PIXEL10_3
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
                 PIXEL12_C
         } else {
@@ -744,7 +744,7 @@ case 31: {
 case 82:
 case 214: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
         } else {
@@ -755,7 +755,7 @@ case 214: {
         PIXEL11
         PIXEL12_C
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL21_C
                 PIXEL22_C
         } else {
@@ -770,7 +770,7 @@ case 248: {
         PIXEL01_1
         PIXEL02_1M
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
         } else {
@@ -778,7 +778,7 @@ case 248: {
                 PIXEL20_4
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL22_C
         } else {
@@ -789,7 +789,7 @@ case 248: {
 }
 case 74:
 case 107: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
         } else {
@@ -800,7 +800,7 @@ case 107: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
                 PIXEL21_C
         } else {
@@ -811,7 +811,7 @@ case 107: {
         break;
 }
 case 27: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -830,7 +830,7 @@ case 27: {
 }
 case 86: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -853,7 +853,7 @@ case 216: {
         PIXEL10_C
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -870,7 +870,7 @@ case 106: {
         PIXEL02_1M
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -884,7 +884,7 @@ case 106: {
 }
 case 30: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -907,7 +907,7 @@ case 210: {
         PIXEL10_1
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -924,7 +924,7 @@ case 120: {
         PIXEL02_1M
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -937,7 +937,7 @@ case 120: {
         break;
 }
 case 75: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1099,13 +1099,13 @@ case 153: {
         break;
 }
 case 58: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1121,7 +1121,7 @@ case 58: {
 case 83: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1131,7 +1131,7 @@ case 83: {
         PIXEL12_C
         PIXEL20_1M
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1145,13 +1145,13 @@ case 92: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1159,7 +1159,7 @@ case 92: {
         break;
 }
 case 202: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
@@ -1169,7 +1169,7 @@ case 202: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
@@ -1179,7 +1179,7 @@ case 202: {
         break;
 }
 case 78: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
@@ -1189,7 +1189,7 @@ case 78: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
@@ -1199,13 +1199,13 @@ case 78: {
         break;
 }
 case 154: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1221,7 +1221,7 @@ case 154: {
 case 114: {
         PIXEL00_1M
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1231,7 +1231,7 @@ case 114: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1245,13 +1245,13 @@ case 89: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1259,13 +1259,13 @@ case 89: {
         break;
 }
 case 90: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1273,13 +1273,13 @@ case 90: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1288,7 +1288,7 @@ case 90: {
 }
 case 55:
 case 23: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_1L
                 PIXEL01_C
                 PIXEL02_C
@@ -1308,7 +1308,7 @@ case 23: {
 }
 case 182:
 case 150: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1328,7 +1328,7 @@ case 150: {
 }
 case 213:
 case 212: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL02_1U
                 PIXEL12_C
                 PIXEL21_C
@@ -1348,7 +1348,7 @@ case 212: {
 }
 case 241:
 case 240: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL20_1L
                 PIXEL21_C
@@ -1368,7 +1368,7 @@ case 240: {
 }
 case 236:
 case 232: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1388,7 +1388,7 @@ case 232: {
 }
 case 109:
 case 105: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_1U
                 PIXEL10_C
                 PIXEL20_C
@@ -1408,7 +1408,7 @@ case 105: {
 }
 case 171:
 case 43: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1428,7 +1428,7 @@ case 43: {
 }
 case 143:
 case 15: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL02_1R
@@ -1452,7 +1452,7 @@ case 124: {
         PIXEL02_1U
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1465,7 +1465,7 @@ case 124: {
         break;
 }
 case 203: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1484,7 +1484,7 @@ case 203: {
 }
 case 62: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1507,7 +1507,7 @@ case 211: {
         PIXEL10_1
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -1520,7 +1520,7 @@ case 211: {
 }
 case 118: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1543,7 +1543,7 @@ case 217: {
         PIXEL10_C
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -1560,7 +1560,7 @@ case 110: {
         PIXEL02_1R
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1573,7 +1573,7 @@ case 110: {
         break;
 }
 case 155: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1692,12 +1692,12 @@ case 220: {
         PIXEL02_1U
         PIXEL10_C
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -1709,12 +1709,12 @@ case 220: {
         break;
 }
 case 158: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1731,7 +1731,7 @@ case 158: {
         break;
 }
 case 234: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
@@ -1740,7 +1740,7 @@ case 234: {
         PIXEL02_1M
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1755,7 +1755,7 @@ case 234: {
 case 242: {
         PIXEL00_1M
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1763,7 +1763,7 @@ case 242: {
         PIXEL10_1
         PIXEL11
         PIXEL20_1L
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -1775,7 +1775,7 @@ case 242: {
         break;
 }
 case 59: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1784,7 +1784,7 @@ case 59: {
                 PIXEL01_3
                 PIXEL10_3
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -1802,7 +1802,7 @@ case 121: {
         PIXEL02_1M
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1811,7 +1811,7 @@ case 121: {
                 PIXEL20_4
                 PIXEL21_3
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1820,7 +1820,7 @@ case 121: {
 }
 case 87: {
         PIXEL00_1L
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1833,7 +1833,7 @@ case 87: {
         PIXEL11
         PIXEL20_1M
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1841,7 +1841,7 @@ case 87: {
         break;
 }
 case 79: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1853,7 +1853,7 @@ case 79: {
         PIXEL02_1R
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
@@ -1863,20 +1863,20 @@ case 79: {
         break;
 }
 case 122: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
         }
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -1885,7 +1885,7 @@ case 122: {
                 PIXEL20_4
                 PIXEL21_3
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1893,12 +1893,12 @@ case 122: {
         break;
 }
 case 94: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -1909,13 +1909,13 @@ case 94: {
         }
         PIXEL10_C
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -1923,25 +1923,25 @@ case 94: {
         break;
 }
 case 218: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
         }
         PIXEL10_C
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -1953,7 +1953,7 @@ case 218: {
         break;
 }
 case 91: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -1962,20 +1962,20 @@ case 91: {
                 PIXEL01_3
                 PIXEL10_3
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
         }
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -2031,13 +2031,13 @@ case 181: {
         break;
 }
 case 186: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -2053,7 +2053,7 @@ case 186: {
 case 115: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -2063,7 +2063,7 @@ case 115: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -2077,13 +2077,13 @@ case 93: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -2091,7 +2091,7 @@ case 93: {
         break;
 }
 case 206: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
@@ -2101,7 +2101,7 @@ case 206: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
@@ -2118,7 +2118,7 @@ case 201: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_1M
         } else {
                 PIXEL20_2
@@ -2129,7 +2129,7 @@ case 201: {
 }
 case 174:
 case 46: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_1M
         } else {
                 PIXEL00_2
@@ -2148,7 +2148,7 @@ case 179:
 case 147: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_1M
         } else {
                 PIXEL02_2
@@ -2171,7 +2171,7 @@ case 116: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_1M
         } else {
                 PIXEL22_2
@@ -2204,7 +2204,7 @@ case 231: {
 }
 case 126: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -2214,7 +2214,7 @@ case 126: {
                 PIXEL12_3
         }
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -2227,7 +2227,7 @@ case 126: {
         break;
 }
 case 219: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -2239,7 +2239,7 @@ case 219: {
         PIXEL02_1M
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -2251,7 +2251,7 @@ case 219: {
         break;
 }
 case 125: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_1U
                 PIXEL10_C
                 PIXEL20_C
@@ -2270,7 +2270,7 @@ case 125: {
         break;
 }
 case 221: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL02_1U
                 PIXEL12_C
                 PIXEL21_C
@@ -2289,7 +2289,7 @@ case 221: {
         break;
 }
 case 207: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL02_1R
@@ -2308,7 +2308,7 @@ case 207: {
         break;
 }
 case 238: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -2327,7 +2327,7 @@ case 238: {
         break;
 }
 case 190: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -2346,7 +2346,7 @@ case 190: {
         break;
 }
 case 187: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -2365,7 +2365,7 @@ case 187: {
         break;
 }
 case 243: {
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL20_1L
                 PIXEL21_C
@@ -2384,7 +2384,7 @@ case 243: {
         break;
 }
 case 119: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_1L
                 PIXEL01_C
                 PIXEL02_C
@@ -2410,7 +2410,7 @@ case 233: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
@@ -2421,7 +2421,7 @@ case 233: {
 }
 case 175:
 case 47: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
@@ -2440,7 +2440,7 @@ case 183:
 case 151: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2463,7 +2463,7 @@ case 244: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
@@ -2475,7 +2475,7 @@ case 250: {
         PIXEL01_C
         PIXEL02_1M
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
         } else {
@@ -2483,7 +2483,7 @@ case 250: {
                 PIXEL20_4
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL22_C
         } else {
@@ -2493,7 +2493,7 @@ case 250: {
         break;
 }
 case 123: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
         } else {
@@ -2504,7 +2504,7 @@ case 123: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
                 PIXEL21_C
         } else {
@@ -2515,7 +2515,7 @@ case 123: {
         break;
 }
 case 95: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL10_C
         } else {
@@ -2523,7 +2523,7 @@ case 95: {
                 PIXEL10_3
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
                 PIXEL12_C
         } else {
@@ -2538,7 +2538,7 @@ case 95: {
 }
 case 222: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
         } else {
@@ -2549,7 +2549,7 @@ case 222: {
         PIXEL11
         PIXEL12_C
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL21_C
                 PIXEL22_C
         } else {
@@ -2564,7 +2564,7 @@ case 252: {
         PIXEL02_1U
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
         } else {
@@ -2572,7 +2572,7 @@ case 252: {
                 PIXEL20_4
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
@@ -2585,13 +2585,13 @@ case 249: {
         PIXEL02_1M
         PIXEL10_C
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL22_C
         } else {
@@ -2601,7 +2601,7 @@ case 249: {
         break;
 }
 case 235: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
         } else {
@@ -2612,7 +2612,7 @@ case 235: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
@@ -2622,7 +2622,7 @@ case 235: {
         break;
 }
 case 111: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
@@ -2632,7 +2632,7 @@ case 111: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
                 PIXEL21_C
         } else {
@@ -2643,13 +2643,13 @@ case 111: {
         break;
 }
 case 63: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
                 PIXEL12_C
         } else {
@@ -2664,7 +2664,7 @@ case 63: {
         break;
 }
 case 159: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL10_C
         } else {
@@ -2672,7 +2672,7 @@ case 159: {
                 PIXEL10_3
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2687,7 +2687,7 @@ case 159: {
 case 215: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2696,7 +2696,7 @@ case 215: {
         PIXEL11
         PIXEL12_C
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL21_C
                 PIXEL22_C
         } else {
@@ -2707,7 +2707,7 @@ case 215: {
 }
 case 246: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
         } else {
@@ -2719,7 +2719,7 @@ case 246: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
@@ -2728,7 +2728,7 @@ case 246: {
 }
 case 254: {
         PIXEL00_1M
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
         } else {
@@ -2736,14 +2736,14 @@ case 254: {
                 PIXEL02_4
         }
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
         } else {
                 PIXEL10_3
                 PIXEL20_4
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL21_C
                 PIXEL22_C
@@ -2761,13 +2761,13 @@ case 253: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
@@ -2775,7 +2775,7 @@ case 253: {
         break;
 }
 case 251: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
         } else {
@@ -2784,7 +2784,7 @@ case 251: {
         }
         PIXEL02_1M
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL10_C
                 PIXEL20_C
                 PIXEL21_C
@@ -2793,7 +2793,7 @@ case 251: {
                 PIXEL20_2
                 PIXEL21_3
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL12_C
                 PIXEL22_C
         } else {
@@ -2803,7 +2803,7 @@ case 251: {
         break;
 }
 case 239: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
@@ -2813,7 +2813,7 @@ case 239: {
         PIXEL10_C
         PIXEL11
         PIXEL12_1
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
@@ -2823,7 +2823,7 @@ case 239: {
         break;
 }
 case 127: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL01_C
                 PIXEL10_C
@@ -2832,7 +2832,7 @@ case 127: {
                 PIXEL01_3
                 PIXEL10_3
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
                 PIXEL12_C
         } else {
@@ -2840,7 +2840,7 @@ case 127: {
                 PIXEL12_3
         }
         PIXEL11
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
                 PIXEL21_C
         } else {
@@ -2851,13 +2851,13 @@ case 127: {
         break;
 }
 case 191: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2871,14 +2871,14 @@ case 191: {
         break;
 }
 case 223: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
                 PIXEL10_C
         } else {
                 PIXEL00_4
                 PIXEL10_3
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL01_C
                 PIXEL02_C
                 PIXEL12_C
@@ -2889,7 +2889,7 @@ case 223: {
         }
         PIXEL11
         PIXEL20_1M
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL21_C
                 PIXEL22_C
         } else {
@@ -2901,7 +2901,7 @@ case 223: {
 case 247: {
         PIXEL00_1L
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2911,7 +2911,7 @@ case 247: {
         PIXEL12_C
         PIXEL20_1L
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
@@ -2919,13 +2919,13 @@ case 247: {
         break;
 }
 case 255: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_C
         } else {
                 PIXEL00_2
         }
         PIXEL01_C
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_C
         } else {
                 PIXEL02_2
@@ -2933,13 +2933,13 @@ case 255: {
         PIXEL10_C
         PIXEL11
         PIXEL12_C
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_C
         } else {
                 PIXEL20_2
         }
         PIXEL21_C
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_C
         } else {
                 PIXEL22_2
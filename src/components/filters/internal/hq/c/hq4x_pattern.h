@@ -324,7 +324,7 @@ case 18:
 case 50: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -359,7 +359,7 @@ case 81: {
         PIXEL13_10
         PIXEL20_61
         PIXEL21_30
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -384,7 +384,7 @@ case 76: {
         PIXEL11_30
         PIXEL12_70
         PIXEL13_60
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -403,7 +403,7 @@ case 76: {
 }
 case 10:
 case 138: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -554,7 +554,7 @@ case 22:
 case 54: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -589,7 +589,7 @@ case 209: {
         PIXEL20_61
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -612,7 +612,7 @@ case 108: {
         PIXEL11_30
         PIXEL12_70
         PIXEL13_60
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -630,7 +630,7 @@ case 108: {
 }
 case 11:
 case 139: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -656,7 +656,7 @@ case 139: {
 }
 case 19:
 case 51: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_81
                 PIXEL01_31
                 PIXEL02_10
@@ -687,7 +687,7 @@ case 146:
 case 178: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -717,7 +717,7 @@ case 85: {
         PIXEL00_20
         PIXEL01_60
         PIXEL02_81
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL03_81
                 PIXEL13_31
                 PIXEL22_30
@@ -753,7 +753,7 @@ case 113: {
         PIXEL13_10
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL30_82
@@ -780,7 +780,7 @@ case 204: {
         PIXEL11_30
         PIXEL12_70
         PIXEL13_60
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -801,7 +801,7 @@ case 204: {
 }
 case 73:
 case 77: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_82
                 PIXEL10_32
                 PIXEL20_10
@@ -830,7 +830,7 @@ case 77: {
 }
 case 42:
 case 170: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -859,7 +859,7 @@ case 170: {
 }
 case 14:
 case 142: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL02_32
@@ -1040,7 +1040,7 @@ case 25: {
 }
 case 26:
 case 31: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -1049,7 +1049,7 @@ case 31: {
                 PIXEL01_50
                 PIXEL10_50
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -1074,7 +1074,7 @@ case 82:
 case 214: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -1089,7 +1089,7 @@ case 214: {
         PIXEL20_61
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -1112,7 +1112,7 @@ case 248: {
         PIXEL11_30
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -1123,7 +1123,7 @@ case 248: {
         }
         PIXEL21_0
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -1136,7 +1136,7 @@ case 248: {
 }
 case 74:
 case 107: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -1150,7 +1150,7 @@ case 107: {
         PIXEL11_0
         PIXEL12_30
         PIXEL13_61
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -1167,7 +1167,7 @@ case 107: {
         break;
 }
 case 27: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -1194,7 +1194,7 @@ case 27: {
 case 86: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -1228,7 +1228,7 @@ case 216: {
         PIXEL20_10
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -1250,7 +1250,7 @@ case 106: {
         PIXEL11_30
         PIXEL12_30
         PIXEL13_61
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -1269,7 +1269,7 @@ case 106: {
 case 30: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -1303,7 +1303,7 @@ case 210: {
         PIXEL20_61
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -1325,7 +1325,7 @@ case 120: {
         PIXEL11_30
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -1342,7 +1342,7 @@ case 120: {
         break;
 }
 case 75: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -1595,7 +1595,7 @@ case 153: {
         break;
 }
 case 58: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -1606,7 +1606,7 @@ case 58: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -1630,7 +1630,7 @@ case 58: {
 case 83: {
         PIXEL00_81
         PIXEL01_31
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -1645,7 +1645,7 @@ case 83: {
         PIXEL11_31
         PIXEL20_61
         PIXEL21_30
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -1669,7 +1669,7 @@ case 92: {
         PIXEL11_30
         PIXEL12_31
         PIXEL13_31
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -1680,7 +1680,7 @@ case 92: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -1694,7 +1694,7 @@ case 92: {
         break;
 }
 case 202: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -1709,7 +1709,7 @@ case 202: {
         PIXEL03_80
         PIXEL12_30
         PIXEL13_61
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -1727,7 +1727,7 @@ case 202: {
         break;
 }
 case 78: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -1742,7 +1742,7 @@ case 78: {
         PIXEL03_82
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -1760,7 +1760,7 @@ case 78: {
         break;
 }
 case 154: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -1771,7 +1771,7 @@ case 154: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -1795,7 +1795,7 @@ case 154: {
 case 114: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -1810,7 +1810,7 @@ case 114: {
         PIXEL11_30
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -1834,7 +1834,7 @@ case 89: {
         PIXEL11_32
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -1845,7 +1845,7 @@ case 89: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -1859,7 +1859,7 @@ case 89: {
         break;
 }
 case 90: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -1870,7 +1870,7 @@ case 90: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -1881,7 +1881,7 @@ case 90: {
                 PIXEL12_0
                 PIXEL13_12
         }
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -1892,7 +1892,7 @@ case 90: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -1907,7 +1907,7 @@ case 90: {
 }
 case 55:
 case 23: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_81
                 PIXEL01_31
                 PIXEL02_0
@@ -1938,7 +1938,7 @@ case 182:
 case 150: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL12_0
@@ -1968,7 +1968,7 @@ case 212: {
         PIXEL00_20
         PIXEL01_60
         PIXEL02_81
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL03_81
                 PIXEL13_31
                 PIXEL22_0
@@ -2004,7 +2004,7 @@ case 240: {
         PIXEL13_10
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_0
                 PIXEL23_0
                 PIXEL30_82
@@ -2031,7 +2031,7 @@ case 232: {
         PIXEL11_30
         PIXEL12_70
         PIXEL13_60
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL21_0
                 PIXEL30_0
@@ -2052,7 +2052,7 @@ case 232: {
 }
 case 109:
 case 105: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_82
                 PIXEL10_32
                 PIXEL20_0
@@ -2081,7 +2081,7 @@ case 105: {
 }
 case 171:
 case 43: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2110,7 +2110,7 @@ case 43: {
 }
 case 143:
 case 15: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL02_32
@@ -2146,7 +2146,7 @@ case 124: {
         PIXEL11_30
         PIXEL12_31
         PIXEL13_31
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -2163,7 +2163,7 @@ case 124: {
         break;
 }
 case 203: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2190,7 +2190,7 @@ case 203: {
 case 62: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -2224,7 +2224,7 @@ case 211: {
         PIXEL20_61
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -2240,7 +2240,7 @@ case 211: {
 case 118: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -2274,7 +2274,7 @@ case 217: {
         PIXEL20_10
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -2296,7 +2296,7 @@ case 110: {
         PIXEL11_30
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -2313,7 +2313,7 @@ case 110: {
         break;
 }
 case 155: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2498,7 +2498,7 @@ case 220: {
         PIXEL11_30
         PIXEL12_31
         PIXEL13_31
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -2510,7 +2510,7 @@ case 220: {
                 PIXEL31_11
         }
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -2522,7 +2522,7 @@ case 220: {
         break;
 }
 case 158: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -2533,7 +2533,7 @@ case 158: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -2554,7 +2554,7 @@ case 158: {
         break;
 }
 case 234: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -2569,7 +2569,7 @@ case 234: {
         PIXEL03_80
         PIXEL12_30
         PIXEL13_61
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -2588,7 +2588,7 @@ case 234: {
 case 242: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -2604,7 +2604,7 @@ case 242: {
         PIXEL20_82
         PIXEL21_32
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -2618,7 +2618,7 @@ case 242: {
         break;
 }
 case 59: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2627,7 +2627,7 @@ case 59: {
                 PIXEL01_50
                 PIXEL10_50
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -2658,7 +2658,7 @@ case 121: {
         PIXEL11_32
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -2668,7 +2668,7 @@ case 121: {
                 PIXEL31_50
         }
         PIXEL21_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -2684,7 +2684,7 @@ case 121: {
 case 87: {
         PIXEL00_81
         PIXEL01_31
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -2698,7 +2698,7 @@ case 87: {
         PIXEL12_0
         PIXEL20_61
         PIXEL21_30
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -2714,7 +2714,7 @@ case 87: {
         break;
 }
 case 79: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2728,7 +2728,7 @@ case 79: {
         PIXEL11_0
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -2746,7 +2746,7 @@ case 79: {
         break;
 }
 case 122: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -2757,7 +2757,7 @@ case 122: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -2768,7 +2768,7 @@ case 122: {
                 PIXEL12_0
                 PIXEL13_12
         }
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -2778,7 +2778,7 @@ case 122: {
                 PIXEL31_50
         }
         PIXEL21_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -2792,7 +2792,7 @@ case 122: {
         break;
 }
 case 94: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -2803,7 +2803,7 @@ case 94: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -2813,7 +2813,7 @@ case 94: {
                 PIXEL13_50
         }
         PIXEL12_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -2824,7 +2824,7 @@ case 94: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -2838,7 +2838,7 @@ case 94: {
         break;
 }
 case 218: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -2849,7 +2849,7 @@ case 218: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -2860,7 +2860,7 @@ case 218: {
                 PIXEL12_0
                 PIXEL13_12
         }
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -2872,7 +2872,7 @@ case 218: {
                 PIXEL31_11
         }
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -2884,7 +2884,7 @@ case 218: {
         break;
 }
 case 91: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -2893,7 +2893,7 @@ case 91: {
                 PIXEL01_50
                 PIXEL10_50
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -2905,7 +2905,7 @@ case 91: {
                 PIXEL13_12
         }
         PIXEL11_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -2916,7 +2916,7 @@ case 91: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -3006,7 +3006,7 @@ case 181: {
         break;
 }
 case 186: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -3017,7 +3017,7 @@ case 186: {
                 PIXEL10_11
                 PIXEL11_0
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -3041,7 +3041,7 @@ case 186: {
 case 115: {
         PIXEL00_81
         PIXEL01_31
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -3056,7 +3056,7 @@ case 115: {
         PIXEL11_31
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -3080,7 +3080,7 @@ case 93: {
         PIXEL11_32
         PIXEL12_31
         PIXEL13_31
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -3091,7 +3091,7 @@ case 93: {
                 PIXEL30_20
                 PIXEL31_11
         }
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -3105,7 +3105,7 @@ case 93: {
         break;
 }
 case 206: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -3120,7 +3120,7 @@ case 206: {
         PIXEL03_82
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -3147,7 +3147,7 @@ case 201: {
         PIXEL11_32
         PIXEL12_70
         PIXEL13_60
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_10
                 PIXEL21_30
                 PIXEL30_80
@@ -3166,7 +3166,7 @@ case 201: {
 }
 case 174:
 case 46: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_80
                 PIXEL01_10
                 PIXEL10_10
@@ -3195,7 +3195,7 @@ case 179:
 case 147: {
         PIXEL00_81
         PIXEL01_31
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_10
                 PIXEL03_80
                 PIXEL12_30
@@ -3230,7 +3230,7 @@ case 116: {
         PIXEL13_31
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_30
                 PIXEL23_10
                 PIXEL32_10
@@ -3286,7 +3286,7 @@ case 231: {
 case 126: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -3298,7 +3298,7 @@ case 126: {
         PIXEL10_10
         PIXEL11_30
         PIXEL12_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -3315,7 +3315,7 @@ case 126: {
         break;
 }
 case 219: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3332,7 +3332,7 @@ case 219: {
         PIXEL20_10
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -3346,7 +3346,7 @@ case 219: {
         break;
 }
 case 125: {
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL00_82
                 PIXEL10_32
                 PIXEL20_0
@@ -3377,7 +3377,7 @@ case 221: {
         PIXEL00_82
         PIXEL01_82
         PIXEL02_81
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL03_81
                 PIXEL13_31
                 PIXEL22_0
@@ -3402,7 +3402,7 @@ case 221: {
         break;
 }
 case 207: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL02_32
@@ -3438,7 +3438,7 @@ case 238: {
         PIXEL11_30
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL21_0
                 PIXEL30_0
@@ -3460,7 +3460,7 @@ case 238: {
 case 190: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL12_0
@@ -3486,7 +3486,7 @@ case 190: {
         break;
 }
 case 187: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3524,7 +3524,7 @@ case 243: {
         PIXEL13_10
         PIXEL20_82
         PIXEL21_32
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL22_0
                 PIXEL23_0
                 PIXEL30_82
@@ -3542,7 +3542,7 @@ case 243: {
         break;
 }
 case 119: {
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL00_81
                 PIXEL01_31
                 PIXEL02_0
@@ -3583,7 +3583,7 @@ case 233: {
         PIXEL21_0
         PIXEL22_31
         PIXEL23_81
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
@@ -3595,7 +3595,7 @@ case 233: {
 }
 case 175:
 case 47: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
@@ -3622,7 +3622,7 @@ case 151: {
         PIXEL00_81
         PIXEL01_31
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -3658,7 +3658,7 @@ case 244: {
         PIXEL30_82
         PIXEL31_32
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -3674,7 +3674,7 @@ case 250: {
         PIXEL11_30
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -3685,7 +3685,7 @@ case 250: {
         }
         PIXEL21_0
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -3697,7 +3697,7 @@ case 250: {
         break;
 }
 case 123: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3711,7 +3711,7 @@ case 123: {
         PIXEL11_0
         PIXEL12_30
         PIXEL13_10
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -3728,7 +3728,7 @@ case 123: {
         break;
 }
 case 95: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3737,7 +3737,7 @@ case 95: {
                 PIXEL01_50
                 PIXEL10_50
         }
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -3761,7 +3761,7 @@ case 95: {
 case 222: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -3776,7 +3776,7 @@ case 222: {
         PIXEL20_10
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -3798,7 +3798,7 @@ case 252: {
         PIXEL11_30
         PIXEL12_31
         PIXEL13_31
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -3811,7 +3811,7 @@ case 252: {
         PIXEL22_0
         PIXEL23_0
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -3830,7 +3830,7 @@ case 249: {
         PIXEL20_0
         PIXEL21_0
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -3839,7 +3839,7 @@ case 249: {
                 PIXEL32_50
                 PIXEL33_50
         }
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
@@ -3848,7 +3848,7 @@ case 249: {
         break;
 }
 case 235: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3866,7 +3866,7 @@ case 235: {
         PIXEL21_0
         PIXEL22_31
         PIXEL23_81
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
@@ -3877,7 +3877,7 @@ case 235: {
         break;
 }
 case 111: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
@@ -3889,7 +3889,7 @@ case 111: {
         PIXEL11_0
         PIXEL12_32
         PIXEL13_82
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -3906,13 +3906,13 @@ case 111: {
         break;
 }
 case 63: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
         }
         PIXEL01_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -3935,7 +3935,7 @@ case 63: {
         break;
 }
 case 159: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -3945,7 +3945,7 @@ case 159: {
                 PIXEL10_50
         }
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -3967,7 +3967,7 @@ case 215: {
         PIXEL00_81
         PIXEL01_31
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -3979,7 +3979,7 @@ case 215: {
         PIXEL20_61
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -3995,7 +3995,7 @@ case 215: {
 case 246: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -4014,7 +4014,7 @@ case 246: {
         PIXEL30_82
         PIXEL31_32
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -4024,7 +4024,7 @@ case 246: {
 case 254: {
         PIXEL00_80
         PIXEL01_10
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -4036,7 +4036,7 @@ case 254: {
         PIXEL10_10
         PIXEL11_30
         PIXEL12_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -4049,7 +4049,7 @@ case 254: {
         PIXEL22_0
         PIXEL23_0
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -4069,14 +4069,14 @@ case 253: {
         PIXEL21_0
         PIXEL22_0
         PIXEL23_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
         }
         PIXEL31_0
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -4084,7 +4084,7 @@ case 253: {
         break;
 }
 case 251: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -4101,7 +4101,7 @@ case 251: {
         PIXEL20_0
         PIXEL21_0
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -4110,7 +4110,7 @@ case 251: {
                 PIXEL32_50
                 PIXEL33_50
         }
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
@@ -4119,7 +4119,7 @@ case 251: {
         break;
 }
 case 239: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
@@ -4135,7 +4135,7 @@ case 239: {
         PIXEL21_0
         PIXEL22_31
         PIXEL23_81
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
@@ -4146,13 +4146,13 @@ case 239: {
         break;
 }
 case 127: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
         }
         PIXEL01_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL02_0
                 PIXEL03_0
                 PIXEL13_0
@@ -4164,7 +4164,7 @@ case 127: {
         PIXEL10_0
         PIXEL11_0
         PIXEL12_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL20_0
                 PIXEL30_0
                 PIXEL31_0
@@ -4181,14 +4181,14 @@ case 127: {
         break;
 }
 case 191: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
         }
         PIXEL01_0
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -4208,7 +4208,7 @@ case 191: {
         break;
 }
 case 223: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
                 PIXEL01_0
                 PIXEL10_0
@@ -4218,7 +4218,7 @@ case 223: {
                 PIXEL10_50
         }
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -4229,7 +4229,7 @@ case 223: {
         PIXEL20_10
         PIXEL21_30
         PIXEL22_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL23_0
                 PIXEL32_0
                 PIXEL33_0
@@ -4246,7 +4246,7 @@ case 247: {
         PIXEL00_81
         PIXEL01_31
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -4262,7 +4262,7 @@ case 247: {
         PIXEL30_82
         PIXEL31_32
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
@@ -4270,14 +4270,14 @@ case 247: {
         break;
 }
 case 255: {
-        if (Diff(yuv[4], yuv[2])) {
+        if (MUL) {
                 PIXEL00_0
         } else {
                 PIXEL00_20
         }
         PIXEL01_0
         PIXEL02_0
-        if (Diff(yuv[2], yuv[6])) {
+        if (MUR) {
                 PIXEL03_0
         } else {
                 PIXEL03_20
@@ -4290,14 +4290,14 @@ case 255: {
         PIXEL21_0
         PIXEL22_0
         PIXEL23_0
-        if (Diff(yuv[8], yuv[4])) {
+        if (MDL) {
                 PIXEL30_0
         } else {
                 PIXEL30_20
         }
         PIXEL31_0
         PIXEL32_0
-        if (Diff(yuv[6], yuv[8])) {
+        if (MDR) {
                 PIXEL33_0
         } else {
                 PIXEL33_20
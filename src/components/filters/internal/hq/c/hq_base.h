@@ -30,7 +30,6 @@
 #ifdef _16BIT
 #define SIZE_PIXEL 2 // 16bit = 2 bytes
 #define COLORTYPE unsigned short
-#define RGBtoYUV RGBtoYUV_16
 #define Interp1 Interp1_16
 #define Interp2 Interp2_16
 #define Interp3 Interp3_16
@@ -44,7 +43,6 @@
 #ifdef _32BIT
 #define SIZE_PIXEL 4 // 32bit = 4 bytes
 #define COLORTYPE unsigned int
-#define RGBtoYUV RGBtoYUV_32
 #define Interp1 Interp1_32
 #define Interp2 Interp2_32
 #define Interp3 Interp3_32
@@ -334,6 +332,12 @@
 
 #endif // #ifdef _HQ4X
 
+// differences between adjacent neighbours, from the row patterns
+#define MUR (patterns[x] & filters::internal::kPatternNToE)
+#define MDR (patterns[x] & filters::internal::kPatternEToS)
+#define MDL (patterns[x] & filters::internal::kPatternSToW)
+#define MUL (patterns[x] & filters::internal::kPatternWToN)
+
 // function header
 #ifdef _16BIT
 #ifdef _HQ3X
@@ -358,8 +362,6 @@ unsigned char *,
 unsigned char *pOut, unsigned int dstPitch,
 int Xres, int Yres )
 {
-        unsigned int yuv[10] = { 0 }; // yuv[0] not used
-        // yuv[1-9] allows reusage of calculated YUV values
         int x, y;
         unsigned int linePlus, lineMinus;
 
@@ -387,6 +389,25 @@ int Xres, int Yres )
                         lineMinus = srcPitch;
                 }
 
+                // The differences between neighbours are computed a whole row
+                // at a time, see filters_simd.h.
+                const COLORTYPE *row = (const COLORTYPE *)pIn;
+                const COLORTYPE *above = (const COLORTYPE *)(pIn - lineMinus);
+                const COLORTYPE *below = (const COLORTYPE *)(pIn + linePlus);
+#ifdef _16BIT
+#ifdef RGB555
+                const unsigned int *patterns = filters::internal::ComputePatterns16(
+                    filters::internal::PatternMetric::kHq3x, true, above, row, below, Xres);
+#else
+                const unsigned int *patterns = filters::internal::ComputePatterns16(
+                    filters::internal::PatternMetric::kHq3x, false, above, row, below, Xres);
+#endif
+#endif
+#ifdef _32BIT
+                const unsigned int *patterns = filters::internal::ComputePatterns32(
+                    filters::internal::PatternMetric::kHq3x, above, row, below, Xres);
+#endif
+
                 for (x = 0; x < Xres; x++) {
                         c[2] = *((COLORTYPE *)(pIn - lineMinus));
                         c[5] = *((COLORTYPE *)(pIn));
@@ -420,31 +441,7 @@ int Xres, int Yres )
                                 c[9] = c[8];
                         }
 
-                        unsigned int pattern = 0;
-                        unsigned int flag = 1;
-
-                        yuv[5] = RGBtoYUV(c[5]);
-
-                        for (unsigned char k = 1; k <= 9; k++) {
-                                if (k == 5)
-                                        continue;
-
-                                if (c[k] != c[5]) {
-                                        // pre-calculating the YUV-values for every pixel does
-                                        // not speed up the process
-                                        yuv[k] = RGBtoYUV(c[k]);
-
-                                        if ((abs_32((yuv[5] & 0x00FF0000) - (yuv[k] & 0x00FF0000)) >
-                                             0x00300000) ||
-                                            (abs_32((yuv[5] & 0x0000FF00) - (yuv[k] & 0x0000FF00)) >
-                                             0x00000700) ||
-                                            (abs_32((yuv[5] & 0x000000FF) - (yuv[k] & 0x000000FF)) >
-                                             0x00000006)) {
-                                                pattern |= flag;
-                                        }
-                                }
-                                flag <<= 1;
-                        }
+                        const unsigned int pattern = patterns[x] & 0xFF;
 
 #ifdef _HQ3X
 #include "hq3x_pattern.h"
@@ -481,7 +478,10 @@ void hq4x32_32(unsigned char *pIn,  unsigned int srcPitch, unsigned char *, unsi
 #undef SIZE_PIXEL
 #undef COLORTYPE
 #undef _MAGNIFICATION
-#undef RGBtoYUV
+#undef MUR
+#undef MDR
+#undef MDL
+#undef MUL
 #undef Interp1
 #undef Interp2
 #undef Interp3
@@ -23,6 +23,7 @@
 
 
 #include "hq_shared.h"
+#include "components/filters/internal/filters_simd.h"
 
 
 #define _16BIT
@@ -52,19 +52,6 @@
 #define RBSHIFT4MASK 0x000F81F0
 #endif
 
-// we only need the 32bit version because our YUV format has 32bits
-#define abs_32(value) ((value)&0x7FFFFFFF)
-
-inline bool Diff(unsigned int YUV1, unsigned int YUV2)
-{
-        if (YUV1 == YUV2)
-                return false; // Save some processing power
-
-        return (abs_32((YUV1 & 0x00FF0000) - (YUV2 & 0x00FF0000)) > 0x00300000) ||
-               (abs_32((YUV1 & 0x0000FF00) - (YUV2 & 0x0000FF00)) > 0x00000700) ||
-               (abs_32((YUV1 & 0x000000FF) - (YUV2 & 0x000000FF)) > 0x00000006);
-}
-
 // ===============
 // 32bit routines:
 // ===============
@@ -146,29 +133,6 @@ inline bool Diff(unsigned int YUV1, unsigned int YUV2)
                                (((((c1)&0xFF00FF) * 5) + (((c2)&0xFF00FF) * 3)) & 0x07F807F8)) >>  \
                                   3)
 
-// 32 bit input color
-// 0x00YYUUVV return value
-inline unsigned int RGBtoYUV_32(unsigned int c)
-{
-        // Division through 3 slows down the emulation about 10% !!!
-
-        unsigned char r, g, b;
-        b = c & 0x0000FF;
-        g = (c & 0x00FF00) >> 8;
-        r = (unsigned char)(c >> 16);
-        return ((r + g + b) << 14) + ((r - b + 512) << 4) + ((2 * g - r - b) >> 3) + 128;
-
-        // unoptimized:
-        // unsigned char r, g, b, Y, u, v;
-        // b = (c & 0x000000FF);
-        // g = (c & 0x0000FF00) >> 8;
-        // r = (c & 0x00FF0000) >> 16;
-        // Y = (r + g + b) >> 2;
-        // u = 128 + ((r - b) >> 2);
-        // v = 128 + ((-r + 2*g -b)>>3);
-        // return (Y<<16) + (u<<8) + v;
-}
-
 // ===============
 // 16bit routines:
 // ===============
@@ -247,23 +211,3 @@ inline unsigned int RGBtoYUV_32(unsigned int c)
                             : ((((((c1)&GMASK) * 5) + (((c2)&GMASK) * 3)) & GSHIFT3MASK) +         \
                                (((((c1)&RBMASK) * 5) + (((c2)&RBMASK) * 3)) & RBSHIFT3MASK)) >>    \
                                   3)
-
-// 16 bit input color
-// 0x00YYUUVV return value
-inline unsigned int RGBtoYUV_16(unsigned short c)
-{
-        // Division through 3 slows down the emulation about 10% !!!
-
-        unsigned char r, g, b;
-#ifdef RGB555
-        r = (c & 0x7C00) >> 7;
-        g = (c & 0x03E0) >> 2;
-        b = (c & 0x001F) << 3;
-#else
-        r = (unsigned char)((c & 0xF800) >> 8);
-        g = (unsigned char)((c & 0x07E0) >> 3);
-        b = (unsigned char)((c & 0x001F) << 3);
-#endif
-
-        return ((r + g + b) << 14) + ((r - b + 512) << 4) + ((2 * g - r - b) >> 3) + 128;
-}
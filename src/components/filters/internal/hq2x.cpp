@@ -28,8 +28,11 @@
  * do so, delete this exception statement from your version.
  */
 
+#include "components/filters/internal/filters_simd.h"
 #include "interp.h"
 
+using filters::internal::PatternMetric;
+
 /***************************************************************************/
 /* HQ2x C implementation */
 
@@ -40,6 +43,8 @@
 static void hq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, const uint16_t* src1, const uint16_t* src2, unsigned count)
 {
   unsigned i;
+  const uint32_t* patterns = filters::internal::ComputePatterns16(
+      PatternMetric::kHq2x, interp_bits_per_pixel != 16, src0, src1, src2, count);
 
   for(i=0;i<count;++i) {
     unsigned char mask;
@@ -70,33 +75,16 @@ static void hq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, co
       c[8] = c[7];
     }
 
-    mask = 0;
-
-    if (interp_16_diff(c[0], c[4]))
-      mask |= 1 << 0;
-    if (interp_16_diff(c[1], c[4]))
-      mask |= 1 << 1;
-    if (interp_16_diff(c[2], c[4]))
-      mask |= 1 << 2;
-    if (interp_16_diff(c[3], c[4]))
-      mask |= 1 << 3;
-    if (interp_16_diff(c[5], c[4]))
-      mask |= 1 << 4;
-    if (interp_16_diff(c[6], c[4]))
-      mask |= 1 << 5;
-    if (interp_16_diff(c[7], c[4]))
-      mask |= 1 << 6;
-    if (interp_16_diff(c[8], c[4]))
-      mask |= 1 << 7;
+    mask = patterns[i] & 0xff;
 
 #define P0 dst0[0]
 #define P1 dst0[1]
 #define P2 dst1[0]
 #define P3 dst1[1]
-#define MUR interp_16_diff(c[1], c[5])
-#define MDR interp_16_diff(c[5], c[7])
-#define MDL interp_16_diff(c[7], c[3])
-#define MUL interp_16_diff(c[3], c[1])
+#define MUR (patterns[i] & filters::internal::kPatternNToE)
+#define MDR (patterns[i] & filters::internal::kPatternEToS)
+#define MDL (patterns[i] & filters::internal::kPatternSToW)
+#define MUL (patterns[i] & filters::internal::kPatternWToN)
 #define IC(p0) c[p0]
 #define I11(p0,p1) interp_16_11(c[p0], c[p1])
 #define I211(p0,p1,p2) interp_16_211(c[p0], c[p1], c[p2])
@@ -150,6 +138,8 @@ static void hq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, co
 static void hq2x_32_def(uint32_t* dst0, uint32_t* dst1, const uint32_t* src0, const uint32_t* src1, const uint32_t* src2, unsigned count)
 {
   unsigned i;
+  const uint32_t* patterns =
+      filters::internal::ComputePatterns32(PatternMetric::kHq2x, src0, src1, src2, count);
 
   for(i=0;i<count;++i) {
     unsigned char mask;
@@ -180,33 +170,16 @@ static void hq2x_32_def(uint32_t* dst0, uint32_t* dst1, const uint32_t* src0, co
       c[8] = c[7];
     }
 
-    mask = 0;
-
-    if (interp_32_diff(c[0], c[4]))
-      mask |= 1 << 0;
-    if (interp_32_diff(c[1], c[4]))
-      mask |= 1 << 1;
-    if (interp_32_diff(c[2], c[4]))
-      mask |= 1 << 2;
-    if (interp_32_diff(c[3], c[4]))
-      mask |= 1 << 3;
-    if (interp_32_diff(c[5], c[4]))
-      mask |= 1 << 4;
-    if (interp_32_diff(c[6], c[4]))
-      mask |= 1 << 5;
-    if (interp_32_diff(c[7], c[4]))
-      mask |= 1 << 6;
-    if (interp_32_diff(c[8], c[4]))
-      mask |= 1 << 7;
+    mask = patterns[i] & 0xff;
 
 #define P0 dst0[0]
 #define P1 dst0[1]
 #define P2 dst1[0]
 #define P3 dst1[1]
-#define MUR interp_32_diff(c[1], c[5])
-#define MDR interp_32_diff(c[5], c[7])
-#define MDL interp_32_diff(c[7], c[3])
-#define MUL interp_32_diff(c[3], c[1])
+#define MUR (patterns[i] & filters::internal::kPatternNToE)
+#define MDR (patterns[i] & filters::internal::kPatternEToS)
+#define MDL (patterns[i] & filters::internal::kPatternSToW)
+#define MUL (patterns[i] & filters::internal::kPatternWToN)
 #define IC(p0) c[p0]
 #define I11(p0,p1) interp_32_11(c[p0], c[p1])
 #define I211(p0,p1,p2) interp_32_211(c[p0], c[p1], c[p2])
@@ -267,6 +240,8 @@ static void hq2x_32_def(uint32_t* dst0, uint32_t* dst1, const uint32_t* src0, co
 static void lq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, const uint16_t* src1, const uint16_t* src2, unsigned count)
 {
   unsigned i;
+  const uint32_t* patterns = filters::internal::ComputePatterns16(
+      PatternMetric::kLq2x, interp_bits_per_pixel != 16, src0, src1, src2, count);
 
   for(i=0;i<count;++i) {
     unsigned char mask;
@@ -297,33 +272,16 @@ static void lq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, co
       c[8] = c[7];
     }
 
-    mask = 0;
-
-    if (c[0] != c[4])
-      mask |= 1 << 0;
-    if (c[1] != c[4])
-      mask |= 1 << 1;
-    if (c[2] != c[4])
-      mask |= 1 << 2;
-    if (c[3] != c[4])
-      mask |= 1 << 3;
-    if (c[5] != c[4])
-      mask |= 1 << 4;
-    if (c[6] != c[4])
-      mask |= 1 << 5;
-    if (c[7] != c[4])
-      mask |= 1 << 6;
-    if (c[8] != c[4])
-      mask |= 1 << 7;
+    mask = patterns[i] & 0xff;
 
 #define P0 dst0[0]
 #define P1 dst0[1]
 #define P2 dst1[0]
 #define P3 dst1[1]
-#define MUR (c[1] != c[5])
-#define MDR (c[5] != c[7])
-#define MDL (c[7] != c[3])
-#define MUL (c[3] != c[1])
+#define MUR (patterns[i] & filters::internal::kPatternNToE)
+#define MDR (patterns[i] & filters::internal::kPatternEToS)
+#define MDL (patterns[i] & filters::internal::kPatternSToW)
+#define MUL (patterns[i] & filters::internal::kPatternWToN)
 #define IC(p0) c[p0]
 #define I11(p0,p1) interp_16_11(c[p0], c[p1])
 #define I211(p0,p1,p2) interp_16_211(c[p0], c[p1], c[p2])
@@ -377,6 +335,8 @@ static void lq2x_16_def(uint16_t* dst0, uint16_t* dst1, const uint16_t* src0, co
 static void lq2x_32_def(uint32_t* dst0, uint32_t* dst1, const uint32_t* src0, const uint32_t* src1, const uint32_t* src2, unsigned count)
 {
   unsigned i;
+  const uint32_t* patterns =
+      filters::internal::ComputePatterns32(PatternMetric::kLq2x, src0, src1, src2, count);
 
   for(i=0;i<count;++i) {
     unsigned char mask;
@@ -407,33 +367,16 @@ static void lq2x_32_def(uint32_t* dst0, uint32_t* dst1, const uint32_t* src0, co
       c[8] = c[7];
     }
 
-    mask = 0;
-
-    if (c[0] != c[4])
-      mask |= 1 << 0;
-    if (c[1] != c[4])
-      mask |= 1 << 1;
-    if (c[2] != c[4])
-      mask |= 1 << 2;
-    if (c[3] != c[4])
-      mask |= 1 << 3;
-    if (c[5] != c[4])
-      mask |= 1 << 4;
-    if (c[6] != c[4])
-      mask |= 1 << 5;
-    if (c[7] != c[4])
-      mask |= 1 << 6;
-    if (c[8] != c[4])
-      mask |= 1 << 7;
+    mask = patterns[i] & 0xff;
 
 #define P0 dst0[0]
 #define P1 dst0[1]
 #define P2 dst1[0]
 #define P3 dst1[1]
-#define MUR (c[1] != c[5])
-#define MDR (c[5] != c[7])
-#define MDL (c[7] != c[3])
-#define MUL (c[3] != c[1])
+#define MUR (patterns[i] & filters::internal::kPatternNToE)
+#define MDR (patterns[i] & filters::internal::kPatternEToS)
+#define MDL (patterns[i] & filters::internal::kPatternSToW)
+#define MUL (patterns[i] & filters::internal::kPatternWToN)
 #define IC(p0) c[p0]
 #define I11(p0,p1) interp_32_11(c[p0], c[p1])
 #define I211(p0,p1,p2) interp_32_211(c[p0], c[p1], c[p2])
@@ -251,75 +251,6 @@ static inline uint32_t interp_32_97(uint32_t p1, uint32_t p2)
                INTERP_32_MASK_2((INTERP_32_MASK_2(p1) * 9 + INTERP_32_MASK_2(p2) * 7) / 16);
 }
 
-/***************************************************************************/
-/* diff */
-
-#define INTERP_Y_LIMIT (0x30 * 4)
-#define INTERP_U_LIMIT (0x07 * 4)
-#define INTERP_V_LIMIT (0x06 * 8)
-
-static int interp_16_diff(uint16_t p1, uint16_t p2)
-{
-        int r, g, b;
-        int y, u, v;
-
-        if (p1 == p2)
-                return 0;
-
-        if (interp_bits_per_pixel == 16) {
-                b = (int)((p1 & 0x1F) - (p2 & 0x1F)) << 3;
-                g = (int)((p1 & 0x7E0) - (p2 & 0x7E0)) >> 3;
-                r = (int)((p1 & 0xF800) - (p2 & 0xF800)) >> 8;
-        } else {
-                b = (int)((p1 & 0x1F) - (p2 & 0x1F)) << 3;
-                g = (int)((p1 & 0x3E0) - (p2 & 0x3E0)) >> 2;
-                r = (int)((p1 & 0x7C00) - (p2 & 0x7C00)) >> 7;
-        }
-
-        y = r + g + b;
-        u = r - b;
-        v = -r + 2 * g - b;
-
-        if (y < -INTERP_Y_LIMIT || y > INTERP_Y_LIMIT)
-                return 1;
-
-        if (u < -INTERP_U_LIMIT || u > INTERP_U_LIMIT)
-                return 1;
-
-        if (v < -INTERP_V_LIMIT || v > INTERP_V_LIMIT)
-                return 1;
-
-        return 0;
-}
-
-static int interp_32_diff(uint32_t p1, uint32_t p2)
-{
-        int r, g, b;
-        int y, u, v;
-
-        if ((p1 & 0xF8F8F8) == (p2 & 0xF8F8F8))
-                return 0;
-
-        b = (int)((p1 & 0xFF) - (p2 & 0xFF));
-        g = (int)((p1 & 0xFF00) - (p2 & 0xFF00)) >> 8;
-        r = (int)((p1 & 0xFF0000) - (p2 & 0xFF0000)) >> 16;
-
-        y = r + g + b;
-        u = r - b;
-        v = -r + 2 * g - b;
-
-        if (y < -INTERP_Y_LIMIT || y > INTERP_Y_LIMIT)
-                return 1;
-
-        if (u < -INTERP_U_LIMIT || u > INTERP_U_LIMIT)
-                return 1;
-
-        if (v < -INTERP_V_LIMIT || v > INTERP_V_LIMIT)
-                return 1;
-
-        return 0;
-}
-
 static void interp_set(unsigned bits_per_pixel)
 {
         interp_bits_per_pixel = bits_per_pixel;
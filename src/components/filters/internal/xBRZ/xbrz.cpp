@@ -1095,6 +1095,145 @@ struct ColorGradientARGB
         pixBack = gradientARGB<M, N>(pixFront, pixBack);
     }
 };
+
+//------------------------------------------------------------------------------------
+//two-pass processing: see preProcessBlendInfo() and scaleFromBlendInfo()
+
+inline
+Kernel_4x4 readKernel4x4(const uint32_t* src, int srcWidth, int srcHeight, int srcPitch, int x, int y)
+{
+    const uint32_t* s_m1 = src + srcPitch * std::max(y - 1, 0);
+    const uint32_t* s_0  = src + srcPitch * y; //center line
+    const uint32_t* s_p1 = src + srcPitch * std::min(y + 1, srcHeight - 1);
+    const uint32_t* s_p2 = src + srcPitch * std::min(y + 2, srcHeight - 1);
+
+    const int x_m1 = std::max(x - 1, 0);
+    const int x_p1 = std::min(x + 1, srcWidth - 1);
+    const int x_p2 = std::min(x + 2, srcWidth - 1);
+
+    Kernel_4x4 ker = {};
+    ker.a = s_m1[x_m1];
+    ker.b = s_m1[x];
+    ker.c = s_m1[x_p1];
+    ker.d = s_m1[x_p2];
+
+    ker.e = s_0[x_m1];
+    ker.f = s_0[x];
+    ker.g = s_0[x_p1];
+    ker.h = s_0[x_p2];
+
+    ker.i = s_p1[x_m1];
+    ker.j = s_p1[x];
+    ker.k = s_p1[x_p1];
+    ker.l = s_p1[x_p2];
+
+    ker.m = s_p2[x_m1];
+    ker.n = s_p2[x];
+    ker.o = s_p2[x_p1];
+    ker.p = s_p2[x_p2];
+    return ker;
+}
+
+//the blend info buffer holds the BlendResult of the F, G, J, K corners of every source pixel F packed into one byte:
+//bits 0-1: blend_f, bits 2-3: blend_g, bits 4-5: blend_j, bits 6-7: blend_k
+template <class ColorDistance>
+void preProcessImage(const uint32_t* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* blendInfo, const xbrz::ScalerCfg& cfg, int yFirst, int yLast)
+{
+    yFirst = std::max(yFirst, 0);
+    yLast  = std::min(yLast, srcHeight);
+
+    for (int y = yFirst; y < yLast; ++y)
+    {
+        unsigned char* out = blendInfo + y * srcWidth;
+        for (int x = 0; x < srcWidth; ++x)
+        {
+            const BlendResult res = preProcessCorners<ColorDistance>(readKernel4x4(src, srcWidth, srcHeight, srcPitch, x, y), cfg);
+            out[x] = static_cast<unsigned char>(res.blend_f | (res.blend_g << 2) | (res.blend_j << 4) | (res.blend_k << 6));
+        }
+    }
+}
+
+
+template <class Scaler, class ColorDistance>
+void scaleImageFromBlendInfo(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight, int srcPitch, int trgWidth, const unsigned char* blendInfo, const xbrz::ScalerCfg& cfg, int yFirst, int yLast)
+{
+    yFirst = std::max(yFirst, 0);
+    yLast  = std::min(yLast, srcHeight);
+
+    for (int y = yFirst; y < yLast; ++y)
+    {
+        uint32_t* out = trg + Scaler::scale * y * trgWidth;
+
+        const unsigned char* info_0  = blendInfo + y * srcWidth;
+        const unsigned char* info_m1 = y > 0 ? info_0 - srcWidth : nullptr;
+
+        const uint32_t* s_m1 = src + srcPitch * std::max(y - 1, 0);
+        const uint32_t* s_0  = src + srcPitch * y;
+        const uint32_t* s_p1 = src + srcPitch * std::min(y + 1, srcHeight - 1);
+
+        for (int x = 0; x < srcWidth; ++x, out += Scaler::scale)
+        {
+            //gather the four corners of (x, y) from the corners evaluated for (x, y), (x - 1, y), (x, y - 1) and (x - 1, y - 1)
+            unsigned char blend_xy = 0;
+            setBottomR(blend_xy, static_cast<BlendType>(info_0[x] & 0x3));
+            if (x > 0)
+                setBottomL(blend_xy, static_cast<BlendType>((info_0[x - 1] >> 2) & 0x3));
+            if (info_m1)
+            {
+                setTopR(blend_xy, static_cast<BlendType>((info_m1[x] >> 4) & 0x3));
+                if (x > 0)
+                    setTopL(blend_xy, static_cast<BlendType>(info_m1[x - 1] >> 6));
+            }
+
+            fillBlock(out, trgWidth * sizeof(uint32_t), s_0[x], Scaler::scale, Scaler::scale);
+
+            if (blendingNeeded(blend_xy))
+            {
+                const int x_m1 = std::max(x - 1, 0);
+                const int x_p1 = std::min(x + 1, srcWidth - 1);
+
+                Kernel_3x3 ker3 = {};
+
+                ker3.a = s_m1[x_m1];
+                ker3.b = s_m1[x];
+                ker3.c = s_m1[x_p1];
+
+                ker3.d = s_0[x_m1];
+                ker3.e = s_0[x];
+                ker3.f = s_0[x_p1];
+
+                ker3.g = s_p1[x_m1];
+                ker3.h = s_p1[x];
+                ker3.i = s_p1[x_p1];
+
+                blendPixel<Scaler, ColorDistance, ROT_0  >(ker3, out, trgWidth, blend_xy, cfg);
+                blendPixel<Scaler, ColorDistance, ROT_90 >(ker3, out, trgWidth, blend_xy, cfg);
+                blendPixel<Scaler, ColorDistance, ROT_180>(ker3, out, trgWidth, blend_xy, cfg);
+                blendPixel<Scaler, ColorDistance, ROT_270>(ker3, out, trgWidth, blend_xy, cfg);
+            }
+        }
+    }
+}
+
+
+template <class ColorGradient, class ColorDistance>
+void scaleFromBlendInfoImpl(size_t factor, const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight, int srcPitch, int trgWidth, const unsigned char* blendInfo, const xbrz::ScalerCfg& cfg, int yFirst, int yLast)
+{
+    switch (factor)
+    {
+        case 2:
+            return scaleImageFromBlendInfo<Scaler2x<ColorGradient>, ColorDistance>(src, trg, srcWidth, srcHeight, srcPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case 3:
+            return scaleImageFromBlendInfo<Scaler3x<ColorGradient>, ColorDistance>(src, trg, srcWidth, srcHeight, srcPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case 4:
+            return scaleImageFromBlendInfo<Scaler4x<ColorGradient>, ColorDistance>(src, trg, srcWidth, srcHeight, srcPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case 5:
+            return scaleImageFromBlendInfo<Scaler5x<ColorGradient>, ColorDistance>(src, trg, srcWidth, srcHeight, srcPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case 6:
+            return scaleImageFromBlendInfo<Scaler6x<ColorGradient>, ColorDistance>(src, trg, srcWidth, srcHeight, srcPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+    }
+    assert(false);
+}
 }
 
 
@@ -1164,6 +1303,42 @@ void xbrz::scale(size_t factor, const uint32_t* src, uint32_t* trg, int srcWidth
 }
 
 
+void xbrz::preProcessBlendInfo(const uint32_t* src, int srcWidth, int srcHeight, ColorFormat colFmt, int srcPitch, unsigned char* blendInfo, const xbrz::ScalerCfg& cfg, int yFirst, int yLast)
+{
+    const int srcPPitch = srcPitch / static_cast<int>(sizeof(uint32_t));
+
+    switch (colFmt)
+    {
+        case ColorFormat::RGB:
+            return preProcessImage<ColorDistanceRGB>(src, srcWidth, srcHeight, srcPPitch, blendInfo, cfg, yFirst, yLast);
+        case ColorFormat::ARGB:
+            return preProcessImage<ColorDistanceARGB>(src, srcWidth, srcHeight, srcPPitch, blendInfo, cfg, yFirst, yLast);
+        case ColorFormat::ARGB_UNBUFFERED:
+            return preProcessImage<ColorDistanceUnbufferedARGB>(src, srcWidth, srcHeight, srcPPitch, blendInfo, cfg, yFirst, yLast);
+    }
+    assert(false);
+}
+
+
+void xbrz::scaleFromBlendInfo(size_t factor, const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight, ColorFormat colFmt, int srcPitch, int trgPitch, const unsigned char* blendInfo, const xbrz::ScalerCfg& cfg, int yFirst, int yLast)
+{
+    const int srcPPitch = srcPitch / static_cast<int>(sizeof(uint32_t));
+    const int trgWidth = trgPitch / static_cast<int>(sizeof(uint32_t));
+
+    static_assert(SCALE_FACTOR_MAX == 6);
+    switch (colFmt)
+    {
+        case ColorFormat::RGB:
+            return scaleFromBlendInfoImpl<ColorGradientRGB, ColorDistanceRGB>(factor, src, trg, srcWidth, srcHeight, srcPPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case ColorFormat::ARGB:
+            return scaleFromBlendInfoImpl<ColorGradientARGB, ColorDistanceARGB>(factor, src, trg, srcWidth, srcHeight, srcPPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+        case ColorFormat::ARGB_UNBUFFERED:
+            return scaleFromBlendInfoImpl<ColorGradientARGB, ColorDistanceUnbufferedARGB>(factor, src, trg, srcWidth, srcHeight, srcPPitch, trgWidth, blendInfo, cfg, yFirst, yLast);
+    }
+    assert(false);
+}
+
+
 bool xbrz::equalColorTest(uint32_t col1, uint32_t col2, ColorFormat colFmt, double luminanceWeight, double equalColorTolerance)
 {
     switch (colFmt)
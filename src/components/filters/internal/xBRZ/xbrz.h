@@ -66,6 +66,25 @@ void scale(size_t factor, //valid range: 2 - SCALE_FACTOR_MAX
            const ScalerCfg& cfg = ScalerCfg(),
            int yFirst = 0, int yLast = std::numeric_limits<int>::max()); //slice of source image
 
+/*
+-> two-pass variant of scale() for scaling a single image on multiple threads:
+   1. preProcessBlendInfo() evaluates the corner blending of the source rows [yFirst, yLast) and stores it into "blendInfo" (srcWidth * srcHeight bytes)
+   2. once all rows are preprocessed, scaleFromBlendInfo() scales the source rows [yFirst, yLast)
+-> no work is repeated at slice boundaries and the result is identical to scaling the complete image with scale()
+
+THREAD-SAFETY: - each pass may be split into any number of non-overlapping slices that are processed in parallel
+*/
+void preProcessBlendInfo(const uint32_t* src, int srcWidth, int srcHeight,
+                         ColorFormat colFmt, int srcPitch, unsigned char* blendInfo,
+                         const ScalerCfg& cfg = ScalerCfg(),
+                         int yFirst = 0, int yLast = std::numeric_limits<int>::max());
+
+void scaleFromBlendInfo(size_t factor, //valid range: 2 - SCALE_FACTOR_MAX
+                        const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
+                        ColorFormat colFmt, int srcPitch, int trgPitch, const unsigned char* blendInfo,
+                        const ScalerCfg& cfg = ScalerCfg(),
+                        int yFirst = 0, int yLast = std::numeric_limits<int>::max());
+
 void bilinearScale(const uint32_t* src, int srcWidth, int srcHeight,
                    /**/  uint32_t* trg, int trgWidth, int trgHeight);
 
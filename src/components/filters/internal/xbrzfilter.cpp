@@ -1,28 +1,79 @@
+#include "components/filters/internal/xbrzfilter.h"
+
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
+#include "core/base/job_pool.h"
 #include "xBRZ/xbrz.h"
 
+namespace {
+
+// Source rows per job. Small enough to balance a 160 row frame over 4-8
+// threads, large enough to keep the output writes of a job sequential.
+constexpr int kRowsPerJob = 8;
+
+}  // namespace
+
+namespace filters {
+namespace internal {
+
+// The blend info of every row is computed once into a buffer shared by all
+// jobs, then the rows are scaled in parallel. The result is the same as a
+// single xbrz::scale() call.
+void XbrzScale(JobPool &pool, size_t factor, uint8_t *srcPtr, uint32_t srcPitch, uint8_t *dstPtr, uint32_t dstPitch,
+               int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    const uint32_t *src = (const uint32_t *)srcPtr;
+    uint32_t *dst = (uint32_t *)dstPtr;
+
+    // Reused across frames; thread-local because the frontends may filter
+    // several bands of a frame at once. The jobs run on the pool's threads,
+    // which have buffers of their own, so they are handed this one.
+    thread_local std::vector<unsigned char> blendInfo;
+    blendInfo.resize((size_t)width * height);
+    unsigned char *blend = blendInfo.data();
+
+    const int jobs = (height + kRowsPerJob - 1) / kRowsPerJob;
+    pool.ParallelFor(jobs, [&](int job) {
+        const int yFirst = job * kRowsPerJob;
+        xbrz::preProcessBlendInfo(src, width, height, xbrz::ColorFormat::RGB, srcPitch, blend,
+                                  xbrz::ScalerCfg(), yFirst, std::min(yFirst + kRowsPerJob, height));
+    });
+    pool.ParallelFor(jobs, [&](int job) {
+        const int yFirst = job * kRowsPerJob;
+        xbrz::scaleFromBlendInfo(factor, src, dst, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch,
+                                 blend, xbrz::ScalerCfg(), yFirst, std::min(yFirst + kRowsPerJob, height));
+    });
+}
+
+}  // namespace internal
+}  // namespace filters
+
 void xbrz2x32(uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */, uint8_t *dstPtr, uint32_t dstPitch, int width, int height)
 {
-    xbrz::scale(2, (const uint32_t *)srcPtr, (uint32_t *)dstPtr, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch);
+    filters::internal::XbrzScale(GetSharedJobPool(), 2, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
 void xbrz3x32(uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */, uint8_t *dstPtr, uint32_t dstPitch, int width, int height)
 {
-    xbrz::scale(3, (const uint32_t *)srcPtr, (uint32_t *)dstPtr, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch);
+    filters::internal::XbrzScale(GetSharedJobPool(), 3, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
 void xbrz4x32(uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */, uint8_t *dstPtr, uint32_t dstPitch, int width, int height)
 {
-    xbrz::scale(4, (const uint32_t *)srcPtr, (uint32_t *)dstPtr, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch);
+    filters::internal::XbrzScale(GetSharedJobPool(), 4, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
 void xbrz5x32(uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */, uint8_t *dstPtr, uint32_t dstPitch, int width, int height)
 {
-    xbrz::scale(5, (const uint32_t *)srcPtr, (uint32_t *)dstPtr, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch);
+    filters::internal::XbrzScale(GetSharedJobPool(), 5, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
 void xbrz6x32(uint8_t *srcPtr, uint32_t srcPitch, uint8_t * /* deltaPtr */, uint8_t *dstPtr, uint32_t dstPitch, int width, int height)
 {
-    xbrz::scale(6, (const uint32_t *)srcPtr, (uint32_t *)dstPtr, width, height, xbrz::ColorFormat::RGB, srcPitch, dstPitch);
+    filters::internal::XbrzScale(GetSharedJobPool(), 6, srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
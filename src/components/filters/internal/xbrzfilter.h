@@ -0,0 +1,20 @@
+#ifndef VBAM_COMPONENTS_FILTERS_INTERNAL_XBRZFILTER_H_
+#define VBAM_COMPONENTS_FILTERS_INTERNAL_XBRZFILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+class JobPool;
+
+namespace filters {
+namespace internal {
+
+// Scales a 32-bit frame by `factor` with xBRZ, split into jobs on `pool`.
+// The xbrz*x32 filters run this on the shared job pool.
+void XbrzScale(JobPool& pool, size_t factor, uint8_t* srcPtr, uint32_t srcPitch, uint8_t* dstPtr,
+               uint32_t dstPitch, int width, int height);
+
+}  // namespace internal
+}  // namespace filters
+
+#endif  // VBAM_COMPONENTS_FILTERS_INTERNAL_XBRZFILTER_H_
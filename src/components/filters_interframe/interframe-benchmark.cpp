@@ -0,0 +1,83 @@
+// Times every interframe blending implementation available on this CPU
+// against the scalar code.
+//
+// Usage: vbam-interframe-benchmark [frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "components/filters_interframe/interframe.h"
+
+int RGB_LOW_BITS_MASK = 0x821;
+
+namespace {
+
+constexpr int kWidth = 240;
+constexpr int kHeight = 160;
+
+typedef void (*FilterFn)(uint8_t*, uint32_t, int, int, int);
+
+struct Filter {
+    const char* name;
+    FilterFn fn;
+    uint32_t pitch;
+};
+
+const Filter kFilters[] = {
+    {"SmartIB", SmartIB, (kWidth + 2) * 2},
+    {"SmartIB32", SmartIB32, (kWidth + 1) * 4},
+    {"MotionBlurIB", MotionBlurIB, (kWidth + 2) * 2},
+    {"MotionBlurIB32", MotionBlurIB32, (kWidth + 1) * 4},
+};
+
+// Returns the time per frame, in microseconds.
+double Time(IFBImplementation impl, const Filter& filter, int frames) {
+    InterframeSetImplementation(impl);
+    InterframeCleanup();
+
+    std::mt19937 rng(42);
+    std::vector<std::vector<uint8_t>> inputs(4);
+    for (auto& input : inputs) {
+        input.resize(filter.pitch * (kHeight + 2));
+        for (auto& byte : input)
+            byte = (uint8_t)(rng() & 0xc3);
+    }
+
+    std::vector<uint8_t> frame(inputs[0].size());
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        memcpy(frame.data(), inputs[i % inputs.size()].data(), frame.size());
+        filter.fn(frame.data(), filter.pitch, kWidth, 0, kHeight + 2);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 10000;
+    if (frames <= 0) {
+        fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+        return 1;
+    }
+
+    for (const Filter& filter : kFilters) {
+        const double scalar = Time(IFB_IMPL_SCALAR, filter, frames);
+        printf("%-16s %-8s %8.2f us/frame\n", filter.name, "scalar", scalar);
+        for (int i = IFB_IMPL_SCALAR + 1; i < IFB_IMPL_COUNT; i++) {
+            const IFBImplementation impl = (IFBImplementation)i;
+            if (!InterframeImplementationAvailable(impl))
+                continue;
+            const double time = Time(impl, filter, frames);
+            printf("%-16s %-8s %8.2f us/frame (%.2fx)\n", filter.name,
+                   InterframeImplementationName(impl), time, scalar / time);
+        }
+    }
+    InterframeCleanup();
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "components/filters_interframe/interframe.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+int RGB_LOW_BITS_MASK = 0x821;
+
+namespace {
+
+constexpr int kWidth = 240;
+constexpr int kHeight = 160;
+// One pixel of border on each side, as drawn by the core.
+constexpr int kPitch32 = (kWidth + 1) * 4;
+constexpr int kPitch16 = (kWidth + 2) * 2;
+constexpr int kFrames = 8;
+
+typedef void (*FilterFn)(uint8_t*, uint32_t, int, int, int);
+
+// Frames drawn from a small palette, so all the branches of the smart filter
+// (static, flickering and moving pixels) are hit.
+std::vector<std::vector<uint8_t>> MakeFrames(uint32_t pitch) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> pick(0, 3);
+    const uint32_t palette[4] = {0x00000000, 0x00ffffff, 0x00f81f07, 0x0007e0f8};
+    std::vector<std::vector<uint8_t>> frames(kFrames);
+    for (auto& frame : frames) {
+        frame.resize(pitch * (kHeight + 2));
+        for (size_t i = 0; i + 4 <= frame.size(); i += 4) {
+            const uint32_t color = palette[pick(rng)];
+            memcpy(&frame[i], &color, 4);
+        }
+    }
+    return frames;
+}
+
+// Filters the frames in `bands` horizontal bands with `impl` and returns the
+// concatenated output.
+std::vector<uint8_t> FilterFrames(IFBImplementation impl, FilterFn filter, uint32_t pitch, int bands) {
+    EXPECT_TRUE(InterframeSetImplementation(impl));
+    InterframeCleanup();
+    std::vector<uint8_t> output;
+    const int bandHeight = (kHeight + 2) / bands;
+    for (auto& frame : MakeFrames(pitch)) {
+        for (int band = 0; band < bands; band++) {
+            const int starty = band * bandHeight;
+            const int height = band == bands - 1 ? kHeight + 2 - starty : bandHeight;
+            filter(frame.data(), pitch, kWidth, starty, height);
+        }
+        output.insert(output.end(), frame.begin(), frame.end());
+    }
+    return output;
+}
+
+class InterframeTest : public ::testing::TestWithParam<IFBImplementation> {
+protected:
+    void SetUp() override {
+        if (!InterframeImplementationAvailable(GetParam()))
+            GTEST_SKIP() << InterframeImplementationName(GetParam()) << " is not available";
+    }
+    void TearDown() override { InterframeCleanup(); }
+};
+
+TEST_P(InterframeTest, SmartIB) {
+    EXPECT_EQ(FilterFrames(GetParam(), SmartIB, kPitch16, 1), FilterFrames(IFB_IMPL_SCALAR, SmartIB, kPitch16, 1));
+}
+
+TEST_P(InterframeTest, SmartIB32) {
+    EXPECT_EQ(FilterFrames(GetParam(), SmartIB32, kPitch32, 1),
+              FilterFrames(IFB_IMPL_SCALAR, SmartIB32, kPitch32, 1));
+}
+
+TEST_P(InterframeTest, MotionBlurIB) {
+    EXPECT_EQ(FilterFrames(GetParam(), MotionBlurIB, kPitch16, 1),
+              FilterFrames(IFB_IMPL_SCALAR, MotionBlurIB, kPitch16, 1));
+}
+
+TEST_P(InterframeTest, MotionBlurIB32) {
+    EXPECT_EQ(FilterFrames(GetParam(), MotionBlurIB32, kPitch32, 1),
+              FilterFrames(IFB_IMPL_SCALAR, MotionBlurIB32, kPitch32, 1));
+}
+
+// Filtering a frame in bands, as the wx frontend does with one band per
+// thread, must give the same result as filtering it in one call.
+TEST_P(InterframeTest, SmartIB32Bands) {
+    EXPECT_EQ(FilterFrames(GetParam(), SmartIB32, kPitch32, 4),
+              FilterFrames(IFB_IMPL_SCALAR, SmartIB32, kPitch32, 1));
+}
+
+INSTANTIATE_TEST_SUITE_P(Implementations,
+                         InterframeTest,
+                         ::testing::Values(IFB_IMPL_SCALAR,
+                                           IFB_IMPL_SSE2,
+                                           IFB_IMPL_AVX2,
+                                           IFB_IMPL_NEON),
+                         [](const ::testing::TestParamInfo<IFBImplementation>& info) {
+                             return std::string(InterframeImplementationName(info.param));
+                         });
+
+}  // namespace
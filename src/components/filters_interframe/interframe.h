@@ -12,19 +12,28 @@ void InterframeFilterInit();
 // call ifc to ignore previous frame / when starting new
 void InterframeCleanup();
 
-// all 4 are MMX-accelerated if enabled
+// SIMD implementations of the filters. The best one supported by the CPU is
+// picked on first use; the others are mostly useful for testing.
+enum IFBImplementation {
+    IFB_IMPL_SCALAR,
+    IFB_IMPL_SSE2,
+    IFB_IMPL_AVX2,
+    IFB_IMPL_NEON,
+    IFB_IMPL_COUNT
+};
+
+// Returns false if `impl` is not compiled in or not supported by the CPU.
+bool InterframeSetImplementation(IFBImplementation impl);
+IFBImplementation InterframeGetImplementation();
+bool InterframeImplementationAvailable(IFBImplementation impl);
+const char* InterframeImplementationName(IFBImplementation impl);
+
+// all 4 are vectorized when the CPU allows it
 void SmartIB(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
 void SmartIB32(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
 void MotionBlurIB(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
 void MotionBlurIB32(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
 
-#ifdef MMX
-static void SmartIB_MMX(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
-static void SmartIB32_MMX(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
-static void MotionBlurIB_MMX(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
-static void MotionBlurIB32_MMX(uint8_t *srcPtr, uint32_t srcPitch, int width, int starty, int height);
-#endif
-
 //Options for if start is 0
 void SmartIB(uint8_t *srcPtr, uint32_t srcPitch, int width, int height);
 void SmartIB32(uint8_t *srcPtr, uint32_t srcPitch, int width, int height);
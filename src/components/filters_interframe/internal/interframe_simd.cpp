@@ -0,0 +1,284 @@
+#include "components/filters_interframe/internal/interframe_simd.h"
+
+#include "core/base/cpu_features.h"
+
+#if defined(VBAM_SIMD_X86)
+#include <immintrin.h>
+#elif defined(VBAM_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// Vector versions of the row kernels in interframe_simd.h. All of them
+// produce exactly the same output as SmartRowScalar()/BlurRowScalar(): the
+// blends are (a & mask) >> 1 + (b & mask) >> 1 per channel, which never
+// carries across lanes, and the smart filter condition is computed with
+// lane-wise compares instead of branches.
+
+namespace interframe {
+namespace internal {
+
+namespace {
+
+#if defined(VBAM_SIMD_X86)
+
+// SSE2, 8 (16-bit) or 4 (32-bit) pixels per step.
+
+VBAM_TARGET_SSE2 void SmartRow16Sse2(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2,
+                                     uint16_t* prev3, int count, uint16_t colorMask) {
+    const __m128i mask = _mm_set1_epi16((short)colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(cur + i));
+        const __m128i p1 = _mm_loadu_si128((const __m128i*)(prev1 + i));
+        const __m128i p2 = _mm_loadu_si128((const __m128i*)(prev2 + i));
+        const __m128i p3 = _mm_loadu_si128((const __m128i*)(prev3 + i));
+        _mm_storeu_si128((__m128i*)(prev3 + i), c);
+        const __m128i still = _mm_or_si128(_mm_cmpeq_epi16(p1, p2), _mm_cmpeq_epi16(p3, c));
+        const __m128i flicker = _mm_or_si128(_mm_cmpeq_epi16(c, p2), _mm_cmpeq_epi16(p1, p3));
+        const __m128i blend = _mm_andnot_si128(still, flicker);
+        const __m128i avg = _mm_add_epi16(_mm_srli_epi16(_mm_and_si128(c, mask), 1),
+                                          _mm_srli_epi16(_mm_and_si128(p1, mask), 1));
+        _mm_storeu_si128((__m128i*)(cur + i),
+                         _mm_or_si128(_mm_and_si128(blend, avg), _mm_andnot_si128(blend, c)));
+    }
+    SmartRowScalar<uint16_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_SSE2 void SmartRow32Sse2(uint32_t* cur, const uint32_t* prev1, const uint32_t* prev2,
+                                     uint32_t* prev3, int count, uint32_t colorMask) {
+    const __m128i mask = _mm_set1_epi32((int)colorMask);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(cur + i));
+        const __m128i p1 = _mm_loadu_si128((const __m128i*)(prev1 + i));
+        const __m128i p2 = _mm_loadu_si128((const __m128i*)(prev2 + i));
+        const __m128i p3 = _mm_loadu_si128((const __m128i*)(prev3 + i));
+        _mm_storeu_si128((__m128i*)(prev3 + i), c);
+        const __m128i still = _mm_or_si128(_mm_cmpeq_epi32(p1, p2), _mm_cmpeq_epi32(p3, c));
+        const __m128i flicker = _mm_or_si128(_mm_cmpeq_epi32(c, p2), _mm_cmpeq_epi32(p1, p3));
+        const __m128i blend = _mm_andnot_si128(still, flicker);
+        const __m128i avg = _mm_add_epi32(_mm_srli_epi32(_mm_and_si128(c, mask), 1),
+                                          _mm_srli_epi32(_mm_and_si128(p1, mask), 1));
+        _mm_storeu_si128((__m128i*)(cur + i),
+                         _mm_or_si128(_mm_and_si128(blend, avg), _mm_andnot_si128(blend, c)));
+    }
+    SmartRowScalar<uint32_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_SSE2 void BlurRow16Sse2(uint16_t* cur, uint16_t* prev1, int count, uint16_t colorMask) {
+    const __m128i mask = _mm_set1_epi16((short)colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(cur + i));
+        const __m128i p1 = _mm_loadu_si128((const __m128i*)(prev1 + i));
+        _mm_storeu_si128((__m128i*)(prev1 + i), c);
+        _mm_storeu_si128((__m128i*)(cur + i),
+                         _mm_add_epi16(_mm_srli_epi16(_mm_and_si128(c, mask), 1),
+                                       _mm_srli_epi16(_mm_and_si128(p1, mask), 1)));
+    }
+    BlurRowScalar<uint16_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_SSE2 void BlurRow32Sse2(uint32_t* cur, uint32_t* prev1, int count, uint32_t colorMask) {
+    const __m128i mask = _mm_set1_epi32((int)colorMask);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i c = _mm_loadu_si128((const __m128i*)(cur + i));
+        const __m128i p1 = _mm_loadu_si128((const __m128i*)(prev1 + i));
+        _mm_storeu_si128((__m128i*)(prev1 + i), c);
+        _mm_storeu_si128((__m128i*)(cur + i),
+                         _mm_add_epi32(_mm_srli_epi32(_mm_and_si128(c, mask), 1),
+                                       _mm_srli_epi32(_mm_and_si128(p1, mask), 1)));
+    }
+    BlurRowScalar<uint32_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+// AVX2, 16 (16-bit) or 8 (32-bit) pixels per step.
+
+VBAM_TARGET_AVX2 void SmartRow16Avx2(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2,
+                                     uint16_t* prev3, int count, uint16_t colorMask) {
+    const __m256i mask = _mm256_set1_epi16((short)colorMask);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(cur + i));
+        const __m256i p1 = _mm256_loadu_si256((const __m256i*)(prev1 + i));
+        const __m256i p2 = _mm256_loadu_si256((const __m256i*)(prev2 + i));
+        const __m256i p3 = _mm256_loadu_si256((const __m256i*)(prev3 + i));
+        _mm256_storeu_si256((__m256i*)(prev3 + i), c);
+        const __m256i still =
+            _mm256_or_si256(_mm256_cmpeq_epi16(p1, p2), _mm256_cmpeq_epi16(p3, c));
+        const __m256i flicker =
+            _mm256_or_si256(_mm256_cmpeq_epi16(c, p2), _mm256_cmpeq_epi16(p1, p3));
+        const __m256i blend = _mm256_andnot_si256(still, flicker);
+        const __m256i avg = _mm256_add_epi16(_mm256_srli_epi16(_mm256_and_si256(c, mask), 1),
+                                             _mm256_srli_epi16(_mm256_and_si256(p1, mask), 1));
+        _mm256_storeu_si256((__m256i*)(cur + i), _mm256_blendv_epi8(c, avg, blend));
+    }
+    SmartRowScalar<uint16_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_AVX2 void SmartRow32Avx2(uint32_t* cur, const uint32_t* prev1, const uint32_t* prev2,
+                                     uint32_t* prev3, int count, uint32_t colorMask) {
+    const __m256i mask = _mm256_set1_epi32((int)colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(cur + i));
+        const __m256i p1 = _mm256_loadu_si256((const __m256i*)(prev1 + i));
+        const __m256i p2 = _mm256_loadu_si256((const __m256i*)(prev2 + i));
+        const __m256i p3 = _mm256_loadu_si256((const __m256i*)(prev3 + i));
+        _mm256_storeu_si256((__m256i*)(prev3 + i), c);
+        const __m256i still =
+            _mm256_or_si256(_mm256_cmpeq_epi32(p1, p2), _mm256_cmpeq_epi32(p3, c));
+        const __m256i flicker =
+            _mm256_or_si256(_mm256_cmpeq_epi32(c, p2), _mm256_cmpeq_epi32(p1, p3));
+        const __m256i blend = _mm256_andnot_si256(still, flicker);
+        const __m256i avg = _mm256_add_epi32(_mm256_srli_epi32(_mm256_and_si256(c, mask), 1),
+                                             _mm256_srli_epi32(_mm256_and_si256(p1, mask), 1));
+        _mm256_storeu_si256((__m256i*)(cur + i), _mm256_blendv_epi8(c, avg, blend));
+    }
+    SmartRowScalar<uint32_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_AVX2 void BlurRow16Avx2(uint16_t* cur, uint16_t* prev1, int count, uint16_t colorMask) {
+    const __m256i mask = _mm256_set1_epi16((short)colorMask);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(cur + i));
+        const __m256i p1 = _mm256_loadu_si256((const __m256i*)(prev1 + i));
+        _mm256_storeu_si256((__m256i*)(prev1 + i), c);
+        _mm256_storeu_si256((__m256i*)(cur + i),
+                            _mm256_add_epi16(_mm256_srli_epi16(_mm256_and_si256(c, mask), 1),
+                                             _mm256_srli_epi16(_mm256_and_si256(p1, mask), 1)));
+    }
+    BlurRowScalar<uint16_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+VBAM_TARGET_AVX2 void BlurRow32Avx2(uint32_t* cur, uint32_t* prev1, int count, uint32_t colorMask) {
+    const __m256i mask = _mm256_set1_epi32((int)colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(cur + i));
+        const __m256i p1 = _mm256_loadu_si256((const __m256i*)(prev1 + i));
+        _mm256_storeu_si256((__m256i*)(prev1 + i), c);
+        _mm256_storeu_si256((__m256i*)(cur + i),
+                            _mm256_add_epi32(_mm256_srli_epi32(_mm256_and_si256(c, mask), 1),
+                                             _mm256_srli_epi32(_mm256_and_si256(p1, mask), 1)));
+    }
+    BlurRowScalar<uint32_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+#elif defined(VBAM_SIMD_NEON)
+
+// NEON, 8 (16-bit) or 4 (32-bit) pixels per step.
+
+void SmartRow16Neon(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2, uint16_t* prev3,
+                    int count, uint16_t colorMask) {
+    const uint16x8_t mask = vdupq_n_u16(colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t c = vld1q_u16(cur + i);
+        const uint16x8_t p1 = vld1q_u16(prev1 + i);
+        const uint16x8_t p2 = vld1q_u16(prev2 + i);
+        const uint16x8_t p3 = vld1q_u16(prev3 + i);
+        vst1q_u16(prev3 + i, c);
+        const uint16x8_t still = vorrq_u16(vceqq_u16(p1, p2), vceqq_u16(p3, c));
+        const uint16x8_t flicker = vorrq_u16(vceqq_u16(c, p2), vceqq_u16(p1, p3));
+        const uint16x8_t blend = vbicq_u16(flicker, still);
+        const uint16x8_t avg =
+            vaddq_u16(vshrq_n_u16(vandq_u16(c, mask), 1), vshrq_n_u16(vandq_u16(p1, mask), 1));
+        vst1q_u16(cur + i, vbslq_u16(blend, avg, c));
+    }
+    SmartRowScalar<uint16_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+void SmartRow32Neon(uint32_t* cur, const uint32_t* prev1, const uint32_t* prev2, uint32_t* prev3,
+                    int count, uint32_t colorMask) {
+    const uint32x4_t mask = vdupq_n_u32(colorMask);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t c = vld1q_u32(cur + i);
+        const uint32x4_t p1 = vld1q_u32(prev1 + i);
+        const uint32x4_t p2 = vld1q_u32(prev2 + i);
+        const uint32x4_t p3 = vld1q_u32(prev3 + i);
+        vst1q_u32(prev3 + i, c);
+        const uint32x4_t still = vorrq_u32(vceqq_u32(p1, p2), vceqq_u32(p3, c));
+        const uint32x4_t flicker = vorrq_u32(vceqq_u32(c, p2), vceqq_u32(p1, p3));
+        const uint32x4_t blend = vbicq_u32(flicker, still);
+        const uint32x4_t avg =
+            vaddq_u32(vshrq_n_u32(vandq_u32(c, mask), 1), vshrq_n_u32(vandq_u32(p1, mask), 1));
+        vst1q_u32(cur + i, vbslq_u32(blend, avg, c));
+    }
+    SmartRowScalar<uint32_t>(cur + i, prev1 + i, prev2 + i, prev3 + i, count - i, colorMask);
+}
+
+void BlurRow16Neon(uint16_t* cur, uint16_t* prev1, int count, uint16_t colorMask) {
+    const uint16x8_t mask = vdupq_n_u16(colorMask);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t c = vld1q_u16(cur + i);
+        const uint16x8_t p1 = vld1q_u16(prev1 + i);
+        vst1q_u16(prev1 + i, c);
+        vst1q_u16(cur + i, vaddq_u16(vshrq_n_u16(vandq_u16(c, mask), 1),
+                                     vshrq_n_u16(vandq_u16(p1, mask), 1)));
+    }
+    BlurRowScalar<uint16_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+void BlurRow32Neon(uint32_t* cur, uint32_t* prev1, int count, uint32_t colorMask) {
+    const uint32x4_t mask = vdupq_n_u32(colorMask);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t c = vld1q_u32(cur + i);
+        const uint32x4_t p1 = vld1q_u32(prev1 + i);
+        vst1q_u32(prev1 + i, c);
+        vst1q_u32(cur + i, vaddq_u32(vshrq_n_u32(vandq_u32(c, mask), 1),
+                                     vshrq_n_u32(vandq_u32(p1, mask), 1)));
+    }
+    BlurRowScalar<uint32_t>(cur + i, prev1 + i, count - i, colorMask);
+}
+
+#endif  // defined(VBAM_SIMD_X86)
+
+}  // namespace
+
+bool GetSse2Kernels(RowKernels* kernels) {
+#if defined(VBAM_SIMD_X86)
+    kernels->smart16 = SmartRow16Sse2;
+    kernels->smart32 = SmartRow32Sse2;
+    kernels->blur16 = BlurRow16Sse2;
+    kernels->blur32 = BlurRow32Sse2;
+    return true;
+#else
+    (void)kernels;
+    return false;
+#endif
+}
+
+bool GetAvx2Kernels(RowKernels* kernels) {
+#if defined(VBAM_SIMD_X86)
+    kernels->smart16 = SmartRow16Avx2;
+    kernels->smart32 = SmartRow32Avx2;
+    kernels->blur16 = BlurRow16Avx2;
+    kernels->blur32 = BlurRow32Avx2;
+    return true;
+#else
+    (void)kernels;
+    return false;
+#endif
+}
+
+bool GetNeonKernels(RowKernels* kernels) {
+#if defined(VBAM_SIMD_NEON)
+    kernels->smart16 = SmartRow16Neon;
+    kernels->smart32 = SmartRow32Neon;
+    kernels->blur16 = BlurRow16Neon;
+    kernels->blur32 = BlurRow32Neon;
+    return true;
+#else
+    (void)kernels;
+    return false;
+#endif
+}
+
+}  // namespace internal
+}  // namespace interframe
@@ -0,0 +1,59 @@
+#ifndef VBAM_COMPONENTS_FILTERS_INTERFRAME_INTERNAL_INTERFRAME_SIMD_H_
+#define VBAM_COMPONENTS_FILTERS_INTERFRAME_INTERNAL_INTERFRAME_SIMD_H_
+
+#include <cstdint>
+
+namespace interframe {
+namespace internal {
+
+// Row kernels for the interframe filters. `cur` is the line being filtered
+// and is updated in place. `prev1`, `prev2` and `prev3` hold the same line
+// from 1, 2 and 3 frames ago. The smart kernel overwrites `prev3` with the
+// unfiltered `cur`; the motion blur kernel overwrites `prev1`.
+typedef void (*SmartRow16)(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2,
+                           uint16_t* prev3, int count, uint16_t colorMask);
+typedef void (*SmartRow32)(uint32_t* cur, const uint32_t* prev1, const uint32_t* prev2,
+                           uint32_t* prev3, int count, uint32_t colorMask);
+typedef void (*BlurRow16)(uint16_t* cur, uint16_t* prev1, int count, uint16_t colorMask);
+typedef void (*BlurRow32)(uint32_t* cur, uint32_t* prev1, int count, uint32_t colorMask);
+
+struct RowKernels {
+    SmartRow16 smart16;
+    SmartRow32 smart32;
+    BlurRow16 blur16;
+    BlurRow32 blur32;
+};
+
+// Reference implementation; the vector kernels use it for the row tail.
+template <typename T>
+inline void SmartRowScalar(T* cur, const T* prev1, const T* prev2, T* prev3, int count,
+                           T colorMask) {
+    for (int i = 0; i < count; i++) {
+        const T color = cur[i];
+        cur[i] = (prev1[i] != prev2[i]) && (prev3[i] != color) &&
+                         ((color == prev2[i]) || (prev1[i] == prev3[i]))
+                     ? (T)(((color & colorMask) >> 1) + ((prev1[i] & colorMask) >> 1))
+                     : color;
+        prev3[i] = color;  // oldest buffer now holds newest frame
+    }
+}
+
+template <typename T>
+inline void BlurRowScalar(T* cur, T* prev1, int count, T colorMask) {
+    for (int i = 0; i < count; i++) {
+        const T color = cur[i];
+        cur[i] = (T)(((color & colorMask) >> 1) + ((prev1[i] & colorMask) >> 1));
+        prev1[i] = color;
+    }
+}
+
+// Each returns false, leaving `kernels` untouched, when the instruction set
+// is not compiled in for this target. Callers check the CPU first.
+bool GetSse2Kernels(RowKernels* kernels);
+bool GetAvx2Kernels(RowKernels* kernels);
+bool GetNeonKernels(RowKernels* kernels);
+
+}  // namespace internal
+}  // namespace interframe
+
+#endif  // VBAM_COMPONENTS_FILTERS_INTERFRAME_INTERNAL_INTERFRAME_SIMD_H_
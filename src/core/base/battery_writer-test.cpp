@@ -0,0 +1,172 @@
+#include "core/base/battery_writer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Returns a path in the test directory, named after the test.
+std::string TestFile(const char* suffix) {
+    return testing::TempDir() + "battery_writer_" +
+           testing::UnitTest::GetInstance()->current_test_info()->name() + suffix;
+}
+
+bool Exists(const std::string& file) {
+    FILE* f = fopen(file.c_str(), "rb");
+    if (f == nullptr)
+        return false;
+    fclose(f);
+    return true;
+}
+
+std::vector<uint8_t> Read(const std::string& file) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(file.c_str(), "rb");
+    if (f == nullptr)
+        return data;
+    int c;
+    while ((c = fgetc(f)) != EOF)
+        data.push_back((uint8_t)c);
+    fclose(f);
+    return data;
+}
+
+TEST(BatteryWriterTest, WritesImage) {
+    const std::string file = TestFile(".sav");
+    remove(file.c_str());
+
+    BatteryWriter writer([](const std::string&) { ADD_FAILURE(); });
+    writer.Write(file, {1, 2, 3});
+    writer.Flush();
+    EXPECT_EQ(Read(file), std::vector<uint8_t>({1, 2, 3}));
+    EXPECT_FALSE(Exists(file + ".tmp"));
+    remove(file.c_str());
+}
+
+// An image queued while the worker is busy replaces the one queued before it,
+// which is never written.
+TEST(BatteryWriterTest, CoalescesQueuedImages) {
+    const std::string missing = TestFile("_missing/game.sav");
+    const std::string first = TestFile("_first.sav");
+    const std::string last = TestFile("_last.sav");
+    remove(first.c_str());
+    remove(last.c_str());
+
+    // The worker is held in on_error until the other images are queued.
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool failing = false;
+    bool queued = false;
+    BatteryWriter writer([&](const std::string& file) {
+        EXPECT_EQ(file, missing);
+        std::unique_lock<std::mutex> lock(mutex);
+        failing = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return queued; });
+    });
+
+    writer.Write(missing, {1});
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return failing; });
+    }
+    writer.Write(first, {2});
+    writer.Write(last, {3});
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued = true;
+    }
+    cv.notify_all();
+
+    writer.Flush();
+    EXPECT_FALSE(Exists(first));
+    EXPECT_EQ(Read(last), std::vector<uint8_t>({3}));
+    remove(last.c_str());
+}
+
+// An image identical to the last one written to the same file is skipped, so
+// the file is not written again.
+TEST(BatteryWriterTest, SkipsIdenticalImage) {
+    const std::string file = TestFile(".sav");
+    BatteryWriter writer([](const std::string&) { ADD_FAILURE(); });
+
+    writer.Write(file, {1, 2, 3});
+    writer.Flush();
+    ASSERT_EQ(remove(file.c_str()), 0);
+
+    writer.Write(file, {1, 2, 3});
+    writer.Flush();
+    EXPECT_FALSE(Exists(file));
+
+    writer.Write(file, {1, 2, 4});
+    writer.Flush();
+    EXPECT_EQ(Read(file), std::vector<uint8_t>({1, 2, 4}));
+    remove(file.c_str());
+}
+
+// The image queued when the writer is destroyed is written, even if the worker
+// only gets to it once the destructor has started.
+TEST(BatteryWriterTest, DestructorWritesQueuedImage) {
+    const std::string missing = TestFile("_missing/game.sav");
+    const std::string file = TestFile(".sav");
+    remove(file.c_str());
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool failing = false;
+    bool release = false;
+    std::thread releaser;
+    {
+        BatteryWriter writer([&](const std::string&) {
+            std::unique_lock<std::mutex> lock(mutex);
+            failing = true;
+            cv.notify_all();
+            cv.wait(lock, [&] { return release; });
+        });
+
+        writer.Write(missing, {1});
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return failing; });
+        }
+        writer.Write(file, {5, 6});
+        releaser = std::thread([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::lock_guard<std::mutex> lock(mutex);
+            release = true;
+            cv.notify_all();
+        });
+    }
+    releaser.join();
+    EXPECT_EQ(Read(file), std::vector<uint8_t>({5, 6}));
+    remove(file.c_str());
+}
+
+// A file that cannot be written is reported and leaves no temporary file. The
+// same image is tried again next time.
+TEST(BatteryWriterTest, ReportsErrors) {
+    const std::string file = TestFile("_missing/game.sav");
+    std::vector<std::string> errors;
+    BatteryWriter writer([&](const std::string& f) { errors.push_back(f); });
+
+    writer.Write(file, {7});
+    writer.Flush();
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0], file);
+    EXPECT_FALSE(Exists(file));
+    EXPECT_FALSE(Exists(file + ".tmp"));
+
+    writer.Write(file, {7});
+    writer.Flush();
+    EXPECT_EQ(errors.size(), 2u);
+}
+
+}  // namespace
@@ -0,0 +1,67 @@
+#include "core/base/battery_writer.h"
+
+#include <utility>
+
+#include "core/base/file_util.h"
+
+BatteryWriter::BatteryWriter(std::function<void(const std::string&)> on_error)
+    : on_error_(std::move(on_error)) {}
+
+BatteryWriter::~BatteryWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void BatteryWriter::Write(std::string file, std::vector<uint8_t> image) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable())
+            worker_ = std::thread(&BatteryWriter::WorkerMain, this);
+        queued_file_ = std::move(file);
+        queued_image_ = std::move(image);
+        queued_ = true;
+    }
+    wake_.notify_all();
+}
+
+void BatteryWriter::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return !queued_ && !busy_; });
+}
+
+void BatteryWriter::WorkerMain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // The queued image is written even when stopping.
+        wake_.wait(lock, [this] { return queued_ || stop_; });
+        if (!queued_)
+            return;
+
+        std::string file = std::move(queued_file_);
+        std::vector<uint8_t> image = std::move(queued_image_);
+        queued_ = false;
+        busy_ = true;
+        lock.unlock();
+
+        if (file != written_file_ || image != written_image_) {
+            if (utilWriteFileAtomic(file.c_str(), image.data(), image.size())) {
+                written_file_ = std::move(file);
+                written_image_ = std::move(image);
+            } else {
+                // Try again next time, even with the same image.
+                written_file_.clear();
+                on_error_(file);
+            }
+        }
+
+        lock.lock();
+        busy_ = false;
+        if (!queued_)
+            idle_.notify_all();
+    }
+}
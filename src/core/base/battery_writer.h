@@ -0,0 +1,60 @@
+#ifndef VBAM_CORE_BASE_BATTERY_WRITER_H_
+#define VBAM_CORE_BASE_BATTERY_WRITER_H_
+
+#if defined(__LIBRETRO__)
+#error "This file is only for non-libretro builds"
+#endif
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes battery saves on a background thread, so that slow storage does not
+// stall emulation. The frontend snapshots the image with emuWriteBatteryMem()
+// and hands it over; the file is replaced with utilWriteFileAtomic(), and an
+// image identical to the last one written to the same file is skipped.
+class BatteryWriter {
+public:
+    // `on_error` is called on the writer thread with the file that could not
+    // be written.
+    explicit BatteryWriter(std::function<void(const std::string&)> on_error);
+    // Writes the queued image before returning.
+    ~BatteryWriter();
+
+    BatteryWriter(const BatteryWriter&) = delete;
+    BatteryWriter& operator=(const BatteryWriter&) = delete;
+
+    // Queues `image` to be written to `file`, replacing a queued image that
+    // has not been written yet. The thread starts on first use.
+    void Write(std::string file, std::vector<uint8_t> image);
+
+    // Returns once the queued image has been written.
+    void Flush();
+
+private:
+    void WorkerMain();
+
+    const std::function<void(const std::string&)> on_error_;
+    std::thread worker_;
+
+    // Protects everything below.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::string queued_file_;
+    std::vector<uint8_t> queued_image_;
+    bool queued_ = false;
+    // The worker is writing an image.
+    bool busy_ = false;
+    bool stop_ = false;
+
+    // The last image written, owned by the worker.
+    std::string written_file_;
+    std::vector<uint8_t> written_image_;
+};
+
+#endif  // VBAM_CORE_BASE_BATTERY_WRITER_H_
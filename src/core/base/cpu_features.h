@@ -0,0 +1,44 @@
+#ifndef VBAM_CORE_BASE_CPU_FEATURES_H_
+#define VBAM_CORE_BASE_CPU_FEATURES_H_
+
+// This header defines helpers to select SIMD code paths at runtime.
+// * VBAM_SIMD_X86 / VBAM_SIMD_NEON - defined when x86 (SSE2/AVX2) or ARM NEON
+//   intrinsics can be compiled for the target.
+// * VBAM_TARGET_SSE2 / VBAM_TARGET_SSSE3 / VBAM_TARGET_SSE41 /
+//   VBAM_TARGET_AVX2 - function attributes that let GCC/Clang compile
+//   intrinsics for an instruction set without changing the build flags for
+//   the whole file. MSVC does not need them.
+// * GetCpuFeatures() - returns the features of the host CPU. A function built
+//   with one of the attributes above must only be called if the matching
+//   feature is reported.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VBAM_SIMD_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define VBAM_SIMD_NEON 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VBAM_TARGET_SSE2 __attribute__((target("sse2")))
+#define VBAM_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define VBAM_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define VBAM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VBAM_TARGET_SSE2
+#define VBAM_TARGET_SSSE3
+#define VBAM_TARGET_SSE41
+#define VBAM_TARGET_AVX2
+#endif
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool neon = false;
+};
+
+// Detected once, on first call. Thread-safe.
+const CpuFeatures& GetCpuFeatures();
+
+#endif  // VBAM_CORE_BASE_CPU_FEATURES_H_
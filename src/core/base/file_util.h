@@ -42,6 +42,11 @@ void utilReadDataMem(const uint8_t *&data, variable_desc *);
 // strip .gz or .z off end
 void utilStripDoubleExtension(const char *, char *);
 
+// Writes `size` bytes to `file` through a temporary file that is synced and
+// renamed over it, so that `file` holds either the old or the new contents
+// even if the process dies or the power goes out meanwhile.
+bool utilWriteFileAtomic(const char *file, const void *data, size_t size);
+
 gzFile utilAutoGzOpen(const char *file, const char *mode);
 gzFile utilGzOpen(const char *file, const char *mode);
 gzFile utilMemGzOpen(char *memory, int available, const char *mode);
@@ -6,6 +6,15 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // defined(_WIN32)
 
 #include "core/base/internal/file_util_internal.h"
 #include "core/base/internal/memgzio.h"
@@ -101,8 +110,61 @@ int(ZEXPORT* utilGzReadFunc)(gzFile, voidp, unsigned int) = nullptr;
 int(ZEXPORT* utilGzCloseFunc)(gzFile) = nullptr;
 z_off_t(ZEXPORT* utilGzSeekFunc)(gzFile, z_off_t, int) = nullptr;
 
+// Makes a rename in the directory of `file` durable.
+void utilSyncDirectory(const std::string& file) {
+#if !defined(_WIN32)
+    const size_t slash = file.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : file.substr(0, slash + 1);
+    const int fd = open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)file;
+#endif  // !defined(_WIN32)
+}
+
 }  // namespace
 
+bool utilWriteFileAtomic(const char* file, const void* data, size_t size) {
+    const std::string temp = std::string(file) + ".tmp";
+    FILE* f = utilOpenFile(temp.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+
+    bool ok = fwrite(data, 1, size, f) == size && fflush(f) == 0;
+#if defined(_WIN32)
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif  // defined(_WIN32)
+    ok = fclose(f) == 0 && ok;
+
+    if (ok) {
+#if defined(_WIN32)
+        ok = MoveFileExW(core::internal::ToUTF16(temp.c_str()).c_str(),
+                         core::internal::ToUTF16(file).c_str(),
+                         MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        ok = rename(temp.c_str(), file) == 0;
+        if (ok) {
+            utilSyncDirectory(temp);
+        }
+#endif  // defined(_WIN32)
+    }
+
+    if (!ok) {
+#if defined(_WIN32)
+        _wremove(core::internal::ToUTF16(temp.c_str()).c_str());
+#else
+        remove(temp.c_str());
+#endif  // defined(_WIN32)
+    }
+    return ok;
+}
+
 uint8_t* utilLoad(const char* file, bool (*accept)(const char*), uint8_t* data, int& size) {
     // find image file
     char buffer[2048];
@@ -0,0 +1,55 @@
+#include "core/base/job_pool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(JobPoolTest, RunsEveryJobOnce) {
+    JobPool pool(3);
+    std::vector<std::atomic<int>> runs(100);
+    pool.ParallelFor(100, [&](int i) { runs[i]++; });
+    for (const std::atomic<int>& count : runs)
+        EXPECT_EQ(count, 1);
+}
+
+TEST(JobPoolTest, RunsInlineWithoutWorkers) {
+    JobPool pool(0);
+    EXPECT_EQ(pool.concurrency(), 1);
+    int sum = 0;
+    pool.ParallelFor(10, [&](int i) { sum += i; });
+    EXPECT_EQ(sum, 45);
+}
+
+// A job may itself call ParallelFor() on its pool. This used to deadlock, as
+// the nested call waited for the batch it was part of.
+TEST(JobPoolTest, NestedParallelFor) {
+    JobPool pool(3);
+    std::vector<std::atomic<int>> runs(8 * 16);
+    pool.ParallelFor(8, [&](int outer) {
+        pool.ParallelFor(16, [&](int inner) { runs[outer * 16 + inner]++; });
+    });
+    for (const std::atomic<int>& count : runs)
+        EXPECT_EQ(count, 1);
+}
+
+// Batches from several threads are serialized, while jobs of each batch may
+// start batches of their own.
+TEST(JobPoolTest, ConcurrentNestedParallelFor) {
+    JobPool pool(3);
+    std::atomic<int> runs{0};
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; t++) {
+        callers.emplace_back([&] {
+            for (int round = 0; round < 50; round++) {
+                pool.ParallelFor(4, [&](int) {
+                    pool.ParallelFor(4, [&](int) { runs++; });
+                });
+            }
+        });
+    }
+    for (std::thread& caller : callers)
+        caller.join();
+    EXPECT_EQ(runs, 4 * 50 * 4 * 4);
+}
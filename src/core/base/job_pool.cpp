@@ -0,0 +1,106 @@
+#include "core/base/job_pool.h"
+
+#include <algorithm>
+
+namespace {
+
+// The pool whose jobs the current thread is running, if any.
+thread_local const JobPool* running_pool = nullptr;
+
+}  // namespace
+
+JobPool::JobPool(int workers) {
+    if (workers < 0)
+        workers = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+
+    workers_.reserve(workers);
+    for (int i = 0; i < workers; i++)
+        workers_.emplace_back(&JobPool::WorkerMain, this);
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void JobPool::ParallelFor(int count, const std::function<void(int)>& job) {
+    if (count <= 0)
+        return;
+
+    // A nested call must not wait for the batch its caller is part of.
+    if (workers_.empty() || count == 1 || running_pool == this) {
+        for (int i = 0; i < count; i++)
+            job(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> batch_lock(batch_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        count_ = count;
+        pending_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        batch_++;
+    }
+    wake_.notify_all();
+
+    RunJobs(job, count);
+
+    // Wait for the workers to leave the batch too, so none of them picks a
+    // job of the next batch with this batch's function.
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0 && active_ == 0; });
+    job_ = nullptr;
+}
+
+void JobPool::RunJobs(const std::function<void(int)>& job, int count) {
+    const JobPool* const outer_pool = running_pool;
+    running_pool = this;
+    int done = 0;
+    for (int i = next_.fetch_add(1); i < count; i = next_.fetch_add(1)) {
+        job(i);
+        done++;
+    }
+    running_pool = outer_pool;
+
+    if (done) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ -= done;
+        if (pending_ == 0)
+            done_.notify_all();
+    }
+}
+
+void JobPool::WorkerMain() {
+    uint64_t seen_batch = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [&] { return stop_ || (job_ && batch_ != seen_batch); });
+        if (stop_)
+            return;
+
+        seen_batch = batch_;
+        const std::function<void(int)>& job = *job_;
+        const int count = count_;
+        active_++;
+        lock.unlock();
+
+        RunJobs(job, count);
+
+        lock.lock();
+        active_--;
+        if (active_ == 0)
+            done_.notify_all();
+    }
+}
+
+JobPool& GetSharedJobPool() {
+    static JobPool pool;
+    return pool;
+}
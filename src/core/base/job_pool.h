@@ -0,0 +1,62 @@
+#ifndef VBAM_CORE_BASE_JOB_POOL_H_
+#define VBAM_CORE_BASE_JOB_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads for splitting per-frame work (filters, rendering)
+// into independent jobs. The calling thread takes part in the work, so a
+// pool with no workers simply runs everything inline.
+class JobPool {
+public:
+    // Starts `workers` threads. -1 means one less than the number of cores.
+    explicit JobPool(int workers = -1);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // Number of threads that run jobs, including the caller.
+    int concurrency() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // Runs `job(i)` for every i in [0, count) and returns once all of them
+    // are done. Calls from several threads are serialized. Calls from a job
+    // of this pool run all of their jobs inline, on the calling thread.
+    void ParallelFor(int count, const std::function<void(int)>& job);
+
+private:
+    void WorkerMain();
+    // Runs jobs of the current batch until none are left.
+    void RunJobs(const std::function<void(int)>& job, int count);
+
+    std::vector<std::thread> workers_;
+
+    // Serializes ParallelFor() calls.
+    std::mutex batch_mutex_;
+
+    // Protects everything below.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* job_ = nullptr;
+    int count_ = 0;
+    // Jobs of the current batch that have not finished yet.
+    int pending_ = 0;
+    // Workers currently running jobs of the current batch.
+    int active_ = 0;
+    uint64_t batch_ = 0;
+    bool stop_ = false;
+
+    // Index of the next job to start.
+    std::atomic<int> next_{0};
+};
+
+// The pool shared by the filters and the core, started on first use.
+JobPool& GetSharedJobPool();
+
+#endif  // VBAM_CORE_BASE_JOB_POOL_H_
@@ -0,0 +1,97 @@
+#include "core/base/line_queue.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Line {
+    int value;
+};
+
+TEST(LineQueueTest, DrawsEveryLineInOrder) {
+    std::vector<int> drawn;
+    LineQueue<Line, 4> queue([&](const Line& line) { drawn.push_back(line.value); });
+    for (int i = 0; i < 100; i++) {
+        queue.Push().value = i;
+        queue.Publish();
+    }
+    queue.Wait();
+
+    ASSERT_EQ(drawn.size(), 100u);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(drawn[i], i);
+}
+
+TEST(LineQueueTest, DestructorDrawsQueuedLines) {
+    int drawn = 0;
+    {
+        LineQueue<Line, 8> queue([&](const Line&) { drawn++; });
+        for (int i = 0; i < 8; i++) {
+            queue.Push();
+            queue.Publish();
+        }
+    }
+    EXPECT_EQ(drawn, 8);
+}
+
+typedef DirtyTiles<4, 16, 3> Tiles;
+
+std::vector<uint8_t> Vram() {
+    std::vector<uint8_t> vram(4 * 16);
+    for (size_t i = 0; i < vram.size(); i++)
+        vram[i] = (uint8_t)i;
+    return vram;
+}
+
+TEST(DirtyTilesTest, CopiesWrittenTiles) {
+    const std::vector<uint8_t> vram = Vram();
+    Tiles tiles;
+    Tiles::Copies copies;
+    // All of VRAM until the first line.
+    EXPECT_FALSE(tiles.Take(vram.data(), copies));
+    EXPECT_EQ(copies.count, 0u);
+
+    tiles.Write(9, 1);
+    tiles.Write(10, 4);
+    tiles.Write(8, 2);
+    ASSERT_TRUE(tiles.Take(vram.data(), copies));
+    ASSERT_EQ(copies.count, 2u);
+
+    std::vector<uint8_t> copy(vram.size());
+    copies.Apply(copy.data());
+    for (size_t i = 0; i < copy.size(); i++)
+        EXPECT_EQ(copy[i], i >= 8 && i < 16 ? vram[i] : 0) << i;
+
+    // Nothing written since.
+    EXPECT_TRUE(tiles.Take(vram.data(), copies));
+    EXPECT_EQ(copies.count, 0u);
+}
+
+TEST(DirtyTilesTest, TooManyTilesCopyAll) {
+    const std::vector<uint8_t> vram = Vram();
+    Tiles tiles;
+    Tiles::Copies copies;
+    tiles.Take(vram.data(), copies);
+
+    for (uint32_t tile = 0; tile < 4; tile++)
+        tiles.Write(tile * 4, 1);
+    EXPECT_FALSE(tiles.Take(vram.data(), copies));
+    EXPECT_EQ(copies.count, 0u);
+
+    tiles.Write(0, 16);
+    EXPECT_FALSE(tiles.Take(vram.data(), copies));
+    tiles.Write(60, 8);
+    EXPECT_FALSE(tiles.Take(vram.data(), copies));
+    tiles.WriteAll();
+    EXPECT_FALSE(tiles.Take(vram.data(), copies));
+
+    // Starts over after each line.
+    tiles.Write(0, 1);
+    EXPECT_TRUE(tiles.Take(vram.data(), copies));
+    EXPECT_EQ(copies.count, 1u);
+}
+
+}  // namespace
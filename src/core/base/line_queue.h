@@ -0,0 +1,201 @@
+#ifndef VBAM_CORE_BASE_LINE_QUEUE_H_
+#define VBAM_CORE_BASE_LINE_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// The queue of the threaded renderers: the thread that emulates queues lines
+// for a worker thread to draw, in order. The lines are allocated once and
+// reused, so queueing a line costs a copy of the state it is drawn from.
+// Only one thread may queue lines.
+template <typename Line, unsigned kLines>
+class LineQueue {
+public:
+    // `draw` is called on the worker for each line.
+    explicit LineQueue(std::function<void(const Line&)> draw) : draw_(std::move(draw)) {}
+
+    ~LineQueue()
+    {
+        if (!worker_.joinable())
+            return;
+
+        Wait();
+        stop_ = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_.notify_one();
+        }
+        worker_.join();
+    }
+
+    LineQueue(const LineQueue&) = delete;
+    LineQueue& operator=(const LineQueue&) = delete;
+
+    // Returns the next free line of the queue, once there is one. Starts the
+    // worker on first use.
+    Line& Push()
+    {
+        if (!worker_.joinable()) {
+            lines_.reset(new Line[kLines]);
+            worker_ = std::thread(&LineQueue::WorkerMain, this);
+        }
+
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        while (head - tail_.load(std::memory_order_acquire) == kLines)
+            std::this_thread::yield();
+
+        return lines_[head % kLines];
+    }
+
+    // Hands the line returned by Push() over to the worker.
+    void Publish()
+    {
+        head_ = head_.load(std::memory_order_relaxed) + 1;
+        if (sleeping_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_.notify_one();
+        }
+    }
+
+    // Returns once the queued lines are drawn.
+    void Wait()
+    {
+        while (tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+    }
+
+private:
+    // Lines come every 60 to 100 us at full speed, so the worker spins a
+    // while before it sleeps.
+    static constexpr int kSpins = 2000;
+
+    void WorkerMain()
+    {
+        unsigned tail = tail_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            unsigned head = head_.load(std::memory_order_acquire);
+            for (int i = 0; head == tail && !stop_ && i < kSpins; i++) {
+                std::this_thread::yield();
+                head = head_.load(std::memory_order_acquire);
+            }
+
+            if (head == tail) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                sleeping_ = true;
+                wake_.wait(lock, [&] {
+                    head = head_;
+                    return head != tail || stop_;
+                });
+                sleeping_ = false;
+            }
+
+            if (stop_)
+                return;
+
+            for (; tail != head; tail++) {
+                draw_(lines_[tail % kLines]);
+                tail_.store(tail + 1, std::memory_order_release);
+            }
+        }
+    }
+
+    const std::function<void(const Line&)> draw_;
+    std::unique_ptr<Line[]> lines_;
+    std::thread worker_;
+    // Lines queued and drawn, counted since the start. head_ is sequentially
+    // consistent with sleeping_, so that either the worker sees a new line
+    // before it sleeps or the queueing thread sees it sleeping and wakes it.
+    std::atomic<unsigned> head_{0};
+    std::atomic<unsigned> tail_{0};
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stop_{false};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+};
+
+// The tiles of VRAM written since the last line was queued. A threaded
+// renderer draws from a VRAM of its own, and each line carries copies of the
+// tiles written before it, to be applied before the line is drawn. When more
+// tiles are written than a line carries, the renderer waits for the queued
+// lines and copies the whole of VRAM instead.
+template <uint32_t kTileSize, uint32_t kTiles, uint32_t kLineTiles>
+class DirtyTiles {
+public:
+    // The tiles a line carries.
+    struct Copies {
+        uint32_t count;
+        uint16_t index[kLineTiles];
+        uint8_t data[kLineTiles][kTileSize];
+
+        // Writes the tiles to `vram`, on the worker.
+        void Apply(uint8_t* vram) const
+        {
+            for (uint32_t i = 0; i < count; i++)
+                memcpy(&vram[index[i] * kTileSize], data[i], kTileSize);
+        }
+    };
+
+    // `size` bytes from `offset` on are about to be written.
+    void Write(uint32_t offset, uint32_t size)
+    {
+        if (all_ || size == 0)
+            return;
+
+        const uint32_t first = offset / kTileSize;
+        const uint32_t last = (offset + size - 1) / kTileSize;
+        if (last >= kTiles || last - first >= kLineTiles) {
+            all_ = true;
+            return;
+        }
+
+        for (uint32_t tile = first; tile <= last; tile++) {
+            if (dirty_[tile])
+                continue;
+            if (count_ == kLineTiles) {
+                all_ = true;
+                return;
+            }
+            dirty_[tile] = true;
+            index_[count_++] = (uint16_t)tile;
+        }
+    }
+
+    // The whole of VRAM may have changed.
+    void WriteAll() { all_ = true; }
+
+    // Copies the written tiles of `vram` into `copies` and starts over.
+    // Returns false, with no tiles copied, if the whole of VRAM is to be
+    // copied instead.
+    bool Take(const uint8_t* vram, Copies& copies)
+    {
+        const bool fits = !all_;
+        copies.count = fits ? count_ : 0;
+        for (uint32_t i = 0; i < count_; i++) {
+            const uint16_t tile = index_[i];
+            if (fits) {
+                copies.index[i] = tile;
+                memcpy(copies.data[i], &vram[tile * kTileSize], kTileSize);
+            }
+            dirty_[tile] = false;
+        }
+        count_ = 0;
+        all_ = false;
+        return fits;
+    }
+
+private:
+    bool dirty_[kTiles] = {};
+    uint16_t index_[kLineTiles];
+    uint32_t count_ = 0;
+    // Set until the first Take().
+    bool all_ = true;
+};
+
+#endif  // VBAM_CORE_BASE_LINE_QUEUE_H_
@@ -0,0 +1,276 @@
+#include "core/base/movie.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "core/base/system.h"
+
+// A movie file starts with "VBMV", the version, the keyframe interval and
+// the joypads per frame, as little-endian 32-bit ints. Blocks follow, each a
+// type byte and a 32-bit payload size:
+//   'K'  a keyframe: the frame it starts, then the emuWriteMemState() data
+//   'I'  inputs: the first frame, then the joypads of each frame
+// Recording writes the inputs before each keyframe and when it stops.
+
+namespace {
+
+constexpr uint32_t kVersion = 1;
+constexpr uint8_t kBlockKeyframe = 'K';
+constexpr uint8_t kBlockInputs = 'I';
+// Room for a memory state of either core.
+constexpr int kMaxStateSize = 1 << 20;
+
+struct Keyframe {
+    uint32_t frame;
+    long offset;
+    uint32_t size;
+};
+
+MovieState movieState = MOVIE_IDLE;
+const EmulatedSystem* movieSystem = nullptr;
+FILE* movieFile = nullptr;
+uint32_t movieInterval = 0;
+uint32_t movieFrame = 0;
+bool movieFailed = false;
+// Recording: the inputs since the last block. Playback: all of them.
+std::vector<uint32_t> movieInputs;
+uint32_t movieInputsStart = 0;
+std::vector<Keyframe> movieKeyframes;
+// Holds a keyframe while it is written or loaded.
+std::vector<char> movieBuffer;
+
+void put32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+uint32_t get32(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool movieWrite(const void* data, size_t size)
+{
+    if (size && fwrite(data, 1, size, movieFile) != size)
+        movieFailed = true;
+    return !movieFailed;
+}
+
+bool movieWriteBlock(uint8_t type, uint32_t first, const void* data, uint32_t size)
+{
+    uint8_t header[9];
+    header[0] = type;
+    put32(header + 1, size + 4);
+    put32(header + 5, first);
+    return movieWrite(header, sizeof(header)) && movieWrite(data, size);
+}
+
+bool movieFlushInputs()
+{
+    if (movieInputs.empty())
+        return true;
+    std::vector<uint8_t> data(movieInputs.size() * 4);
+    for (size_t i = 0; i < movieInputs.size(); i++)
+        put32(&data[i * 4], movieInputs[i]);
+    movieInputs.clear();
+    const bool ok = movieWriteBlock(kBlockInputs, movieInputsStart, data.data(), (uint32_t)data.size());
+    movieInputsStart = movieFrame;
+    return ok;
+}
+
+bool movieWriteKeyframe()
+{
+    long size = 0;
+    movieBuffer.resize(kMaxStateSize);
+    if (!movieSystem->emuWriteMemState(movieBuffer.data(), kMaxStateSize, size)) {
+        movieFailed = true;
+        return false;
+    }
+    return movieWriteBlock(kBlockKeyframe, movieFrame, movieBuffer.data(), (uint32_t)size);
+}
+
+bool movieLoadKeyframe(const Keyframe& k)
+{
+    movieBuffer.resize(k.size);
+    if (fseek(movieFile, k.offset, SEEK_SET) != 0
+        || fread(movieBuffer.data(), 1, k.size, movieFile) != k.size
+        || !movieSystem->emuReadMemState(movieBuffer.data(), (int)k.size))
+        return false;
+    movieFrame = k.frame;
+    return true;
+}
+
+// Reads the blocks of the movie opened for playback.
+bool movieScan()
+{
+    uint8_t header[9];
+    while (fread(header, 1, 1, movieFile) == 1) {
+        if (fread(header + 1, 1, 8, movieFile) != 8)
+            return false;
+        const uint8_t type = header[0];
+        const uint32_t size = get32(header + 1);
+        const uint32_t first = get32(header + 5);
+        if (size < 4)
+            return false;
+        const uint32_t payload = size - 4;
+
+        if (type == kBlockKeyframe) {
+            movieKeyframes.push_back({ first, ftell(movieFile), payload });
+            if (fseek(movieFile, payload, SEEK_CUR) != 0)
+                return false;
+        } else if (type == kBlockInputs) {
+            if (first * MOVIE_JOYPADS != movieInputs.size() || payload % (MOVIE_JOYPADS * 4))
+                return false;
+            std::vector<uint8_t> data(payload);
+            if (fread(data.data(), 1, payload, movieFile) != payload)
+                return false;
+            for (uint32_t i = 0; i < payload; i += 4)
+                movieInputs.push_back(get32(&data[i]));
+        } else {
+            return false;
+        }
+    }
+    return !movieKeyframes.empty() && movieKeyframes[0].frame == 0;
+}
+
+void movieClose()
+{
+    if (movieFile)
+        fclose(movieFile);
+    movieFile = nullptr;
+    movieState = MOVIE_IDLE;
+    movieInputs.clear();
+    movieKeyframes.clear();
+    movieBuffer.clear();
+    movieBuffer.shrink_to_fit();
+}
+
+}  // namespace
+
+bool movieStartRecording(const char* file, const EmulatedSystem* system, int keyframeInterval)
+{
+    movieStop();
+    if (!system->emuWriteMemState || !system->emuReadMemState)
+        return false;
+    movieFile = fopen(file, "wb");
+    if (!movieFile)
+        return false;
+
+    movieSystem = system;
+    movieInterval = keyframeInterval > 0 ? keyframeInterval : MOVIE_DEFAULT_KEYFRAME_INTERVAL;
+    movieFrame = 0;
+    movieInputsStart = 0;
+    movieFailed = false;
+
+    uint8_t header[16];
+    memcpy(header, "VBMV", 4);
+    put32(header + 4, kVersion);
+    put32(header + 8, movieInterval);
+    put32(header + 12, MOVIE_JOYPADS);
+    if (!movieWrite(header, sizeof(header)) || !movieWriteKeyframe()) {
+        movieClose();
+        return false;
+    }
+    movieState = MOVIE_RECORDING;
+    return true;
+}
+
+bool movieStartPlayback(const char* file, const EmulatedSystem* system)
+{
+    movieStop();
+    if (!system->emuReadMemState)
+        return false;
+    movieFile = fopen(file, "rb");
+    if (!movieFile)
+        return false;
+
+    movieSystem = system;
+    uint8_t header[16];
+    if (fread(header, 1, sizeof(header), movieFile) != sizeof(header)
+        || memcmp(header, "VBMV", 4) || get32(header + 4) != kVersion
+        || get32(header + 12) != MOVIE_JOYPADS || !movieScan()
+        || !movieLoadKeyframe(movieKeyframes[0])) {
+        movieClose();
+        return false;
+    }
+    movieInterval = get32(header + 8);
+    movieState = MOVIE_PLAYING;
+    return true;
+}
+
+bool movieStop()
+{
+    if (movieState == MOVIE_IDLE)
+        return true;
+    bool ok = true;
+    if (movieState == MOVIE_RECORDING)
+        ok = movieFlushInputs() && fflush(movieFile) == 0 && !movieFailed;
+    movieClose();
+    return ok;
+}
+
+MovieState movieGetState()
+{
+    return movieState;
+}
+
+uint32_t movieGetFrame()
+{
+    return movieFrame;
+}
+
+uint32_t movieGetLength()
+{
+    if (movieState == MOVIE_RECORDING)
+        return movieFrame;
+    return (uint32_t)(movieInputs.size() / MOVIE_JOYPADS);
+}
+
+bool movieSeek(uint32_t frame)
+{
+    if (movieState != MOVIE_PLAYING || frame > movieGetLength())
+        return false;
+
+    // The last keyframe at or before `frame`, unless going on from the
+    // current frame is closer.
+    const Keyframe* closest = nullptr;
+    for (const Keyframe& k : movieKeyframes) {
+        if (k.frame > frame)
+            break;
+        closest = &k;
+    }
+    if (frame < movieFrame || (closest && closest->frame > movieFrame)) {
+        if (!closest || !movieLoadKeyframe(*closest))
+            return false;
+    }
+
+    while (movieFrame < frame && movieState == MOVIE_PLAYING)
+        movieSystem->emuMain(movieSystem->emuCount);
+    return movieFrame == frame;
+}
+
+void movieUpdateJoypads(uint32_t* joypads, int count)
+{
+    if (movieState == MOVIE_RECORDING) {
+        if (movieFrame % movieInterval == 0 && movieFrame != 0) {
+            movieFlushInputs();
+            movieWriteKeyframe();
+        }
+        for (int i = 0; i < MOVIE_JOYPADS; i++)
+            movieInputs.push_back(i < count ? joypads[i] : 0);
+        movieFrame++;
+    } else if (movieState == MOVIE_PLAYING) {
+        if (movieFrame >= movieGetLength()) {
+            movieStop();
+            return;
+        }
+        const uint32_t* recorded = &movieInputs[movieFrame * MOVIE_JOYPADS];
+        for (int i = 0; i < count && i < MOVIE_JOYPADS; i++)
+            joypads[i] = recorded[i];
+        movieFrame++;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef VBAM_CORE_BASE_MOVIE_H_
+#define VBAM_CORE_BASE_MOVIE_H_
+
+#include <cstdint>
+
+struct EmulatedSystem;
+
+// Input movies for both cores. A movie holds the joypads of every frame and
+// a save state every `keyframeInterval` frames, so that playback can go to
+// any frame by loading the closest state before it and emulating at most
+// `keyframeInterval` frames. A frame is one emuMain() call; the cores pass
+// their joypads through movieUpdateJoypads() at the start of each.
+
+enum MovieState {
+    MOVIE_IDLE,
+    MOVIE_RECORDING,
+    MOVIE_PLAYING
+};
+
+// Joypads recorded per frame, enough for the four of SGB multiplayer.
+#define MOVIE_JOYPADS 4
+#define MOVIE_DEFAULT_KEYFRAME_INTERVAL 600
+
+#if defined(__LIBRETRO__)
+
+inline void movieUpdateJoypads(uint32_t*, int) {}
+
+#else
+
+// Starts recording from the current state of `system`, which must stay valid
+// until movieStop().
+bool movieStartRecording(const char* file, const EmulatedSystem* system, int keyframeInterval);
+// Loads the first state of the movie in `file` into `system` and plays the
+// movie back from there.
+bool movieStartPlayback(const char* file, const EmulatedSystem* system);
+// Ends the recording or the playback. Returns false if writing failed.
+bool movieStop();
+
+MovieState movieGetState();
+// The frame about to be emulated.
+uint32_t movieGetFrame();
+// The frames in the movie being played or recorded.
+uint32_t movieGetLength();
+// Goes to `frame` during playback, emulating the frames from the closest
+// state with emuMain(). Returns false if the movie is shorter.
+bool movieSeek(uint32_t frame);
+
+// Hook for the cores, called at the start of each frame with their
+// `count` joypads. Records them or replaces them with the recorded ones.
+// Playback stops once the last recorded frame has been used.
+void movieUpdateJoypads(uint32_t* joypads, int count);
+
+#endif  // defined(__LIBRETRO__)
+
+#endif  // VBAM_CORE_BASE_MOVIE_H_
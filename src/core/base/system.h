@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "core/base/sound_driver.h"
 
@@ -29,6 +30,8 @@ struct EmulatedSystem {
     // load state
     unsigned (*emuWriteState)(uint8_t*);
 #else
+    // copy the battery image, empty without a battery (BatteryWriter)
+    bool (*emuWriteBatteryMem)(std::vector<uint8_t>&);
     // load state
     bool (*emuReadState)(const char*);
     // save state
@@ -60,6 +63,13 @@ extern struct CoreOptions {
     bool speedup = false;
     bool speedup_throttle_frame_skip = false;
     bool speedup_mute = true;
+    // Emulates without rendering any frame, e.g. for frames that are not shown.
+    bool skipRender = false;
+    // Draws mid-line changes to the display registers, the palette and OAM
+    // where they happen, at a cost. Set per ROM.
+    bool accurateRendering = false;
+    // Draws GBA and GB lines on a thread of its own. Not in libretro builds.
+    bool threadedRendering = false;
     int cheatsEnabled = 1;
     int cpuDisableSfx = 0;
     int cpuSaveType = 0;
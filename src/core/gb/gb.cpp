@@ -10,12 +10,14 @@
 #include "core/base/check.h"
 #include "core/base/file_util.h"
 #include "core/base/message.h"
+#include "core/base/movie.h"
 #include "core/base/sizes.h"
 #include "core/base/system.h"
 #include "core/gb/gbCheats.h"
 #include "core/gb/gbGfx.h"
 #include "core/gb/gbGlobals.h"
 #include "core/gb/gbMemory.h"
+#include "core/gb/gbRenderer.h"
 #include "core/gb/gbSGB.h"
 #include "core/gb/gbSound.h"
 #include "core/gba/gbaSound.h"
@@ -137,6 +139,22 @@ bool WriteBatteryFile(const char* file_name) {
     return true;
 }
 
+bool WriteBatteryMem(std::vector<uint8_t>& image) {
+    image.clear();
+    if (g_gbBatteryError) {
+        return false;
+    }
+    if (!g_gbCartData.has_battery()) {
+        return true;
+    }
+
+    for (const VBamIoVec& vec : g_vbamIoVecs) {
+        const uint8_t* data = static_cast<const uint8_t*>(vec.data);
+        image.insert(image.end(), data, data + vec.length);
+    }
+    return true;
+}
+
 bool ReadBatteryFile(const char* file_name) {
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
     if (!g_gbCartData.has_battery()) {
@@ -641,6 +659,8 @@ int gbSpeed = 0;
 int gbFrameCount = 0;
 int gbFrameSkip = 0;
 int gbFrameSkipCount = 0;
+// The frame being emulated is not rendered.
+static bool gbRenderOff = false;
 // timing
 uint32_t gbLastTime = 0;
 int gbSynchronizeTicks = GBSYNCHRONIZE_CLOCK_TICKS;
@@ -1256,6 +1276,9 @@ bool gbIsGameboyRom(char* file)
 
 void gbCopyMemory(uint16_t d, uint16_t s, int count)
 {
+    if ((d & 0xe000) == 0x8000)
+        gbRendererVramWrite(d, count);
+
     while (count) {
         gbMemoryMap[d >> 12][d & 0x0fff] = gbMemoryMap[s >> 12][s & 0x0fff];
         s++;
@@ -1345,8 +1368,10 @@ void gbWriteMemory(uint16_t address, uint8_t value)
 
     if (address < 0xa000) {
 
-        if (gbVramWriteAccessValid())
+        if (gbVramWriteAccessValid()) {
+            gbRendererVramWrite(address, 1);
             gbMemoryMap[address >> 12][address & 0x0fff] = value;
+        }
         return;
     }
 
@@ -3138,6 +3163,7 @@ void gbReset()
 
     gbLastTime = systemGetClock();
     gbFrameCount = 0;
+    gbRenderOff = false;
 
     gbScreenOn = true;
     gbSystemMessage = false;
@@ -3884,15 +3910,15 @@ int gbGetNextEvent(int _clockTicks)
     return _clockTicks;
 }
 
-void gbDrawLine()
+void gbDrawLine(int y)
 {
     switch (systemColorDepth) {
     case 16: {
 #ifdef __LIBRETRO__
-        uint16_t* dest = (uint16_t*)g_pix + gbBorderLineSkip * (register_LY + gbBorderRowSkip)
+        uint16_t* dest = (uint16_t*)g_pix + gbBorderLineSkip * (y + gbBorderRowSkip)
             + gbBorderColumnSkip;
 #else
-        uint16_t* dest = (uint16_t*)g_pix + (gbBorderLineSkip + 2) * (register_LY + gbBorderRowSkip + 1)
+        uint16_t* dest = (uint16_t*)g_pix + (gbBorderLineSkip + 2) * (y + gbBorderRowSkip + 1)
             + gbBorderColumnSkip;
 #endif
         for (size_t x = 0; x < kGBWidth;) {
@@ -3924,7 +3950,7 @@ void gbDrawLine()
     } break;
 
     case 24: {
-        uint8_t* dest = (uint8_t*)g_pix + 3 * (gbBorderLineSkip * (register_LY + gbBorderRowSkip) + gbBorderColumnSkip);
+        uint8_t* dest = (uint8_t*)g_pix + 3 * (gbBorderLineSkip * (y + gbBorderRowSkip) + gbBorderColumnSkip);
         for (size_t x = 0; x < kGBWidth;) {
             *((uint32_t*)dest) = systemColorMap32[gbLineMix[x++]];
             dest += 3;
@@ -3966,10 +3992,10 @@ void gbDrawLine()
 
     case 32: {
 #ifdef __LIBRETRO__
-        uint32_t* dest = (uint32_t*)g_pix + gbBorderLineSkip * (register_LY + gbBorderRowSkip)
+        uint32_t* dest = (uint32_t*)g_pix + gbBorderLineSkip * (y + gbBorderRowSkip)
             + gbBorderColumnSkip;
 #else
-        uint32_t* dest = (uint32_t*)g_pix + (gbBorderLineSkip + 1) * (register_LY + gbBorderRowSkip + 1)
+        uint32_t* dest = (uint32_t*)g_pix + (gbBorderLineSkip + 1) * (y + gbBorderRowSkip + 1)
             + gbBorderColumnSkip;
 #endif
         for (size_t x = 0; x < kGBWidth;) {
@@ -4014,13 +4040,14 @@ static void gbUpdateJoypads() {
             gbJoymask[0] = systemReadJoypad(-1);
         }
     }
+    movieUpdateJoypads((uint32_t*)gbJoymask, 4);
 
     if (g_gbCartData.has_sensor()) {
         systemUpdateMotionSensor();
     }
 }
 
-void gbEmulate(int ticksToStop)
+static void gbEmulateLoop(int ticksToStop)
 {
     gbRegister tempRegister;
     uint8_t tempValue;
@@ -4286,7 +4313,7 @@ void gbEmulate(int ticksToStop)
                         // OAM being accessed mode
                         // next mode is OAM and VRAM in use
                         if ((gbScreenOn) && (register_LCDC & 0x80)) {
-                            gbDrawSprites(false);
+                            gbCountSprites();
                             // Used to add a one tick delay when a window line is drawn.
                             //(fixes a part of Carmaggedon problem)
                             if ((register_LCDC & 0x01 || gbCgbMode) && (register_LCDC & 0x20) && (gbWindowLine != -2)) {
@@ -4416,6 +4443,9 @@ void gbEmulate(int ticksToStop)
                             gbLcdTicksDelayed += GBLCD_MODE_1_CLOCK_TICKS;
                             gbLcdModeDelayed = 1;
 
+                            if (!gbRenderOff)
+                                gbRenderer->EndFrame();
+
                             gbFrameCount++;
                             systemFrame();
                             gbSoundTick(soundTicks);
@@ -4454,11 +4484,11 @@ void gbEmulate(int ticksToStop)
                             }
                             gbCapturePrevious = gbCapture;
 
-                            if (gbFrameSkipCount >= framesToSkip) {
+                            if (!gbRenderOff) {
 
                                 if (!gbSgbMask) {
                                     if (gbBorderOn)
-                                        gbSgbRenderBorder();
+                                        gbRenderer->DrawBorder();
                                     //if (gbScreenOn)
                                     systemDrawScreen();
                                     if (systemPauseOnFrame())
@@ -4466,7 +4496,8 @@ void gbEmulate(int ticksToStop)
                                 }
                                 gbFrameSkipCount = 0;
                             } else {
-                                gbFrameSkipCount++;
+                                if (gbFrameSkipCount < framesToSkip)
+                                    gbFrameSkipCount++;
                                 systemSendScreen();
                             }
 
@@ -4503,13 +4534,22 @@ void gbEmulate(int ticksToStop)
 
                         // OAM and VRAM in use
                         // next mode is H-Blank
+                        // A frame is rendered or skipped as a whole.
+                        if (register_LY == 0) {
+                            gbRenderOff = coreOptions.skipRender || gbFrameSkipCount < framesToSkip;
+                            if (!gbRenderOff) {
+                                gbSelectRenderer();
+                                gbRenderer->StartFrame();
+                            }
+                        }
+
                         if ((register_LY < kGBHeight) && (register_LCDC & 0x80) && gbScreenOn) {
                             if (!gbSgbMask) {
-                                if (gbFrameSkipCount >= framesToSkip) {
+                                if (!gbRenderOff) {
                                     if (!gbBlackScreen) {
-                                        gbRenderLine();
-                                        gbDrawSprites(true);
+                                        gbRenderer->EndLine();
                                     } else if (gbBlackScreen) {
+                                        gbRenderer->Flush();
                                         uint16_t color = gbColorOption ? gbColorFilter[0] : 0;
                                         if (!gbCgbMode)
                                             color = gbColorOption ? gbColorFilter[gbPalette[3] & 0x7FFF] : gbPalette[3] & 0x7FFF;
@@ -4517,8 +4557,8 @@ void gbEmulate(int ticksToStop)
                                             gbLineMix[i] = color;
                                             gbLineBuffer[i] = 0;
                                         }
+                                        gbDrawLine(register_LY);
                                     }
-                                    gbDrawLine();
                                 }
                             }
                         }
@@ -4573,6 +4613,7 @@ void gbEmulate(int ticksToStop)
                 }
                 if (gbScreenTicks <= 0) {
                     gbWhiteScreen = 1;
+                    gbRenderer->Flush();
                     uint8_t register_LYLcdOff = ((register_LY + 154) % 154);
                     for (register_LY = 0; register_LY <= 0x90; register_LY++) {
                         uint16_t color = gbColorOption ? gbColorFilter[0x7FFF] : 0x7FFF;
@@ -4582,7 +4623,7 @@ void gbEmulate(int ticksToStop)
                             gbLineMix[i] = color;
                             gbLineBuffer[i] = 0;
                         }
-                        gbDrawLine();
+                        gbDrawLine(register_LY);
                     }
                     register_LY = register_LYLcdOff;
                 }
@@ -4595,6 +4636,7 @@ void gbEmulate(int ticksToStop)
                     register_LY = ((register_LY + 1) % 154);
                     gbLcdLYIncrementTicks += GBLY_INCREMENT_CLOCK_TICKS;
                     if (register_LY < kGBHeight) {
+                        gbRenderer->Flush();
 
                         uint16_t color = gbColorOption ? gbColorFilter[0x7FFF] : 0x7FFF;
                         if (!gbCgbMode)
@@ -4603,7 +4645,7 @@ void gbEmulate(int ticksToStop)
                             gbLineMix[i] = color;
                             gbLineBuffer[i] = 0;
                         }
-                        gbDrawLine();
+                        gbDrawLine(register_LY);
                     } else if ((register_LY == kGBHeight) && (!systemFrameSkip)) {
                         int framesToSkip = systemFrameSkip;
                         //if (coreOptions.speedup)
@@ -4897,6 +4939,13 @@ void gbEmulate(int ticksToStop)
     }
 }
 
+void gbEmulate(int ticksToStop)
+{
+    gbEmulateLoop(ticksToStop);
+    // Whatever runs next, e.g. a savestate, may change the emulator state.
+    gbRenderer->Flush();
+}
+
 bool gbLoadRomData(const char* data, size_t size) {
     if (gbRom != nullptr) {
         gbCleanUp();
@@ -5276,6 +5325,8 @@ struct EmulatedSystem GBSystem = {
     ReadBatteryFile,
     // emuWriteBattery
     WriteBatteryFile,
+    // emuWriteBatteryMem
+    WriteBatteryMem,
     // emuReadState
     gbReadSaveState,
     // emuWriteState
@@ -45,37 +45,90 @@ uint16_t gbLineMix[160];
 uint16_t gbWindowColor[160];
 extern int inUseRegister_WY;
 
-void gbRenderLine()
+void gbBeginLine(GBLineState& state)
 {
-    memset(gbLineMix, 0, sizeof(gbLineMix));
-    uint8_t* bank0;
-    uint8_t* bank1;
+    state.ly = register_LY;
+    state.speed = gbSpeed;
+    state.lcdc = register_LCDC;
+    state.wx = register_WX;
+    state.windowLine = -1;
+    state.windowY = 0;
+    state.dmgCompat = (gbMemory[0xff6c] & 1) != 0;
+    state.scyLine = gbSCYLine;
+    state.scxLine = gbSCXLine;
+    state.bgpLine = gbBgpLine;
+    state.obp0Line = gbObp0Line;
+    state.obp1Line = gbObp1Line;
+    state.spritesTicks = gbSpritesTicks;
+    state.bgp = gbBgp;
+    state.palette = gbPalette;
+    state.oam = &gbMemory[0xfe00];
     if (gbCgbMode) {
-        bank0 = &gbVram[0x0000];
-        bank1 = &gbVram[0x2000];
+        state.bank0 = &gbVram[0x0000];
+        state.bank1 = &gbVram[0x2000];
     } else {
-        bank0 = &gbMemory[0x8000];
-        bank1 = nullptr;
+        state.bank0 = &gbMemory[0x8000];
+        state.bank1 = nullptr;
     }
 
+    if (!(register_LCDC & 0x80))
+        return;
+
+    // LCDC.0 also enables/disables the window in !gbCgbMode ?!?!
+    // (tested on real hardware)
+    // This fixes Last Bible II & Zankurou Musouken
+    if ((register_LCDC & 0x01 || gbCgbMode) && (register_LCDC & 0x20) && (coreOptions.layerSettings & 0x2000) && (gbWindowLine != -2)) {
+        // Fix (accurate emulation) for most of the window display problems
+        // (ie. Zen - Intergalactic Ninja, Urusei Yatsura...).
+        if ((gbWindowLine == -1) || (gbWindowLine > 144)) {
+            inUseRegister_WY = oldRegister_WY;
+            if (register_LY > oldRegister_WY)
+                gbWindowLine = 146;
+        }
+
+        if (register_LY >= inUseRegister_WY) {
+
+            if ((gbWindowLine == -1) || (gbWindowLine > 144))
+                gbWindowLine = 0;
+
+            if (register_WX - 7 <= 159 && gbWindowLine <= 143) {
+                state.windowLine = gbWindowLine++;
+                state.windowY = inUseRegister_WY;
+            }
+        }
+    } else if (gbWindowLine == -2) {
+        inUseRegister_WY = oldRegister_WY;
+        if (register_LY > oldRegister_WY)
+            gbWindowLine = 146;
+        else
+            gbWindowLine = 0;
+    }
+}
+
+void gbRenderLine(const GBLineState& state)
+{
+    memset(gbLineMix, 0, sizeof(gbLineMix));
+    const uint8_t* bank0 = state.bank0;
+    const uint8_t* bank1 = state.bank1;
+
     int tile_map = 0x1800;
-    if ((register_LCDC & 8) != 0)
+    if ((state.lcdc & 8) != 0)
         tile_map = 0x1c00;
 
     int tile_pattern = 0x0800;
 
-    if ((register_LCDC & 16) != 0)
+    if ((state.lcdc & 16) != 0)
         tile_pattern = 0x0000;
 
     int x = 0;
-    int y = register_LY;
+    int y = state.ly;
 
     if (y >= 144)
         return;
 
-    int SpritesTicks = gbSpritesTicks[x] * (gbSpeed ? 2 : 4);
-    int sx = gbSCXLine[(gbSpeed ? 0 : 4) + SpritesTicks];
-    int sy = gbSCYLine[(gbSpeed ? 11 : 5) + SpritesTicks];
+    int SpritesTicks = state.spritesTicks[x] * (state.speed ? 2 : 4);
+    int sx = state.scxLine[(state.speed ? 0 : 4) + SpritesTicks];
+    int sy = state.scyLine[(state.speed ? 11 : 5) + SpritesTicks];
 
     sy += y;
 
@@ -99,13 +152,13 @@ void gbRenderLine()
 
     tile_map_address++;
 
-    if (!(register_LCDC & 0x10))
+    if (!(state.lcdc & 0x10))
         tile ^= 0x80;
 
     int tile_pattern_address = tile_pattern + tile * 16 + by * 2;
 
-    if (register_LCDC & 0x80) {
-        if ((register_LCDC & 0x01 || gbCgbMode) && (coreOptions.layerSettings & 0x0100)) {
+    if (state.lcdc & 0x80) {
+        if ((state.lcdc & 0x01 || gbCgbMode) && (coreOptions.layerSettings & 0x0100)) {
             while (x < 160) {
 
                 uint8_t tile_a = 0;
@@ -139,13 +192,13 @@ void gbRenderLine()
 
                     if (gbCgbMode) {
                         // Use the DMG palette if we are in compat mode.
-                        if (gbMemory[0xff6c] & 1) {
-                            c = gbBgp[c];
+                        if (state.dmgCompat) {
+                            c = state.bgp[c];
                         } else {
                             c = c + (attrs & 7) * 4;
                         }
                     } else {
-                        c = (gbBgpLine[x + (gbSpeed ? 5 : 11) + SpritesTicks] >> (c << 1)) & 3;
+                        c = (state.bgpLine[x + (state.speed ? 5 : 11) + SpritesTicks] >> (c << 1)) & 3;
                         if (gbSgbMode && !gbCgbMode) {
                             int dx = x >> 3;
                             int dy = y >> 3;
@@ -158,7 +211,7 @@ void gbRenderLine()
                             c = c + 4 * palette;
                         }
                     }
-                    gbLineMix[x] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+                    gbLineMix[x] = gbColorOption ? gbColorFilter[state.palette[c] & 0x7FFF] : state.palette[c] & 0x7FFF;
                     x++;
                     if (x >= 160)
                         break;
@@ -167,11 +220,11 @@ void gbRenderLine()
 
                 bx = 128;
 
-                SpritesTicks = gbSpritesTicks[x] * (gbSpeed ? 2 : 4);
+                SpritesTicks = state.spritesTicks[x] * (state.speed ? 2 : 4);
 
-                sx = gbSCXLine[x + (gbSpeed ? 0 : 4) + SpritesTicks];
+                sx = state.scxLine[x + (state.speed ? 0 : 4) + SpritesTicks];
 
-                sy = gbSCYLine[x + (gbSpeed ? 11 : 5) + SpritesTicks];
+                sy = state.scyLine[x + (state.speed ? 11 : 5) + SpritesTicks];
 
                 tx = ((sx + x) >> 3) & 0x1f;
 
@@ -194,7 +247,7 @@ void gbRenderLine()
 
                 tile = bank0[tile_map_line_y + tx];
 
-                if (!(register_LCDC & 0x10))
+                if (!(state.lcdc & 0x10))
                     tile ^= 0x80;
 
                 tile_pattern_address = tile_pattern + tile * 16 + by * 2;
@@ -206,189 +259,159 @@ void gbRenderLine()
             for (int i = 0; i < 160; i++) {
                 uint16_t color = gbColorOption ? gbColorFilter[0x7FFF] : 0x7FFF;
                 if (!gbCgbMode)
-                    color = gbColorOption ? gbColorFilter[gbPalette[gbBgpLine[i + (gbSpeed ? 5 : 11) + gbSpritesTicks[i] * (gbSpeed ? 2 : 4)] & 3] & 0x7FFF] : gbPalette[gbBgpLine[i + (gbSpeed ? 5 : 11) + gbSpritesTicks[i] * (gbSpeed ? 2 : 4)] & 3] & 0x7FFF;
+                    color = gbColorOption ? gbColorFilter[state.palette[state.bgpLine[i + (state.speed ? 5 : 11) + state.spritesTicks[i] * (state.speed ? 2 : 4)] & 3] & 0x7FFF] : state.palette[state.bgpLine[i + (state.speed ? 5 : 11) + state.spritesTicks[i] * (state.speed ? 2 : 4)] & 3] & 0x7FFF;
                 gbLineMix[i] = color;
                 gbLineBuffer[i] = 0;
             }
         }
 
         // do the window display
-        // LCDC.0 also enables/disables the window in !gbCgbMode ?!?!
-        // (tested on real hardware)
-        // This fixes Last Bible II & Zankurou Musouken
-        if ((register_LCDC & 0x01 || gbCgbMode) && (register_LCDC & 0x20) && (coreOptions.layerSettings & 0x2000) && (gbWindowLine != -2)) {
+        if (state.windowLine >= 0) {
             int i = 0;
-            // Fix (accurate emulation) for most of the window display problems
-            // (ie. Zen - Intergalactic Ninja, Urusei Yatsura...).
-            if ((gbWindowLine == -1) || (gbWindowLine > 144)) {
-                inUseRegister_WY = oldRegister_WY;
-                if (register_LY > oldRegister_WY)
-                    gbWindowLine = 146;
-                // for (i = 0; i<160; i++)
-                //   gbWindowColor[i] = gbLineMix[i];
-            }
-
-            int wy = inUseRegister_WY;
+            int wy = state.windowY;
+            int wx = state.wx;
+            int swx = 0;
+            wx -= 7;
 
-            if (y >= inUseRegister_WY) {
+            tile_map = 0x1800;
 
-                if ((gbWindowLine == -1) || (gbWindowLine > 144))
-                    gbWindowLine = 0;
+            if ((state.lcdc & 0x40) != 0)
+                tile_map = 0x1c00;
 
-                int wx = register_WX;
-                int swx = 0;
-                wx -= 7;
+            tx = 0;
+            ty = state.windowLine >> 3;
 
-                if (wx <= 159 && gbWindowLine <= 143) {
+            bx = 128;
+            by = state.windowLine & 7;
 
-                    tile_map = 0x1800;
+            // Tries to emulate the 'window scrolling bug' when wx == 0 (ie. wx-7 == -7).
+            // Nothing close to perfect, but good enought for now...
+            if (wx == -7) {
+                swx = 7 - ((state.scxLine[0] - 1) & 7);
+                bx >>= ((state.scxLine[0] + ((swx != 1) ? 1 : 0)) & 7);
+                if (swx == 1)
+                    swx = 2;
 
-                    if ((register_LCDC & 0x40) != 0)
-                        tile_map = 0x1c00;
+                //bx >>= ((state.scxLine[0]+(((swx>1) && (swx != 7)) ? 1 : 0)) & 7);
 
-                    tx = 0;
-                    ty = gbWindowLine >> 3;
-
-                    bx = 128;
-                    by = gbWindowLine & 7;
+                if (swx == 7) {
+                    //wx = 0;
+                    if ((state.windowLine > 0) || (wy == 0))
+                        swx = 0;
+                }
+            } else if (wx < 0) {
+                bx >>= (-wx);
+                wx = 0;
+            }
 
-                    // Tries to emulate the 'window scrolling bug' when wx == 0 (ie. wx-7 == -7).
-                    // Nothing close to perfect, but good enought for now...
-                    if (wx == -7) {
-                        swx = 7 - ((gbSCXLine[0] - 1) & 7);
-                        bx >>= ((gbSCXLine[0] + ((swx != 1) ? 1 : 0)) & 7);
-                        if (swx == 1)
-                            swx = 2;
+            tile_map_line_y = tile_map + ty * 32;
 
-                        //bx >>= ((gbSCXLine[0]+(((swx>1) && (swx != 7)) ? 1 : 0)) & 7);
+            tile_map_address = tile_map_line_y + tx;
 
-                        if (swx == 7) {
-                            //wx = 0;
-                            if ((gbWindowLine > 0) || (wy == 0))
-                                swx = 0;
-                        }
-                    } else if (wx < 0) {
-                        bx >>= (-wx);
-                        wx = 0;
-                    }
+            x = wx;
 
-                    tile_map_line_y = tile_map + ty * 32;
+            tile = bank0[tile_map_address];
+            uint8_t attrs = 0;
+            if (bank1)
+                attrs = bank1[tile_map_address];
+            tile_map_address++;
 
-                    tile_map_address = tile_map_line_y + tx;
+            if ((state.lcdc & 16) == 0) {
+                if (tile < 128)
+                    tile += 128;
+                else
+                    tile -= 128;
+            }
 
-                    x = wx;
+            tile_pattern_address = tile_pattern + tile * 16 + by * 2;
 
-                    tile = bank0[tile_map_address];
-                    uint8_t attrs = 0;
-                    if (bank1)
-                        attrs = bank1[tile_map_address];
-                    tile_map_address++;
+            if (wx)
+                for (i = 0; i < swx; i++)
+                    gbLineMix[i] = gbWindowColor[i];
 
-                    if ((register_LCDC & 16) == 0) {
-                        if (tile < 128)
-                            tile += 128;
-                        else
-                            tile -= 128;
-                    }
+            while (x < 160) {
+                uint8_t tile_a = 0;
+                uint8_t tile_b = 0;
 
-                    tile_pattern_address = tile_pattern + tile * 16 + by * 2;
+                if (attrs & 0x40) {
+                    tile_pattern_address = tile_pattern + tile * 16 + (7 - by) * 2;
+                }
 
-                    if (wx)
-                        for (i = 0; i < swx; i++)
-                            gbLineMix[i] = gbWindowColor[i];
+                if (attrs & 0x08) {
+                    tile_a = bank1[tile_pattern_address++];
+                    tile_b = bank1[tile_pattern_address];
+                } else {
+                    tile_a = bank0[tile_pattern_address++];
+                    tile_b = bank0[tile_pattern_address];
+                }
 
-                    while (x < 160) {
-                        uint8_t tile_a = 0;
-                        uint8_t tile_b = 0;
+                if (attrs & 0x20) {
+                    tile_a = gbInvertTab[tile_a];
+                    tile_b = gbInvertTab[tile_b];
+                }
 
-                        if (attrs & 0x40) {
-                            tile_pattern_address = tile_pattern + tile * 16 + (7 - by) * 2;
-                        }
+                while (bx > 0) {
+                    uint8_t c = (tile_a & bx) != 0 ? 1 : 0;
+                    c += ((tile_b & bx) != 0 ? 2 : 0);
 
-                        if (attrs & 0x08) {
-                            tile_a = bank1[tile_pattern_address++];
-                            tile_b = bank1[tile_pattern_address];
+                    if (x >= 0) {
+                        if (attrs & 0x80)
+                            gbLineBuffer[x] = 0x300 + c;
+                        else
+                            gbLineBuffer[x] = 0x100 + c;
+
+                        if (gbCgbMode) {
+                            // Use the DMG palette if we are in compat mode.
+                            if (state.dmgCompat) {
+                                c = state.bgp[c];
+                            } else {
+                                c = c + (attrs & 7) * 4;
+                            }
                         } else {
-                            tile_a = bank0[tile_pattern_address++];
-                            tile_b = bank0[tile_pattern_address];
-                        }
+                            c = (state.bgpLine[x + (state.speed ? 5 : 11) + state.spritesTicks[x] * (state.speed ? 2 : 4)] >> (c << 1)) & 3;
+                            if (gbSgbMode && !gbCgbMode) {
+                                int dx = x >> 3;
+                                int dy = y >> 3;
 
-                        if (attrs & 0x20) {
-                            tile_a = gbInvertTab[tile_a];
-                            tile_b = gbInvertTab[tile_b];
-                        }
+                                int palette = gbSgbATF[dy * 20 + dx];
+
+                                if (c == 0)
+                                    palette = 0;
 
-                        while (bx > 0) {
-                            uint8_t c = (tile_a & bx) != 0 ? 1 : 0;
-                            c += ((tile_b & bx) != 0 ? 2 : 0);
-
-                            if (x >= 0) {
-                                if (attrs & 0x80)
-                                    gbLineBuffer[x] = 0x300 + c;
-                                else
-                                    gbLineBuffer[x] = 0x100 + c;
-
-                                if (gbCgbMode) {
-                                    // Use the DMG palette if we are in compat mode.
-                                    if (gbMemory[0xff6c] & 1) {
-                                        c = gbBgp[c];
-                                    } else {
-                                        c = c + (attrs & 7) * 4;
-                                    }
-                                } else {
-                                    c = (gbBgpLine[x + (gbSpeed ? 5 : 11) + gbSpritesTicks[x] * (gbSpeed ? 2 : 4)] >> (c << 1)) & 3;
-                                    if (gbSgbMode && !gbCgbMode) {
-                                        int dx = x >> 3;
-                                        int dy = y >> 3;
-
-                                        int palette = gbSgbATF[dy * 20 + dx];
-
-                                        if (c == 0)
-                                            palette = 0;
-
-                                        c = c + 4 * palette;
-                                    }
-                                }
-                                gbLineMix[x] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+                                c = c + 4 * palette;
                             }
-                            x++;
-                            if (x >= 160)
-                                break;
-                            bx >>= 1;
                         }
-                        tx++;
-                        if (tx == 32)
-                            tx = 0;
-                        bx = 128;
-                        tile = bank0[tile_map_line_y + tx];
-                        if (bank1)
-                            attrs = bank1[tile_map_line_y + tx];
-
-                        if ((register_LCDC & 16) == 0) {
-                            if (tile < 128)
-                                tile += 128;
-                            else
-                                tile -= 128;
-                        }
-                        tile_pattern_address = tile_pattern + tile * 16 + by * 2;
+                        gbLineMix[x] = gbColorOption ? gbColorFilter[state.palette[c] & 0x7FFF] : state.palette[c] & 0x7FFF;
                     }
+                    x++;
+                    if (x >= 160)
+                        break;
+                    bx >>= 1;
+                }
+                tx++;
+                if (tx == 32)
+                    tx = 0;
+                bx = 128;
+                tile = bank0[tile_map_line_y + tx];
+                if (bank1)
+                    attrs = bank1[tile_map_line_y + tx];
 
-                    //for (i = swx; i<160; i++)
-                    //  gbLineMix[i] = gbWindowColor[i];
-                    gbWindowLine++;
+                if ((state.lcdc & 16) == 0) {
+                    if (tile < 128)
+                        tile += 128;
+                    else
+                        tile -= 128;
                 }
+                tile_pattern_address = tile_pattern + tile * 16 + by * 2;
             }
-        } else if (gbWindowLine == -2) {
-            inUseRegister_WY = oldRegister_WY;
-            if (register_LY > oldRegister_WY)
-                gbWindowLine = 146;
-            else
-                gbWindowLine = 0;
+
+            //for (i = swx; i<160; i++)
+            //  gbLineMix[i] = gbWindowColor[i];
         }
     } else {
         uint16_t color = gbColorOption ? gbColorFilter[0x7FFF] : 0x7FFF;
         if (!gbCgbMode)
-            color = gbColorOption ? gbColorFilter[gbPalette[0] & 0x7FFF] : gbPalette[0] & 0x7FFF;
+            color = gbColorOption ? gbColorFilter[state.palette[0] & 0x7FFF] : state.palette[0] & 0x7FFF;
         for (int i = 0; i < 160; i++) {
             gbLineMix[i] = color;
             gbLineBuffer[i] = 0;
@@ -396,33 +419,28 @@ void gbRenderLine()
     }
 }
 
-void gbDrawSpriteTile(int tile, int x, int y, int t, int flags,
+void gbDrawSpriteTile(const GBLineState& state, int tile, int x, int y, int t, int flags,
     int size, int spriteNumber)
 {
-    uint8_t* bank0;
-    uint8_t* bank1;
-    if (gbCgbMode) {
-        bank0 = &gbVram[0x0000];
-        bank1 = &gbVram[0x2000];
-    } else {
-        bank0 = &gbMemory[0x8000];
-        bank1 = nullptr;
-    }
+    const uint8_t* bank0 = state.bank0;
+    const uint8_t* bank1 = state.bank1;
 
-    int SpritesTicks = gbSpritesTicks[x + 8] * (gbSpeed ? 2 : 4);
+    int SpritesTicks = state.spritesTicks[x + 8] * (state.speed ? 2 : 4);
     int index = x + 11 + SpritesTicks;
 
+    uint8_t obp0[4];
+    uint8_t obp1[4];
     for (int i = 0; i < 4; i++) {
-        gbObp0[i] = (gbObp0Line[index] >> (i << 1)) & 3;
-        gbObp1[i] = (gbObp1Line[index] >> (i << 1)) & 3;
+        obp0[i] = (state.obp0Line[index] >> (i << 1)) & 3;
+        obp1[i] = (state.obp1Line[index] >> (i << 1)) & 3;
     }
-    uint8_t* pal = gbObp0;
+    uint8_t* pal = obp0;
 
     int flipx = (flags & 0x20);
     int flipy = (flags & 0x40);
 
     if ((flags & 0x10))
-        pal = gbObp1;
+        pal = obp1;
 
     if (flipy) {
         t = (size ? 15 : 7) - t;
@@ -463,17 +481,17 @@ void gbDrawSpriteTile(int tile, int x, int y, int t, int flags,
         uint16_t color = gbLineBuffer[xxx];
 
         // Fixes OAM-BG priority
-        if (prio && (register_LCDC & 1)) {
+        if (prio && (state.lcdc & 1)) {
             if (color < 0x200 && ((color & 0xFF) != 0))
                 continue;
         }
         // Fixes OAM-BG priority for Moorhuhn 2
-        if (color >= 0x300 && color != 0x300 && (register_LCDC & 1))
+        if (color >= 0x300 && color != 0x300 && (state.lcdc & 1))
             continue;
         else if (color >= 0x200 && color < 0x300) {
             int sprite = color & 0xff;
 
-            int spriteX = gbMemory[0xfe00 + 4 * sprite + 1] - 8;
+            int spriteX = state.oam[4 * sprite + 1] - 8;
 
             if (spriteX == x) {
                 if (sprite < spriteNumber)
@@ -496,7 +514,7 @@ void gbDrawSpriteTile(int tile, int x, int y, int t, int flags,
         // make sure that sprites will work even in CGB mode
         if (gbCgbMode) {
             // Use the DMG palette if we are in compat mode.
-            if (gbMemory[0xff6c] & 1) {
+            if (state.dmgCompat) {
                 c = pal[c] + ((flags & 0x10) >> 4) * 4 + 32;
             } else {
                 c = c + (flags & 0x07) * 4 + 32;
@@ -519,58 +537,76 @@ void gbDrawSpriteTile(int tile, int x, int y, int t, int flags,
             }
         }
 
-        gbLineMix[xxx] = gbColorOption ? gbColorFilter[gbPalette[c] & 0x7FFF] : gbPalette[c] & 0x7FFF;
+        gbLineMix[xxx] = gbColorOption ? gbColorFilter[state.palette[c] & 0x7FFF] : state.palette[c] & 0x7FFF;
     }
 }
 
-void gbDrawSprites(bool draw)
+// Finds the sprites shown on line `ly`, at most 10, in OAM order. Returns how
+// many there are.
+static int gbFindSprites(const uint8_t* oam, uint8_t lcdc, int ly, int* sprites)
 {
-    int x = 0;
-    int y = 0;
+    int size = (lcdc & 4);
     int count = 0;
 
-    int size = (register_LCDC & 4);
+    for (int i = 0; i < 40; i++) {
+        int y = oam[4 * i];
+        int x = oam[4 * i + 1];
+
+        if (x > 0 && y > 0 && x < 168 && y < 160) {
+            // check if sprite intersects current line
+            int t = ly - y + 16;
+            if ((size && t >= 0 && t < 16) || (!size && t >= 0 && t < 8))
+                sprites[count++] = i;
+        }
+        // sprite limit reached!
+        if (count >= 10)
+            break;
+    }
+    return count;
+}
 
-    if (!draw)
-        memset(gbSpritesTicks, 0, sizeof(gbSpritesTicks));
+void gbDrawSprites(const GBLineState& state)
+{
+    int size = (state.lcdc & 4);
 
-    if (!(register_LCDC & 0x80))
+    if (!(state.lcdc & 0x80))
         return;
 
-    if ((register_LCDC & 2) && (coreOptions.layerSettings & 0x1000)) {
-        int yc = register_LY;
+    if ((state.lcdc & 2) && (coreOptions.layerSettings & 0x1000)) {
+        int sprites[10];
+        int count = gbFindSprites(state.oam, state.lcdc, state.ly, sprites);
 
-        int address = 0xfe00;
-        for (int i = 0; i < 40; i++) {
-            y = gbMemory[address++];
-            x = gbMemory[address++];
-            int tile = gbMemory[address++];
+        for (int i = 0; i < count; i++) {
+            const uint8_t* sprite = &state.oam[4 * sprites[i]];
+            int tile = sprite[2];
             if (size)
                 tile &= 254;
-            int flags = gbMemory[address++];
-
-            if (x > 0 && y > 0 && x < 168 && y < 160) {
-                // check if sprite intersects current line
-                int t = yc - y + 16;
-                if ((size && t >= 0 && t < 16) || (!size && t >= 0 && t < 8)) {
-                    if (draw)
-                        gbDrawSpriteTile(tile, x - 8, yc, t, flags, size, i);
-                    else {
-                        for (int j = x - 8; j < 300; j++)
-                            if (j >= 0) {
-                                if (gbSpeed)
-                                    gbSpritesTicks[j] += 5;
-                                else
-                                    gbSpritesTicks[j] += 2 + (count & 1);
-                            }
-                    }
-                    count++;
+
+            gbDrawSpriteTile(state, tile, sprite[1] - 8, state.ly, state.ly - sprite[0] + 16, sprite[3], size, sprites[i]);
+        }
+    }
+}
+
+void gbCountSprites()
+{
+    memset(gbSpritesTicks, 0, sizeof(gbSpritesTicks));
+
+    if (!(register_LCDC & 0x80))
+        return;
+
+    if ((register_LCDC & 2) && (coreOptions.layerSettings & 0x1000)) {
+        int sprites[10];
+        int count = gbFindSprites(&gbMemory[0xfe00], register_LCDC, register_LY, sprites);
+
+        for (int i = 0; i < count; i++) {
+            int x = gbMemory[0xfe00 + 4 * sprites[i] + 1];
+            for (int j = x - 8; j < 300; j++)
+                if (j >= 0) {
+                    if (gbSpeed)
+                        gbSpritesTicks[j] += 5;
+                    else
+                        gbSpritesTicks[j] += 2 + (i & 1);
                 }
-            }
-            // sprite limit reached!
-            if (count >= 10)
-                break;
         }
     }
-    return;
 }
@@ -1,7 +1,44 @@
 #ifndef VBAM_CORE_GB_GBGFX_H_
 #define VBAM_CORE_GB_GBGFX_H_
 
-void gbRenderLine();
-void gbDrawSprites(bool);
+#include <cstdint>
+
+// What a line is drawn from: the registers as the line ends, the per-dot
+// register arrays, palettes and OAM it was shown with, and VRAM.
+struct GBLineState {
+    int ly;
+    int speed;
+    uint8_t lcdc;
+    uint8_t wx;
+    // The line of the window shown on this line, or -1, and the WY the window
+    // started at.
+    int windowLine;
+    int windowY;
+    // FF6C bit 0, a CGB using the DMG palettes.
+    bool dmgCompat;
+    const uint8_t* scyLine;
+    const uint8_t* scxLine;
+    const uint8_t* bgpLine;
+    const uint8_t* obp0Line;
+    const uint8_t* obp1Line;
+    const uint8_t* spritesTicks;
+    const uint8_t* bgp;
+    const uint16_t* palette;
+    const uint8_t* oam;
+    // The VRAM banks, bank1 only on CGB.
+    const uint8_t* bank0;
+    const uint8_t* bank1;
+};
+
+// Points `state` at the emulator state line register_LY is drawn from and
+// moves the window on past the line.
+void gbBeginLine(GBLineState& state);
+// Draws the line into gbLineMix.
+void gbRenderLine(const GBLineState& state);
+void gbDrawSprites(const GBLineState& state);
+// Fills gbSpritesTicks for line register_LY.
+void gbCountSprites();
+// Copies gbLineMix to line `y` of g_pix.
+void gbDrawLine(int y);
 
 #endif  // VBAM_CORE_GB_GBGFX_H_
@@ -0,0 +1,143 @@
+#include "core/gb/gbRenderer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/base/sizes.h"
+#include "core/base/system.h"
+#include "core/gb/gbGlobals.h"
+
+extern uint8_t* g_pix;
+
+namespace {
+
+constexpr size_t kPixSize = 4 * 161 * 146;
+
+// Draws CGB frames with raster effects, i.e. writes to the scroll registers,
+// the palettes, OAM and both VRAM banks between lines, as an HBlank handler
+// or HDMA would.
+class GBRendererTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        gbMemory = (uint8_t*)calloc(1, 0x10000);
+        gbVram = (uint8_t*)calloc(1, kGBVRamSize);
+        gbLineBuffer = (uint16_t*)calloc(1, kGBLineBufferSize);
+        g_pix = (uint8_t*)calloc(1, kPixSize);
+        for (int i = 0; i < 16; i++)
+            gbMemoryMap[i] = &gbMemory[i * 0x1000];
+
+        gbCgbMode = true;
+        gbBorderLineSkip = 160;
+        systemColorDepth = 32;
+        for (int i = 0; i < 0x10000; i++)
+            systemColorMap32[i] = i;
+    }
+
+    void TearDown() override
+    {
+        coreOptions.threadedRendering = false;
+        gbSelectRenderer();
+
+        free(gbMemory);
+        free(gbVram);
+        free(gbLineBuffer);
+        free(g_pix);
+        gbMemory = gbVram = g_pix = nullptr;
+        gbLineBuffer = nullptr;
+        for (int i = 0; i < 16; i++)
+            gbMemoryMap[i] = nullptr;
+        gbCgbMode = false;
+    }
+
+    // Returns the frames drawn by the renderer `threaded` selects, from the
+    // same emulator state and writes.
+    std::vector<uint8_t> DrawFrames(bool threaded)
+    {
+        coreOptions.threadedRendering = threaded;
+        seed_ = 1;
+        for (size_t i = 0; i < kGBVRamSize; i++)
+            gbVram[i] = (uint8_t)Next();
+        for (int i = 0; i < 0xa0; i++)
+            gbMemory[0xfe00 + i] = (uint8_t)Next();
+        for (uint16_t& color : gbPalette)
+            color = Next() & 0x7fff;
+        memset(g_pix, 0, kPixSize);
+        SelectBank(0);
+
+        register_WY = 40;
+        register_WX = 87;
+        std::vector<uint8_t> frames;
+        for (int frame = 0; frame < 3; frame++) {
+            gbSelectRenderer();
+            // the window and the sprites, then 8x16 sprites and the other
+            // maps, then no window
+            static const uint8_t kLcdc[] = { 0xe3, 0xdf, 0x93 };
+            register_LCDC = kLcdc[frame];
+            gbWindowLine = -1;
+            oldRegister_WY = register_WY;
+            gbRenderer->StartFrame();
+
+            for (int y = 0; y < 144; y++) {
+                register_LY = (uint8_t)y;
+                WriteLine(y);
+                gbRenderer->EndLine();
+            }
+            gbRenderer->EndFrame();
+            frames.insert(frames.end(), g_pix, g_pix + kPixSize);
+        }
+        return frames;
+    }
+
+private:
+    void WriteLine(int y)
+    {
+        memset(gbSCXLine, (uint8_t)(y * 3), sizeof(gbSCXLine));
+        memset(gbSCYLine, (uint8_t)Next(), sizeof(gbSCYLine));
+        gbPalette[Next() & 0x7f] = Next() & 0x7fff;
+        gbMemory[0xfe00 + Next() % 0xa0] = (uint8_t)Next();
+
+        // a few tiles in either bank, as an HBlank handler would
+        for (int i = 0; i < 4; i++) {
+            SelectBank(Next() & 1);
+            WriteVram(0x8000 + Next() % 0x2000, 1, (uint8_t)Next());
+        }
+        // more than a line carries, as a general purpose DMA would
+        if (y % 50 == 25)
+            WriteVram(0x8000 + (Next() & 3) * 0x800, 0x800, (uint8_t)Next());
+    }
+
+    void SelectBank(int bank)
+    {
+        gbMemoryMap[0x08] = &gbVram[bank * 0x2000];
+        gbMemoryMap[0x09] = &gbVram[bank * 0x2000 + 0x1000];
+    }
+
+    void WriteVram(uint16_t address, int size, uint8_t value)
+    {
+        gbRendererVramWrite(address, size);
+        for (int i = 0; i < size; i++, address++)
+            gbMemoryMap[address >> 12][address & 0x0fff] = value;
+    }
+
+    uint32_t Next()
+    {
+        seed_ = seed_ * 1103515245 + 12345;
+        return seed_ >> 16;
+    }
+
+    uint32_t seed_ = 1;
+};
+
+TEST_F(GBRendererTest, ThreadedMatchesScanline)
+{
+    const std::vector<uint8_t> scanline = DrawFrames(false);
+    const std::vector<uint8_t> threaded = DrawFrames(true);
+    EXPECT_TRUE(scanline == threaded);
+}
+
+}  // namespace
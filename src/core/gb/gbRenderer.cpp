@@ -0,0 +1,199 @@
+#include "core/gb/gbRenderer.h"
+
+#include <cstring>
+
+#include "core/base/sizes.h"
+#include "core/base/system.h"
+#include "core/gb/gbGfx.h"
+#include "core/gb/gbGlobals.h"
+#include "core/gb/gbSGB.h"
+
+#if !defined(__LIBRETRO__)
+#include "core/base/line_queue.h"
+#endif
+
+namespace {
+
+// Draws each line in one go at HBlank.
+class ScanlineRenderer : public GBRenderer {
+public:
+    void EndLine() override
+    {
+        GBLineState state;
+        gbBeginLine(state);
+        gbRenderLine(state);
+        gbDrawSprites(state);
+        gbDrawLine(state.ly);
+    }
+
+    void DrawBorder() override { gbSgbRenderBorder(); }
+};
+
+#if !defined(__LIBRETRO__)
+// Draws the lines on a thread of its own while the CPU emulates on. Each line
+// is queued with a copy of the registers, the per-dot register arrays, the
+// palettes and OAM it was shown with, so that the CPU may change them while
+// the line waits to be drawn. SGB commands wait for the queued lines to be
+// drawn before they change the SGB state. The SGB border is queued first of
+// all at the start of the frame, as it takes longer to draw than the lines.
+//
+// The worker draws from a VRAM of its own. The 16-byte tiles the CPU and HDMA
+// write are queued with the next line and copied to it before that line is
+// drawn. When more tiles changed than a line holds, e.g. after a general
+// purpose DMA, or when VRAM may have changed outside of the CPU loop, the
+// CPU waits for the queued lines instead and copies the whole of VRAM.
+class ThreadedRenderer : public GBRenderer {
+public:
+    void StartFrame() override
+    {
+        border_ = gbBorderOn && !gbSgbMask;
+        if (!border_)
+            return;
+
+        Line& line = queue_.Push();
+        line.border = true;
+        line.tiles.count = 0;
+        queue_.Publish();
+    }
+
+    void BeforeVramWrite(uint32_t offset, uint32_t size) override { tiles_.Write(offset, size); }
+
+    void EndLine() override
+    {
+        Line& line = queue_.Push();
+        line.border = false;
+
+        GBLineState& state = line.state;
+        gbBeginLine(state);
+        state.scyLine = Copy(line.scyLine, state.scyLine);
+        state.scxLine = Copy(line.scxLine, state.scxLine);
+        state.bgpLine = Copy(line.bgpLine, state.bgpLine);
+        state.obp0Line = Copy(line.obp0Line, state.obp0Line);
+        state.obp1Line = Copy(line.obp1Line, state.obp1Line);
+        state.spritesTicks = Copy(line.spritesTicks, state.spritesTicks);
+        state.bgp = Copy(line.bgp, state.bgp);
+        state.palette = Copy(line.palette, state.palette);
+        state.oam = Copy(line.oam, state.oam);
+
+        // bank1 follows bank0 in gbVram
+        const uint8_t* vram = state.bank0;
+        const uint32_t size = state.bank1 ? kGBVRamSize : 0x2000;
+        if (size != vramSize_)
+            tiles_.WriteAll();
+        state.bank0 = vram_;
+        state.bank1 = state.bank1 ? &vram_[0x2000] : nullptr;
+
+        if (!tiles_.Take(vram, line.tiles)) {
+            // the worker does not read its VRAM while it waits
+            queue_.Wait();
+            memcpy(vram_, vram, size);
+            vramSize_ = size;
+        }
+
+        queue_.Publish();
+    }
+
+    void EndFrame() override { queue_.Wait(); }
+
+    void DrawBorder() override
+    {
+        queue_.Wait();
+        if (!border_)
+            gbSgbRenderBorder();
+        border_ = false;
+    }
+
+    void Flush() override
+    {
+        queue_.Wait();
+        tiles_.WriteAll();
+    }
+
+private:
+    // Tiles a line carries. Raster effects that stream a few tiles per
+    // line fit.
+    typedef DirtyTiles<16, kGBVRamSize / 16, 64> Tiles;
+
+    struct Line {
+        GBLineState state;
+        // Draws the SGB border instead.
+        bool border;
+        Tiles::Copies tiles;
+        uint8_t scyLine[sizeof(gbSCYLine)];
+        uint8_t scxLine[sizeof(gbSCXLine)];
+        uint8_t bgpLine[sizeof(gbBgpLine)];
+        uint8_t obp0Line[sizeof(gbObp0Line)];
+        uint8_t obp1Line[sizeof(gbObp1Line)];
+        uint8_t spritesTicks[sizeof(gbSpritesTicks)];
+        uint8_t bgp[sizeof(gbBgp)];
+        uint16_t palette[sizeof(gbPalette) / sizeof(gbPalette[0])];
+        uint8_t oam[0xa0];
+    };
+
+    template <typename T, size_t N>
+    static const T* Copy(T (&to)[N], const T* from)
+    {
+        memcpy(to, from, sizeof(to));
+        return to;
+    }
+
+    void Draw(const Line& line)
+    {
+        if (line.border) {
+            gbSgbRenderBorder();
+            return;
+        }
+
+        line.tiles.Apply(vram_);
+        gbRenderLine(line.state);
+        gbDrawSprites(line.state);
+        gbDrawLine(line.state.ly);
+    }
+
+    // The VRAM the worker draws from, and how much of it the lines use:
+    // both banks on CGB, the first otherwise.
+    uint8_t vram_[kGBVRamSize];
+    uint32_t vramSize_ = 0;
+    Tiles tiles_;
+    // Whether the border of the frame was queued.
+    bool border_ = false;
+    // A frame and its border fit, so that the CPU does not wait on the
+    // border.
+    LineQueue<Line, 256> queue_{[this](const Line& line) { Draw(line); }};
+};
+#endif
+
+ScanlineRenderer scanlineRenderer;
+#if !defined(__LIBRETRO__)
+ThreadedRenderer threadedRenderer;
+#endif
+
+}  // namespace
+
+GBRenderer* gbRenderer = &scanlineRenderer;
+bool gbRendererWantsVramWrites = false;
+
+void gbSelectRenderer()
+{
+    GBRenderer* renderer = &scanlineRenderer;
+#if !defined(__LIBRETRO__)
+    if (coreOptions.threadedRendering)
+        renderer = &threadedRenderer;
+#endif
+
+    if (renderer != gbRenderer) {
+        gbRenderer->Flush();
+        gbRenderer = renderer;
+        // VRAM may have changed since the renderer was last in use.
+        gbRenderer->Flush();
+    }
+#if !defined(__LIBRETRO__)
+    gbRendererWantsVramWrites = renderer == &threadedRenderer;
+#endif
+}
+
+void gbRendererVramWriteSlow(uint16_t address, int size)
+{
+    const uint8_t* vram = gbCgbMode ? gbVram : &gbMemory[0x8000];
+    gbRenderer->BeforeVramWrite((uint32_t)(&gbMemoryMap[address >> 12][address & 0x0fff] - vram), size);
+}
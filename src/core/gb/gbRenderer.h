@@ -0,0 +1,49 @@
+#ifndef VBAM_CORE_GB_GBRENDERER_H_
+#define VBAM_CORE_GB_GBRENDERER_H_
+
+#include <cstdint>
+
+// Draws the GB screen into g_pix. gbEmulate calls the renderer at the end of
+// each visible line, when the LCD enters HBlank, and at VBlank, before the
+// frame is shown. Lines of skipped frames are not drawn.
+class GBRenderer {
+public:
+    virtual ~GBRenderer() = default;
+
+    // A frame that is drawn starts.
+    virtual void StartFrame() {}
+    // Line register_LY is done.
+    virtual void EndLine() = 0;
+    // The last line of the frame is done. g_pix must hold the whole frame on
+    // return.
+    virtual void EndFrame() {}
+    // Draws the SGB border into g_pix, before the frame is shown.
+    virtual void DrawBorder() = 0;
+    // `size` bytes of VRAM from `offset` on are about to change. The offset
+    // is in VRAM as gbVram holds it, bank 1 after bank 0. Only called while
+    // gbRendererWantsVramWrites is set.
+    virtual void BeforeVramWrite(uint32_t /*offset*/, uint32_t /*size*/) {}
+    // Returns once the renderer no longer reads VRAM or the SGB state and no
+    // longer writes gbLineMix or g_pix, which may then change.
+    virtual void Flush() {}
+};
+
+// The renderer in use, chosen by gbSelectRenderer().
+extern GBRenderer* gbRenderer;
+// Checked before calling gbRendererVramWrite().
+extern bool gbRendererWantsVramWrites;
+
+// Chooses the renderer from coreOptions. Called at the start of each frame.
+void gbSelectRenderer();
+
+// Hook for the CPU and HDMA, on writes of `size` bytes from `address` on, in
+// the VRAM bank in use.
+void gbRendererVramWriteSlow(uint16_t address, int size);
+
+inline void gbRendererVramWrite(uint16_t address, int size)
+{
+    if (gbRendererWantsVramWrites)
+        gbRendererVramWriteSlow(address, size);
+}
+
+#endif  // VBAM_CORE_GB_GBRENDERER_H_
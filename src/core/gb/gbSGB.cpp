@@ -8,6 +8,7 @@
 #include "core/base/system.h"
 #include "core/gb/gb.h"
 #include "core/gb/gbGlobals.h"
+#include "core/gb/gbRenderer.h"
 
 extern uint8_t* g_pix;
 extern bool speedup;
@@ -704,6 +705,9 @@ void gbSgbCommand()
     int command = gbSgbPacket[0] >> 3;
     //  int nPacket = gbSgbPacket[0] & 7;
 
+    // The commands change what the lines and the border are drawn with.
+    gbRenderer->Flush();
+
     switch (command) {
     case 0x00:
         gbSgbSetPalette(0, 1, (uint16_t*)&gbSgbPacket[1]);
@@ -5,6 +5,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #ifndef _MSC_VER
 #include <strings.h>
@@ -12,6 +13,7 @@
 
 #include "core/base/file_util.h"
 #include "core/base/message.h"
+#include "core/base/movie.h"
 #include "core/base/port.h"
 #include "core/base/sizes.h"
 #include "core/base/system.h"
@@ -23,6 +25,8 @@
 #include "core/gba/gbaGfx.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaPrint.h"
+#include "core/gba/gbaProfiler.h"
+#include "core/gba/gbaRenderer.h"
 #include "core/gba/gbaSound.h"
 #include "core/gba/internal/gbaBios.h"
 #include "core/gba/internal/gbaEreader.h"
@@ -40,10 +44,6 @@
 #include "core/base/image_util.h"
 #endif // !__LIBRETRO__
 
-#ifdef PROFILING
-#include "prof/prof.h"
-#endif
-
 #ifdef __GNUC__
 #define _stricmp strcasecmp
 #endif
@@ -85,11 +85,6 @@ bool cpuEEPROMSensorEnabled = false;
 uint32_t cpuPrefetch[2];
 
 int cpuTotalTicks = 0;
-#ifdef PROFILING
-int profilingTicks = 0;
-int profilingTicksReload = 0;
-static profile_segment* profilSegment = NULL;
-#endif
 
 #ifdef VBAM_ENABLE_DEBUGGER
 uint8_t freezeWorkRAM[SIZE_WRAM];
@@ -135,6 +130,10 @@ void (*renderLine)() = mode0RenderLine;
 bool fxOn = false;
 bool windowOn = false;
 int frameCount = 0;
+// The frame being emulated is not rendered. Until its next rendered line,
+// renderLine is left out of date (renderDirty).
+static bool renderOff = false;
+static bool renderDirty = false;
 char g_buffer[1024];
 uint32_t lastTime = 0;
 int g_count = 0;
@@ -492,21 +491,6 @@ void gbaUpdateRomSize(int size)
     }
 }
 
-#ifdef PROFILING
-void cpuProfil(profile_segment* seg)
-{
-    profilSegment = seg;
-}
-
-void cpuEnableProfiling(int hz)
-{
-    if (hz == 0)
-        hz = 100;
-    profilingTicks = profilingTicksReload = 16777216 / hz;
-    profSetHertz(hz);
-}
-#endif
-
 inline int CPUUpdateTicks()
 {
     int cpuLoopTicks = lcdTicks;
@@ -526,13 +510,9 @@ inline int CPUUpdateTicks()
     if (timer3On && !(TM3CNT & 4) && (timer3Ticks < cpuLoopTicks)) {
         cpuLoopTicks = timer3Ticks;
     }
-#ifdef PROFILING
-    if (profilingTicksReload != 0) {
-        if (profilingTicks < cpuLoopTicks) {
-            cpuLoopTicks = profilingTicks;
-        }
+    if (profilerEnabled && profilerTicks < cpuLoopTicks) {
+        cpuLoopTicks = profilerTicks;
     }
-#endif
 
     if (SWITicks) {
         if (SWITicks < cpuLoopTicks)
@@ -547,38 +527,6 @@ inline int CPUUpdateTicks()
     return cpuLoopTicks;
 }
 
-void CPUUpdateWindow0()
-{
-    int x00 = WIN0H >> 8;
-    int x01 = WIN0H & 255;
-
-    if (x00 <= x01) {
-        for (int i = 0; i < 240; i++) {
-            gfxInWin0[i] = (i >= x00 && i < x01);
-        }
-    } else {
-        for (int i = 0; i < 240; i++) {
-            gfxInWin0[i] = (i >= x00 || i < x01);
-        }
-    }
-}
-
-void CPUUpdateWindow1()
-{
-    int x00 = WIN1H >> 8;
-    int x01 = WIN1H & 255;
-
-    if (x00 <= x01) {
-        for (int i = 0; i < 240; i++) {
-            gfxInWin1[i] = (i >= x00 && i < x01);
-        }
-    } else {
-        for (int i = 0; i < 240; i++) {
-            gfxInWin1[i] = (i >= x00 || i < x01);
-        }
-    }
-}
-
 extern uint32_t g_line0[240];
 extern uint32_t g_line1[240];
 extern uint32_t g_line2[240];
@@ -696,9 +644,6 @@ bool CPUReadState(const uint8_t* data)
     CLEAR_ARRAY(g_line3);
     // End of CPU Update Render Buffers set to true
 
-    CPUUpdateWindow0();
-    CPUUpdateWindow1();
-
     SetSaveType(coreOptions.saveType);
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
@@ -916,8 +861,6 @@ static bool CPUReadState(gzFile gzFile)
 
     CPUUpdateRender();
     CPUUpdateRenderBuffers(true);
-    CPUUpdateWindow0();
-    CPUUpdateWindow1();
 
     SetSaveType(coreOptions.saveType);
 
@@ -984,6 +927,25 @@ bool CPUExportEepromFile(const char* fileName)
     return true;
 }
 
+bool CPUWriteBatteryMem(std::vector<uint8_t>& image)
+{
+    image.clear();
+
+    if (!coreOptions.saveType || coreOptions.saveType == GBA_SAVE_NONE)
+        return true;
+
+    // only save if Flash/Sram in use or EEprom in use
+    if (!eepromInUse) {
+        if (coreOptions.saveType == GBA_SAVE_FLASH) // save flash type
+            image.assign(flashSaveMemory, flashSaveMemory + g_flashSize);
+        else if (coreOptions.saveType == GBA_SAVE_SRAM) // save sram type
+            image.assign(flashSaveMemory, flashSaveMemory + 0x8000);
+    } else { // save eeprom type
+        image.assign(eepromData, eepromData + eepromSize);
+    }
+    return true;
+}
+
 bool CPUWriteBatteryFile(const char* fileName)
 {
     if ((coreOptions.saveType) && (coreOptions.saveType != GBA_SAVE_NONE)) {
@@ -995,24 +957,12 @@ bool CPUWriteBatteryFile(const char* fileName)
             return false;
         }
 
-        // only save if Flash/Sram in use or EEprom in use
-        if (!eepromInUse) {
-            if (coreOptions.saveType == GBA_SAVE_FLASH) { // save flash type
-                if (fwrite(flashSaveMemory, 1, g_flashSize, file) != (size_t)g_flashSize) {
-                    fclose(file);
-                    return false;
-                }
-            } else if (coreOptions.saveType == GBA_SAVE_SRAM) { // save sram type
-                if (fwrite(flashSaveMemory, 1, 0x8000, file) != 0x8000) {
-                    fclose(file);
-                    return false;
-                }
-            }
-        } else { // save eeprom type
-            if (fwrite(eepromData, 1, eepromSize, file) != (size_t)eepromSize) {
-                fclose(file);
-                return false;
-            }
+        std::vector<uint8_t> image;
+        CPUWriteBatteryMem(image);
+
+        if (fwrite(image.data(), 1, image.size(), file) != image.size()) {
+            fclose(file);
+            return false;
         }
         fclose(file);
     }
@@ -1378,12 +1328,6 @@ bool CPUIsELF(const char* file)
 
 void CPUCleanUp()
 {
-#ifdef PROFILING
-    if (profilingTicksReload) {
-        profCleanup();
-    }
-#endif
-
     if (g_rom != NULL) {
         free(g_rom);
         g_rom = NULL;
@@ -1816,6 +1760,20 @@ void CPUUpdateRender()
     }
 }
 
+void gbaRendererWriteSlow()
+{
+    if (renderOff)
+        return;
+
+    // Only HDraw has a line partly out. The line started 1008 cycles before
+    // lcdTicks runs out, and the CPU has run cpuTotalTicks since lcdTicks was
+    // last updated. A pixel takes 4.
+    int x = 0;
+    if (!(DISPSTAT & 3))
+        x = (1008 - (lcdTicks - cpuTotalTicks)) / 4;
+    gbaRenderer->BeforeWrite(x < 0 ? 0 : x);
+}
+
 void CPUUpdateCPSR()
 {
     uint32_t CPSR = reg[16].I & 0x40;
@@ -2030,24 +1988,6 @@ void CPUSoftwareInterrupt(int comment)
         dbgOutput(NULL, reg[0].I);
         return;
     }
-#endif
-#ifdef PROFILING
-    if (comment == 0xfe) {
-        profStartup(reg[0].I, reg[1].I);
-        return;
-    }
-    if (comment == 0xfd) {
-        profControl(reg[0].I);
-        return;
-    }
-    if (comment == 0xfc) {
-        profCleanup();
-        return;
-    }
-    if (comment == 0xfb) {
-        profCount();
-        return;
-    }
 #endif
     if (comment == 0xfa) {
         agbPrintFlush();
@@ -2350,8 +2290,211 @@ void CPUCompareVCOUNT()
     }
     if (layerEnableDelay > 0) {
         layerEnableDelay--;
-        if (layerEnableDelay == 1)
+        if (layerEnableDelay == 1) {
+            gbaRendererWrite();
             coreOptions.layerEnable = coreOptions.layerSettings & DISPCNT;
+        }
+    }
+}
+
+uint8_t* CPUGetHostMemory(uint32_t address, int unit, bool read, uint32_t& lo, uint32_t& hi, uint8_t*& freeze)
+{
+    const int region = address >> 24;
+    uint8_t* base = NULL;
+    uint32_t size = 0;
+
+    freeze = NULL;
+    lo = address & 0xFF000000;
+    hi = lo + 0x01000000;
+#ifdef VBAM_ENABLE_DEBUGGER
+    if (map[region].breakPoints)
+        return NULL;
+#endif
+
+    // Byte writes to video memory are widened or ignored.
+    if (unit == 1 && !read && region != 2 && region != 3)
+        return NULL;
+
+    switch (region) {
+    case 2:
+        base = g_workRAM;
+        size = 0x40000;
+#ifdef VBAM_ENABLE_DEBUGGER
+        freeze = freezeWorkRAM;
+#endif
+        break;
+    case 3:
+        base = g_internalRAM;
+        size = 0x8000;
+#ifdef VBAM_ENABLE_DEBUGGER
+        freeze = freezeInternalRAM;
+#endif
+        break;
+    case 5:
+        if (!read)
+            gbaRendererWrite();
+        base = g_paletteRAM;
+        size = 0x400;
+#ifdef VBAM_ENABLE_DEBUGGER
+        freeze = freezePRAM;
+#endif
+        break;
+    case 6: {
+        // 0x18000-0x1FFFF mirrors 0x10000-0x17FFF, except that the first
+        // 16 KB of it are unmapped in the bitmap modes.
+        const bool bitmap = (DISPCNT & 7) > 2;
+        const uint32_t mirror = address & ~0x1FFFF;
+        uint32_t off = address & 0x1FFFF;
+        if (off < 0x18000) {
+            lo = mirror;
+            hi = mirror + 0x18000;
+        } else if (bitmap && off < 0x1C000) {
+            lo = mirror + 0x18000;
+            hi = mirror + 0x1C000;
+            return NULL;
+        } else {
+            lo = mirror + (bitmap ? 0x1C000 : 0x18000);
+            hi = mirror + 0x20000;
+            off -= 0x8000;
+        }
+        if (!read)
+            gbaRendererVramWrite(off - (address - lo), hi - lo);
+#ifdef VBAM_ENABLE_DEBUGGER
+        freeze = freezeVRAM + off;
+#endif
+        return g_vram + off;
+    }
+    case 7:
+        if (!read)
+            gbaRendererWrite();
+        base = g_oam;
+        size = 0x400;
+#ifdef VBAM_ENABLE_DEBUGGER
+        freeze = freezeOAM;
+#endif
+        break;
+    case 8:
+    case 9:
+    case 10:
+    case 11:
+    case 12:
+        if (!read)
+            return NULL;
+        base = g_rom;
+        size = 0x2000000;
+        break;
+    default:
+        return NULL;
+    }
+
+    lo = address & ~(size - 1);
+    hi = lo + size;
+    if (region == 12)
+        hi = 0x0D000000;
+    else if (region == 8 && unit == 2) {
+        // The RTC registers.
+        if (address >= 0x080000C4 && address < 0x080000CA) {
+            lo = 0x080000C4;
+            hi = 0x080000CA;
+            return NULL;
+        }
+        if (address < 0x080000C4)
+            hi = 0x080000C4;
+        else
+            lo = 0x080000CA;
+    }
+#ifdef VBAM_ENABLE_DEBUGGER
+    if (freeze)
+        freeze += address & (size - 1);
+#endif
+    return base + (address & (size - 1));
+}
+
+// Number of units from `address` on, stepping by `inc`, that stay within
+// [lo, hi), at most `c`.
+static uint32_t dmaUnitsInRange(uint32_t address, uint32_t inc, int unit, uint32_t lo, uint32_t hi, uint32_t c)
+{
+    uint32_t n = c;
+    if ((int32_t)inc > 0)
+        n = (hi - address) / unit;
+    else if ((int32_t)inc < 0)
+        n = (address - lo) / unit + 1;
+    return n < c ? n : c;
+}
+
+// Moves units of a DMA between plain memory regions directly, until the
+// transfer is done or its next unit needs the full memory handlers. With
+// `zero`, zeros are written and the source is left alone, as for a source
+// in the BIOS region outside of the BIOS.
+static void doDMAFast(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t& c, int unit, bool zero)
+{
+    while (c != 0) {
+        uint32_t sLo, sHi, dLo, dHi;
+        uint8_t *sFreeze, *dFreeze;
+        const uint32_t daddr = d & ~(uint32_t)(unit - 1);
+        uint8_t* dst = CPUGetHostMemory(daddr, unit, false, dLo, dHi, dFreeze);
+        if (!dst)
+            return;
+        uint32_t n = dmaUnitsInRange(daddr, di, unit, dLo, dHi, c);
+        const uint8_t* src = NULL;
+        if (!zero) {
+            src = CPUGetHostMemory(s, unit, true, sLo, sHi, sFreeze);
+            if (!src)
+                return;
+            n = dmaUnitsInRange(s, si, unit, sLo, sHi, n);
+        }
+        (void)sFreeze;
+
+#ifdef VBAM_ENABLE_DEBUGGER
+        // Frozen addresses go through the cheat engine.
+        if (dFreeze) {
+            for (int32_t i = 0; i < (int32_t)n; i++) {
+                for (int k = 0; k < unit; k++) {
+                    if (dFreeze[i * (int32_t)di + k])
+                        return;
+                }
+            }
+        }
+#else
+        (void)dFreeze;
+#endif
+
+        const size_t bytes = (size_t)n * unit;
+        if (zero) {
+            if (di == (uint32_t)unit)
+                memset(dst, 0, bytes);
+            else {
+                for (uint32_t i = 0; i < n; i++) {
+                    memset(dst, 0, unit);
+                    dst += (int32_t)di;
+                }
+            }
+        } else if (si == (uint32_t)unit && di == (uint32_t)unit && (src + bytes <= dst || dst + bytes <= src)) {
+            memcpy(dst, src, bytes);
+            src += bytes - unit;
+            cpuDmaLast = unit == 4 ? READ32LE(src) : READ16LE(src);
+        } else if (unit == 4) {
+            for (uint32_t i = 0; i < n; i++) {
+                cpuDmaLast = READ32LE(src);
+                WRITE32LE(dst, cpuDmaLast);
+                src += (int32_t)si;
+                dst += (int32_t)di;
+            }
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                cpuDmaLast = READ16LE(src);
+                WRITE16LE(dst, DowncastU16(cpuDmaLast));
+                src += (int32_t)si;
+                dst += (int32_t)di;
+            }
+        }
+        if (!zero && unit == 2)
+            cpuDmaLast |= (cpuDmaLast << 16);
+
+        if (!zero)
+            s += si * n;
+        d += di * n;
+        c -= n;
     }
 }
 
@@ -2362,6 +2505,10 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
     int sw = 0;
     int dw = 0;
     int sc = c;
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    const uint32_t source = s;
+    const uint32_t dest = d;
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
     cpuDmaRunning = true;
     cpuDmaPC = reg[15].I;
@@ -2375,16 +2522,24 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
     //if ((sm>=0x05) && (sm<=0x07) || (dm>=0x05) && (dm <=0x07))
     //    blank = (((DISPSTAT | ((DISPSTAT>>1)&1))==1) ?  true : false);
 
+    // Plain memory is copied directly, one unit at a time through the
+    // memory handlers only where those are needed.
     if (transfer32) {
         s &= 0xFFFFFFFC;
         if (s < 0x02000000 && (reg[15].I >> 24)) {
             while (c != 0) {
+                doDMAFast(s, d, si, di, c, 4, true);
+                if (c == 0)
+                    break;
                 CPUWriteMemory(d, 0);
                 d += di;
                 c--;
             }
         } else {
             while (c != 0) {
+                doDMAFast(s, d, si, di, c, 4, false);
+                if (c == 0)
+                    break;
                 cpuDmaLast = CPUReadMemory(s);
                 CPUWriteMemory(d, cpuDmaLast);
                 d += di;
@@ -2398,12 +2553,18 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
         di = (int)di >> 1;
         if (s < 0x02000000 && (reg[15].I >> 24)) {
             while (c != 0) {
+                doDMAFast(s, d, si, di, c, 2, true);
+                if (c == 0)
+                    break;
                 CPUWriteHalfWord(d, 0);
                 d += di;
                 c--;
             }
         } else {
             while (c != 0) {
+                doDMAFast(s, d, si, di, c, 2, false);
+                if (c == 0)
+                    break;
                 cpuDmaLast = CPUReadHalfWord(s);
                 CPUWriteHalfWord(d, DowncastU16(cpuDmaLast));
                 cpuDmaLast |= (cpuDmaLast << 16);
@@ -2430,6 +2591,10 @@ void doDMA(uint32_t& s, uint32_t& d, uint32_t si, uint32_t di, uint32_t c, int t
 
     cpuDmaTicksToUpdate += totalTicks;
     cpuDmaRunning = false;
+
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    memStatsDma(source, dest, si, di, sc, totalTicks);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 }
 
 void CPUCheckDMA(int reason, int dmamask)
@@ -2686,6 +2851,10 @@ void CPUCheckDMA(int reason, int dmamask)
 
 void CPUUpdateRegister(uint32_t address, uint16_t value)
 {
+    // the display registers, but DISPSTAT and VCOUNT
+    if (address < 0x56 && address != 0x04 && address != 0x06)
+        gbaRendererWrite();
+
     switch (address) {
     case 0x00: { // we need to place the following code in { } because we declare & initialize variables in a case statement
         if ((value & 7) > 5) {
@@ -2693,7 +2862,6 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
             DISPCNT = (value & 7);
         }
         bool change = (0 != ((DISPCNT ^ value) & 0x80));
-        bool changeBG = (0 != ((DISPCNT ^ value) & 0x0F00));
         uint16_t changeBGon = ((~DISPCNT) & value) & 0x0F00; // these layers are being activated
 
         DISPCNT = (value & 0xFFF7); // bit 3 can only be accessed by the BIOS to enable GBC mode
@@ -2719,11 +2887,11 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
             }
             //        (*renderLine)();
         }
-        CPUUpdateRender();
-        // we only care about changes in BG0-BG3
-        if (changeBG) {
-            CPUUpdateRenderBuffers(false);
+        if (renderOff) {
+            renderDirty = true;
+            break;
         }
+        CPUUpdateRender();
         break;
     }
     case 0x04:
@@ -2800,22 +2968,22 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
     case 0x28:
         BG2X_L = value;
         UPDATE_REG(0x28, BG2X_L);
-        gfxBG2Changed |= 1;
+        gfxBG2Written |= 1;
         break;
     case 0x2A:
         BG2X_H = (value & 0xFFF);
         UPDATE_REG(0x2A, BG2X_H);
-        gfxBG2Changed |= 1;
+        gfxBG2Written |= 1;
         break;
     case 0x2C:
         BG2Y_L = value;
         UPDATE_REG(0x2C, BG2Y_L);
-        gfxBG2Changed |= 2;
+        gfxBG2Written |= 2;
         break;
     case 0x2E:
         BG2Y_H = value & 0xFFF;
         UPDATE_REG(0x2E, BG2Y_H);
-        gfxBG2Changed |= 2;
+        gfxBG2Written |= 2;
         break;
     case 0x30:
         BG3PA = value;
@@ -2836,32 +3004,30 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
     case 0x38:
         BG3X_L = value;
         UPDATE_REG(0x38, BG3X_L);
-        gfxBG3Changed |= 1;
+        gfxBG3Written |= 1;
         break;
     case 0x3A:
         BG3X_H = value & 0xFFF;
         UPDATE_REG(0x3A, BG3X_H);
-        gfxBG3Changed |= 1;
+        gfxBG3Written |= 1;
         break;
     case 0x3C:
         BG3Y_L = value;
         UPDATE_REG(0x3C, BG3Y_L);
-        gfxBG3Changed |= 2;
+        gfxBG3Written |= 2;
         break;
     case 0x3E:
         BG3Y_H = value & 0xFFF;
         UPDATE_REG(0x3E, BG3Y_H);
-        gfxBG3Changed |= 2;
+        gfxBG3Written |= 2;
         break;
     case 0x40:
         WIN0H = value;
         UPDATE_REG(0x40, WIN0H);
-        CPUUpdateWindow0();
         break;
     case 0x42:
         WIN1H = value;
         UPDATE_REG(0x42, WIN1H);
-        CPUUpdateWindow1();
         break;
     case 0x44:
         WIN0V = value;
@@ -2887,7 +3053,10 @@ void CPUUpdateRegister(uint32_t address, uint16_t value)
         BLDMOD = value & 0x3FFF;
         UPDATE_REG(0x50, BLDMOD);
         fxOn = ((BLDMOD >> 6) & 3) != 0;
-        CPUUpdateRender();
+        if (renderOff)
+            renderDirty = true;
+        else
+            CPUUpdateRender();
         break;
     case 0x52:
         COLEV = value & 0x1F1F;
@@ -3633,6 +3802,10 @@ void CPUReset()
     fxOn = false;
     windowOn = false;
     frameCount = 0;
+    renderOff = false;
+    renderDirty = false;
+    gbaSelectRenderer();
+    gbaRenderer->Reset();
     coreOptions.layerEnable = DISPCNT & coreOptions.layerSettings;
 
     CPUUpdateRenderBuffers(true);
@@ -3659,9 +3832,6 @@ void CPUReset()
 
     soundReset();
 
-    CPUUpdateWindow0();
-    CPUUpdateWindow1();
-
     // make sure registers are correctly initialized if not using BIOS
     if (!coreOptions.useBios) {
         if (coreOptions.cpuIsMultiBoot)
@@ -3704,6 +3874,9 @@ void CPUInterrupt()
     reg[15].I += 4;
     ARM_PREFETCH;
 
+    if (profilerEnabled)
+        profilerInterrupt(PC - (savedState ? 4 : 2));
+
     //  if(!holdState)
     biosProtected[0] = 0x02;
     biosProtected[1] = 0xc0;
@@ -3720,6 +3893,7 @@ static void gbaUpdateJoypads(void)
     if (systemReadJoypads())
         // read default joystick
         joy = systemReadJoypad(-1);
+    movieUpdateJoypads(&joy, 1);
 
     P1 = 0x03FF ^ (joy & 0x3FF);
     systemUpdateMotionSensor();
@@ -3745,7 +3919,7 @@ static void gbaUpdateJoypads(void)
     }
 }
 
-void CPULoop(int ticks)
+static void CPURunLoop(int ticks)
 {
     int clockTicks;
     int timerOverflow = 0;
@@ -3779,8 +3953,13 @@ void CPULoop(int ticks)
                     return;
             }
             clockTicks = 0;
-        } else
+        } else {
             clockTicks = CPUUpdateTicks();
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+            if (holdState)
+                memStatsHalt(clockTicks);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+        }
 
         cpuTotalTicks += clockTicks;
 
@@ -3892,8 +4071,18 @@ void CPULoop(int ticks)
                         lcdTicks += 1008;
                         DISPSTAT &= 0xFFFD;
                         if (VCOUNT == 160) {
+                            // g_pix is complete, for captures as well.
+                            if (!renderOff)
+                                gbaRenderer->EndFrame();
                             g_count++;
                             systemFrame();
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+                            memStatsEndFrame();
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+                            if (traceEnabled)
+                                traceFrame();
+#endif  // defined(VBAM_ENABLE_TRACE)
 
                             if ((g_count % 10) == 0) {
                                 system10Frames();
@@ -3938,11 +4127,12 @@ void CPULoop(int ticks)
 
                             psoundTickfn();
 
-                            if (frameCount >= framesToSkip) {
+                            if (!renderOff) {
                                 systemDrawScreen();
                                 frameCount = 0;
                             } else {
-                                frameCount++;
+                                if (frameCount < framesToSkip)
+                                    frameCount++;
                                 systemSendScreen();
                             }
                             if (systemPauseOnFrame())
@@ -3955,110 +4145,19 @@ void CPULoop(int ticks)
                         CPUCompareVCOUNT();
 
                     } else {
-                        if (frameCount >= framesToSkip) {
-                            (*renderLine)();
-                            switch (systemColorDepth) {
-                            case 16: {
-#ifdef __LIBRETRO__
-                                uint16_t* dest = (uint16_t*)g_pix + 240 * VCOUNT;
-#else
-                                uint16_t* dest = (uint16_t*)g_pix + 242 * (VCOUNT + 1);
-#endif
-                                for (int x = 0; x < 240;) {
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap16[g_lineMix[x++] & 0xFFFF];
-                                }
-// for filters that read past the screen
-#ifndef __LIBRETRO__
-                                *dest++ = 0;
-#endif
-                            } break;
-                            case 24: {
-                                uint8_t* dest = (uint8_t*)g_pix + 240 * VCOUNT * 3;
-                                for (int x = 0; x < 240;) {
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                    *((uint32_t*)dest) = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    dest += 3;
-                                }
-                            } break;
-                            case 32: {
-#ifdef __LIBRETRO__
-                                uint32_t* dest = (uint32_t*)g_pix + 240 * VCOUNT;
-#else
-                                uint32_t* dest = (uint32_t*)g_pix + 241 * (VCOUNT + 1);
-#endif
-                                for (int x = 0; x < 240;) {
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                    *dest++ = systemColorMap32[g_lineMix[x++] & 0xFFFF];
-                                }
-                            } break;
+                        // A frame is rendered or skipped as a whole, so that
+                        // the affine and mosaic latches start over on line 0.
+                        if (VCOUNT == 0) {
+                            renderOff = coreOptions.skipRender || frameCount < framesToSkip;
+                            gbaSelectRenderer();
+                        }
+
+                        if (!renderOff) {
+                            if (renderDirty) {
+                                CPUUpdateRender();
+                                renderDirty = false;
                             }
+                            gbaRenderer->EndLine();
                         }
                         // entering H-Blank
                         DISPSTAT |= 2;
@@ -4189,25 +4288,12 @@ void CPULoop(int ticks)
 
             timerOverflow = 0;
 
-#ifdef PROFILING
-            profilingTicks -= clockTicks;
-            if (profilingTicks <= 0) {
-                profilingTicks += profilingTicksReload;
-                if (profilSegment) {
-                    profile_segment* seg = profilSegment;
-                    do {
-                        uint16_t* b = (uint16_t*)seg->sbuf;
-                        int pc = ((reg[15].I - seg->s_lowpc) * seg->s_scale) / 0x10000;
-                        if (pc >= 0 && pc < seg->ssiz) {
-                            b[pc]++;
-                            break;
-                        }
+            if (profilerEnabled)
+                profilerTick(clockTicks);
 
-                        seg = seg->next;
-                    } while (seg);
-                }
-            }
-#endif
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+            memStatsCycles(clockTicks);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
             ticks -= clockTicks;
 
@@ -4291,12 +4377,24 @@ void CPULoop(int ticks)
                 break;
         }
     }
+#ifdef VBAM_ENABLE_DEBUGGER
+    // Interrupt requests from GDB are checked here rather than per
+    // instruction.
+    remotePoll();
+#endif
 #ifndef NO_LINK
     if (GetLinkMode() != LINK_DISCONNECTED)
         CheckLinkConnection();
 #endif
 }
 
+void CPULoop(int ticks)
+{
+    CPURunLoop(ticks);
+    // Whatever runs next, e.g. the debugger, may change the emulator state.
+    gbaRenderer->Flush();
+}
+
 void gbaEmulate(int ticks)
 {
     has_frames = false;
@@ -4334,6 +4432,8 @@ struct EmulatedSystem GBASystem = {
     CPUReadBatteryFile,
     // emuWriteBattery
     CPUWriteBatteryFile,
+    // emuWriteBatteryMem
+    CPUWriteBatteryMem,
     // emuReadState
     CPUReadState,
     // emuWriteState
@@ -2,6 +2,7 @@
 #define VBAM_CORE_GBA_GBA_H_
 
 #include <cstdint>
+#include <vector>
 
 #include "core/base/system.h"
 
@@ -125,6 +126,7 @@ extern bool CPUReadGSASnapshot(const char*);
 extern bool CPUReadGSASPSnapshot(const char*);
 extern bool CPUWriteGSASnapshot(const char*, const char*, const char*, const char*);
 extern bool CPUWriteBatteryFile(const char*);
+extern bool CPUWriteBatteryMem(std::vector<uint8_t>&);
 extern bool CPUReadBatteryFile(const char*);
 extern bool CPUExportEepromFile(const char*);
 extern bool CPUImportEepromFile(const char*);
@@ -152,13 +154,16 @@ void SetSaveType(int st);
 extern void CPUReset();
 extern void CPULoop(int);
 extern void CPUCheckDMA(int, int);
+// Returns the host memory behind `address` for plain accesses of `unit`
+// bytes, and the addresses [lo, hi) around it that map linearly onto that
+// memory, or NULL if the access needs the full memory handlers (I/O, save
+// memory, byte writes to video memory, debugger breakpoints...), in which
+// case [lo, hi) is a range that needs them as well. ROM is only returned for
+// reads. In debugger builds, `freeze` receives the matching freeze flags, if
+// any.
+extern uint8_t* CPUGetHostMemory(uint32_t address, int unit, bool read, uint32_t& lo, uint32_t& hi, uint8_t*& freeze);
 extern bool CPUIsGBAImage(const char*);
 extern bool CPUIsZipFile(const char*);
-#ifdef PROFILING
-#include "prof/prof.h"
-extern void cpuProfil(profile_segment* seg);
-extern void cpuEnableProfiling(int hz);
-#endif
 
 const char* GetLoadDotCodeFile();
 const char* GetSaveDotCodeFile();
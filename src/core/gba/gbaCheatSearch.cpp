@@ -1,92 +1,447 @@
 #include "core/gba/gbaCheatSearch.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <utility>
+
+#include "core/base/cpu_features.h"
+
+#if !defined(__LIBRETRO__)
+#include "core/base/job_pool.h"
+#endif
+
+#if defined(VBAM_SIMD_X86)
+#include <immintrin.h>
+#endif
 
 CheatSearchBlock cheatSearchBlocks[4];
 
 CheatSearchData cheatSearchData = {
     0,
-    cheatSearchBlocks
+    cheatSearchBlocks,
+    {}
 };
 
-static bool cheatSearchEQ(uint32_t a, uint32_t b)
+namespace {
+
+// Number of searches that can be undone.
+constexpr size_t kHistorySize = 32;
+
+// Dense blocks are searched in slices of this many bytes, in parallel when
+// there is enough of them. Slices never share a byte of `bits`.
+constexpr int kSliceSize = 0x8000;
+constexpr int kParallelThreshold = 0x10000;
+
+// Per search size, the bits of a `bits` word that are tested, and the bits
+// that are cleared from a tested bit when its candidate fails.
+const uint32_t kTestedBits[3] = { 0xFFFFFFFF, 0x55555555, 0x11111111 };
+const uint32_t kClearedBits[3] = { 0x1, 0x3, 0xF };
+
+struct SearchArgs {
+    int compare;
+    // Compare against `value` rather than the saved values.
+    bool byValue;
+    uint32_t value;
+};
+
+int CountBits(uint32_t x)
 {
-    return a == b;
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F;
+    return (int)((x * 0x01010101) >> 24);
 }
 
-static bool cheatSearchNE(uint32_t a, uint32_t b)
+template <typename T>
+inline bool Compare(int compare, T a, T b)
 {
-    return a != b;
+    switch (compare) {
+    case SEARCH_EQ:
+        return a == b;
+    case SEARCH_NE:
+        return a != b;
+    case SEARCH_LT:
+        return a < b;
+    case SEARCH_LE:
+        return a <= b;
+    case SEARCH_GT:
+        return a > b;
+    default:
+        return a >= b;
+    }
 }
 
-static bool cheatSearchLT(uint32_t a, uint32_t b)
+// Reads a little-endian value of `kSize`, extended to 32 bits.
+template <typename T, int kSize>
+inline T Load(const uint8_t* p)
 {
-    return a < b;
+    uint32_t res = p[0];
+    if (kSize >= BITS_16)
+        res |= ((uint32_t)p[1]) << 8;
+    if (kSize == BITS_32)
+        res |= (((uint32_t)p[2]) << 16) | (((uint32_t)p[3]) << 24);
+    if (T(-1) < T(0)) {
+        const int shift = 32 - (8 << kSize);
+        return (T)(((int32_t)(res << shift)) >> shift);
+    }
+    return (T)res;
 }
 
-static bool cheatSearchLE(uint32_t a, uint32_t b)
+// A search against a value that does not fit the search size gives the same
+// result for every candidate, and is left to the scalar code.
+bool FitsSize(uint32_t value, int size, bool isSigned)
 {
-    return a <= b;
+    if (size == BITS_32)
+        return true;
+    const int bits = 8 << size;
+    if (isSigned) {
+        const int32_t v = (int32_t)value;
+        return v >= -(1 << (bits - 1)) && v < (1 << (bits - 1));
+    }
+    return value < (1u << bits);
 }
 
-static bool cheatSearchGT(uint32_t a, uint32_t b)
+// The vector kernels search whole vectors of [begin, end) in a dense block
+// and return where they stopped.
+typedef int (*SearchKernel)(CheatSearchBlock* block, const SearchArgs& args, bool isSigned, int begin, int end);
+
+#if defined(VBAM_SIMD_X86)
+
+/* SSE2, 16 bytes per step */
+
+template <int kSize>
+VBAM_TARGET_SSE2 inline __m128i Splat128(uint32_t v)
 {
-    return a > b;
+    if (kSize == BITS_8)
+        return _mm_set1_epi8((char)v);
+    if (kSize == BITS_16)
+        return _mm_set1_epi16((short)v);
+    return _mm_set1_epi32((int)v);
 }
 
-static bool cheatSearchGE(uint32_t a, uint32_t b)
+template <int kSize>
+VBAM_TARGET_SSE2 inline __m128i CmpEq128(__m128i a, __m128i b)
 {
-    return a >= b;
+    if (kSize == BITS_8)
+        return _mm_cmpeq_epi8(a, b);
+    if (kSize == BITS_16)
+        return _mm_cmpeq_epi16(a, b);
+    return _mm_cmpeq_epi32(a, b);
 }
 
-static bool cheatSearchSignedEQ(int32_t a, int32_t b)
+template <int kSize>
+VBAM_TARGET_SSE2 inline __m128i CmpGt128(__m128i a, __m128i b)
 {
-    return a == b;
+    if (kSize == BITS_8)
+        return _mm_cmpgt_epi8(a, b);
+    if (kSize == BITS_16)
+        return _mm_cmpgt_epi16(a, b);
+    return _mm_cmpgt_epi32(a, b);
 }
 
-static bool cheatSearchSignedNE(int32_t a, int32_t b)
+// The bytes of the lanes that fail `compare`, one bit per byte. The lanes
+// hold signed values; unsigned ones have their sign bit flipped.
+template <int kSize>
+VBAM_TARGET_SSE2 inline uint32_t Fail128(int compare, __m128i a, __m128i b)
 {
-    return a != b;
+    switch (compare) {
+    case SEARCH_EQ:
+        return ~_mm_movemask_epi8(CmpEq128<kSize>(a, b)) & 0xFFFF;
+    case SEARCH_NE:
+        return _mm_movemask_epi8(CmpEq128<kSize>(a, b));
+    case SEARCH_LT:
+        return _mm_movemask_epi8(_mm_or_si128(CmpGt128<kSize>(a, b), CmpEq128<kSize>(a, b)));
+    case SEARCH_LE:
+        return _mm_movemask_epi8(CmpGt128<kSize>(a, b));
+    case SEARCH_GT:
+        return ~_mm_movemask_epi8(CmpGt128<kSize>(a, b)) & 0xFFFF;
+    default:
+        return _mm_movemask_epi8(CmpGt128<kSize>(b, a));
+    }
 }
 
-static bool cheatSearchSignedLT(int32_t a, int32_t b)
+template <int kSize>
+VBAM_TARGET_SSE2 int SearchSse2(CheatSearchBlock* block, const SearchArgs& args, bool isSigned, int begin, int end)
 {
-    return a < b;
+    const __m128i bias = isSigned ? _mm_setzero_si128() : Splat128<kSize>(0x80u << ((8 << kSize) - 8));
+    const __m128i value = _mm_xor_si128(Splat128<kSize>(args.value), bias);
+    const uint8_t* saved = block->saved;
+    int j = begin;
+    for (; j + 16 <= end; j += 16) {
+        uint16_t word;
+        memcpy(&word, block->bits + (j >> 3), sizeof(word));
+        const uint32_t tested = word & kTestedBits[kSize];
+        if (!tested)
+            continue;
+        const __m128i a = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(block->data + j)), bias);
+        const __m128i b = args.byValue ? value : _mm_xor_si128(_mm_loadu_si128((const __m128i*)(saved + j)), bias);
+        const uint32_t cleared = Fail128<kSize>(args.compare, a, b) & (tested * kClearedBits[kSize]);
+        if (cleared) {
+            word = (uint16_t)(word & ~cleared);
+            memcpy(block->bits + (j >> 3), &word, sizeof(word));
+        }
+    }
+    return j;
 }
 
-static bool cheatSearchSignedLE(int32_t a, int32_t b)
+/* AVX2, 32 bytes per step */
+
+template <int kSize>
+VBAM_TARGET_AVX2 inline __m256i Splat256(uint32_t v)
 {
-    return a <= b;
+    if (kSize == BITS_8)
+        return _mm256_set1_epi8((char)v);
+    if (kSize == BITS_16)
+        return _mm256_set1_epi16((short)v);
+    return _mm256_set1_epi32((int)v);
 }
 
-static bool cheatSearchSignedGT(int32_t a, int32_t b)
+template <int kSize>
+VBAM_TARGET_AVX2 inline __m256i CmpEq256(__m256i a, __m256i b)
 {
-    return a > b;
+    if (kSize == BITS_8)
+        return _mm256_cmpeq_epi8(a, b);
+    if (kSize == BITS_16)
+        return _mm256_cmpeq_epi16(a, b);
+    return _mm256_cmpeq_epi32(a, b);
 }
 
-static bool cheatSearchSignedGE(int32_t a, int32_t b)
+template <int kSize>
+VBAM_TARGET_AVX2 inline __m256i CmpGt256(__m256i a, __m256i b)
 {
-    return a >= b;
+    if (kSize == BITS_8)
+        return _mm256_cmpgt_epi8(a, b);
+    if (kSize == BITS_16)
+        return _mm256_cmpgt_epi16(a, b);
+    return _mm256_cmpgt_epi32(a, b);
 }
 
-static bool (*cheatSearchFunc[])(uint32_t, uint32_t) = {
-    cheatSearchEQ,
-    cheatSearchNE,
-    cheatSearchLT,
-    cheatSearchLE,
-    cheatSearchGT,
-    cheatSearchGE
-};
+template <int kSize>
+VBAM_TARGET_AVX2 inline uint32_t Fail256(int compare, __m256i a, __m256i b)
+{
+    switch (compare) {
+    case SEARCH_EQ:
+        return ~(uint32_t)_mm256_movemask_epi8(CmpEq256<kSize>(a, b));
+    case SEARCH_NE:
+        return (uint32_t)_mm256_movemask_epi8(CmpEq256<kSize>(a, b));
+    case SEARCH_LT:
+        return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(CmpGt256<kSize>(a, b), CmpEq256<kSize>(a, b)));
+    case SEARCH_LE:
+        return (uint32_t)_mm256_movemask_epi8(CmpGt256<kSize>(a, b));
+    case SEARCH_GT:
+        return ~(uint32_t)_mm256_movemask_epi8(CmpGt256<kSize>(a, b));
+    default:
+        return (uint32_t)_mm256_movemask_epi8(CmpGt256<kSize>(b, a));
+    }
+}
+
+template <int kSize>
+VBAM_TARGET_AVX2 int SearchAvx2(CheatSearchBlock* block, const SearchArgs& args, bool isSigned, int begin, int end)
+{
+    const __m256i bias = isSigned ? _mm256_setzero_si256() : Splat256<kSize>(0x80u << ((8 << kSize) - 8));
+    const __m256i value = _mm256_xor_si256(Splat256<kSize>(args.value), bias);
+    const uint8_t* saved = block->saved;
+    int j = begin;
+    for (; j + 32 <= end; j += 32) {
+        uint32_t word;
+        memcpy(&word, block->bits + (j >> 3), sizeof(word));
+        const uint32_t tested = word & kTestedBits[kSize];
+        if (!tested)
+            continue;
+        const __m256i a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(block->data + j)), bias);
+        const __m256i b = args.byValue ? value : _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(saved + j)), bias);
+        const uint32_t cleared = Fail256<kSize>(args.compare, a, b) & (tested * kClearedBits[kSize]);
+        if (cleared) {
+            word &= ~cleared;
+            memcpy(block->bits + (j >> 3), &word, sizeof(word));
+        }
+    }
+    return j;
+}
 
-static bool (*cheatSearchSignedFunc[])(int32_t, int32_t) = {
-    cheatSearchSignedEQ,
-    cheatSearchSignedNE,
-    cheatSearchSignedLT,
-    cheatSearchSignedLE,
-    cheatSearchSignedGT,
-    cheatSearchSignedGE
+const SearchKernel kSse2Kernels[3] = { SearchSse2<BITS_8>, SearchSse2<BITS_16>, SearchSse2<BITS_32> };
+const SearchKernel kAvx2Kernels[3] = { SearchAvx2<BITS_8>, SearchAvx2<BITS_16>, SearchAvx2<BITS_32> };
+
+#endif // defined(VBAM_SIMD_X86)
+
+SearchKernel GetKernel(int size)
+{
+    const CpuFeatures& cpu = GetCpuFeatures();
+#if defined(VBAM_SIMD_X86)
+    if (cpu.avx2)
+        return kAvx2Kernels[size];
+    if (cpu.sse2)
+        return kSse2Kernels[size];
+#endif
+    (void)cpu;
+    (void)size;
+    return nullptr;
+}
+
+// Searches the candidates in [begin, end) of a dense block.
+template <typename T, int kSize>
+void SearchDense(CheatSearchBlock* block, const SearchArgs& args, SearchKernel kernel, int begin, int end)
+{
+    const bool isSigned = T(-1) < T(0);
+    if (kernel)
+        begin = kernel(block, args, isSigned, begin, end);
+
+    const int inc = 1 << kSize;
+    uint8_t* bits = block->bits;
+    const T value = (T)args.value;
+    for (int j = begin; j + inc <= end; j += inc) {
+        if (IS_BIT_SET(bits, j)) {
+            const T a = Load<T, kSize>(block->data + j);
+            const T b = args.byValue ? value : Load<T, kSize>(block->saved + j);
+            if (!Compare(args.compare, a, b)) {
+                for (int k = 0; k < inc; k++)
+                    CLEAR_BIT(bits, j + k);
+            }
+        }
+    }
+}
+
+// Searches the candidate list of a sparse block.
+template <typename T, int kSize>
+void SearchSparse(CheatSearchBlock* block, const SearchArgs& args)
+{
+    const uint32_t inc = 1 << kSize;
+    const T value = (T)args.value;
+    std::vector<uint32_t>& candidates = block->candidates;
+    size_t kept = 0;
+    // End of the last failed candidate, whose bytes are all dropped.
+    uint32_t cleared = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const uint32_t off = candidates[i];
+        if (off < cleared)
+            continue;
+        if (!(off & (inc - 1)) && off + inc <= (uint32_t)block->size) {
+            const T a = Load<T, kSize>(block->data + off);
+            const T b = args.byValue ? value : Load<T, kSize>(block->saved + off);
+            if (!Compare(args.compare, a, b)) {
+                for (uint32_t k = 0; k < inc; k++)
+                    CLEAR_BIT(block->bits, off + k);
+                cleared = off + inc;
+                continue;
+            }
+        }
+        candidates[kept++] = off;
+    }
+    candidates.resize(kept);
+}
+
+typedef void (*DenseSearch)(CheatSearchBlock* block, const SearchArgs& args, SearchKernel kernel, int begin, int end);
+typedef void (*SparseSearch)(CheatSearchBlock* block, const SearchArgs& args);
+
+// Indexed by [isSigned][size].
+const DenseSearch kDenseSearch[2][3] = {
+    { SearchDense<uint32_t, BITS_8>, SearchDense<uint32_t, BITS_16>, SearchDense<uint32_t, BITS_32> },
+    { SearchDense<int32_t, BITS_8>, SearchDense<int32_t, BITS_16>, SearchDense<int32_t, BITS_32> }
 };
+const SparseSearch kSparseSearch[2][3] = {
+    { SearchSparse<uint32_t, BITS_8>, SearchSparse<uint32_t, BITS_16>, SearchSparse<uint32_t, BITS_32> },
+    { SearchSparse<int32_t, BITS_8>, SearchSparse<int32_t, BITS_16>, SearchSparse<int32_t, BITS_32> }
+};
+
+// Switches a dense block to a candidate list once the list would be
+// smaller than the bitmap.
+void UpdateSparse(CheatSearchBlock* block)
+{
+    const int bytes = block->size >> 3;
+    int count = 0;
+    for (int k = 0; k < bytes; k++)
+        count += CountBits(block->bits[k]);
+    if (count * (int)sizeof(uint32_t) > bytes)
+        return;
+
+    block->sparse = true;
+    block->candidates.clear();
+    block->candidates.reserve(count);
+    for (int k = 0; k < bytes; k++) {
+        if (!block->bits[k])
+            continue;
+        for (int bit = 0; bit < 8; bit++) {
+            if (block->bits[k] & (1 << bit))
+                block->candidates.push_back((k << 3) + bit);
+        }
+    }
+}
+
+void PushHistory(CheatSearchData* cs, int compare, int size, bool isSigned, const SearchArgs& args)
+{
+    if (cs->history.size() == kHistorySize)
+        cs->history.erase(cs->history.begin());
+
+    CheatSearchStep step;
+    step.compare = compare;
+    step.size = size;
+    step.isSigned = isSigned;
+    step.byValue = args.byValue;
+    step.value = args.value;
+    step.sparse.resize(cs->count);
+    step.candidates.resize(cs->count);
+    step.bits.resize(cs->count);
+    for (int i = 0; i < cs->count; i++) {
+        const CheatSearchBlock* block = &cs->blocks[i];
+        step.sparse[i] = block->sparse;
+        if (block->sparse)
+            step.candidates[i] = block->candidates;
+        else
+            step.bits[i].assign(block->bits, block->bits + (block->size >> 3));
+    }
+    cs->history.push_back(std::move(step));
+}
+
+void Search(CheatSearchData* cs, int compare, int size, bool isSigned, const SearchArgs& args)
+{
+    if (compare < 0 || compare > SEARCH_GE || size < BITS_8 || size > BITS_32)
+        return;
+
+    PushHistory(cs, compare, size, isSigned, args);
+
+    const SearchKernel kernel = args.byValue && !FitsSize(args.value, size, isSigned) ? nullptr : GetKernel(size);
+    const DenseSearch dense = kDenseSearch[isSigned][size];
+
+    struct Slice {
+        CheatSearchBlock* block;
+        int begin;
+        int end;
+    };
+    std::vector<Slice> slices;
+    int denseBytes = 0;
+    for (int i = 0; i < cs->count; i++) {
+        CheatSearchBlock* block = &cs->blocks[i];
+        if (block->sparse) {
+            kSparseSearch[isSigned][size](block, args);
+            continue;
+        }
+        for (int begin = 0; begin < block->size; begin += kSliceSize)
+            slices.push_back({ block, begin, std::min(begin + kSliceSize, block->size) });
+        denseBytes += block->size;
+    }
+
+    const std::function<void(int)> job = [&](int i) {
+        dense(slices[i].block, args, kernel, slices[i].begin, slices[i].end);
+    };
+#if !defined(__LIBRETRO__)
+    if (denseBytes >= kParallelThreshold) {
+        GetSharedJobPool().ParallelFor((int)slices.size(), job);
+    } else
+#endif
+    {
+        for (size_t i = 0; i < slices.size(); i++)
+            job((int)i);
+    }
+
+    for (int i = 0; i < cs->count; i++) {
+        if (!cs->blocks[i].sparse)
+            UpdateSparse(&cs->blocks[i]);
+    }
+}
+
+} // namespace
 
 void cheatSearchCleanup(CheatSearchData* cs)
 {
@@ -95,11 +450,14 @@ void cheatSearchCleanup(CheatSearchData* cs)
     for (int i = 0; i < count; i++) {
         free(cs->blocks[i].saved);
         free(cs->blocks[i].bits);
+        cs->blocks[i].sparse = false;
+        std::vector<uint32_t>().swap(cs->blocks[i].candidates);
     }
+    cs->history.clear();
     cs->count = 0;
 }
 
-void cheatSearchStart(const CheatSearchData* cs)
+void cheatSearchStart(CheatSearchData* cs)
 {
     int count = cs->count;
 
@@ -108,7 +466,10 @@ void cheatSearchStart(const CheatSearchData* cs)
 
         memset(block->bits, 0xff, block->size >> 3);
         memcpy(block->saved, block->data, block->size);
+        block->sparse = false;
+        block->candidates.clear();
     }
+    cs->history.clear();
 }
 
 int32_t cheatSearchSignedRead(uint8_t* data, int off, int size)
@@ -145,142 +506,74 @@ uint32_t cheatSearchRead(uint8_t* data, int off, int size)
     return res;
 }
 
-void cheatSearch(const CheatSearchData* cs, int compare, int size,
+void cheatSearch(CheatSearchData* cs, int compare, int size,
     bool isSigned)
 {
-    if (compare < 0 || compare > SEARCH_GE)
-        return;
-    int inc = 1;
-    if (size == BITS_16)
-        inc = 2;
-    else if (size == BITS_32)
-        inc = 4;
+    SearchArgs args = { compare, false, 0 };
+    Search(cs, compare, size, isSigned, args);
+}
 
-    if (isSigned) {
-        bool (*func)(int32_t, int32_t) = cheatSearchSignedFunc[compare];
-
-        for (int i = 0; i < cs->count; i++) {
-            CheatSearchBlock* block = &cs->blocks[i];
-            int size2 = block->size;
-            uint8_t* bits = block->bits;
-            uint8_t* data = block->data;
-            uint8_t* saved = block->saved;
-
-            for (int j = 0; j < size2; j += inc) {
-                if (IS_BIT_SET(bits, j)) {
-                    int32_t a = cheatSearchSignedRead(data, j, size);
-                    int32_t b = cheatSearchSignedRead(saved, j, size);
-
-                    if (!func(a, b)) {
-                        CLEAR_BIT(bits, j);
-                        if (size == BITS_16)
-                            CLEAR_BIT(bits, j + 1);
-                        if (size == BITS_32) {
-                            CLEAR_BIT(bits, j + 2);
-                            CLEAR_BIT(bits, j + 3);
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        bool (*func)(uint32_t, uint32_t) = cheatSearchFunc[compare];
-
-        for (int i = 0; i < cs->count; i++) {
-            CheatSearchBlock* block = &cs->blocks[i];
-            int size2 = block->size;
-            uint8_t* bits = block->bits;
-            uint8_t* data = block->data;
-            uint8_t* saved = block->saved;
-
-            for (int j = 0; j < size2; j += inc) {
-                if (IS_BIT_SET(bits, j)) {
-                    uint32_t a = cheatSearchRead(data, j, size);
-                    uint32_t b = cheatSearchRead(saved, j, size);
-
-                    if (!func(a, b)) {
-                        CLEAR_BIT(bits, j);
-                        if (size == BITS_16)
-                            CLEAR_BIT(bits, j + 1);
-                        if (size == BITS_32) {
-                            CLEAR_BIT(bits, j + 2);
-                            CLEAR_BIT(bits, j + 3);
-                        }
-                    }
-                }
-            }
+void cheatSearchValue(CheatSearchData* cs, int compare, int size,
+    bool isSigned, uint32_t value)
+{
+    SearchArgs args = { compare, true, value };
+    Search(cs, compare, size, isSigned, args);
+}
+
+bool cheatSearchUndo(CheatSearchData* cs)
+{
+    if (cs->history.empty())
+        return false;
+
+    CheatSearchStep& step = cs->history.back();
+    for (int i = 0; i < cs->count && i < (int)step.sparse.size(); i++) {
+        CheatSearchBlock* block = &cs->blocks[i];
+        block->sparse = step.sparse[i];
+        if (block->sparse) {
+            memset(block->bits, 0, block->size >> 3);
+            block->candidates = std::move(step.candidates[i]);
+            for (uint32_t off : block->candidates)
+                SET_BIT(block->bits, off);
+        } else {
+            memcpy(block->bits, step.bits[i].data(), block->size >> 3);
+            block->candidates.clear();
         }
     }
+    cs->history.pop_back();
+    return true;
 }
 
-void cheatSearchValue(const CheatSearchData* cs, int compare, int size,
-    bool isSigned, uint32_t value)
+int cheatSearchGetCount(const CheatSearchData* cs, int size)
 {
-    if (compare < 0 || compare > SEARCH_GE)
-        return;
+    int res = 0;
     int inc = 1;
     if (size == BITS_16)
         inc = 2;
     else if (size == BITS_32)
         inc = 4;
 
-    if (isSigned) {
-        bool (*func)(int32_t, int32_t) = cheatSearchSignedFunc[compare];
-
-        for (int i = 0; i < cs->count; i++) {
-            CheatSearchBlock* block = &cs->blocks[i];
-            int size2 = block->size;
-            uint8_t* bits = block->bits;
-            uint8_t* data = block->data;
-
-            for (int j = 0; j < size2; j += inc) {
-                if (IS_BIT_SET(bits, j)) {
-                    int32_t a = cheatSearchSignedRead(data, j, size);
-                    int32_t b = (int32_t)value;
-
-                    if (!func(a, b)) {
-                        CLEAR_BIT(bits, j);
-                        if (size == BITS_16)
-                            CLEAR_BIT(bits, j + 1);
-                        if (size == BITS_32) {
-                            CLEAR_BIT(bits, j + 2);
-                            CLEAR_BIT(bits, j + 3);
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        bool (*func)(uint32_t, uint32_t) = cheatSearchFunc[compare];
-
-        for (int i = 0; i < cs->count; i++) {
-            CheatSearchBlock* block = &cs->blocks[i];
-            int size2 = block->size;
-            uint8_t* bits = block->bits;
-            uint8_t* data = block->data;
-
-            for (int j = 0; j < size2; j += inc) {
-                if (IS_BIT_SET(bits, j)) {
-                    uint32_t a = cheatSearchRead(data, j, size);
-
-                    if (!func(a, value)) {
-                        CLEAR_BIT(bits, j);
-                        if (size == BITS_16)
-                            CLEAR_BIT(bits, j + 1);
-                        if (size == BITS_32) {
-                            CLEAR_BIT(bits, j + 2);
-                            CLEAR_BIT(bits, j + 3);
-                        }
-                    }
-                }
+    for (int i = 0; i < cs->count; i++) {
+        const CheatSearchBlock* block = &cs->blocks[i];
+
+        if (block->sparse) {
+            for (uint32_t off : block->candidates) {
+                if (!(off & (inc - 1)))
+                    res++;
             }
+            continue;
         }
+
+        const uint32_t tested = kTestedBits[inc >> 1] & 0xFF;
+        int bytes = block->size >> 3;
+        for (int k = 0; k < bytes; k++)
+            res += CountBits(block->bits[k] & tested);
     }
+    return res;
 }
 
-int cheatSearchGetCount(const CheatSearchData* cs, int size)
+std::vector<uint32_t> cheatSearchGetResults(const CheatSearchData* cs, int size)
 {
-    int res = 0;
+    std::vector<uint32_t> res;
     int inc = 1;
     if (size == BITS_16)
         inc = 2;
@@ -288,13 +581,24 @@ int cheatSearchGetCount(const CheatSearchData* cs, int size)
         inc = 4;
 
     for (int i = 0; i < cs->count; i++) {
-        CheatSearchBlock* block = &cs->blocks[i];
+        const CheatSearchBlock* block = &cs->blocks[i];
+        const uint32_t tag = (uint32_t)i << 28;
 
-        int size2 = block->size;
-        uint8_t* bits = block->bits;
-        for (int j = 0; j < size2; j += inc) {
-            if (IS_BIT_SET(bits, j))
-                res++;
+        if (block->sparse) {
+            for (uint32_t off : block->candidates) {
+                if (!(off & (inc - 1)))
+                    res.push_back(tag + off);
+            }
+            continue;
+        }
+
+        for (int j = 0; j < block->size; j += inc) {
+            if (!(j & 7) && !block->bits[j >> 3]) {
+                j += 8 - inc;
+                continue;
+            }
+            if (IS_BIT_SET(block->bits, j))
+                res.push_back(tag + j);
         }
     }
     return res;
@@ -2,18 +2,40 @@
 #define VBAM_CORE_GBA_GBACHEATSEARCH_H_
 
 #include <cstdint>
+#include <vector>
 
 struct CheatSearchBlock {
     int size;
     uint32_t offset;
+    // One bit per byte of `data`, set while the byte is still a candidate.
     uint8_t* bits;
     uint8_t* data;
     uint8_t* saved;
+    // Once few candidates are left, `candidates` holds the sorted offsets of
+    // the set bits of `bits` and the searches only visit those. `bits` is
+    // kept up to date either way.
+    bool sparse;
+    std::vector<uint32_t> candidates;
+};
+
+// The candidates of every block before a search, so it can be undone.
+struct CheatSearchStep {
+    int compare;
+    int size;
+    bool isSigned;
+    // True for a search against `value`, false for one against the old values.
+    bool byValue;
+    uint32_t value;
+    std::vector<bool> sparse;
+    std::vector<std::vector<uint32_t>> candidates;
+    std::vector<std::vector<uint8_t>> bits;
 };
 
 struct CheatSearchData {
     int count;
     CheatSearchBlock* blocks;
+    // The most recent searches, oldest first.
+    std::vector<CheatSearchStep> history;
 };
 
 enum { SEARCH_EQ,
@@ -36,10 +58,15 @@ enum { BITS_8,
 extern CheatSearchData cheatSearchData;
 
 void cheatSearchCleanup(CheatSearchData* cs);
-void cheatSearchStart(const CheatSearchData* cs);
-void cheatSearch(const CheatSearchData* cs, int compare, int size, bool isSigned);
-void cheatSearchValue(const CheatSearchData* cs, int compare, int size, bool isSigned, uint32_t value);
+void cheatSearchStart(CheatSearchData* cs);
+void cheatSearch(CheatSearchData* cs, int compare, int size, bool isSigned);
+void cheatSearchValue(CheatSearchData* cs, int compare, int size, bool isSigned, uint32_t value);
+// Restores the candidates from before the last search. Returns false if
+// there is no search left to undo.
+bool cheatSearchUndo(CheatSearchData* cs);
 int cheatSearchGetCount(const CheatSearchData* cs, int size);
+// Returns the candidates aligned to `size`, as (block << 28) + offset.
+std::vector<uint32_t> cheatSearchGetResults(const CheatSearchData* cs, int size);
 void cheatSearchUpdateValues(const CheatSearchData* cs);
 int32_t cheatSearchSignedRead(uint8_t* data, int off, int size);
 uint32_t cheatSearchRead(uint8_t* data, int off, int size);
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 #include "core/base/file_util.h"
 #include "core/base/message.h"
@@ -562,6 +563,791 @@ static int getCodeLength(int num)
     return 1;
 }
 
+// cheatsCheckKeys() runs at every VBlank, and at every pass over the master
+// code when there is one, so it does not interpret cheatsList itself. The
+// list is compiled, whenever it has changed, into a flat program of
+// pre-decoded ops: the code types are resolved once, the lines a code reads
+// ahead are captured, disabled codes are left out and the conditional codes
+// become jumps to the op that runs next.
+//
+// Every enabled line has two halves, each compiled to at most one op. The
+// first half always runs and may consume the next line. The second half runs
+// on the line the first one stopped at, and only while no GSA conditional
+// has turned the codes off, so its op is "gated".
+
+enum CheatOpKind : uint8_t {
+    CHEAT_OP_NONE, // Only moves on, for the codes that skip lines.
+    CHEAT_OP_CODES_ON,
+    CHEAT_OP_SLOWDOWN,
+    CHEAT_OP_MASTER_CODE,
+    CHEAT_OP_WRITE,
+    CHEAT_OP_BUTTON_WRITE,
+    CHEAT_OP_ROM_WRITE,
+    CHEAT_OP_ROM_PATCH,
+    CHEAT_OP_ROM_PATCH2,
+    CHEAT_OP_SLIDE,
+    CHEAT_OP_FILL,
+    CHEAT_OP_BYTES,
+    CHEAT_OP_GROUP_WRITE,
+    CHEAT_OP_IO_WRITE,
+    CHEAT_OP_AND,
+    CHEAT_OP_OR,
+    CHEAT_OP_ADD,
+    CHEAT_OP_ADD_WORD, // Adds to the word at the address, writes `width` bytes.
+    CHEAT_OP_POINTER,
+    CHEAT_OP_IF,
+    CHEAT_OP_IF_KEYS,
+};
+
+enum CheatCompare : uint8_t {
+    CHEAT_CMP_EQ,
+    CHEAT_CMP_NE,
+    CHEAT_CMP_LT,
+    CHEAT_CMP_GT,
+    CHEAT_CMP_AND,
+};
+
+struct CheatOp {
+    uint8_t kind;
+    // Skipped while the codes are off.
+    bool gated;
+    // Access size in bytes, or the rompatch2 slot of CHEAT_OP_ROM_PATCH2.
+    uint8_t width;
+    // CHEAT_OP_IF: the condition to jump on. CHEAT_OP_IF_KEYS: the mode.
+    uint8_t cmp;
+    bool negate;
+    bool isSigned;
+    // CHEAT_OP_IF: turn the codes off instead of jumping.
+    bool clearsOnOff;
+    // Line of cheatsList holding the state of the code.
+    int entry;
+    uint32_t address;
+    uint32_t value;
+    uint32_t operand;
+    uint32_t valueInc;
+    uint32_t addressInc;
+    uint32_t count;
+    // First element in cheatsProgramData.
+    uint32_t data;
+    // Plain writes to work RAM and internal RAM go straight to the host
+    // buffer. `base` points to g_workRAM or g_internalRAM, which are only
+    // allocated when a ROM is loaded.
+    uint8_t** base;
+    uint32_t offset;
+#ifdef VBAM_ENABLE_DEBUGGER
+    const uint8_t* freeze;
+#endif
+    // Ops to run next: after the op, when it jumps, and when it is skipped
+    // because the codes are off.
+    int next;
+    int skip;
+    int fallthrough;
+};
+
+// While compiling, jump targets are lines of cheatsList. This one stands for
+// the op right after, i.e. the second half of the same line.
+static const int kCheatNextOp = -1;
+
+static std::vector<CheatOp> cheatsProgram;
+static std::vector<uint32_t> cheatsProgramData;
+static int cheatsProgramStart = 0;
+static bool cheatsProgramDirty = true;
+
+static uint32_t cheatsWidthMask(int width)
+{
+    return width == 1 ? 0xFF : width == 2 ? 0xFFFF : 0xFFFFFFFF;
+}
+
+static uint32_t cheatsRead(int width, uint32_t address)
+{
+    switch (width) {
+    case 1:
+        return CPUReadByte(address);
+    case 2:
+        return CPUReadHalfWord(address);
+    default:
+        return CPUReadMemory(address);
+    }
+}
+
+static void cheatsWrite(int width, uint32_t address, uint32_t value)
+{
+    switch (width) {
+    case 1:
+        CPUWriteByte(address, DowncastU8(value));
+        break;
+    case 2:
+        CPUWriteHalfWord(address, DowncastU16(value));
+        break;
+    default:
+        CPUWriteMemory(address, value);
+        break;
+    }
+}
+
+static void cheatsSetWrite(CheatOp& op, uint8_t kind, int width, uint32_t address, uint32_t value)
+{
+    op.kind = kind;
+    op.width = width;
+    op.address = address;
+    op.value = value;
+
+    const uint32_t alignMask = ~(uint32_t)(width - 1);
+    switch (address >> 24) {
+    case 2:
+        op.base = &g_workRAM;
+        op.offset = address & 0x3FFFF & alignMask;
+#ifdef VBAM_ENABLE_DEBUGGER
+        op.freeze = &freezeWorkRAM[op.offset];
+#endif
+        break;
+    case 3:
+        op.base = &g_internalRAM;
+        op.offset = address & 0x7FFF & alignMask;
+#ifdef VBAM_ENABLE_DEBUGGER
+        op.freeze = &freezeInternalRAM[op.offset];
+#endif
+        break;
+    }
+}
+
+static void cheatsRunWrite(const CheatOp& op)
+{
+    if (op.base) {
+#ifdef VBAM_ENABLE_DEBUGGER
+        // Breakpoints and frozen addresses are handled by CPUWrite*().
+        bool direct = map[op.address >> 24].breakPoints == NULL;
+        for (int i = 0; direct && i < op.width; i++)
+            direct = op.freeze[i] == 0;
+        if (direct)
+#endif
+        {
+            uint8_t* p = *op.base + op.offset;
+            switch (op.width) {
+            case 1:
+                *p = DowncastU8(op.value);
+                break;
+            case 2:
+                WRITE16LE(((uint16_t*)p), DowncastU16(op.value));
+                break;
+            default:
+                WRITE32LE(((uint32_t*)p), op.value);
+                break;
+            }
+            return;
+        }
+    }
+    cheatsWrite(op.width, op.address, op.value);
+}
+
+static void cheatsSetIf(CheatOp& op, int width, uint8_t cmp, bool negate, bool isSigned, uint32_t operand,
+    int skipLines)
+{
+    op.kind = CHEAT_OP_IF;
+    op.width = width;
+    op.cmp = cmp;
+    op.negate = negate;
+    op.isSigned = isSigned;
+    op.operand = operand;
+    op.skip = op.entry + skipLines + 1;
+}
+
+// The "3" GSA conditionals turn off all the codes that follow, up to the
+// next GSA_CODES_ON, instead of skipping lines.
+static void cheatsSetIfOff(CheatOp& op, int width, uint8_t cmp, bool negate, bool isSigned, uint32_t operand)
+{
+    cheatsSetIf(op, width, cmp, negate, isSigned, operand, 0);
+    op.clearsOnOff = true;
+}
+
+static bool cheatsRunCompare(const CheatOp& op)
+{
+    const uint32_t value = cheatsRead(op.width, op.address);
+    bool result;
+    if (op.isSigned) {
+        int32_t svalue;
+        if (op.width == 1)
+            svalue = static_cast<int8_t>(value);
+        else if (op.width == 2)
+            svalue = static_cast<int16_t>(value);
+        else
+            svalue = static_cast<int32_t>(value);
+        if (op.cmp == CHEAT_CMP_LT)
+            result = svalue < (int32_t)op.operand;
+        else
+            result = svalue > (int32_t)op.operand;
+    } else {
+        switch (op.cmp) {
+        case CHEAT_CMP_EQ:
+            result = value == op.operand;
+            break;
+        case CHEAT_CMP_NE:
+            result = value != op.operand;
+            break;
+        case CHEAT_CMP_LT:
+            result = value < op.operand;
+            break;
+        case CHEAT_CMP_GT:
+            result = value > op.operand;
+            break;
+        default:
+            result = (value & op.operand) != 0;
+            break;
+        }
+    }
+    return result != op.negate;
+}
+
+// Compiles the first half of line `i`. Returns the line the second half runs
+// on, which is the next one for the codes that take two lines.
+static int cheatsCompileFirst(int i, CheatOp& op)
+{
+    const CheatsData& c = cheatsList[i];
+    op.entry = i;
+    switch (c.size) {
+    case GSA_CODES_ON:
+        op.kind = CHEAT_OP_CODES_ON;
+        break;
+    case GSA_SLOWDOWN:
+        op.kind = CHEAT_OP_SLOWDOWN;
+        break;
+    case GSA_8_BIT_SLIDE:
+    case GSA_16_BIT_SLIDE:
+    case GSA_32_BIT_SLIDE:
+        if (++i < cheatsNumber) {
+            const CheatsData& line = cheatsList[i];
+            op.kind = CHEAT_OP_SLIDE;
+            op.width = c.size == GSA_8_BIT_SLIDE ? 1 : c.size == GSA_16_BIT_SLIDE ? 2 : 4;
+            op.address = c.value;
+            op.value = line.rawaddress & cheatsWidthMask(op.width);
+            op.valueInc = (line.value >> 24) & 0xFF;
+            op.count = (line.value >> 16) & 0xFF;
+            op.addressInc = (line.value & 0xFFFF) * op.width;
+            // The 16-bit slide has always kept its increment in 16 bits.
+            if (op.width == 2)
+                op.addressInc &= 0xFFFF;
+        }
+        break;
+    case GSA_8_BIT_GS_WRITE2:
+    case GSA_16_BIT_GS_WRITE2:
+    case GSA_32_BIT_GS_WRITE2:
+        if (++i < cheatsNumber) {
+            const int width = c.size == GSA_8_BIT_GS_WRITE2 ? 1 : c.size == GSA_16_BIT_GS_WRITE2 ? 2 : 4;
+            cheatsSetWrite(op, CHEAT_OP_BUTTON_WRITE, width, c.value, cheatsList[i].address);
+        }
+        break;
+    case GSA_16_BIT_ROM_PATCH:
+        op.kind = CHEAT_OP_ROM_PATCH;
+        break;
+    case GSA_16_BIT_ROM_PATCH2C:
+    case GSA_16_BIT_ROM_PATCH2D:
+    case GSA_16_BIT_ROM_PATCH2E:
+    case GSA_16_BIT_ROM_PATCH2F:
+        if (++i < cheatsNumber) {
+            op.kind = CHEAT_OP_ROM_PATCH2;
+            op.width = c.size == GSA_16_BIT_ROM_PATCH2C ? 0 : c.size - GSA_16_BIT_ROM_PATCH2D + 1;
+            op.address = ((c.value & 0x00FFFFFF) << 1) + 0x8000000;
+            op.value = cheatsList[i].rawaddress & 0xFFFF;
+        }
+        break;
+    case MASTER_CODE:
+        op.kind = CHEAT_OP_MASTER_CODE;
+        op.address = c.address;
+        break;
+    }
+    op.next = i + 1;
+    return i;
+}
+
+// Compiles the second half of line `i`, the part that only runs while the
+// codes are on. Jump targets are left as lines of cheatsList.
+static void cheatsCompileSecond(int i, CheatOp& op)
+{
+    const CheatsData& c = cheatsList[i];
+    op.gated = true;
+    op.entry = i;
+    op.address = c.address;
+    op.value = c.value;
+    op.next = i + 1;
+    op.fallthrough = i + 1;
+    switch (c.size) {
+    case INT_8_BIT_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_WRITE, 1, c.address, c.value);
+        break;
+    case INT_16_BIT_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_WRITE, 2, c.address, c.value);
+        break;
+    case INT_32_BIT_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_WRITE, 4, c.address, c.value);
+        break;
+    case GSA_8_BIT_GS_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_BUTTON_WRITE, 1, c.address, c.value);
+        break;
+    case GSA_16_BIT_GS_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_BUTTON_WRITE, 2, c.address, c.value);
+        break;
+    case GSA_32_BIT_GS_WRITE:
+        cheatsSetWrite(op, CHEAT_OP_BUTTON_WRITE, 4, c.address, c.value);
+        break;
+    case CBA_IF_KEYS_PRESSED:
+        if ((c.address & 0xF0) <= 0x20) {
+            op.kind = CHEAT_OP_IF_KEYS;
+            op.cmp = c.address & 0xF0;
+            op.value = c.value & 0xFFFF;
+            op.skip = i + 2;
+        }
+        break;
+    case CBA_IF_TRUE:
+        cheatsSetIf(op, 2, CHEAT_CMP_NE, false, false, c.value, 1);
+        break;
+    case CBA_SLIDE_CODE:
+        if (i + 1 < cheatsNumber) {
+            const CheatsData& line = cheatsList[i + 1];
+            op.kind = CHEAT_OP_SLIDE;
+            op.width = 2;
+            op.value = c.value & 0xFFFF;
+            op.count = ((line.address - 1) & 0xFFFF) + 1;
+            op.valueInc = (line.address >> 16) & 0xFFFF;
+            op.addressInc = line.value;
+        }
+        op.next = i + 2;
+        break;
+    case CBA_IF_FALSE:
+        cheatsSetIf(op, 2, CHEAT_CMP_EQ, false, false, c.value, 1);
+        break;
+    case CBA_AND:
+        op.kind = CHEAT_OP_AND;
+        break;
+    case GSA_8_BIT_IF_TRUE:
+        cheatsSetIf(op, 1, CHEAT_CMP_NE, false, false, c.value, 1);
+        break;
+    case GSA_32_BIT_IF_TRUE:
+        cheatsSetIf(op, 4, CHEAT_CMP_NE, false, false, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_FALSE:
+        cheatsSetIf(op, 1, CHEAT_CMP_EQ, false, false, c.value, 1);
+        break;
+    case GSA_32_BIT_IF_FALSE:
+        cheatsSetIf(op, 4, CHEAT_CMP_EQ, false, false, c.value, 1);
+        break;
+    case GSA_8_BIT_FILL:
+        op.kind = CHEAT_OP_FILL;
+        op.width = 1;
+        op.value = c.value & 0xff;
+        op.addressInc = 1;
+        op.operand = c.address + (c.value >> 8);
+        break;
+    case GSA_16_BIT_FILL:
+        op.kind = CHEAT_OP_FILL;
+        op.width = 2;
+        op.value = c.value & 0xffff;
+        op.addressInc = 2;
+        op.operand = c.address + ((c.value >> 16) << 1);
+        break;
+    case GSA_8_BIT_IF_TRUE2:
+        cheatsSetIf(op, 1, CHEAT_CMP_NE, false, false, c.value, 2);
+        break;
+    case GSA_16_BIT_IF_TRUE2:
+        cheatsSetIf(op, 2, CHEAT_CMP_NE, false, false, c.value, 2);
+        break;
+    case GSA_32_BIT_IF_TRUE2:
+        cheatsSetIf(op, 4, CHEAT_CMP_NE, false, false, c.value, 2);
+        break;
+    case GSA_8_BIT_IF_FALSE2:
+        cheatsSetIf(op, 1, CHEAT_CMP_EQ, false, false, c.value, 2);
+        break;
+    case GSA_16_BIT_IF_FALSE2:
+        cheatsSetIf(op, 2, CHEAT_CMP_EQ, false, false, c.value, 2);
+        break;
+    case GSA_32_BIT_IF_FALSE2:
+        cheatsSetIf(op, 4, CHEAT_CMP_EQ, false, false, c.value, 2);
+        break;
+    case CBA_ADD:
+        op.kind = CHEAT_OP_ADD;
+        op.operand = c.value;
+        if ((c.address & 1) == 0) {
+            op.width = 2;
+        } else {
+            op.width = 4;
+            op.address = c.address & 0x0FFFFFFE;
+        }
+        break;
+    case CBA_OR:
+        op.kind = CHEAT_OP_OR;
+        break;
+    case CBA_GT:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, true, false, c.value, 1);
+        break;
+    case CBA_LT:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, true, false, c.value, 1);
+        break;
+    case CBA_SUPER: {
+        // The bytes to write follow in the next lines, six per line.
+        const int count = 2 * ((c.value - 1) & 0xFFFF) + 1;
+        int line = i;
+        op.kind = CHEAT_OP_BYTES;
+        op.data = (uint32_t)cheatsProgramData.size();
+        for (int x = 0; x <= count; x++) {
+            const int res = x % 6;
+            if (res == 0)
+                line++;
+            if (line >= MAX_CHEATS)
+                continue;
+            if (res < 4)
+                cheatsProgramData.push_back((cheatsList[line].address >> (24 - 8 * res)) & 0xFF);
+            else
+                cheatsProgramData.push_back((cheatsList[line].value >> (8 - 8 * (res - 4))) & 0xFF);
+        }
+        op.count = (uint32_t)cheatsProgramData.size() - op.data;
+        op.next = line + 1;
+    } break;
+    case GSA_8_BIT_POINTER:
+        op.kind = CHEAT_OP_POINTER;
+        op.width = 1;
+        op.operand = (c.value & 0xFFFFFF00) >> 8;
+        op.value = c.value & 0xFF;
+        break;
+    case GSA_16_BIT_POINTER:
+        op.kind = CHEAT_OP_POINTER;
+        op.width = 2;
+        op.operand = (c.value & 0xFFFF0000) >> 15;
+        op.value = c.value & 0xFFFF;
+        break;
+    case GSA_32_BIT_POINTER:
+        op.kind = CHEAT_OP_POINTER;
+        op.width = 4;
+        break;
+    case GSA_8_BIT_ADD:
+        op.kind = CHEAT_OP_ADD_WORD;
+        op.width = 1;
+        op.operand = c.value & 0xFF;
+        break;
+    case GSA_16_BIT_ADD:
+        op.kind = CHEAT_OP_ADD_WORD;
+        op.width = 2;
+        op.operand = c.value & 0xFFFF;
+        break;
+    case GSA_32_BIT_ADD:
+        op.kind = CHEAT_OP_ADD_WORD;
+        op.width = 4;
+        op.operand = c.value;
+        break;
+    case GSA_8_BIT_IF_LOWER_U:
+        cheatsSetIf(op, 1, CHEAT_CMP_LT, true, false, c.value & 0xFF, 1);
+        break;
+    case GSA_16_BIT_IF_LOWER_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, true, false, c.value & 0xFFFF, 1);
+        break;
+    case GSA_32_BIT_IF_LOWER_U:
+        cheatsSetIf(op, 4, CHEAT_CMP_LT, true, false, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_HIGHER_U:
+        cheatsSetIf(op, 1, CHEAT_CMP_GT, true, false, c.value & 0xFF, 1);
+        break;
+    case GSA_16_BIT_IF_HIGHER_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, true, false, c.value & 0xFFFF, 1);
+        break;
+    case GSA_32_BIT_IF_HIGHER_U:
+        cheatsSetIf(op, 4, CHEAT_CMP_GT, true, false, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_AND:
+        cheatsSetIf(op, 1, CHEAT_CMP_AND, true, false, c.value & 0xFF, 1);
+        break;
+    case GSA_16_BIT_IF_AND:
+        cheatsSetIf(op, 2, CHEAT_CMP_AND, true, false, c.value & 0xFFFF, 1);
+        break;
+    case GSA_32_BIT_IF_AND:
+        cheatsSetIf(op, 4, CHEAT_CMP_AND, true, false, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_LOWER_U2:
+        cheatsSetIf(op, 1, CHEAT_CMP_LT, true, false, c.value & 0xFF, 2);
+        break;
+    case GSA_16_BIT_IF_LOWER_U2:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, true, false, c.value & 0xFFFF, 2);
+        break;
+    case GSA_32_BIT_IF_LOWER_U2:
+        cheatsSetIf(op, 4, CHEAT_CMP_LT, true, false, c.value, 2);
+        break;
+    case GSA_8_BIT_IF_HIGHER_U2:
+        cheatsSetIf(op, 1, CHEAT_CMP_GT, true, false, c.value & 0xFF, 2);
+        break;
+    case GSA_16_BIT_IF_HIGHER_U2:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, true, false, c.value & 0xFFFF, 2);
+        break;
+    case GSA_32_BIT_IF_HIGHER_U2:
+        cheatsSetIf(op, 4, CHEAT_CMP_GT, true, false, c.value, 2);
+        break;
+    case GSA_8_BIT_IF_AND2:
+        cheatsSetIf(op, 1, CHEAT_CMP_AND, true, false, c.value & 0xFF, 2);
+        break;
+    case GSA_16_BIT_IF_AND2:
+        cheatsSetIf(op, 2, CHEAT_CMP_AND, true, false, c.value & 0xFFFF, 2);
+        break;
+    case GSA_32_BIT_IF_AND2:
+        cheatsSetIf(op, 4, CHEAT_CMP_AND, true, false, c.value, 2);
+        break;
+    case GSA_ALWAYS:
+        op.next = i + 2;
+        break;
+    case GSA_ALWAYS2:
+        op.next = i + 3;
+        break;
+    case GSA_8_BIT_IF_LOWER_S:
+        cheatsSetIf(op, 1, CHEAT_CMP_LT, true, true, c.value & 0xFF, 1);
+        break;
+    case GSA_16_BIT_IF_LOWER_S:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, true, true, c.value & 0xFFFF, 1);
+        break;
+    case GSA_32_BIT_IF_LOWER_S:
+        cheatsSetIf(op, 4, CHEAT_CMP_LT, true, true, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_HIGHER_S:
+        cheatsSetIf(op, 1, CHEAT_CMP_GT, true, true, c.value & 0xFF, 1);
+        break;
+    case GSA_16_BIT_IF_HIGHER_S:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, true, true, c.value & 0xFFFF, 1);
+        break;
+    case GSA_32_BIT_IF_HIGHER_S:
+        cheatsSetIf(op, 4, CHEAT_CMP_GT, true, true, c.value, 1);
+        break;
+    case GSA_8_BIT_IF_LOWER_S2:
+        cheatsSetIf(op, 1, CHEAT_CMP_LT, true, true, c.value & 0xFF, 2);
+        break;
+    case GSA_16_BIT_IF_LOWER_S2:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, true, true, c.value & 0xFFFF, 2);
+        break;
+    case GSA_32_BIT_IF_LOWER_S2:
+        cheatsSetIf(op, 4, CHEAT_CMP_LT, true, true, c.value, 2);
+        break;
+    case GSA_8_BIT_IF_HIGHER_S2:
+        cheatsSetIf(op, 1, CHEAT_CMP_GT, true, true, c.value & 0xFF, 2);
+        break;
+    case GSA_16_BIT_IF_HIGHER_S2:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, true, true, c.value & 0xFFFF, 2);
+        break;
+    case GSA_32_BIT_IF_HIGHER_S2:
+        cheatsSetIf(op, 4, CHEAT_CMP_GT, true, true, c.value, 2);
+        break;
+    case GSA_16_BIT_WRITE_IOREGS:
+    case GSA_32_BIT_WRITE_IOREGS:
+        // Pairs of (offset in g_ioMem, value). DISPSTAT and KEYINPUT are
+        // never written.
+        op.data = (uint32_t)cheatsProgramData.size();
+        if (c.size == GSA_16_BIT_WRITE_IOREGS) {
+            if ((c.address <= 0x3FF) && (c.address != 0x6) && (c.address != 0x130)) {
+                cheatsProgramData.push_back(c.address & 0x3FE);
+                cheatsProgramData.push_back(c.value & 0xFFFF);
+            }
+        } else if (c.address <= 0x3FF) {
+            const uint32_t cheat_addr = c.address & 0x3FC;
+            if ((cheat_addr != 6) && (cheat_addr != 0x130)) {
+                cheatsProgramData.push_back(cheat_addr);
+                cheatsProgramData.push_back(c.value & 0xFFFF);
+            }
+            if (((cheat_addr + 2) != 0x6) && (cheat_addr + 2) != 0x130) {
+                cheatsProgramData.push_back(cheat_addr + 2);
+                cheatsProgramData.push_back((c.value >> 16) & 0xFFFF);
+            }
+        }
+        op.count = ((uint32_t)cheatsProgramData.size() - op.data) / 2;
+        if (op.count)
+            op.kind = CHEAT_OP_IO_WRITE;
+        break;
+    case GSA_8_BIT_IF_TRUE3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_NE, false, false, c.value);
+        break;
+    case GSA_16_BIT_IF_TRUE3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_NE, false, false, c.value);
+        break;
+    case GSA_32_BIT_IF_TRUE3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_NE, false, false, c.value);
+        break;
+    case GSA_8_BIT_IF_FALSE3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_EQ, false, false, c.value);
+        break;
+    case GSA_16_BIT_IF_FALSE3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_EQ, false, false, c.value);
+        break;
+    case GSA_32_BIT_IF_FALSE3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_EQ, false, false, c.value);
+        break;
+    case GSA_8_BIT_IF_LOWER_S3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_LT, true, true, c.value & 0xFF);
+        break;
+    case GSA_16_BIT_IF_LOWER_S3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_LT, true, true, c.value & 0xFFFF);
+        break;
+    case GSA_32_BIT_IF_LOWER_S3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_LT, true, true, c.value);
+        break;
+    case GSA_8_BIT_IF_HIGHER_S3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_GT, true, true, c.value & 0xFF);
+        break;
+    case GSA_16_BIT_IF_HIGHER_S3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_GT, true, true, c.value & 0xFFFF);
+        break;
+    case GSA_32_BIT_IF_HIGHER_S3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_GT, true, true, c.value);
+        break;
+    case GSA_8_BIT_IF_LOWER_U3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_LT, true, false, c.value & 0xFF);
+        break;
+    case GSA_16_BIT_IF_LOWER_U3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_LT, true, false, c.value & 0xFFFF);
+        break;
+    case GSA_32_BIT_IF_LOWER_U3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_LT, true, false, c.value);
+        break;
+    case GSA_8_BIT_IF_HIGHER_U3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_GT, true, false, c.value & 0xFF);
+        break;
+    case GSA_16_BIT_IF_HIGHER_U3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_GT, true, false, c.value & 0xFFFF);
+        break;
+    case GSA_32_BIT_IF_HIGHER_U3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_GT, true, false, c.value);
+        break;
+    case GSA_8_BIT_IF_AND3:
+        cheatsSetIfOff(op, 1, CHEAT_CMP_AND, true, false, c.value & 0xFF);
+        break;
+    case GSA_16_BIT_IF_AND3:
+        cheatsSetIfOff(op, 2, CHEAT_CMP_AND, true, false, c.value & 0xFFFF);
+        break;
+    case GSA_32_BIT_IF_AND3:
+    case GSA_ALWAYS3:
+        cheatsSetIfOff(op, 4, CHEAT_CMP_AND, true, false, c.value);
+        break;
+    case GSA_GROUP_WRITE: {
+        // Writes the value to the addresses that follow, two per line.
+        const int count = ((c.address) & 0xFFFE) + 1;
+        int line = i;
+        op.kind = CHEAT_OP_GROUP_WRITE;
+        op.data = (uint32_t)cheatsProgramData.size();
+        for (int x = 1; x <= count; x++) {
+            if ((x % 2) == 0) {
+                if (x < count)
+                    line++;
+                if (line < MAX_CHEATS)
+                    cheatsProgramData.push_back(cheatsList[line].rawaddress);
+            } else if (line < MAX_CHEATS) {
+                cheatsProgramData.push_back(cheatsList[line].value);
+            }
+        }
+        op.count = (uint32_t)cheatsProgramData.size() - op.data;
+        op.next = line + 1;
+    } break;
+    case GSA_32_BIT_ADD2:
+    case GSA_32_BIT_SUB2: {
+        const uint32_t operand = i + 1 < MAX_CHEATS ? cheatsList[i + 1].rawaddress : 0;
+        op.kind = CHEAT_OP_ADD;
+        op.width = 4;
+        op.address = c.value;
+        op.operand = c.size == GSA_32_BIT_ADD2 ? operand : 0 - operand;
+        op.next = i + 2;
+    } break;
+    case GSA_16_BIT_IF_LOWER_OR_EQ_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, false, false, c.value, 1);
+        break;
+    case GSA_16_BIT_IF_HIGHER_OR_EQ_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, false, false, c.value, 1);
+        break;
+    case GSA_16_BIT_MIF_TRUE:
+        cheatsSetIf(op, 2, CHEAT_CMP_NE, false, false, c.value, (c.rawaddress >> 0x10) & 0xFF);
+        break;
+    case GSA_16_BIT_MIF_FALSE:
+        cheatsSetIf(op, 2, CHEAT_CMP_EQ, false, false, c.value, (c.rawaddress >> 0x10) & 0xFF);
+        break;
+    case GSA_16_BIT_MIF_LOWER_OR_EQ_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_GT, false, false, c.value, (c.rawaddress >> 0x10) & 0xFF);
+        break;
+    case GSA_16_BIT_MIF_HIGHER_OR_EQ_U:
+        cheatsSetIf(op, 2, CHEAT_CMP_LT, false, false, c.value, (c.rawaddress >> 0x10) & 0xFF);
+        break;
+    case CHEATS_16_BIT_WRITE:
+        if ((c.address >> 24) >= 0x08) {
+            op.kind = CHEAT_OP_ROM_WRITE;
+            op.width = 2;
+        } else {
+            cheatsSetWrite(op, CHEAT_OP_WRITE, 2, c.address, c.value);
+        }
+        break;
+    case CHEATS_32_BIT_WRITE:
+        if ((c.address >> 24) >= 0x08) {
+            op.kind = CHEAT_OP_ROM_WRITE;
+            op.width = 4;
+        } else {
+            cheatsSetWrite(op, CHEAT_OP_WRITE, 4, c.address, c.value);
+        }
+        break;
+    }
+}
+
+// Returns the op that runs when execution reaches `line` of cheatsList.
+static int cheatsResolveLine(int line, const std::vector<int>& lineOps)
+{
+    for (;;) {
+        // Skip the disabled codes, with all their lines.
+        while (line < cheatsNumber && !cheatsList[line].enabled)
+            line += getCodeLength(line);
+        if (line >= cheatsNumber)
+            return (int)cheatsProgram.size();
+        if (lineOps[line] >= 0)
+            return lineOps[line];
+        // An enabled line that does nothing.
+        line++;
+    }
+}
+
+static void cheatsCompile()
+{
+    cheatsProgram.clear();
+    cheatsProgramData.clear();
+
+    std::vector<int> lineOps(cheatsNumber, -1);
+    for (int i = 0; i < cheatsNumber; i++) {
+        if (!cheatsList[i].enabled)
+            continue;
+
+        CheatOp first = {};
+        const int line = cheatsCompileFirst(i, first);
+
+        // The second half of a line past the end of the list never ran.
+        CheatOp second = {};
+        bool hasSecond = false;
+        if (line < cheatsNumber) {
+            cheatsCompileSecond(line, second);
+            hasSecond = second.kind != CHEAT_OP_NONE || second.next != line + 1;
+        }
+
+        if (first.kind != CHEAT_OP_NONE) {
+            lineOps[i] = (int)cheatsProgram.size();
+            if (hasSecond)
+                first.next = kCheatNextOp;
+            first.fallthrough = first.next;
+            cheatsProgram.push_back(first);
+        }
+        if (hasSecond) {
+            if (lineOps[i] < 0)
+                lineOps[i] = (int)cheatsProgram.size();
+            cheatsProgram.push_back(second);
+        }
+    }
+
+    for (size_t pc = 0; pc < cheatsProgram.size(); pc++) {
+        CheatOp& op = cheatsProgram[pc];
+        if (op.next == kCheatNextOp) {
+            op.next = op.fallthrough = (int)pc + 1;
+        } else {
+            op.next = cheatsResolveLine(op.next, lineOps);
+            op.fallthrough = cheatsResolveLine(op.fallthrough, lineOps);
+        }
+        if (op.kind == CHEAT_OP_IF || op.kind == CHEAT_OP_IF_KEYS)
+            op.skip = cheatsResolveLine(op.skip, lineOps);
+    }
+    cheatsProgramStart = cheatsResolveLine(0, lineOps);
+    cheatsProgramDirty = false;
+}
+
 int cheatsCheckKeys(uint32_t keys, uint32_t extended)
 {
     bool onoff = true;
@@ -575,703 +1361,136 @@ int cheatsCheckKeys(uint32_t keys, uint32_t extended)
             rompatch2addr[i] = 0;
         }
 
-    for (i = 0; i < cheatsNumber; i++) {
-        if (!cheatsList[i].enabled) {
-            // make sure we skip other lines in this code
-            i += getCodeLength(i) - 1;
+    if (cheatsProgramDirty)
+        cheatsCompile();
+
+    const int size = (int)cheatsProgram.size();
+    int pc = cheatsProgramStart;
+    while (pc < size) {
+        const CheatOp& op = cheatsProgram[pc];
+        if (op.gated && !onoff) {
+            pc = op.fallthrough;
             continue;
         }
-        switch (cheatsList[i].size) {
-        case GSA_CODES_ON:
+        pc = op.next;
+        switch (op.kind) {
+        case CHEAT_OP_NONE:
+            break;
+        case CHEAT_OP_CODES_ON:
             onoff = true;
             break;
-        case GSA_SLOWDOWN:
+        case CHEAT_OP_SLOWDOWN: {
+            CheatsData& c = cheatsList[op.entry];
             // check if button was pressed and released, if so toggle our state
-            if ((cheatsList[i].status & 4) && !(extended & 4))
-                cheatsList[i].status ^= 1;
+            if ((c.status & 4) && !(extended & 4))
+                c.status ^= 1;
             if (extended & 4)
-                cheatsList[i].status |= 4;
+                c.status |= 4;
             else
-                cheatsList[i].status &= ~4;
+                c.status &= ~4;
 
-            if (cheatsList[i].status & 1)
-                ticks += ((cheatsList[i].value & 0xFFFF) * 7);
-            break;
-        case GSA_8_BIT_SLIDE:
-            i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint8_t value = DowncastU8(cheatsList[i].rawaddress);
-                const uint8_t vinc = DowncastU8(cheatsList[i].value >> 24);
-                uint8_t count = DowncastU8(cheatsList[i].value >> 16);
-                const uint16_t ainc = DowncastU16(cheatsList[i].value);
-                while (count > 0) {
-                    CPUWriteByte(addr, value);
-                    value += vinc;
-                    addr += ainc;
-                    count--;
-                }
-            }
-            break;
-        case GSA_16_BIT_SLIDE:
-            i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint16_t value = DowncastU16(cheatsList[i].rawaddress);
-                const uint16_t vinc = DowncastU16(cheatsList[i].value >> 24);
-                uint8_t count = DowncastU8(cheatsList[i].value >> 16);
-                const uint16_t ainc = DowncastU16(cheatsList[i].value & 0xffff) * 2;
-                while (count > 0) {
-                    CPUWriteHalfWord(addr, value);
-                    value += vinc;
-                    addr += ainc;
-                    count--;
-                }
-            }
-            break;
-        case GSA_32_BIT_SLIDE:
-            i++;
-            if (i < cheatsNumber) {
-                uint32_t addr = cheatsList[i - 1].value;
-                uint32_t value = cheatsList[i].rawaddress;
-                int vinc = (cheatsList[i].value >> 24) & 255;
-                int count = (cheatsList[i].value >> 16) & 255;
-                int ainc = (cheatsList[i].value & 0xffff) * 4;
-                while (count > 0) {
-                    CPUWriteMemory(addr, value);
-                    value += vinc;
-                    addr += ainc;
-                    count--;
-                }
-            }
+            if (c.status & 1)
+                ticks += ((c.value & 0xFFFF) * 7);
+        } break;
+        case CHEAT_OP_MASTER_CODE:
+            mastercode = op.address;
             break;
-        case GSA_8_BIT_GS_WRITE2:
-            i++;
-            if (i < cheatsNumber) {
-                if (extended & 4) {
-                    CPUWriteByte(cheatsList[i - 1].value, cheatsList[i].address);
-                }
-            }
+        case CHEAT_OP_WRITE:
+            cheatsRunWrite(op);
             break;
-        case GSA_16_BIT_GS_WRITE2:
-            i++;
-            if (i < cheatsNumber) {
-                if (extended & 4) {
-                    CPUWriteHalfWord(cheatsList[i - 1].value, cheatsList[i].address);
-                }
-            }
+        case CHEAT_OP_BUTTON_WRITE:
+            if (extended & 4)
+                cheatsRunWrite(op);
             break;
-        case GSA_32_BIT_GS_WRITE2:
-            i++;
-            if (i < cheatsNumber) {
-                if (extended & 4) {
-                    CPUWriteMemory(cheatsList[i - 1].value, cheatsList[i].address);
-                }
+        case CHEAT_OP_ROM_WRITE:
+            if (op.width == 2) {
+                CHEAT_PATCH_ROM_16BIT(op.address, op.value);
+            } else {
+                CHEAT_PATCH_ROM_32BIT(op.address, op.value);
             }
             break;
-        case GSA_16_BIT_ROM_PATCH:
-            if ((cheatsList[i].status & 1) == 0) {
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    cheatsList[i].oldValue = CPUReadHalfWord(cheatsList[i].address);
-                    cheatsList[i].status |= 1;
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[i].address, cheatsList[i].value);
+        case CHEAT_OP_ROM_PATCH: {
+            CheatsData& c = cheatsList[op.entry];
+            if ((c.status & 1) == 0) {
+                if (CPUReadHalfWord(c.address) != c.value) {
+                    c.oldValue = CPUReadHalfWord(c.address);
+                    c.status |= 1;
+                    CHEAT_PATCH_ROM_16BIT(c.address, c.value);
                 }
             }
+        } break;
+        case CHEAT_OP_ROM_PATCH2:
+            rompatch2addr[op.width] = op.address;
+            rompatch2oldval[op.width] = CPUReadHalfWord(op.address);
+            rompatch2val[op.width] = DowncastU16(op.value);
             break;
-        case GSA_16_BIT_ROM_PATCH2C:
-            i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[0] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[0] = CPUReadHalfWord(rompatch2addr[0]);
-                rompatch2val[0] = cheatsList[i].rawaddress & 0xFFFF;
-            }
-            break;
-        case GSA_16_BIT_ROM_PATCH2D:
-            i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[1] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[1] = CPUReadHalfWord(rompatch2addr[1]);
-                rompatch2val[1] = cheatsList[i].rawaddress & 0xFFFF;
+        case CHEAT_OP_SLIDE: {
+            uint32_t address = op.address;
+            uint32_t value = op.value;
+            for (uint32_t x = 0; x < op.count; x++) {
+                cheatsWrite(op.width, address, value);
+                value += op.valueInc;
+                address += op.addressInc;
             }
+        } break;
+        case CHEAT_OP_FILL: {
+            uint32_t address = op.address;
+            do {
+                cheatsWrite(op.width, address, op.value);
+                address += op.addressInc;
+            } while (address <= op.operand);
+        } break;
+        case CHEAT_OP_BYTES: {
+            const uint32_t* bytes = &cheatsProgramData[op.data];
+            for (uint32_t x = 0; x < op.count; x++)
+                CPUWriteByte(op.address + x, DowncastU8(bytes[x]));
+        } break;
+        case CHEAT_OP_GROUP_WRITE: {
+            const uint32_t* addresses = &cheatsProgramData[op.data];
+            for (uint32_t x = 0; x < op.count; x++)
+                CPUWriteMemory(addresses[x], op.value);
+        } break;
+        case CHEAT_OP_IO_WRITE: {
+            const uint32_t* writes = &cheatsProgramData[op.data];
+            for (uint32_t x = 0; x < op.count; x++)
+                g_ioMem[writes[2 * x]] = DowncastU8(writes[2 * x + 1]);
+        } break;
+        case CHEAT_OP_AND:
+            CPUWriteHalfWord(op.address, DowncastU16(CPUReadHalfWord(op.address) & op.value));
             break;
-        case GSA_16_BIT_ROM_PATCH2E:
-            i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[2] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[2] = CPUReadHalfWord(rompatch2addr[2]);
-                rompatch2val[2] = cheatsList[i].rawaddress & 0xFFFF;
-            }
+        case CHEAT_OP_OR:
+            CPUWriteHalfWord(op.address, DowncastU16(CPUReadHalfWord(op.address) | op.value));
             break;
-        case GSA_16_BIT_ROM_PATCH2F:
-            i++;
-            if (i < cheatsNumber) {
-                rompatch2addr[3] = ((cheatsList[i - 1].value & 0x00FFFFFF) << 1) + 0x8000000;
-                rompatch2oldval[3] = CPUReadHalfWord(rompatch2addr[3]);
-                rompatch2val[3] = cheatsList[i].rawaddress & 0xFFFF;
-            }
+        case CHEAT_OP_ADD:
+            cheatsWrite(op.width, op.address, cheatsRead(op.width, op.address) + op.operand);
             break;
-        case MASTER_CODE:
-            mastercode = cheatsList[i].address;
+        case CHEAT_OP_ADD_WORD:
+            cheatsWrite(op.width, op.address, CPUReadMemory(op.address) + op.operand);
             break;
-        }
-        if (onoff) {
-            switch (cheatsList[i].size) {
-            case INT_8_BIT_WRITE:
-                CPUWriteByte(cheatsList[i].address, cheatsList[i].value);
-                break;
-            case INT_16_BIT_WRITE:
-                CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
-                break;
-            case INT_32_BIT_WRITE:
-                CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
-                break;
-            case GSA_8_BIT_GS_WRITE:
-                if (extended & 4) {
-                    CPUWriteByte(cheatsList[i].address, cheatsList[i].value);
-                }
-                break;
-            case GSA_16_BIT_GS_WRITE:
-                if (extended & 4) {
-                    CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
-                }
-                break;
-            case GSA_32_BIT_GS_WRITE:
-                if (extended & 4) {
-                    CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
-                }
-                break;
-            case CBA_IF_KEYS_PRESSED: {
-                uint16_t value = cheatsList[i].value;
-                uint32_t addr = cheatsList[i].address;
-                if ((addr & 0xF0) == 0x20) {
-                    if ((keys & value) == 0) {
-                        i++;
-                    }
-                } else if ((addr & 0xF0) == 0x10) {
-                    if ((keys & value) == value) {
-                        i++;
-                    }
-                } else if ((addr & 0xF0) == 0x00) {
-                    if (((~keys) & 0x3FF) == value) {
-                        i++;
-                    }
-                }
-            } break;
-            case CBA_IF_TRUE:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case CBA_SLIDE_CODE: {
-                uint32_t address = cheatsList[i].address;
-                uint16_t value = cheatsList[i].value;
-                i++;
-                if (i < cheatsNumber) {
-                    int count = ((cheatsList[i].address - 1) & 0xFFFF);
-                    uint16_t vinc = (cheatsList[i].address >> 16) & 0xFFFF;
-                    int inc = cheatsList[i].value;
-                    for (int x = 0; x <= count; x++) {
-                        CPUWriteHalfWord(address, value);
-                        address += inc;
-                        value += vinc;
-                    }
-                }
-            } break;
-            case CBA_IF_FALSE:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case CBA_AND:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    CPUReadHalfWord(cheatsList[i].address) & cheatsList[i].value);
-                break;
-            case GSA_8_BIT_IF_TRUE:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_TRUE:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_FALSE:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_FALSE:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_FILL: {
-                uint32_t addr = cheatsList[i].address;
-                uint8_t v = cheatsList[i].value & 0xff;
-                uint32_t end = addr + (cheatsList[i].value >> 8);
-                do {
-                    CPUWriteByte(addr, v);
-                    addr++;
-                } while (addr <= end);
-            } break;
-            case GSA_16_BIT_FILL: {
-                uint32_t addr = cheatsList[i].address;
-                uint16_t v = cheatsList[i].value & 0xffff;
-                uint32_t end = addr + ((cheatsList[i].value >> 16) << 1);
-                do {
-                    CPUWriteHalfWord(addr, v);
-                    addr += 2;
-                } while (addr <= end);
-            } break;
-            case GSA_8_BIT_IF_TRUE2:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_TRUE2:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_TRUE2:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case GSA_8_BIT_IF_FALSE2:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_FALSE2:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_FALSE2:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
-                    i += 2;
-                }
-                break;
-            case CBA_ADD:
-                if ((cheatsList[i].address & 1) == 0) {
-                    CPUWriteHalfWord(cheatsList[i].address,
-                        CPUReadHalfWord(cheatsList[i].address) + cheatsList[i].value);
-                } else {
-                    CPUWriteMemory(cheatsList[i].address & 0x0FFFFFFE,
-                        CPUReadMemory(cheatsList[i].address & 0x0FFFFFFE) + cheatsList[i].value);
-                }
-                break;
-            case CBA_OR:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    CPUReadHalfWord(cheatsList[i].address) | cheatsList[i].value);
-                break;
-            case CBA_GT:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case CBA_LT:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case CBA_SUPER: {
-                int count = 2 * ((cheatsList[i].value - 1) & 0xFFFF) + 1;
-                uint32_t address = cheatsList[i].address;
-                for (int x = 0; x <= count; x++) {
-                    uint8_t b;
-                    int res = x % 6;
-                    if (res == 0)
-                        i++;
-                    if (res < 4)
-                        b = (cheatsList[i].address >> (24 - 8 * res)) & 0xFF;
-                    else
-                        b = (cheatsList[i].value >> (8 - 8 * (res - 4))) & 0xFF;
-                    CPUWriteByte(address, b);
-                    address++;
-                }
-            } break;
-            case GSA_8_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteByte(CPUReadMemory(cheatsList[i].address) + ((cheatsList[i].value & 0xFFFFFF00) >> 8),
-                        cheatsList[i].value & 0xFF);
-                }
-                break;
-            case GSA_16_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteHalfWord(CPUReadMemory(cheatsList[i].address) + ((cheatsList[i].value & 0xFFFF0000) >> 15),
-                        cheatsList[i].value & 0xFFFF);
-                }
-                break;
-            case GSA_32_BIT_POINTER:
-                if (((CPUReadMemory(cheatsList[i].address) >= 0x02000000) && (CPUReadMemory(cheatsList[i].address) < 0x02040000)) || ((CPUReadMemory(cheatsList[i].address) >= 0x03000000) && (CPUReadMemory(cheatsList[i].address) < 0x03008000))) {
-                    CPUWriteMemory(CPUReadMemory(cheatsList[i].address),
-                        cheatsList[i].value);
-                }
-                break;
-            case GSA_8_BIT_ADD:
-                CPUWriteByte(cheatsList[i].address,
-                    ((cheatsList[i].value & 0xFF) + CPUReadMemory(cheatsList[i].address)) & 0xFF);
-                break;
-            case GSA_16_BIT_ADD:
-                CPUWriteHalfWord(cheatsList[i].address,
-                    ((cheatsList[i].value & 0xFFFF) + CPUReadMemory(cheatsList[i].address)) & 0xFFFF);
-                break;
-            case GSA_32_BIT_ADD:
-                CPUWriteMemory(cheatsList[i].address,
-                    (cheatsList[i].value + CPUReadMemory(cheatsList[i].address)) & 0xFFFFFFFF);
-                break;
-            case GSA_8_BIT_IF_LOWER_U:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_U:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_U:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_U:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_U:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_U:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_AND:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_AND:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_AND:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_LOWER_U2:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_U2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_U2:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
-                    i += 2;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_U2:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_U2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_U2:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
-                    i += 2;
-                }
-                break;
-            case GSA_8_BIT_IF_AND2:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_AND2:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_AND2:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
-                    i += 2;
-                }
-                break;
-            case GSA_ALWAYS:
-                i++;
-                break;
-            case GSA_ALWAYS2:
-                i += 2;
-                break;
-            case GSA_8_BIT_IF_LOWER_S:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_S:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_S:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_S:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_S:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    i++;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_S:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
-                    i++;
-                }
-                break;
-            case GSA_8_BIT_IF_LOWER_S2:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_S2:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_S2:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
-                    i += 2;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_S2:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_S2:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    i += 2;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_S2:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
-                    i += 2;
-                }
-                break;
-            case GSA_16_BIT_WRITE_IOREGS:
-                if ((cheatsList[i].address <= 0x3FF) && (cheatsList[i].address != 0x6) && (cheatsList[i].address != 0x130))
-                    g_ioMem[cheatsList[i].address & 0x3FE] = cheatsList[i].value & 0xFFFF;
-                break;
-            case GSA_32_BIT_WRITE_IOREGS:
-                if (cheatsList[i].address <= 0x3FF) {
-                    uint32_t cheat_addr = cheatsList[i].address & 0x3FC;
-                    if ((cheat_addr != 6) && (cheat_addr != 0x130))
-                        g_ioMem[cheat_addr] = (cheatsList[i].value & 0xFFFF);
-                    if (((cheat_addr + 2) != 0x6) && (cheat_addr + 2) != 0x130)
-                        g_ioMem[cheat_addr + 2] = ((cheatsList[i].value >> 16) & 0xFFFF);
-                }
-                break;
-            case GSA_8_BIT_IF_TRUE3:
-                if (CPUReadByte(cheatsList[i].address) != cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_TRUE3:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_TRUE3:
-                if (CPUReadMemory(cheatsList[i].address) != cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_FALSE3:
-                if (CPUReadByte(cheatsList[i].address) == cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_FALSE3:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_FALSE3:
-                if (CPUReadMemory(cheatsList[i].address) == cheatsList[i].value) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_LOWER_S3:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) < ((int8_t)cheatsList[i].value & 0xFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_S3:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) < ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_S3:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) < (int32_t)cheatsList[i].value)) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_S3:
-                if (!((int8_t)CPUReadByte(cheatsList[i].address) > ((int8_t)cheatsList[i].value & 0xFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_S3:
-                if (!((int16_t)CPUReadHalfWord(cheatsList[i].address) > ((int16_t)cheatsList[i].value & 0xFFFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_S3:
-                if (!((int32_t)CPUReadMemory(cheatsList[i].address) > (int32_t)cheatsList[i].value)) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_LOWER_U3:
-                if (!(CPUReadByte(cheatsList[i].address) < (cheatsList[i].value & 0xFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_LOWER_U3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) < (cheatsList[i].value & 0xFFFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_LOWER_U3:
-                if (!(CPUReadMemory(cheatsList[i].address) < cheatsList[i].value)) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_HIGHER_U3:
-                if (!(CPUReadByte(cheatsList[i].address) > (cheatsList[i].value & 0xFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_U3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) > (cheatsList[i].value & 0xFFFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_HIGHER_U3:
-                if (!(CPUReadMemory(cheatsList[i].address) > cheatsList[i].value)) {
-                    onoff = false;
-                }
-                break;
-            case GSA_8_BIT_IF_AND3:
-                if (!(CPUReadByte(cheatsList[i].address) & (cheatsList[i].value & 0xFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_16_BIT_IF_AND3:
-                if (!(CPUReadHalfWord(cheatsList[i].address) & (cheatsList[i].value & 0xFFFF))) {
-                    onoff = false;
-                }
-                break;
-            case GSA_32_BIT_IF_AND3:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
-                    onoff = false;
-                }
-                break;
-            case GSA_ALWAYS3:
-                if (!(CPUReadMemory(cheatsList[i].address) & cheatsList[i].value)) {
+        case CHEAT_OP_POINTER: {
+            const uint32_t pointer = CPUReadMemory(op.address);
+            if ((pointer >= 0x02000000 && pointer < 0x02040000) || (pointer >= 0x03000000 && pointer < 0x03008000))
+                cheatsWrite(op.width, pointer + op.operand, op.value);
+        } break;
+        case CHEAT_OP_IF:
+            if (cheatsRunCompare(op)) {
+                if (op.clearsOnOff)
                     onoff = false;
-                }
-                break;
-            case GSA_GROUP_WRITE: {
-                int count = ((cheatsList[i].address) & 0xFFFE) + 1;
-                uint32_t value = cheatsList[i].value;
-                if (count == 0)
-                    i++;
                 else
-                    for (int x = 1; x <= count; x++) {
-                        if ((x % 2) == 0) {
-                            if (x < count)
-                                i++;
-                            CPUWriteMemory(cheatsList[i].rawaddress, value);
-                        } else
-                            CPUWriteMemory(cheatsList[i].value, value);
-                    }
-            } break;
-            case GSA_32_BIT_ADD2:
-                CPUWriteMemory(cheatsList[i].value,
-                    (CPUReadMemory(cheatsList[i].value) + cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
-                i++;
-                break;
-            case GSA_32_BIT_SUB2:
-                CPUWriteMemory(cheatsList[i].value,
-                    (CPUReadMemory(cheatsList[i].value) - cheatsList[i + 1].rawaddress) & 0xFFFFFFFF);
-                i++;
-                break;
-            case GSA_16_BIT_IF_LOWER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_IF_HIGHER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value) {
-                    i++;
-                }
-                break;
-            case GSA_16_BIT_MIF_TRUE:
-                if (CPUReadHalfWord(cheatsList[i].address) != cheatsList[i].value) {
-                    i += ((cheatsList[i].rawaddress >> 0x10) & 0xFF);
-                }
-                break;
-            case GSA_16_BIT_MIF_FALSE:
-                if (CPUReadHalfWord(cheatsList[i].address) == cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
-                }
-                break;
-            case GSA_16_BIT_MIF_LOWER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) > cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
-                }
-                break;
-            case GSA_16_BIT_MIF_HIGHER_OR_EQ_U:
-                if (CPUReadHalfWord(cheatsList[i].address) < cheatsList[i].value) {
-                    i += (cheatsList[i].rawaddress >> 0x10) & 0xFF;
-                }
-                break;
-            case CHEATS_16_BIT_WRITE:
-                if ((cheatsList[i].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_16BIT(cheatsList[i].address, cheatsList[i].value);
-                } else {
-                    CPUWriteHalfWord(cheatsList[i].address, cheatsList[i].value);
-                }
-                break;
-            case CHEATS_32_BIT_WRITE:
-                if ((cheatsList[i].address >> 24) >= 0x08) {
-                    CHEAT_PATCH_ROM_32BIT(cheatsList[i].address, cheatsList[i].value);
-                } else {
-                    CPUWriteMemory(cheatsList[i].address, cheatsList[i].value);
-                }
-                break;
+                    pc = op.skip;
             }
+            break;
+        case CHEAT_OP_IF_KEYS: {
+            bool skip;
+            if (op.cmp == 0x20)
+                skip = (keys & op.value) == 0;
+            else if (op.cmp == 0x10)
+                skip = (keys & op.value) == op.value;
+            else
+                skip = ((~keys) & 0x3FF) == op.value;
+            if (skip)
+                pc = op.skip;
+        } break;
         }
     }
     for (i = 0; i < 4; i++)
@@ -1320,6 +1539,7 @@ void cheatsAdd(const char* codeStr,
             break;
         }
         cheatsNumber++;
+        cheatsProgramDirty = true;
     }
 }
 
@@ -1377,6 +1597,7 @@ void cheatsDelete(int number, bool restore)
             memcpy(&cheatsList[x], &cheatsList[x + 1], sizeof(CheatsData) * (cheatsNumber - x - 1));
         }
         cheatsNumber--;
+        cheatsProgramDirty = true;
     }
 }
 
@@ -1392,6 +1613,7 @@ void cheatsEnable(int i)
     if (i >= 0 && i < cheatsNumber) {
         cheatsList[i].enabled = true;
         mastercode = 0;
+        cheatsProgramDirty = true;
     }
 }
 
@@ -1419,6 +1641,7 @@ void cheatsDisable(int i)
             break;
         }
         cheatsList[i].enabled = false;
+        cheatsProgramDirty = true;
     }
 }
 
@@ -2586,6 +2809,7 @@ void cheatsSaveGame(gzFile file)
 void cheatsReadGame(gzFile file, int version)
 {
     cheatsNumber = 0;
+    cheatsProgramDirty = true;
 
     cheatsNumber = utilReadInt(file);
 
@@ -2793,6 +3017,7 @@ bool cheatsLoadCheatList(const char* file)
         }
     }
     cheatsNumber = count;
+    cheatsProgramDirty = true;
     fclose(f);
     return true;
 }
@@ -7,6 +7,10 @@
 #include "core/gba/gbaCheats.h"
 #include "core/gba/gbaGlobals.h"
 
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+#include "core/gba/gbaMemStats.h"
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+
 extern int armExecute();
 extern int thumbExecute();
 
@@ -74,6 +78,9 @@ inline int dataTicksAccess16(uint32_t address) // DATA 8/16bits NON SEQ
 {
     int addr = (address >> 24) & 15;
     int value = memoryWait[addr];
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    memStatsCount(address, MEMSTATS_STALLS, value);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
     if ((addr >= 0x08) || (addr < 0x02)) {
         busPrefetchCount = 0;
@@ -92,6 +99,9 @@ inline int dataTicksAccess32(uint32_t address) // DATA 32bits NON SEQ
 {
     int addr = (address >> 24) & 15;
     int value = memoryWait32[addr];
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    memStatsCount(address, MEMSTATS_STALLS, value);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
     if ((addr >= 0x08) || (addr < 0x02)) {
         busPrefetchCount = 0;
@@ -110,6 +120,9 @@ inline int dataTicksAccessSeq16(uint32_t address) // DATA 8/16bits SEQ
 {
     int addr = (address >> 24) & 15;
     int value = memoryWaitSeq[addr];
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    memStatsCount(address, MEMSTATS_STALLS, value);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
     if ((addr >= 0x08) || (addr < 0x02)) {
         busPrefetchCount = 0;
@@ -128,6 +141,9 @@ inline int dataTicksAccessSeq32(uint32_t address) // DATA 32bits SEQ
 {
     int addr = (address >> 24) & 15;
     int value = memoryWaitSeq32[addr];
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    memStatsCount(address, MEMSTATS_STALLS, value);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 
     if ((addr >= 0x08) || (addr < 0x02)) {
         busPrefetchCount = 0;
@@ -3,15 +3,12 @@
 #include "core/gba/gbaCpu.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/gbaProfiler.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaRemote.h"
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
-#ifdef PROFILING
-#include "prof/prof.h"
-#endif
-
 #ifdef _MSC_VER
 // Disable "empty statement" warnings
 #pragma warning(disable : 4390)
@@ -1457,6 +1454,8 @@ static INSN_REGPARM void arm121(uint32_t opcode)
     if (LIKELY((opcode & 0x0FFFFFF0) == 0x012FFF10)) {
         int base = opcode & 0x0F;
         busPrefetchCount = 0;
+        if (profilerEnabled)
+            profilerBranch(reg[15].I - 8, reg[15].I - 4, reg[base].I);
         armState = reg[base].I & 1 ? false : true;
         if (armState) {
             reg[15].I = reg[base].I & 0xFFFFFFFC;
@@ -2582,6 +2581,8 @@ static INSN_REGPARM void armB00(uint32_t opcode)
     ARM_PREFETCH;
     clockTicks = (codeTicksAccessSeq32(armNextPC) * 2) + codeTicksAccess32(armNextPC) + 3;
     busPrefetchCount = 0;
+    if (profilerEnabled)
+        profilerCall(armNextPC, reg[14].I);
 }
 
 #ifdef GP_SUPPORT
@@ -2959,6 +2960,14 @@ int armExecute()
         if (clockTicks == 0)
             clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
         cpuTotalTicks += clockTicks;
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+        memStatsCount(oldArmNextPC, MEMSTATS_EXECUTED, 1);
+        memStatsCount(oldArmNextPC, MEMSTATS_CYCLES, clockTicks);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+        if (traceEnabled)
+            traceInstruction(oldArmNextPC, opcode, false);
+#endif  // defined(VBAM_ENABLE_TRACE)
 
     } while (cpuTotalTicks < cpuNextEvent && armState && !holdState && !SWITicks && !debugger);
 
@@ -10,15 +10,12 @@
 #include "core/gba/gbaCpu.h"
 #include "core/gba/gbaInline.h"
 #include "core/gba/gbaGlobals.h"
+#include "core/gba/gbaProfiler.h"
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 #include "core/gba/gbaRemote.h"
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
-#ifdef PROFILING
-#include "prof/prof.h"
-#endif
-
 #ifdef _MSC_VER
 #define snprintf _snprintf
 #endif
@@ -1286,6 +1283,8 @@ static INSN_REGPARM void thumb47(uint32_t opcode)
     int base = (opcode >> 3) & 15;
     busPrefetchCount = 0;
     UPDATE_OLDREG;
+    if (profilerEnabled)
+        profilerBranch(reg[15].I - 4, reg[15].I - 2, reg[base].I);
     reg[15].I = reg[base].I;
     if (reg[base].I & 1) {
         armState = false;
@@ -1624,6 +1623,8 @@ static INSN_REGPARM void thumbBD(uint32_t opcode)
     THUMB_PREFETCH;
     busPrefetchCount = 0;
     clockTicks += 3 + (codeTicksAccess16(armNextPC) * 2);
+    if (profilerEnabled)
+        profilerReturn(armNextPC);
 }
 
 // Load/store multiple ////////////////////////////////////////////////////
@@ -1860,6 +1861,8 @@ static INSN_REGPARM void thumbF8(uint32_t opcode)
     THUMB_PREFETCH;
     clockTicks = codeTicksAccessSeq16(armNextPC) * 2 + codeTicksAccess16(armNextPC) + 3;
     busPrefetchCount = 0;
+    if (profilerEnabled)
+        profilerCall(armNextPC, temp);
 }
 
 // Instruction table //////////////////////////////////////////////////////
@@ -2090,6 +2093,14 @@ int thumbExecute()
         if (clockTicks == 0)
             clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
         cpuTotalTicks += clockTicks;
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+        memStatsCount(oldArmNextPC, MEMSTATS_EXECUTED, 1);
+        memStatsCount(oldArmNextPC, MEMSTATS_CYCLES, clockTicks);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+        if (traceEnabled)
+            traceInstruction(oldArmNextPC, opcode, true);
+#endif  // defined(VBAM_ENABLE_TRACE)
 
     } while (cpuTotalTicks < cpuNextEvent && !armState && !holdState && !SWITicks && !debugger);
     return 1;
@@ -4,6 +4,20 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "core/base/message.h"
 #include "core/base/port.h"
 #include "core/gba/gba.h"
@@ -236,31 +250,170 @@ int elfFdeCount = 0;
 
 CompileUnit* elfCurrentUnit = NULL;
 
+// Whether elfFileData is a file mapping rather than a heap buffer.
+static bool elfFileMapped = false;
+static size_t elfFileSize = 0;
+
+// An address range [lo, hi) that resolves to the entry `index` of a table.
+struct ELFRange {
+    uint32_t lo;
+    uint64_t hi;
+    int index;
+};
+
+// The lookup tables of a compile unit, built when it is loaded.
+struct ELFUnitIndex {
+    std::vector<ELFRange> functions;
+    // The highest line table address up to each line table entry.
+    std::vector<uint32_t> lineMaxAddress;
+};
+
+static std::vector<ELFRange> elfSymbolRanges;
+static std::unordered_map<std::string, int> elfSymbolNames;
+static std::vector<CompileUnit*> elfUnits;
+static std::vector<ELFRange> elfUnitRanges;
+static std::vector<ELFUnitIndex> elfUnitIndexes;
+static std::vector<ELFRange> elfFdeRanges;
+
 uint32_t elfRead4Bytes(uint8_t*);
 uint16_t elfRead2Bytes(uint8_t*);
+uint8_t* elfParseCompileUnitChildren(uint8_t* data, CompileUnit* unit);
+void elfParseLineInfo(CompileUnit* unit);
 
-CompileUnit* elfGetCompileUnit(uint32_t addr)
+// Turns possibly overlapping ranges into sorted, disjoint ones in which
+// every address resolves to the lowest index that covers it, i.e. to the
+// entry that a scan of the table in order would find first.
+static std::vector<ELFRange> elfBuildRangeIndex(std::vector<ELFRange> ranges)
 {
-    if (elfCompileUnits) {
-        CompileUnit* unit = elfCompileUnits;
-        while (unit) {
-            if (unit->lowPC) {
-                if (addr >= unit->lowPC && addr < unit->highPC)
-                    return unit;
-            } else {
-                ARanges* r = unit->ranges;
-                if (r) {
-                    int count = r->count;
-                    for (int j = 0; j < count; j++) {
-                        if (addr >= r->ranges[j].lowPC && addr < r->ranges[j].highPC)
-                            return unit;
-                    }
-                }
-            }
-            unit = unit->next;
+    std::vector<ELFRange> index;
+    std::vector<uint64_t> bounds;
+    for (const ELFRange& r : ranges) {
+        if (r.hi > r.lo) {
+            bounds.push_back(r.lo);
+            bounds.push_back(r.hi);
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    std::sort(ranges.begin(), ranges.end(), [](const ELFRange& a, const ELFRange& b) {
+        return a.lo < b.lo;
+    });
+
+    auto later = [](const ELFRange& a, const ELFRange& b) { return a.index > b.index; };
+    std::priority_queue<ELFRange, std::vector<ELFRange>, decltype(later)> active(later);
+    size_t next = 0;
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        const uint64_t lo = bounds[i];
+        while (next < ranges.size() && ranges[next].lo <= lo) {
+            if (ranges[next].hi > ranges[next].lo)
+                active.push(ranges[next]);
+            next++;
+        }
+        while (!active.empty() && active.top().hi <= lo)
+            active.pop();
+        if (active.empty())
+            continue;
+        const int winner = active.top().index;
+        if (!index.empty() && index.back().hi == lo && index.back().index == winner)
+            index.back().hi = bounds[i + 1];
+        else
+            index.push_back({ (uint32_t)lo, bounds[i + 1], winner });
+    }
+    return index;
+}
+
+// Returns the index that `addr` resolves to, or -1.
+static int elfLookupRange(const std::vector<ELFRange>& index, uint32_t addr)
+{
+    auto it = std::upper_bound(index.begin(), index.end(), addr,
+        [](uint32_t a, const ELFRange& r) { return a < r.lo; });
+    if (it == index.begin())
+        return -1;
+    --it;
+    return addr < it->hi ? it->index : -1;
+}
+
+static void elfBuildSymbolIndex()
+{
+    std::vector<ELFRange> ranges;
+    ranges.reserve(elfSymbolsCount);
+    for (int i = 0; i < elfSymbolsCount; i++) {
+        const Symbol* s = &elfSymbols[i];
+        // A symbol also covers its own address when its size is 0 or
+        // wraps around.
+        const uint32_t end = s->value + s->size;
+        ranges.push_back({ s->value, end > s->value ? end : (uint64_t)s->value + 1, i });
+        elfSymbolNames.emplace(s->name, i);
+    }
+    elfSymbolRanges = elfBuildRangeIndex(std::move(ranges));
+}
+
+static void elfBuildCompileUnitIndex()
+{
+    std::vector<ELFRange> ranges;
+    for (CompileUnit* unit = elfCompileUnits; unit; unit = unit->next) {
+        if (unit->lowPC) {
+            ranges.push_back({ unit->lowPC, unit->highPC, unit->index });
+        } else if (unit->ranges) {
+            for (int j = 0; j < unit->ranges->count; j++)
+                ranges.push_back({ unit->ranges->ranges[j].lowPC, unit->ranges->ranges[j].highPC, unit->index });
         }
     }
-    return NULL;
+    elfUnitRanges = elfBuildRangeIndex(std::move(ranges));
+}
+
+static void elfLoadLineInfo(CompileUnit* unit)
+{
+    if (unit->lineInfoTable || !elfDebugInfo->linedata)
+        return;
+    elfParseLineInfo(unit);
+
+    const LineInfo* l = unit->lineInfoTable;
+    std::vector<uint32_t>& max = elfUnitIndexes[unit->index].lineMaxAddress;
+    max.resize(l->number);
+    for (int i = 0; i < l->number; i++)
+        max[i] = i ? std::max(max[i - 1], l->lines[i].address) : l->lines[i].address;
+}
+
+// Parses the functions, variables and line table of `unit` the first time
+// that they are needed.
+static void elfLoadCompileUnit(CompileUnit* unit)
+{
+    if (unit->loaded)
+        return;
+    unit->loaded = true;
+
+    if (unit->children) {
+        CompileUnit* current = elfCurrentUnit;
+        elfCurrentUnit = unit;
+        elfParseCompileUnitChildren(unit->children, unit);
+        elfCurrentUnit = current;
+    }
+    elfLoadLineInfo(unit);
+
+    std::vector<ELFRange> ranges;
+    int i = 0;
+    for (Function* func = unit->functions; func; func = func->next)
+        ranges.push_back({ func->lowPC, func->highPC, i++ });
+    elfUnitIndexes[unit->index].functions = elfBuildRangeIndex(std::move(ranges));
+}
+
+CompileUnit* elfGetCompileUnit(uint32_t addr)
+{
+    const int i = elfLookupRange(elfUnitRanges, addr);
+    return i < 0 ? NULL : elfUnits[i];
+}
+
+static Function* elfGetFunction(CompileUnit* unit, uint32_t addr)
+{
+    elfLoadCompileUnit(unit);
+    int i = elfLookupRange(elfUnitIndexes[unit->index].functions, addr);
+    if (i < 0)
+        return NULL;
+    Function* func = unit->functions;
+    while (i--)
+        func = func->next;
+    return func;
 }
 
 const char* elfGetAddressSymbol(uint32_t addr)
@@ -270,50 +423,37 @@ const char* elfGetAddressSymbol(uint32_t addr)
     CompileUnit* unit = elfGetCompileUnit(addr);
     // found unit, need to find function
     if (unit) {
-        Function* func = unit->functions;
-        while (func) {
-            if (addr >= func->lowPC && addr < func->highPC) {
-                int offset = addr - func->lowPC;
-                const char* name = func->name;
-                if (!name)
-                    name = "";
-                if (offset)
-                    snprintf(buffer, 256, "%s+%d", name, offset);
-                else {
-                    strncpy(buffer, name, 255);		//strncpy does not allways append a '\0'
-		    buffer[255] = '\0';
-		}
-                return buffer;
-            }
-            func = func->next;
-        }
-    }
-
-    if (elfSymbolsCount) {
-        for (int i = 0; i < elfSymbolsCount; i++) {
-            Symbol* s = &elfSymbols[i];
-            if ((addr >= s->value) && addr < (s->value + s->size)) {
-                int offset = addr - s->value;
-                const char* name = s->name;
-                if (name == NULL)
-                    name = "";
-                if (offset)
-                    snprintf(buffer, 256,"%s+%d", name, addr - s->value);
-                else {
-                    strncpy(buffer, name, 255);
-		    buffer[255] = '\0';
-		}
-                return buffer;
-            } else if (addr == s->value) {
-                if (s->name) {
-                    strncpy(buffer, s->name, 255);
-		    buffer[255] = '\0';
-		} else
-                    strcpy(buffer, "");
-                return buffer;
+        Function* func = elfGetFunction(unit, addr);
+        if (func) {
+            int offset = addr - func->lowPC;
+            const char* name = func->name;
+            if (!name)
+                name = "";
+            if (offset)
+                snprintf(buffer, 256, "%s+%d", name, offset);
+            else {
+                strncpy(buffer, name, 255);		//strncpy does not allways append a '\0'
+                buffer[255] = '\0';
             }
+            return buffer;
         }
     }
+
+    const int i = elfLookupRange(elfSymbolRanges, addr);
+    if (i >= 0) {
+        Symbol* s = &elfSymbols[i];
+        int offset = addr - s->value;
+        const char* name = s->name;
+        if (name == NULL)
+            name = "";
+        if (offset)
+            snprintf(buffer, 256, "%s+%d", name, offset);
+        else {
+            strncpy(buffer, name, 255);
+            buffer[255] = '\0';
+        }
+        return buffer;
+    }
     return "";
 }
 
@@ -322,6 +462,7 @@ bool elfFindLineInModule(uint32_t* addr, const char* name, int line)
     CompileUnit* unit = elfCompileUnits;
 
     while (unit) {
+        elfLoadLineInfo(unit);
         if (unit->lineInfoTable) {
             int i;
             int count = unit->lineInfoTable->fileCount;
@@ -354,16 +495,15 @@ bool elfFindLineInModule(uint32_t* addr, const char* name, int line)
 int elfFindLine(CompileUnit* unit, Function* /* func */, uint32_t addr, const char** f)
 {
     int currentLine = -1;
-    if (unit->hasLineInfo) {
-        int count = unit->lineInfoTable->number;
-        LineInfoItem* table = unit->lineInfoTable->lines;
-        int i;
-        for (i = 0; i < count; i++) {
-            if (addr <= table[i].address)
-                break;
-        }
-        if (i == count)
+    elfLoadCompileUnit(unit);
+    if (unit->hasLineInfo && unit->lineInfoTable && unit->lineInfoTable->number) {
+        // The first entry at or above addr is where the running maximum
+        // first reaches it.
+        const std::vector<uint32_t>& max = elfUnitIndexes[unit->index].lineMaxAddress;
+        int i = (int)(std::lower_bound(max.begin(), max.end(), addr) - max.begin());
+        if (i == (int)max.size())
             i--;
+        LineInfoItem* table = unit->lineInfoTable->lines;
         *f = table[i].file;
         currentLine = table[i].line;
     }
@@ -372,7 +512,8 @@ int elfFindLine(CompileUnit* unit, Function* /* func */, uint32_t addr, const ch
 
 bool elfFindLineInUnit(uint32_t* addr, CompileUnit* unit, int line)
 {
-    if (unit->hasLineInfo) {
+    elfLoadCompileUnit(unit);
+    if (unit->hasLineInfo && unit->lineInfoTable) {
         int count = unit->lineInfoTable->number;
         LineInfoItem* table = unit->lineInfoTable->lines;
         int i;
@@ -391,14 +532,11 @@ bool elfGetCurrentFunction(uint32_t addr, Function** f, CompileUnit** u)
     CompileUnit* unit = elfGetCompileUnit(addr);
     // found unit, need to find function
     if (unit) {
-        Function* func = unit->functions;
-        while (func) {
-            if (addr >= func->lowPC && addr < func->highPC) {
-                *f = func;
-                *u = unit;
-                return true;
-            }
-            func = func->next;
+        Function* func = elfGetFunction(unit, addr);
+        if (func) {
+            *f = func;
+            *u = unit;
+            return true;
         }
     }
     return false;
@@ -407,6 +545,7 @@ bool elfGetCurrentFunction(uint32_t addr, Function** f, CompileUnit** u)
 bool elfGetObject(const char* name, Function* f, CompileUnit* u, Object** o)
 {
     if (f && u) {
+        elfLoadCompileUnit(u);
         Object* v = f->variables;
 
         while (v) {
@@ -438,6 +577,7 @@ bool elfGetObject(const char* name, Function* f, CompileUnit* u, Object** o)
 
     while (c) {
         if (c != u) {
+            elfLoadCompileUnit(c);
             Object* v = c->variables;
             while (v) {
                 if (strcmp(name, v->name) == 0) {
@@ -467,32 +607,35 @@ const char* elfGetSymbol(int i, uint32_t* value, uint32_t* size, int* type)
 
 bool elfGetSymbolAddress(const char* sym, uint32_t* addr, uint32_t* size, int* type)
 {
-    if (elfSymbolsCount) {
-        for (int i = 0; i < elfSymbolsCount; i++) {
-            Symbol* s = &elfSymbols[i];
-            if (strcmp(sym, s->name) == 0) {
-                *addr = s->value;
-                *size = s->size;
-                *type = s->type;
-                return true;
-            }
-        }
+    auto it = elfSymbolNames.find(sym);
+    if (it != elfSymbolNames.end()) {
+        Symbol* s = &elfSymbols[it->second];
+        *addr = s->value;
+        *size = s->size;
+        *type = s->type;
+        return true;
     }
     return false;
 }
 
+static void elfBuildFdeIndex()
+{
+    std::vector<ELFRange> ranges;
+    ranges.reserve(elfFdeCount);
+    for (int i = 0; i < elfFdeCount; i++)
+        ranges.push_back({ elfFdes[i]->address, elfFdes[i]->end, i });
+    elfFdeRanges = elfBuildRangeIndex(std::move(ranges));
+}
+
 ELFfde* elfGetFde(uint32_t address)
 {
-    if (elfFdes) {
-        int i;
-        for (i = 0; i < elfFdeCount; i++) {
-            if (address >= elfFdes[i]->address && address < elfFdes[i]->end) {
-                return elfFdes[i];
-            }
-        }
-    }
+    const int i = elfLookupRange(elfFdeRanges, address);
+    return i < 0 ? NULL : elfFdes[i];
+}
 
-    return NULL;
+bool elfHasFrameInfo()
+{
+    return elfFdeCount != 0;
 }
 
 void elfExecuteCFAInstructions(ELFFrameState* state, uint8_t* data, uint32_t len,
@@ -621,12 +764,85 @@ ELFFrameState* elfGetFrameState(ELFfde* fde, uint32_t address)
     return state;
 }
 
+static void elfFreeFrameState(ELFFrameState* state)
+{
+    ELFFrameStateRegisters* prev = state->registers.previous;
+    while (prev) {
+        ELFFrameStateRegisters* p = prev->previous;
+        free(prev);
+        prev = p;
+    }
+    free(state);
+}
+
+// Restores `regs` to their values in the caller of the function that
+// `*address` is in and sets `*address` to the return address. Returns false
+// when there is no frame information to do so.
+static bool elfUnwindFrame(uint32_t* address, reg_pair* regs, bool verbose)
+{
+    ELFfde* fde = elfGetFde(*address);
+
+    if (fde == NULL) {
+        return false;
+    }
+
+    ELFFrameState* state = elfGetFrameState(fde, *address);
+
+    if (!state) {
+        return false;
+    }
+
+    bool ok = state->cfaMode == CFA_REG_OFFSET;
+    if (ok) {
+        reg_pair newRegs[15];
+        for (int i = 0; i < 15; i++) {
+            ELFFrameStateRegister* r = &state->registers.regs[i];
+
+            switch (r->mode) {
+            case REG_NOT_SET:
+                newRegs[i].I = regs[i].I;
+                break;
+            case REG_OFFSET:
+                newRegs[i].I = elfReadMemory(regs[state->cfaRegister].I + state->cfaOffset + r->offset);
+                break;
+            case REG_REGISTER:
+                newRegs[i].I = regs[r->reg].I;
+                break;
+            default:
+                newRegs[i].I = regs[i].I;
+                if (verbose)
+                    printf("Unknown register mode: %d\n", r->mode);
+                break;
+            }
+        }
+        memcpy(regs, newRegs, sizeof(reg_pair) * 15);
+        *address = newRegs[14].I & 0xfffffffe;
+    } else if (verbose) {
+        printf("CFA not set\n");
+    }
+    elfFreeFrameState(state);
+    return ok;
+}
+
+int elfGetCallChain(uint32_t address, uint32_t* chain, int max)
+{
+    reg_pair regs[15];
+    memcpy(&regs[0], &reg[0], sizeof(reg_pair) * 15);
+
+    int count = 0;
+    while (count < max) {
+        chain[count++] = address;
+        if (!elfUnwindFrame(&address, regs, false))
+            break;
+    }
+    return count;
+}
+
 void elfPrintCallChain(uint32_t address)
 {
     int count = 1;
 
     reg_pair regs[15];
-    reg_pair newRegs[15];
 
     memcpy(&regs[0], &reg[0], sizeof(reg_pair) * 15);
 
@@ -637,58 +853,9 @@ void elfPrintCallChain(uint32_t address)
 
         printf("%08x %s\n", address, addr);
 
-        ELFfde* fde = elfGetFde(address);
-
-        if (fde == NULL) {
-            break;
-        }
-
-        ELFFrameState* state = elfGetFrameState(fde, address);
-
-        if (!state) {
-            break;
-        }
-
-        if (state->cfaMode == CFA_REG_OFFSET) {
-            memcpy(&newRegs[0], &regs[0], sizeof(reg_pair) * 15);
-            uint32_t addr = 0;
-            for (int i = 0; i < 15; i++) {
-                ELFFrameStateRegister* r = &state->registers.regs[i];
-
-                switch (r->mode) {
-                case REG_NOT_SET:
-                    newRegs[i].I = regs[i].I;
-                    break;
-                case REG_OFFSET:
-                    newRegs[i].I = elfReadMemory(regs[state->cfaRegister].I + state->cfaOffset + r->offset);
-                    break;
-                case REG_REGISTER:
-                    newRegs[i].I = regs[r->reg].I;
-                    break;
-                default:
-                    printf("Unknown register mode: %d\n", r->mode);
-                    break;
-                }
-            }
-            memcpy(regs, newRegs, sizeof(reg_pair) * 15);
-            addr = newRegs[14].I;
-            addr &= 0xfffffffe;
-            address = addr;
-            count++;
-        } else {
-            printf("CFA not set\n");
+        if (!elfUnwindFrame(&address, regs, true))
             break;
-        }
-        if (state->registers.previous) {
-            ELFFrameStateRegisters* prev = state->registers.previous;
-
-            while (prev) {
-                ELFFrameStateRegisters* p = prev->previous;
-                free(prev);
-                prev = p;
-            }
-        }
-        free(state);
+        count++;
     }
 }
 
@@ -871,15 +1038,13 @@ CompileUnit* elfGetCompileUnitForData(uint8_t* data)
     if (data >= elfCurrentUnit->top && data < end)
         return elfCurrentUnit;
 
-    CompileUnit* unit = elfCompileUnits;
-
-    while (unit) {
-        end = unit->top + 4 + unit->length;
-
-        if (data >= unit->top && data < end)
+    // The units are in section order.
+    auto it = std::upper_bound(elfUnits.begin(), elfUnits.end(), data,
+        [](uint8_t* d, CompileUnit* unit) { return d < unit->top; });
+    if (it != elfUnits.begin()) {
+        CompileUnit* unit = *(it - 1);
+        if (data < unit->top + 4 + unit->length)
             return unit;
-
-        unit = unit->next;
     }
 
     printf("Error: cannot find reference to compile unit at offset %08x\n",
@@ -1136,20 +1301,14 @@ void elfAddLine(LineInfo* l, uint32_t a, int file, int line, int* max)
     l->number++;
 }
 
-void elfParseLineInfo(CompileUnit* unit, uint8_t* top)
+void elfParseLineInfo(CompileUnit* unit)
 {
-    ELFSectionHeader* h = elfGetSectionByName(".debug_line");
-    if (h == NULL) {
-        fprintf(stderr, "No line information found\n");
-        return;
-    }
     LineInfo* l = unit->lineInfoTable = (LineInfo*)calloc(1, sizeof(LineInfo));
     l->number = 0;
     int max = 1000;
     l->lines = (LineInfoItem*)malloc(1000 * sizeof(LineInfoItem));
 
-    uint8_t* data = elfReadSection(top, h);
-    data += unit->lineInfo;
+    uint8_t* data = elfDebugInfo->linedata + unit->lineInfo;
     uint32_t totalLen = elfRead4Bytes(data);
     data += 4;
     uint8_t* end = data + totalLen;
@@ -2434,7 +2593,7 @@ CompileUnit* elfParseCompUnit(uint8_t* data, uint8_t* abbrevData)
     }
 
     if (abbrev->hasChildren)
-        elfParseCompileUnitChildren(data, unit);
+        unit->children = data;
 
     return unit;
 }
@@ -2670,6 +2829,12 @@ bool elfReadProgram(ELFHeader* eh, uint8_t* data, unsigned long data_size, int&
         elfDebugInfo->debugdata = data;
         elfDebugInfo->infodata = debugdata;
 
+        h = elfGetSectionByName(".debug_line");
+        if (h == NULL)
+            fprintf(stderr, "No line information found\n");
+        else
+            elfDebugInfo->linedata = elfReadSection(data, h);
+
         uint32_t total = READ32LE(&dbgHeader->size);
         uint8_t* end = debugdata + total;
         uint8_t* ddata = debugdata;
@@ -2677,10 +2842,13 @@ bool elfReadProgram(ELFHeader* eh, uint8_t* data, unsigned long data_size, int&
         CompileUnit* last = NULL;
         CompileUnit* unit = NULL;
 
+        // Only the unit headers are read here, their contents are parsed when
+        // a lookup first needs them.
         while (ddata < end) {
             unit = elfParseCompUnit(ddata, abbrevdata);
             unit->offset = (uint32_t)(ddata - debugdata);
-            elfParseLineInfo(unit, data);
+            unit->index = (int)elfUnits.size();
+            elfUnits.push_back(unit);
             if (last == NULL)
                 elfCompileUnits = unit;
             else
@@ -2699,8 +2867,12 @@ bool elfReadProgram(ELFHeader* eh, uint8_t* data, unsigned long data_size, int&
                 }
             comp = comp->next;
         }
+        elfUnitIndexes.resize(elfUnits.size());
+        elfBuildCompileUnitIndex();
         elfParseCFA(data);
+        elfBuildFdeIndex();
         elfReadSymtab(data);
+        elfBuildSymbolIndex();
     }
 end:
     if (sh) {
@@ -2714,33 +2886,79 @@ end:
     return true;
 }
 
-bool elfRead(const char* name, int& siz, FILE* f)
+// Maps the file into memory, or reads it into a heap buffer if it cannot be
+// mapped. The file is closed either way.
+static uint8_t* elfLoadFile(FILE* f, size_t* size)
 {
-    fseek(f, 0, SEEK_END);
-    unsigned long size = ftell(f);
-    elfFileData = (uint8_t*)malloc(size);
-    fseek(f, 0, SEEK_SET);
-    int res = fread(elfFileData, 1, size, f);
+    uint8_t* data = NULL;
+#if defined(_WIN32)
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(f));
+    LARGE_INTEGER fileSize;
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            *size = (size_t)fileSize.QuadPart;
+        }
+    }
+#else
+    struct stat st;
+    if (fstat(fileno(f), &st) == 0 && st.st_size > 0) {
+        void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        if (mapping != MAP_FAILED) {
+            data = (uint8_t*)mapping;
+            *size = st.st_size;
+        }
+    }
+#endif
+    elfFileMapped = data != NULL;
+    if (!data) {
+        fseek(f, 0, SEEK_END);
+        *size = ftell(f);
+        data = (uint8_t*)malloc(*size);
+        fseek(f, 0, SEEK_SET);
+        if (fread(data, 1, *size, f) != *size) {
+            free(data);
+            data = NULL;
+        }
+    }
     fclose(f);
+    return data;
+}
 
-    if (res < 0) {
+static void elfFreeFile()
+{
+    if (elfFileMapped) {
+#if defined(_WIN32)
+        UnmapViewOfFile(elfFileData);
+#else
+        munmap(elfFileData, elfFileSize);
+#endif
+    } else {
         free(elfFileData);
-        elfFileData = NULL;
-        return false;
     }
+    elfFileData = NULL;
+    elfFileSize = 0;
+    elfFileMapped = false;
+}
+
+bool elfRead(const char* name, int& siz, FILE* f)
+{
+    elfFileData = elfLoadFile(f, &elfFileSize);
+    if (elfFileData == NULL)
+        return false;
 
     ELFHeader* header = (ELFHeader*)elfFileData;
 
-    if (READ32LE(&header->magic) != 0x464C457F || READ16LE(&header->e_machine) != 40 || header->clazz != 1) {
+    if (elfFileSize < sizeof(ELFHeader) || READ32LE(&header->magic) != 0x464C457F || READ16LE(&header->e_machine) != 40 || header->clazz != 1) {
         systemMessage(0, N_("Not a valid ELF file %s"), name);
-        free(elfFileData);
-        elfFileData = NULL;
+        elfFreeFile();
         return false;
     }
 
-    if (!elfReadProgram(header, elfFileData, size, siz, coreOptions.parseDebug)) {
-        free(elfFileData);
-        elfFileData = NULL;
+    if (!elfReadProgram(header, elfFileData, elfFileSize, siz, coreOptions.parseDebug)) {
+        elfFreeFile();
         return false;
     }
 
@@ -2911,8 +3129,13 @@ void elfCleanUp()
     }
     elfCies = NULL;
 
-    if (elfFileData) {
-        free(elfFileData);
-        elfFileData = NULL;
-    }
+    elfUnits.clear();
+    elfUnitRanges.clear();
+    elfUnitIndexes.clear();
+    elfSymbolRanges.clear();
+    elfSymbolNames.clear();
+    elfFdeRanges.clear();
+
+    if (elfFileData)
+        elfFreeFile();
 }
@@ -227,6 +227,10 @@ struct CompileUnit {
     Function* lastFunction;
     Object* variables;
     Type* types;
+    // The children of the unit DIE, parsed on first use.
+    uint8_t* children;
+    bool loaded;
+    int index;
     CompileUnit* next;
 };
 
@@ -235,6 +239,7 @@ struct DebugInfo {
     uint8_t* abbrevdata;
     uint8_t* debugdata;
     uint8_t* infodata;
+    uint8_t* linedata;
     int numRanges;
     ARanges* ranges;
 };
@@ -262,5 +267,10 @@ extern bool elfFindLineInModule(uint32_t*, const char*, int);
 uint32_t elfDecodeLocation(Function*, ELFBlock*, LocationType*);
 uint32_t elfDecodeLocation(Function*, ELFBlock*, LocationType*, uint32_t);
 int elfFindLine(CompileUnit* unit, Function* func, uint32_t addr, const char**);
+// Whether the loaded image has call frame information to unwind with.
+bool elfHasFrameInfo();
+// Unwinds the stack from `address` using the current registers and stores up
+// to `max` addresses in `chain`, innermost first. Returns the count stored.
+int elfGetCallChain(uint32_t address, uint32_t* chain, int max);
 
 #endif  // VBAM_CORE_GBA_GBAELF_H_
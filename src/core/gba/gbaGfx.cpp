@@ -1,8 +1,6 @@
 #include "core/gba/gbaGfx.h"
 
-#if defined(TILED_RENDERING)
 #include <cstring>
-#endif  // defined(TILED_RENDERING)
 
 int g_coeff[32] = {
     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
@@ -20,6 +18,10 @@ bool gfxInWin0[240];
 bool gfxInWin1[240];
 int lineOBJpixleft[128];
 
+GfxLineState gfxLine;
+
+int gfxBG2Written = 0;
+int gfxBG3Written = 0;
 int gfxBG2Changed = 0;
 int gfxBG3Changed = 0;
 
@@ -28,6 +30,175 @@ int gfxBG2Y = 0;
 int gfxBG3X = 0;
 int gfxBG3Y = 0;
 int gfxLastVCOUNT = 0;
+uint16_t gfxVCOUNT = 0;
+
+void gfxSaveLine(GfxLineState& state)
+{
+    state.DISPCNT = DISPCNT;
+    state.BG0CNT = BG0CNT;
+    state.BG1CNT = BG1CNT;
+    state.BG2CNT = BG2CNT;
+    state.BG3CNT = BG3CNT;
+    state.BG0HOFS = BG0HOFS;
+    state.BG0VOFS = BG0VOFS;
+    state.BG1HOFS = BG1HOFS;
+    state.BG1VOFS = BG1VOFS;
+    state.BG2HOFS = BG2HOFS;
+    state.BG2VOFS = BG2VOFS;
+    state.BG3HOFS = BG3HOFS;
+    state.BG3VOFS = BG3VOFS;
+    state.BG2PA = BG2PA;
+    state.BG2PB = BG2PB;
+    state.BG2PC = BG2PC;
+    state.BG2PD = BG2PD;
+    state.BG2X_L = BG2X_L;
+    state.BG2X_H = BG2X_H;
+    state.BG2Y_L = BG2Y_L;
+    state.BG2Y_H = BG2Y_H;
+    state.BG3PA = BG3PA;
+    state.BG3PB = BG3PB;
+    state.BG3PC = BG3PC;
+    state.BG3PD = BG3PD;
+    state.BG3X_L = BG3X_L;
+    state.BG3X_H = BG3X_H;
+    state.BG3Y_L = BG3Y_L;
+    state.BG3Y_H = BG3Y_H;
+    state.WIN0H = WIN0H;
+    state.WIN1H = WIN1H;
+    state.WIN0V = WIN0V;
+    state.WIN1V = WIN1V;
+    state.WININ = WININ;
+    state.WINOUT = WINOUT;
+    state.MOSAIC = MOSAIC;
+    state.BLDMOD = BLDMOD;
+    state.COLEV = COLEV;
+    state.COLY = COLY;
+    state.layerEnable = coreOptions.layerEnable;
+    state.customBackdropColor = customBackdropColor;
+    state.bg2Written = gfxBG2Written;
+    state.bg3Written = gfxBG3Written;
+    state.paletteRAM = g_paletteRAM;
+    state.oam = g_oam;
+    state.vram = g_vram;
+}
+
+// The WIN0H and WIN1H gfxInWin0 and gfxInWin1 hold, and the BG layers whose
+// lines are known to be clear.
+static int gfxWin0H = -1;
+static int gfxWin1H = -1;
+static int gfxClearLayers = 0;
+
+static void gfxUpdateWindow(bool* inWin, int winH)
+{
+    int x00 = winH >> 8;
+    int x01 = winH & 255;
+
+    if (x00 <= x01) {
+        for (int i = 0; i < 240; i++) {
+            inWin[i] = (i >= x00 && i < x01);
+        }
+    } else {
+        for (int i = 0; i < 240; i++) {
+            inWin[i] = (i >= x00 || i < x01);
+        }
+    }
+}
+
+void gfxPrepareLine()
+{
+    if (gfxLine.WIN0H != gfxWin0H) {
+        gfxWin0H = gfxLine.WIN0H;
+        gfxUpdateWindow(gfxInWin0, gfxWin0H);
+    }
+    if (gfxLine.WIN1H != gfxWin1H) {
+        gfxWin1H = gfxLine.WIN1H;
+        gfxUpdateWindow(gfxInWin1, gfxWin1H);
+    }
+
+    // the renderers leave the lines of disabled layers alone
+    const int disabled = ~gfxLine.layerEnable & 0x0f00;
+    uint32_t* const lines[] = { g_line0, g_line1, g_line2, g_line3 };
+    for (int i = 0; i < 4; i++) {
+        const int layer = 0x0100 << i;
+        if ((disabled & layer) && !(gfxClearLayers & layer))
+            gfxClearArray(lines[i]);
+    }
+    gfxClearLayers = disabled;
+}
+
+GfxSprite gfxSprites[128];
+uint8_t gfxSpriteLines[228][128];
+int gfxSpriteLineCount[228];
+
+// The OAM gfxSprites was decoded from, and the first line bucketed since.
+static uint8_t gfxSpriteOam[0x400];
+static int gfxSpriteFirstLine = 228;
+
+void gfxUpdateSprites()
+{
+    int line = gfxVCOUNT;
+    if (line >= gfxSpriteFirstLine && !memcmp(gfxSpriteOam, gfxLine.oam, sizeof(gfxSpriteOam)))
+        return;
+
+    // OAM written mid-frame only changes the lines still to be drawn.
+    memcpy(gfxSpriteOam, gfxLine.oam, sizeof(gfxSpriteOam));
+    gfxSpriteFirstLine = line;
+    for (int y = line; y < 228; y++)
+        gfxSpriteLineCount[y] = 0;
+
+    uint16_t* sprites = (uint16_t*)gfxLine.oam;
+    for (int x = 0; x < 128; x++) {
+        uint16_t a0 = READ16LE(sprites++);
+        uint16_t a1 = READ16LE(sprites++);
+        uint16_t a2 = READ16LE(sprites++);
+        sprites++;
+
+        if ((a0 & 0x0c00) == 0x0c00)
+            a0 &= 0xF3FF;
+
+        if ((a0 >> 14) == 3) {
+            a0 &= 0x3FFF;
+            a1 &= 0x3FFF;
+        }
+
+        int sizeX = 8 << (a1 >> 14);
+        int sizeY = sizeX;
+
+        if ((a0 >> 14) & 1) {
+            if (sizeX < 32)
+                sizeX <<= 1;
+            if (sizeY > 8)
+                sizeY >>= 1;
+        } else if ((a0 >> 14) & 2) {
+            if (sizeX > 8)
+                sizeX >>= 1;
+            if (sizeY < 32)
+                sizeY <<= 1;
+        }
+
+        GfxSprite& sprite = gfxSprites[x];
+        sprite.a0 = a0;
+        sprite.a1 = a1;
+        sprite.a2 = a2;
+        sprite.sizeX = sizeX;
+        sprite.sizeY = sizeY;
+
+        // disabled OBJ are never drawn, but disabled OBJ-WIN still take cycles
+        if (((a0 & 0x0300) == 0x0200) && ((a0 & 0x0c00) != 0x0800))
+            continue;
+
+        // the lines covered, double size included, as the renderers see them
+        int height = ((a0 & 0x0300) == 0x0300) ? sizeY << 1 : sizeY;
+        int sy = (a0 & 255);
+        if ((sy + height) > 256)
+            sy -= 256;
+
+        int top = sy > line ? sy : line;
+        int bottom = sy + height < 228 ? sy + height : 228;
+        for (int y = top; y < bottom; y++)
+            gfxSpriteLines[y][gfxSpriteLineCount[y]++] = (uint8_t)x;
+    }
+}
 
 #ifdef TILED_RENDERING
 #ifdef _MSC_VER
@@ -179,9 +350,9 @@ template <TileReader readTile>
 static void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs,
     uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-    uint16_t* screenBase = (uint16_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
+    const uint8_t* charBase = &gfxLine.vram[((control >> 2) & 0x03) * 0x4000];
+    uint16_t* screenBase = (uint16_t*)&gfxLine.vram[((control >> 8) & 0x1f) * 0x800];
     uint32_t prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 256;
     int sizeY = 256;
@@ -206,13 +377,13 @@ static void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs,
     bool mosaicOn = (control & 0x40) ? true : false;
 
     int xxx = hofs & maskX;
-    int yyy = (vofs + VCOUNT) & maskY;
-    int mosaicX = (MOSAIC & 0x000F) + 1;
-    int mosaicY = ((MOSAIC & 0x00F0) >> 4) + 1;
+    int yyy = (vofs + gfxVCOUNT) & maskY;
+    int mosaicX = (gfxLine.MOSAIC & 0x000F) + 1;
+    int mosaicY = ((gfxLine.MOSAIC & 0x00F0) >> 4) + 1;
 
     if (mosaicOn) {
-        if ((VCOUNT % mosaicY) != 0) {
-            mosaicY = VCOUNT - (VCOUNT % mosaicY);
+        if ((gfxVCOUNT % mosaicY) != 0) {
+            mosaicY = gfxVCOUNT - (gfxVCOUNT % mosaicY);
             yyy = (vofs + mosaicY) & maskY;
         }
     }
@@ -62,6 +62,95 @@ extern bool gfxInWin0[240];
 extern bool gfxInWin1[240];
 extern int lineOBJpixleft[128];
 
+// An OAM entry, with the attributes normalized as the renderers read them.
+struct GfxSprite {
+    uint16_t a0;
+    uint16_t a1;
+    uint16_t a2;
+    int sizeX;
+    int sizeY;
+};
+
+// The sprites that may be drawn on each line, in OAM order. Other sprites
+// only take their 2 cycles from the line budget.
+extern GfxSprite gfxSprites[128];
+extern uint8_t gfxSpriteLines[228][128];
+extern int gfxSpriteLineCount[228];
+
+// Decodes OAM again if it changed, and updates the lines from gfxVCOUNT on.
+void gfxUpdateSprites();
+
+// What the renderers draw line gfxVCOUNT from: the display registers as the
+// line ends, and PRAM, OAM and VRAM, which may be copies.
+struct GfxLineState {
+    uint16_t DISPCNT;
+    uint16_t BG0CNT;
+    uint16_t BG1CNT;
+    uint16_t BG2CNT;
+    uint16_t BG3CNT;
+    uint16_t BG0HOFS;
+    uint16_t BG0VOFS;
+    uint16_t BG1HOFS;
+    uint16_t BG1VOFS;
+    uint16_t BG2HOFS;
+    uint16_t BG2VOFS;
+    uint16_t BG3HOFS;
+    uint16_t BG3VOFS;
+    uint16_t BG2PA;
+    uint16_t BG2PB;
+    uint16_t BG2PC;
+    uint16_t BG2PD;
+    uint16_t BG2X_L;
+    uint16_t BG2X_H;
+    uint16_t BG2Y_L;
+    uint16_t BG2Y_H;
+    uint16_t BG3PA;
+    uint16_t BG3PB;
+    uint16_t BG3PC;
+    uint16_t BG3PD;
+    uint16_t BG3X_L;
+    uint16_t BG3X_H;
+    uint16_t BG3Y_L;
+    uint16_t BG3Y_H;
+    uint16_t WIN0H;
+    uint16_t WIN1H;
+    uint16_t WIN0V;
+    uint16_t WIN1V;
+    uint16_t WININ;
+    uint16_t WINOUT;
+    uint16_t MOSAIC;
+    uint16_t BLDMOD;
+    uint16_t COLEV;
+    uint16_t COLY;
+    int layerEnable;
+    int customBackdropColor;
+    // The gfxBG2Written and gfxBG3Written bits handed over with the line.
+    int bg2Written;
+    int bg3Written;
+    const uint8_t* paletteRAM;
+    const uint8_t* oam;
+    const uint8_t* vram;
+};
+
+// The line being drawn, set by the renderer.
+extern GfxLineState gfxLine;
+
+// Copies the display registers line VCOUNT is drawn with into `state` and
+// points it at the live PRAM, OAM and VRAM. Leaves gfxBG2Written and
+// gfxBG3Written alone.
+void gfxSaveLine(GfxLineState& state);
+
+// Brings what the renderers keep from line to line, the window spans and the
+// lines of disabled layers, up to date with gfxLine.
+void gfxPrepareLine();
+
+// Set by the CPU when it writes the BG2 or BG3 reference point, bit 0 for X
+// and bit 1 for Y, until the renderer takes the next line.
+extern int gfxBG2Written;
+extern int gfxBG3Written;
+
+// Whether the renderers reload the BG2 and BG3 reference points, as the bits
+// of gfxBG2Written and gfxBG3Written, from the line registers.
 extern int gfxBG2Changed;
 extern int gfxBG3Changed;
 
@@ -71,6 +160,10 @@ extern int gfxBG3X;
 extern int gfxBG3Y;
 extern int gfxLastVCOUNT;
 
+// The line the renderers draw. Unlike VCOUNT, it stays put while a renderer
+// on another thread draws the line and the CPU moves on.
+extern uint16_t gfxVCOUNT;
+
 static inline void gfxClearArray(uint32_t* array)
 {
     for (int i = 0; i < 240; i++) {
@@ -81,9 +174,9 @@ static inline void gfxClearArray(uint32_t* array)
 #ifndef TILED_RENDERING
 static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t vofs, uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
     const size_t charBankBaseOffset = ((control >> 2) & 0x03) * 0x4000;
-    uint16_t* screenBase = (uint16_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint16_t* screenBase = (uint16_t*)&gfxLine.vram[((control >> 8) & 0x1f) * 0x800];
     uint32_t prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 256;
     int sizeY = 256;
@@ -108,13 +201,13 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
     bool mosaicOn = (control & 0x40) ? true : false;
 
     int xxx = hofs & maskX;
-    int yyy = (vofs + VCOUNT) & maskY;
-    int mosaicX = (MOSAIC & 0x000F) + 1;
-    int mosaicY = ((MOSAIC & 0x00F0) >> 4) + 1;
+    int yyy = (vofs + gfxVCOUNT) & maskY;
+    int mosaicX = (gfxLine.MOSAIC & 0x000F) + 1;
+    int mosaicY = ((gfxLine.MOSAIC & 0x00F0) >> 4) + 1;
 
     if (mosaicOn) {
-        if ((VCOUNT % mosaicY) != 0) {
-            mosaicY = VCOUNT - (VCOUNT % mosaicY);
+        if ((gfxVCOUNT % mosaicY) != 0) {
+            mosaicY = gfxVCOUNT - (gfxVCOUNT % mosaicY);
             yyy = (vofs + mosaicY) & maskY;
         }
     }
@@ -154,7 +247,7 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
                 // use 0 here.
                 color = 0;
             } else {
-                color = g_vram[charBankTotalOffset];
+                color = gfxLine.vram[charBankTotalOffset];
             }
 
             line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
@@ -199,7 +292,7 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
                 // use 0 here.
                 color = 0;
             } else {
-                color = g_vram[charBankTotalOffset];
+                color = gfxLine.vram[charBankTotalOffset];
                 if (tileX & 1) {
                     color = (color >> 4);
                 } else {
@@ -240,13 +333,131 @@ static inline void gfxDrawTextScreen(uint16_t control, uint16_t hofs, uint16_t v
 }
 #endif // !__TILED_RENDERING
 
+// Rotation background lines with PC == 0 sample a single row, so the row is
+// looked up once. With PA == 0x100 (identity or translation) the samples are
+// consecutive and the row is read a run at a time.
+
+// The span [first, last) of a line whose samples from x0 on are inside
+// [0, size), the rest of the line being transparent.
+static inline void gfxRotClip(int x0, int size, int& first, int& last, uint32_t* line)
+{
+    first = x0 < 0 ? (-x0 < 240 ? -x0 : 240) : 0;
+    last = size - x0 < 240 ? (size - x0 > first ? size - x0 : first) : 240;
+    for (int x = 0; x < first; x++)
+        line[x] = 0x80000000;
+    for (int x = last; x < 240; x++)
+        line[x] = 0x80000000;
+}
+
+static inline void gfxDrawRotRow(const uint8_t* screenBase, const uint8_t* charBase, int sizeX, int sizeY,
+    int yshift, bool wrap, int prio, int realX, int realY, int dx, uint32_t* line)
+{
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
+    int maskX = sizeX - 1;
+
+    int yyy = realY >> 8;
+    if (wrap) {
+        yyy &= sizeY - 1;
+    } else if (yyy < 0 || yyy >= sizeY) {
+        gfxClearArray(line);
+        return;
+    }
+
+    const uint8_t* row = &screenBase[(yyy >> 3) << yshift];
+    const uint8_t* tileRow = &charBase[(yyy & 7) << 3];
+
+    if (dx == 0x100) {
+        int xxx = realX >> 8;
+        int first = 0;
+        int last = 240;
+        if (wrap)
+            xxx &= maskX;
+        else
+            gfxRotClip(xxx, sizeX, first, last, line);
+        xxx += first;
+
+        for (int x = first; x < last;) {
+            const uint8_t* pixels = &tileRow[row[xxx >> 3] << 6];
+            int tileX = xxx & 7;
+            int n = 8 - tileX < last - x ? 8 - tileX : last - x;
+            for (int i = 0; i < n; i++) {
+                uint8_t color = pixels[tileX + i];
+                line[x + i] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
+            }
+            x += n;
+            xxx = (xxx + n) & maskX;
+        }
+        return;
+    }
+
+    for (int x = 0; x < 240; x++) {
+        int xxx = realX >> 8;
+        if (wrap) {
+            xxx &= maskX;
+        } else if (xxx < 0 || xxx >= sizeX) {
+            line[x] = 0x80000000;
+            realX += dx;
+            continue;
+        }
+
+        uint8_t color = tileRow[(row[xxx >> 3] << 6) + (xxx & 7)];
+        line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
+        realX += dx;
+    }
+}
+
+// The bitmap mode counterpart, for 16-bit colors or 8-bit palette indices.
+static inline uint32_t gfxRotBitmapColor(const uint16_t* row, int x, const uint16_t*, int prio)
+{
+    return READ16LE(&row[x]) | prio;
+}
+
+static inline uint32_t gfxRotBitmapColor(const uint8_t* row, int x, const uint16_t* palette, int prio)
+{
+    uint8_t color = row[x];
+    return color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
+}
+
+template <typename Pixel>
+static inline void gfxDrawRotBitmapRow(const Pixel* screenBase, int sizeX, int sizeY, int prio, int realX,
+    int realY, int dx, uint32_t* line)
+{
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
+
+    int yyy = realY >> 8;
+    if (yyy < 0 || yyy >= sizeY) {
+        gfxClearArray(line);
+        return;
+    }
+
+    const Pixel* row = &screenBase[yyy * sizeX];
+
+    if (dx == 0x100) {
+        int xxx = realX >> 8;
+        int first, last;
+        gfxRotClip(xxx, sizeX, first, last, line);
+        for (int x = first; x < last; x++)
+            line[x] = gfxRotBitmapColor(row, xxx + x, palette, prio);
+        return;
+    }
+
+    for (int x = 0; x < 240; x++) {
+        int xxx = realX >> 8;
+        if (xxx < 0 || xxx >= sizeX)
+            line[x] = 0x80000000;
+        else
+            line[x] = gfxRotBitmapColor(row, xxx, palette, prio);
+        realX += dx;
+    }
+}
+
 static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h, uint16_t y_l, uint16_t y_h, uint16_t pa, uint16_t pb,
     uint16_t pc, uint16_t pd, int& currentX, int& currentY, int changed,
     uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* charBase = &g_vram[((control >> 2) & 0x03) * 0x4000];
-    uint8_t* screenBase = (uint8_t*)&g_vram[((control >> 8) & 0x1f) * 0x800];
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
+    const uint8_t* charBase = &gfxLine.vram[((control >> 2) & 0x03) * 0x4000];
+    uint8_t* screenBase = (uint8_t*)&gfxLine.vram[((control >> 8) & 0x1f) * 0x800];
     int prio = ((control & 3) << 25) + 0x1000000;
 
     int sizeX = 128;
@@ -283,7 +494,7 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
+    if (gfxVCOUNT == 0)
         changed = 3;
 
     if (changed & 1) {
@@ -306,13 +517,16 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = (VCOUNT % mosaicY);
+        int mosaicY = ((gfxLine.MOSAIC & 0xF0) >> 4) + 1;
+        int y = (gfxVCOUNT % mosaicY);
         realX -= y * dmx;
         realY -= y * dmy;
     }
 
-    if (control & 0x2000) {
+    if (dy == 0) {
+        gfxDrawRotRow(screenBase, charBase, sizeX, sizeY, yshift, (control & 0x2000) != 0, prio, realX,
+            realY, dx, line);
+    } else if (control & 0x2000) {
         for (int x = 0; x < 240; x++) {
             int xxx = (realX >> 8) & maskX;
             int yyy = (realY >> 8) & maskY;
@@ -352,7 +566,7 @@ static inline void gfxDrawRotScreen(uint16_t control, uint16_t x_l, uint16_t x_h
     }
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -371,7 +585,7 @@ static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_
     uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
     int changed, uint32_t* line)
 {
-    uint16_t* screenBase = (uint16_t*)&g_vram[0];
+    uint16_t* screenBase = (uint16_t*)&gfxLine.vram[0];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 240;
     int sizeY = 160;
@@ -396,7 +610,7 @@ static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
+    if (gfxVCOUNT == 0)
         changed = 3;
 
     if (changed & 1) {
@@ -418,30 +632,34 @@ static inline void gfxDrawRotScreen16Bit(uint16_t control, uint16_t x_l, uint16_
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = (VCOUNT % mosaicY);
+        int mosaicY = ((gfxLine.MOSAIC & 0xF0) >> 4) + 1;
+        int y = (gfxVCOUNT % mosaicY);
         realX -= y * dmx;
         realY -= y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
+    if (dy == 0) {
+        gfxDrawRotBitmapRow(screenBase, sizeX, sizeY, prio, realX, realY, dx, line);
+    } else {
+        int xxx = (realX >> 8);
+        int yyy = (realY >> 8);
 
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
-        }
-        realX += dx;
-        realY += dy;
+        for (int x = 0; x < 240; x++) {
+            if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
+                line[x] = 0x80000000;
+            } else {
+                line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
+            }
+            realX += dx;
+            realY += dy;
 
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
+            xxx = (realX >> 8);
+            yyy = (realY >> 8);
+        }
     }
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -460,8 +678,8 @@ static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t
     uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
     int changed, uint32_t* line)
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
-    uint8_t* screenBase = (DISPCNT & 0x0010) ? &g_vram[0xA000] : &g_vram[0x0000];
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
+    const uint8_t* screenBase = (gfxLine.DISPCNT & 0x0010) ? &gfxLine.vram[0xA000] : &gfxLine.vram[0x0000];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 240;
     int sizeY = 160;
@@ -486,7 +704,7 @@ static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
+    if (gfxVCOUNT == 0)
         changed = 3;
 
     if (changed & 1) {
@@ -509,32 +727,36 @@ static inline void gfxDrawRotScreen256(uint16_t control, uint16_t x_l, uint16_t
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = VCOUNT - (VCOUNT % mosaicY);
+        int mosaicY = ((gfxLine.MOSAIC & 0xF0) >> 4) + 1;
+        int y = gfxVCOUNT - (gfxVCOUNT % mosaicY);
         realX = startX + y * dmx;
         realY = startY + y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
+    if (dy == 0) {
+        gfxDrawRotBitmapRow(screenBase, sizeX, sizeY, prio, realX, realY, dx, line);
+    } else {
+        int xxx = (realX >> 8);
+        int yyy = (realY >> 8);
 
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            uint8_t color = screenBase[yyy * 240 + xxx];
+        for (int x = 0; x < 240; x++) {
+            if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
+                line[x] = 0x80000000;
+            } else {
+                uint8_t color = screenBase[yyy * 240 + xxx];
 
-            line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
-        }
-        realX += dx;
-        realY += dy;
+                line[x] = color ? (READ16LE(&palette[color]) | prio) : 0x80000000;
+            }
+            realX += dx;
+            realY += dy;
 
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
+            xxx = (realX >> 8);
+            yyy = (realY >> 8);
+        }
     }
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -553,7 +775,7 @@ static inline void gfxDrawRotScreen16Bit160(uint16_t control, uint16_t x_l, uint
     uint16_t pb, uint16_t pc, uint16_t pd, int& currentX, int& currentY,
     int changed, uint32_t* line)
 {
-    uint16_t* screenBase = (DISPCNT & 0x0010) ? (uint16_t*)&g_vram[0xa000] : (uint16_t*)&g_vram[0];
+    uint16_t* screenBase = (gfxLine.DISPCNT & 0x0010) ? (uint16_t*)&gfxLine.vram[0xa000] : (uint16_t*)&gfxLine.vram[0];
     int prio = ((control & 3) << 25) + 0x1000000;
     int sizeX = 160;
     int sizeY = 128;
@@ -578,7 +800,7 @@ static inline void gfxDrawRotScreen16Bit160(uint16_t control, uint16_t x_l, uint
     if (pd & 0x8000)
         dmy |= 0xFFFF8000;
 
-    if (VCOUNT == 0)
+    if (gfxVCOUNT == 0)
         changed = 3;
 
     if (changed & 1) {
@@ -601,30 +823,34 @@ static inline void gfxDrawRotScreen16Bit160(uint16_t control, uint16_t x_l, uint
     int realY = currentY;
 
     if (control & 0x40) {
-        int mosaicY = ((MOSAIC & 0xF0) >> 4) + 1;
-        int y = VCOUNT - (VCOUNT % mosaicY);
+        int mosaicY = ((gfxLine.MOSAIC & 0xF0) >> 4) + 1;
+        int y = gfxVCOUNT - (gfxVCOUNT % mosaicY);
         realX = startX + y * dmx;
         realY = startY + y * dmy;
     }
 
-    int xxx = (realX >> 8);
-    int yyy = (realY >> 8);
+    if (dy == 0) {
+        gfxDrawRotBitmapRow(screenBase, sizeX, sizeY, prio, realX, realY, dx, line);
+    } else {
+        int xxx = (realX >> 8);
+        int yyy = (realY >> 8);
 
-    for (int x = 0; x < 240; x++) {
-        if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
-            line[x] = 0x80000000;
-        } else {
-            line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
-        }
-        realX += dx;
-        realY += dy;
+        for (int x = 0; x < 240; x++) {
+            if (xxx < 0 || yyy < 0 || xxx >= sizeX || yyy >= sizeY) {
+                line[x] = 0x80000000;
+            } else {
+                line[x] = (READ16LE(&screenBase[yyy * sizeX + xxx]) | prio);
+            }
+            realX += dx;
+            realY += dy;
 
-        xxx = (realX >> 8);
-        yyy = (realY >> 8);
+            xxx = (realX >> 8);
+            yyy = (realY >> 8);
+        }
     }
 
     if (control & 0x40) {
-        int mosaicX = (MOSAIC & 0xF) + 1;
+        int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
         if (mosaicX > 1) {
             int m = 1;
             for (int i = 0; i < 239; i++) {
@@ -644,19 +870,27 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
     // lineOBJpix is used to keep track of the drawn OBJs
     // and to stop drawing them if the 'maximum number of OBJ per line'
     // has been reached.
-    int lineOBJpix = (DISPCNT & 0x20) ? 954 : 1226;
+    int lineOBJpix = (gfxLine.DISPCNT & 0x20) ? 954 : 1226;
     int m = 0;
     gfxClearArray(lineOBJ);
-    if (coreOptions.layerEnable & 0x1000) {
-        uint16_t* sprites = (uint16_t*)g_oam;
-        uint16_t* spritePalette = &((uint16_t*)g_paletteRAM)[256];
-        int mosaicY = ((MOSAIC & 0xF000) >> 12) + 1;
-        int mosaicX = ((MOSAIC & 0xF00) >> 8) + 1;
-        for (int x = 0; x < 128; x++) {
-            uint16_t a0 = READ16LE(sprites++);
-            uint16_t a1 = READ16LE(sprites++);
-            uint16_t a2 = READ16LE(sprites++);
-            sprites++;
+    if (gfxLine.layerEnable & 0x1000) {
+        uint16_t* spritePalette = &((uint16_t*)gfxLine.paletteRAM)[256];
+        int mosaicY = ((gfxLine.MOSAIC & 0xF000) >> 12) + 1;
+        int mosaicX = ((gfxLine.MOSAIC & 0xF00) >> 8) + 1;
+        gfxUpdateSprites();
+        const uint8_t* bucket = gfxSpriteLines[gfxVCOUNT];
+        int count = gfxSpriteLineCount[gfxVCOUNT];
+        int last = -1;
+        for (int i = 0; i < count; i++) {
+            int x = bucket[i];
+            // the sprites in between are not on this line
+            lineOBJpix -= 2 * (x - last - 1);
+            last = x;
+
+            const GfxSprite& sprite = gfxSprites[x];
+            uint16_t a0 = sprite.a0;
+            uint16_t a1 = sprite.a1;
+            uint16_t a2 = sprite.a2;
 
             lineOBJpixleft[x] = lineOBJpix;
 
@@ -664,28 +898,8 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
             if (lineOBJpix <= 0)
                 continue;
 
-            if ((a0 & 0x0c00) == 0x0c00)
-                a0 &= 0xF3FF;
-
-            if ((a0 >> 14) == 3) {
-                a0 &= 0x3FFF;
-                a1 &= 0x3FFF;
-            }
-
-            int sizeX = 8 << (a1 >> 14);
-            int sizeY = sizeX;
-
-            if ((a0 >> 14) & 1) {
-                if (sizeX < 32)
-                    sizeX <<= 1;
-                if (sizeY > 8)
-                    sizeY >>= 1;
-            } else if ((a0 >> 14) & 2) {
-                if (sizeX > 8)
-                    sizeX >>= 1;
-                if (sizeY < 32)
-                    sizeY <<= 1;
-            }
+            int sizeX = sprite.sizeX;
+            int sizeY = sprite.sizeY;
 
 #ifdef SPRITE_DEBUG
             int maskX = sizeX - 1;
@@ -696,7 +910,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
             int sx = (a1 & 0x1FF);
 
             // computes ticks used by OBJ-WIN if OBJWIN is enabled
-            if (((a0 & 0x0c00) == 0x0800) && (coreOptions.layerEnable & 0x8000)) {
+            if (((a0 & 0x0c00) == 0x0800) && (gfxLine.layerEnable & 0x8000)) {
                 if ((a0 & 0x0300) == 0x0300) {
                     sizeX <<= 1;
                     sizeY <<= 1;
@@ -710,7 +924,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                     sx = 0;
                 } else if ((sx + sizeX) > 240)
                     sizeX = 240 - sx;
-                if ((VCOUNT >= sy) && (VCOUNT < sy + sizeY) && (sx < 240)) {
+                if ((gfxVCOUNT >= sy) && (gfxVCOUNT < sy + sizeY) && (sx < 240)) {
                     if (a0 & 0x0100)
                         lineOBJpix -= 8 + 2 * sizeX;
                     else
@@ -734,7 +948,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                 }
                 if ((sy + fieldY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gfxVCOUNT - sy;
                 if ((t >= 0) && (t < fieldY)) {
                     int startpix = 0;
                     if ((sx + fieldX) > 512) {
@@ -745,7 +959,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             lineOBJpix -= 8;
                             // int t2 = t - (fieldY >> 1);
                             int rot = (a1 >> 9) & 0x1F;
-                            uint16_t* OAM = (uint16_t*)g_oam;
+                            uint16_t* OAM = (uint16_t*)gfxLine.oam;
                             int dx = READ16LE(&OAM[3 + (rot << 4)]);
                             if (dx & 0x8000)
                                 dx |= 0xFFFF8000;
@@ -770,10 +984,10 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
 
                             if (a0 & 0x2000) {
                                 int c = (a2 & 0x3FF);
-                                if ((DISPCNT & 7) > 2 && (c < 512))
+                                if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                     continue;
                                 int inc = 32;
-                                if (DISPCNT & 0x40)
+                                if (gfxLine.DISPCNT & 0x40)
                                     inc = sizeX >> 2;
                                 else
                                     c &= 0x3FE;
@@ -788,7 +1002,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240)
                                         ;
                                     else {
-                                        uint32_t color = g_vram
+                                        uint32_t color = gfxLine.vram
                                             [0x10000 + ((((c + (yyy >> 3) * inc)
                                                              << 5)
                                                             + ((yyy & 7)
@@ -839,11 +1053,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                 }
                             } else {
                                 int c = (a2 & 0x3FF);
-                                if ((DISPCNT & 7) > 2 && (c < 512))
+                                if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                     continue;
 
                                 int inc = 32;
-                                if (DISPCNT & 0x40)
+                                if (gfxLine.DISPCNT & 0x40)
                                     inc = sizeX >> 3;
                                 int palette = (a2 >> 8) & 0xF0;
                                 for (int y = 0; y < fieldX; y++) {
@@ -856,7 +1070,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240)
                                         ;
                                     else {
-                                        uint32_t color = g_vram
+                                        uint32_t color = gfxLine.vram
                                             [0x10000 + ((((c + (yyy >> 3) * inc)
                                                              << 5)
                                                             + ((yyy & 7)
@@ -916,7 +1130,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
             } else {
                 if (sy + sizeY > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gfxVCOUNT - sy;
                 if ((t >= 0) && (t < sizeY)) {
                     int startpix = 0;
                     if ((sx + sizeX) > 512) {
@@ -928,11 +1142,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gfxLine.DISPCNT & 0x40) {
                                 inc = sizeX >> 2;
                             } else {
                                 c &= 0x3FE;
@@ -957,7 +1171,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                 if (lineOBJpix < 0)
                                     continue;
                                 if (sx < 240) {
-                                    uint8_t color = g_vram[address];
+                                    uint8_t color = gfxLine.vram[address];
                                     if ((color == 0) && (((prio >> 25) & 3) < ((lineOBJ[sx] >> 25) & 3))) {
                                         lineOBJ[sx] = (lineOBJ[sx] & 0xF9FFFFFF) | prio;
                                         if ((a0 & 0x1000) && m)
@@ -1014,11 +1228,11 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gfxLine.DISPCNT & 0x40) {
                                 inc = sizeX >> 3;
                             }
                             int xxx = 0;
@@ -1041,7 +1255,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gfxLine.vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1100,7 +1314,7 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gfxLine.vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1164,15 +1378,18 @@ static inline void gfxDrawSprites(uint32_t* lineOBJ)
 static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 {
     gfxClearArray(lineOBJWin);
-    if ((coreOptions.layerEnable & 0x9000) == 0x9000) {
-        uint16_t* sprites = (uint16_t*)g_oam;
-        // uint16_t *spritePalette = &((uint16_t *)g_paletteRAM)[256];
-        for (int x = 0; x < 128; x++) {
+    if ((gfxLine.layerEnable & 0x9000) == 0x9000) {
+        // uint16_t *spritePalette = &((uint16_t *)gfxLine.paletteRAM)[256];
+        // the sprites were bucketed by gfxDrawSprites() for this line
+        const uint8_t* bucket = gfxSpriteLines[gfxVCOUNT];
+        int count = gfxSpriteLineCount[gfxVCOUNT];
+        for (int i = 0; i < count; i++) {
+            int x = bucket[i];
             int lineOBJpix = lineOBJpixleft[x];
-            uint16_t a0 = READ16LE(sprites++);
-            uint16_t a1 = READ16LE(sprites++);
-            uint16_t a2 = READ16LE(sprites++);
-            sprites++;
+            const GfxSprite& sprite = gfxSprites[x];
+            uint16_t a0 = sprite.a0;
+            uint16_t a1 = sprite.a1;
+            uint16_t a2 = sprite.a2;
 
             if (lineOBJpix <= 0)
                 continue;
@@ -1181,28 +1398,8 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
             if (((a0 & 0x0c00) != 0x0800) || ((a0 & 0x0300) == 0x0200))
                 continue;
 
-            if ((a0 & 0x0c00) == 0x0c00)
-                a0 &= 0xF3FF;
-
-            if ((a0 >> 14) == 3) {
-                a0 &= 0x3FFF;
-                a1 &= 0x3FFF;
-            }
-
-            int sizeX = 8 << (a1 >> 14);
-            int sizeY = sizeX;
-
-            if ((a0 >> 14) & 1) {
-                if (sizeX < 32)
-                    sizeX <<= 1;
-                if (sizeY > 8)
-                    sizeY >>= 1;
-            } else if ((a0 >> 14) & 2) {
-                if (sizeX > 8)
-                    sizeX >>= 1;
-                if (sizeY < 32)
-                    sizeY <<= 1;
-            }
+            int sizeX = sprite.sizeX;
+            int sizeY = sprite.sizeY;
 
             int sy = (a0 & 255);
 
@@ -1215,7 +1412,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                 }
                 if ((sy + fieldY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gfxVCOUNT - sy;
                 if ((t >= 0) && (t < fieldY)) {
                     int sx = (a1 & 0x1FF);
                     int startpix = 0;
@@ -1226,7 +1423,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                         lineOBJpix -= 8;
                         // int t2 = t - (fieldY >> 1);
                         int rot = (a1 >> 9) & 0x1F;
-                        uint16_t* OAM = (uint16_t*)g_oam;
+                        uint16_t* OAM = (uint16_t*)gfxLine.oam;
                         int dx = READ16LE(&OAM[3 + (rot << 4)]);
                         if (dx & 0x8000)
                             dx |= 0xFFFF8000;
@@ -1248,10 +1445,10 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 
                         if (a0 & 0x2000) {
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
                             int inc = 32;
-                            if (DISPCNT & 0x40)
+                            if (gfxLine.DISPCNT & 0x40)
                                 inc = sizeX >> 2;
                             else
                                 c &= 0x3FE;
@@ -1265,7 +1462,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
 
                                 if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240) {
                                 } else {
-                                    uint32_t color = g_vram
+                                    uint32_t color = gfxLine.vram
                                         [0x10000 + ((((c + (yyy >> 3) * inc)
                                                          << 5)
                                                         + ((yyy & 7) << 3) + ((xxx >> 3) << 6) + (xxx & 7))
@@ -1280,11 +1477,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             }
                         } else {
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40)
+                            if (gfxLine.DISPCNT & 0x40)
                                 inc = sizeX >> 3;
                             // int palette = (a2 >> 8) & 0xF0;
                             for (int y = 0; y < fieldX; y++) {
@@ -1304,7 +1501,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                 //              } else {
                                 if (xxx < 0 || xxx >= sizeX || yyy < 0 || yyy >= sizeY || sx >= 240) {
                                 } else {
-                                    uint32_t color = g_vram
+                                    uint32_t color = gfxLine.vram
                                         [0x10000 + ((((c + (yyy >> 3) * inc)
                                                          << 5)
                                                         + ((yyy & 7) << 2) + ((xxx >> 3) << 5) + ((xxx & 7) >> 1))
@@ -1329,7 +1526,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
             } else {
                 if ((sy + sizeY) > 256)
                     sy -= 256;
-                int t = VCOUNT - sy;
+                int t = gfxVCOUNT - sy;
                 if ((t >= 0) && (t < sizeY)) {
                     int sx = (a1 & 0x1FF);
                     int startpix = 0;
@@ -1342,11 +1539,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gfxLine.DISPCNT & 0x40) {
                                 inc = sizeX >> 2;
                             } else {
                                 c &= 0x3FE;
@@ -1365,7 +1562,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                 if (lineOBJpix < 0)
                                     continue;
                                 if (sx < 240) {
-                                    uint8_t color = g_vram[address];
+                                    uint8_t color = gfxLine.vram[address];
                                     if (color) {
                                         lineOBJWin[sx] = 1;
                                     }
@@ -1396,11 +1593,11 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                             if (a1 & 0x2000)
                                 t = sizeY - t - 1;
                             int c = (a2 & 0x3FF);
-                            if ((DISPCNT & 7) > 2 && (c < 512))
+                            if ((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                                 continue;
 
                             int inc = 32;
-                            if (DISPCNT & 0x40) {
+                            if (gfxLine.DISPCNT & 0x40) {
                                 inc = sizeX >> 3;
                             }
                             int xxx = 0;
@@ -1419,7 +1616,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gfxLine.vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
@@ -1449,7 +1646,7 @@ static inline void gfxDrawOBJWin(uint32_t* lineOBJWin)
                                     if (lineOBJpix < 0)
                                         continue;
                                     if (sx < 240) {
-                                        uint8_t color = g_vram[address];
+                                        uint8_t color = gfxLine.vram[address];
                                         if (xx & 1) {
                                             color = (color >> 4);
                                         } else
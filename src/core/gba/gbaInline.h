@@ -10,6 +10,7 @@
 #include "core/gba/gbaEeprom.h"
 #include "core/gba/gbaFlash.h"
 #include "core/gba/gbaPrint.h"
+#include "core/gba/gbaRenderer.h"
 #include "core/gba/gbaRtc.h"
 #include "core/gba/gbaSound.h"
 
@@ -17,6 +18,14 @@
 #include "core/gba/gbaRemote.h"
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+#include "core/gba/gbaMemStats.h"
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+
+#if defined(VBAM_ENABLE_TRACE)
+#include "core/gba/gbaTrace.h"
+#endif  // defined(VBAM_ENABLE_TRACE)
+
 extern const uint32_t objTilesAddress[3];
 
 extern bool stopState;
@@ -76,8 +85,20 @@ static inline int8_t Downcast8(T value) {
 
 extern uint32_t myROM[];
 
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+// Counts a CPU access. doDMA counts its transfers as a whole.
+static inline void CPUCountAccess(uint32_t address, int counter)
+{
+    if (!cpuDmaRunning)
+        memStatsCount(address, counter, 1);
+}
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+
 static inline uint32_t CPUReadMemory(uint32_t address)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_READS);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 #ifdef VBAM_ENABLE_DEBUGGER
     memoryMap* m = &map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
@@ -219,6 +240,9 @@ static inline uint32_t CPUReadMemory(uint32_t address)
 
 static inline uint32_t CPUReadHalfWord(uint32_t address)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_READS);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 #ifdef VBAM_ENABLE_DEBUGGER
     memoryMap* m = &map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
@@ -366,6 +390,9 @@ static inline int16_t CPUReadHalfWordSigned(uint32_t address)
 
 static inline uint8_t CPUReadByte(uint32_t address)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_READS);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 #ifdef VBAM_ENABLE_DEBUGGER
     memoryMap* m = &map[address >> 24];
     if (m->breakPoints && BreakReadCheck(m->breakPoints, address & m->mask)) {
@@ -460,6 +487,13 @@ static inline uint8_t CPUReadByte(uint32_t address)
 
 static inline void CPUWriteMemory(uint32_t address, uint32_t value)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_WRITES);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+    if (!cpuDmaRunning)
+        traceWrite(address, value, 4);
+#endif  // defined(VBAM_ENABLE_TRACE)
 #ifdef GBA_LOGGING
     if (address & 3) {
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
@@ -505,6 +539,7 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
             goto unwritable;
         break;
     case 0x05:
+        gbaRendererWrite();
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint32_t*)&freezePRAM[address & 0x3fc]))
             cheatsWriteMemory(address & 0x70003FC, value);
@@ -518,6 +553,7 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
+        gbaRendererVramWrite(address, 4);
 
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint32_t*)&freezeVRAM[address]))
@@ -528,6 +564,7 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
             WRITE32LE(((uint32_t*)&g_vram[address]), value);
         break;
     case 0x07:
+        gbaRendererWrite();
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint32_t*)&freezeOAM[address & 0x3fc]))
             cheatsWriteMemory(address & 0x70003FC, value);
@@ -565,6 +602,13 @@ static inline void CPUWriteMemory(uint32_t address, uint32_t value)
 
 static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_WRITES);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+    if (!cpuDmaRunning)
+        traceWrite(address, value, 2);
+#endif  // defined(VBAM_ENABLE_TRACE)
 #ifdef GBA_LOGGING
     if (address & 1) {
         if (systemVerbose & VERBOSE_UNALIGNED_MEMORY) {
@@ -609,6 +653,7 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             goto unwritable;
         break;
     case 5:
+        gbaRendererWrite();
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint16_t*)&freezePRAM[address & 0x03fe]))
             cheatsWriteHalfWord(address & 0x70003fe, value);
@@ -622,6 +667,7 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
+        gbaRendererVramWrite(address, 2);
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint16_t*)&freezeVRAM[address]))
             cheatsWriteHalfWord(address + 0x06000000, value);
@@ -630,6 +676,7 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
             WRITE16LE(((uint16_t*)&g_vram[address]), value);
         break;
     case 7:
+        gbaRendererWrite();
 #ifdef VBAM_ENABLE_DEBUGGER
         if (*((uint16_t*)&freezeOAM[address & 0x03fe]))
             cheatsWriteHalfWord(address & 0x70003fe, value);
@@ -674,6 +721,13 @@ static inline void CPUWriteHalfWord(uint32_t address, uint16_t value)
 
 static inline void CPUWriteByte(uint32_t address, uint8_t b)
 {
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    CPUCountAccess(address, MEMSTATS_WRITES);
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#if defined(VBAM_ENABLE_TRACE)
+    if (!cpuDmaRunning)
+        traceWrite(address, b, 1);
+#endif  // defined(VBAM_ENABLE_TRACE)
 #ifdef VBAM_ENABLE_DEBUGGER
     memoryMap* m = &map[address >> 24];
     if (m->breakPoints && BreakWriteCheck(m->breakPoints, address & m->mask)) {
@@ -767,6 +821,7 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
             goto unwritable;
         break;
     case 5:
+        gbaRendererWrite();
         // no need to switch
         *((uint16_t*)&g_paletteRAM[address & 0x3FE]) = (b << 8) | b;
         break;
@@ -776,6 +831,7 @@ static inline void CPUWriteByte(uint32_t address, uint8_t b)
             return;
         if ((address & 0x18000) == 0x18000)
             address &= 0x17fff;
+        gbaRendererVramWrite(address, 2);
 
         // no need to switch
         // byte writes to OBJ VRAM are ignored
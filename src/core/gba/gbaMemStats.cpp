@@ -0,0 +1,137 @@
+#include "core/gba/gbaMemStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+bool memStatsEnabled = false;
+MemStatsFrame memStatsCurrent;
+uint32_t memStatsPages[MEMSTATS_PAGES][MEMSTATS_COUNTERS];
+uint8_t memStatsTouched[MEMSTATS_PAGES];
+
+namespace {
+
+std::vector<uint32_t> memStatsDirty;
+std::vector<MemStatsFrame> memStatsRing(MEMSTATS_HISTORY);
+// The next slot of the ring to fill and the number of frames in it.
+int memStatsHead = 0;
+int memStatsFrames = 0;
+uint32_t memStatsFrameNumber = 0;
+
+void memStatsClearCurrent()
+{
+    for (uint32_t page : memStatsDirty) {
+        memset(memStatsPages[page], 0, sizeof(memStatsPages[page]));
+        memStatsTouched[page] = 0;
+    }
+    memStatsDirty.clear();
+
+    memStatsCurrent.cycles = 0;
+    memStatsCurrent.haltCycles = 0;
+    memStatsCurrent.dmaCycles = 0;
+    memset(memStatsCurrent.regions, 0, sizeof(memStatsCurrent.regions));
+}
+
+void memStatsWriteRow(FILE* f, uint32_t frame, const char* scope, uint32_t address, const uint32_t* counters)
+{
+    fprintf(f, "%u,%s,0x%08x", frame, scope, address);
+    for (int i = 0; i < MEMSTATS_COUNTERS; i++)
+        fprintf(f, ",%u", counters[i]);
+    fprintf(f, ",,\n");
+}
+
+}  // namespace
+
+void memStatsEnable(bool enable)
+{
+    memStatsEnabled = enable;
+    memStatsReset();
+}
+
+void memStatsReset()
+{
+    memStatsClearCurrent();
+    memStatsHead = 0;
+    memStatsFrames = 0;
+    memStatsFrameNumber = 0;
+}
+
+void memStatsTouch(uint32_t page)
+{
+    memStatsTouched[page] = 1;
+    memStatsDirty.push_back(page);
+}
+
+void memStatsDma(uint32_t source, uint32_t dest, uint32_t sourceIncrement, uint32_t destIncrement, uint32_t count, int ticks)
+{
+    if (!memStatsEnabled)
+        return;
+    memStatsCurrent.dmaCycles += ticks;
+    for (uint32_t i = 0; i < count; i++) {
+        memStatsCount(source, MEMSTATS_READS, 1);
+        memStatsCount(dest, MEMSTATS_WRITES, 1);
+        source += sourceIncrement;
+        dest += destIncrement;
+    }
+}
+
+void memStatsEndFrame()
+{
+    if (!memStatsEnabled)
+        return;
+
+    MemStatsFrame& out = memStatsRing[memStatsHead];
+    out.frame = memStatsFrameNumber++;
+    out.cycles = memStatsCurrent.cycles;
+    out.haltCycles = memStatsCurrent.haltCycles;
+    out.dmaCycles = memStatsCurrent.dmaCycles;
+    memcpy(out.regions, memStatsCurrent.regions, sizeof(out.regions));
+
+    std::sort(memStatsDirty.begin(), memStatsDirty.end());
+    out.pages.resize(memStatsDirty.size());
+    for (size_t i = 0; i < memStatsDirty.size(); i++) {
+        const uint32_t page = memStatsDirty[i];
+        out.pages[i].address = page << MEMSTATS_PAGE_SHIFT;
+        memcpy(out.pages[i].counters, memStatsPages[page], sizeof(out.pages[i].counters));
+    }
+
+    memStatsHead = (memStatsHead + 1) % MEMSTATS_HISTORY;
+    if (memStatsFrames < MEMSTATS_HISTORY)
+        memStatsFrames++;
+    memStatsClearCurrent();
+}
+
+int memStatsFrameCount()
+{
+    return memStatsFrames;
+}
+
+const MemStatsFrame* memStatsGetFrame(int index)
+{
+    if (index < 0 || index >= memStatsFrames)
+        return NULL;
+    return &memStatsRing[(memStatsHead - memStatsFrames + index + MEMSTATS_HISTORY) % MEMSTATS_HISTORY];
+}
+
+bool memStatsWriteCsv(const char* file)
+{
+    FILE* f = fopen(file, "w");
+    if (!f)
+        return false;
+
+    fprintf(f, "frame,scope,address,reads,writes,executed,cycles,stalls,halt_cycles,dma_cycles\n");
+    for (int i = 0; i < memStatsFrames; i++) {
+        const MemStatsFrame* frame = memStatsGetFrame(i);
+        fprintf(f, "%u,frame,,,,,%u,,%u,%u\n", frame->frame, frame->cycles, frame->haltCycles, frame->dmaCycles);
+        for (int r = 0; r < MEMSTATS_REGIONS; r++) {
+            bool used = false;
+            for (int c = 0; c < MEMSTATS_COUNTERS; c++)
+                used |= frame->regions[r][c] != 0;
+            if (used)
+                memStatsWriteRow(f, frame->frame, "region", (uint32_t)r << 24, frame->regions[r]);
+        }
+        for (const MemStatsPage& page : frame->pages)
+            memStatsWriteRow(f, frame->frame, "page", page.address, page.counters);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,91 @@
+#ifndef VBAM_CORE_GBA_GBAMEMSTATS_H_
+#define VBAM_CORE_GBA_GBAMEMSTATS_H_
+
+#if !defined(VBAM_ENABLE_MEMORY_STATS)
+#error "gbaMemStats.h requires VBAM_ENABLE_MEMORY_STATS"
+#endif
+
+#include <cstdint>
+#include <vector>
+
+// Memory access and cycle counters, per region (address >> 24) and per 4 KB
+// page, for builds configured with ENABLE_MEMORY_STATS. The counters of each
+// frame are kept in a ring buffer of the last MEMSTATS_HISTORY frames.
+
+enum {
+    // CPU data reads and writes. DMA transfers count one per unit.
+    MEMSTATS_READS,
+    MEMSTATS_WRITES,
+    // Instructions executed from the region and the cycles they took.
+    MEMSTATS_EXECUTED,
+    MEMSTATS_CYCLES,
+    // Wait states of the CPU data accesses.
+    MEMSTATS_STALLS,
+    MEMSTATS_COUNTERS
+};
+
+#define MEMSTATS_REGIONS 16
+#define MEMSTATS_PAGE_SHIFT 12
+#define MEMSTATS_PAGES (MEMSTATS_REGIONS << (24 - MEMSTATS_PAGE_SHIFT))
+#define MEMSTATS_HISTORY 300
+
+struct MemStatsPage {
+    uint32_t address;
+    uint32_t counters[MEMSTATS_COUNTERS];
+};
+
+struct MemStatsFrame {
+    uint32_t frame;
+    uint32_t cycles;
+    uint32_t haltCycles;
+    uint32_t dmaCycles;
+    uint32_t regions[MEMSTATS_REGIONS][MEMSTATS_COUNTERS];
+    // The pages accessed during the frame, by address.
+    std::vector<MemStatsPage> pages;
+};
+
+extern bool memStatsEnabled;
+// The counters of the frame being emulated; `pages` is filled at its end.
+extern MemStatsFrame memStatsCurrent;
+extern uint32_t memStatsPages[MEMSTATS_PAGES][MEMSTATS_COUNTERS];
+extern uint8_t memStatsTouched[MEMSTATS_PAGES];
+
+void memStatsEnable(bool enable);
+void memStatsReset();
+// Called at the start of the vertical blank.
+void memStatsEndFrame();
+void memStatsTouch(uint32_t page);
+// Frames in the ring buffer, 0 being the oldest.
+int memStatsFrameCount();
+const MemStatsFrame* memStatsGetFrame(int index);
+// Writes the frames in the ring buffer as CSV.
+bool memStatsWriteCsv(const char* file);
+
+inline void memStatsCount(uint32_t address, int counter, uint32_t amount)
+{
+    if (!memStatsEnabled)
+        return;
+    const uint32_t region = (address >> 24) < MEMSTATS_REGIONS ? address >> 24 : MEMSTATS_REGIONS - 1;
+    memStatsCurrent.regions[region][counter] += amount;
+    const uint32_t page = (region << (24 - MEMSTATS_PAGE_SHIFT)) | ((address & 0xFFFFFF) >> MEMSTATS_PAGE_SHIFT);
+    if (!memStatsTouched[page])
+        memStatsTouch(page);
+    memStatsPages[page][counter] += amount;
+}
+
+inline void memStatsCycles(int ticks)
+{
+    if (memStatsEnabled)
+        memStatsCurrent.cycles += ticks;
+}
+
+inline void memStatsHalt(int ticks)
+{
+    if (memStatsEnabled)
+        memStatsCurrent.haltCycles += ticks;
+}
+
+// Counts a DMA transfer of `count` units that took `ticks` cycles.
+void memStatsDma(uint32_t source, uint32_t dest, uint32_t sourceIncrement, uint32_t destIncrement, uint32_t count, int ticks);
+
+#endif  // VBAM_CORE_GBA_GBAMEMSTATS_H_
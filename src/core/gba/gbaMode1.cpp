@@ -4,40 +4,40 @@
 
 void mode1RenderLine()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    if (coreOptions.layerEnable & 0x0100) {
-        gfxDrawTextScreen(BG0CNT, BG0HOFS, BG0VOFS, g_line0);
+    if (gfxLine.layerEnable & 0x0100) {
+        gfxDrawTextScreen(gfxLine.BG0CNT, gfxLine.BG0HOFS, gfxLine.BG0VOFS, g_line0);
     }
 
-    if (coreOptions.layerEnable & 0x0200) {
-        gfxDrawTextScreen(BG1CNT, BG1HOFS, BG1VOFS, g_line1);
+    if (gfxLine.layerEnable & 0x0200) {
+        gfxDrawTextScreen(gfxLine.BG1CNT, gfxLine.BG1HOFS, gfxLine.BG1VOFS, g_line1);
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed, g_line2);
     }
 
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -84,19 +84,19 @@ void mode1RenderLine()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -105,45 +105,45 @@ void mode1RenderLine()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode1RenderLineNoWindow()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    if (coreOptions.layerEnable & 0x0100) {
-        gfxDrawTextScreen(BG0CNT, BG0HOFS, BG0VOFS, g_line0);
+    if (gfxLine.layerEnable & 0x0100) {
+        gfxDrawTextScreen(gfxLine.BG0CNT, gfxLine.BG0HOFS, gfxLine.BG0VOFS, g_line0);
     }
 
-    if (coreOptions.layerEnable & 0x0200) {
-        gfxDrawTextScreen(BG1CNT, BG1HOFS, BG1VOFS, g_line1);
+    if (gfxLine.layerEnable & 0x0200) {
+        gfxDrawTextScreen(gfxLine.BG1CNT, gfxLine.BG1HOFS, gfxLine.BG1VOFS, g_line1);
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed, g_line2);
     }
 
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -171,11 +171,11 @@ void mode1RenderLineNoWindow()
         }
 
         if (!(color & 0x00010000)) {
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = backdrop;
                     uint8_t top2 = 0x20;
                     if ((uint8_t)(g_line0[x] >> 24) < (uint8_t)(back >> 24)) {
@@ -206,19 +206,19 @@ void mode1RenderLineNoWindow()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         } else {
@@ -241,19 +241,19 @@ void mode1RenderLineNoWindow()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -262,57 +262,57 @@ void mode1RenderLineNoWindow()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode1RenderLineAll()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
     bool inWindow0 = false;
     bool inWindow1 = false;
 
-    if (coreOptions.layerEnable & 0x2000) {
-        uint8_t v0 = WIN0V >> 8;
-        uint8_t v1 = WIN0V & 255;
+    if (gfxLine.layerEnable & 0x2000) {
+        uint8_t v0 = gfxLine.WIN0V >> 8;
+        uint8_t v1 = gfxLine.WIN0V & 255;
         inWindow0 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow0 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow0 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
-    if (coreOptions.layerEnable & 0x4000) {
-        uint8_t v0 = WIN1V >> 8;
-        uint8_t v1 = WIN1V & 255;
+    if (gfxLine.layerEnable & 0x4000) {
+        uint8_t v0 = gfxLine.WIN1V >> 8;
+        uint8_t v1 = gfxLine.WIN1V & 255;
         inWindow1 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow1 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow1 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
 
-    if (coreOptions.layerEnable & 0x0100) {
-        gfxDrawTextScreen(BG0CNT, BG0HOFS, BG0VOFS, g_line0);
+    if (gfxLine.layerEnable & 0x0100) {
+        gfxDrawTextScreen(gfxLine.BG0CNT, gfxLine.BG0HOFS, gfxLine.BG0VOFS, g_line0);
     }
 
-    if (coreOptions.layerEnable & 0x0200) {
-        gfxDrawTextScreen(BG1CNT, BG1HOFS, BG1VOFS, g_line1);
+    if (gfxLine.layerEnable & 0x0200) {
+        gfxDrawTextScreen(gfxLine.BG1CNT, gfxLine.BG1HOFS, gfxLine.BG1VOFS, g_line1);
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed, g_line2);
     }
 
@@ -320,15 +320,15 @@ void mode1RenderLineAll()
     gfxDrawOBJWin(g_lineOBJWin);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
-    uint8_t inWin0Mask = WININ & 0xFF;
-    uint8_t inWin1Mask = WININ >> 8;
-    uint8_t outMask = WINOUT & 0xFF;
+    uint8_t inWin0Mask = gfxLine.WININ & 0xFF;
+    uint8_t inWin1Mask = gfxLine.WININ >> 8;
+    uint8_t outMask = gfxLine.WINOUT & 0xFF;
 
     for (int x = 0; x < 240; x++) {
         uint32_t color = backdrop;
@@ -336,7 +336,7 @@ void mode1RenderLineAll()
         uint8_t mask = outMask;
 
         if (!(g_lineOBJWin[x] & 0x80000000)) {
-            mask = WINOUT >> 8;
+            mask = gfxLine.WINOUT >> 8;
         }
 
         if (inWindow1) {
@@ -390,29 +390,29 @@ void mode1RenderLineAll()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
         } else if (mask & 32) {
             // special FX on the window
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = backdrop;
                     uint8_t top2 = 0x20;
 
@@ -444,19 +444,19 @@ void mode1RenderLineAll()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         }
@@ -464,5 +464,5 @@ void mode1RenderLineAll()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
@@ -3,43 +3,43 @@
 
 void mode2RenderLine()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD, gfxBG2X, gfxBG2Y,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD, gfxBG2X, gfxBG2Y,
             changed, g_line2);
     }
 
-    if (coreOptions.layerEnable & 0x0800) {
+    if (gfxLine.layerEnable & 0x0800) {
         int changed = gfxBG3Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG3CNT, BG3X_L, BG3X_H, BG3Y_L, BG3Y_H,
-            BG3PA, BG3PB, BG3PC, BG3PD, gfxBG3X, gfxBG3Y,
+        gfxDrawRotScreen(gfxLine.BG3CNT, gfxLine.BG3X_L, gfxLine.BG3X_H, gfxLine.BG3Y_L, gfxLine.BG3Y_H,
+            gfxLine.BG3PA, gfxLine.BG3PB, gfxLine.BG3PC, gfxLine.BG3PD, gfxBG3X, gfxBG3Y,
             changed, g_line3);
     }
 
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -76,19 +76,19 @@ void mode2RenderLine()
                 top2 = 0x08;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -98,48 +98,48 @@ void mode2RenderLine()
     }
     gfxBG2Changed = 0;
     gfxBG3Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode2RenderLineNoWindow()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD, gfxBG2X, gfxBG2Y,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD, gfxBG2X, gfxBG2Y,
             changed, g_line2);
     }
 
-    if (coreOptions.layerEnable & 0x0800) {
+    if (gfxLine.layerEnable & 0x0800) {
         int changed = gfxBG3Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG3CNT, BG3X_L, BG3X_H, BG3Y_L, BG3Y_H,
-            BG3PA, BG3PB, BG3PC, BG3PD, gfxBG3X, gfxBG3Y,
+        gfxDrawRotScreen(gfxLine.BG3CNT, gfxLine.BG3X_L, gfxLine.BG3X_H, gfxLine.BG3Y_L, gfxLine.BG3Y_H,
+            gfxLine.BG3PA, gfxLine.BG3PB, gfxLine.BG3PC, gfxLine.BG3PD, gfxBG3X, gfxBG3Y,
             changed, g_line3);
     }
 
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -162,11 +162,11 @@ void mode2RenderLineNoWindow()
         }
 
         if (!(color & 0x00010000)) {
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = backdrop;
                     uint8_t top2 = 0x20;
 
@@ -191,19 +191,19 @@ void mode2RenderLineNoWindow()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         } else {
@@ -221,19 +221,19 @@ void mode2RenderLineNoWindow()
                 top2 = 0x08;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -243,60 +243,60 @@ void mode2RenderLineNoWindow()
     }
     gfxBG2Changed = 0;
     gfxBG3Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode2RenderLineAll()
 {
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (DISPCNT & 0x80) {
+    if (gfxLine.DISPCNT & 0x80) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
     bool inWindow0 = false;
     bool inWindow1 = false;
 
-    if (coreOptions.layerEnable & 0x2000) {
-        uint8_t v0 = WIN0V >> 8;
-        uint8_t v1 = WIN0V & 255;
+    if (gfxLine.layerEnable & 0x2000) {
+        uint8_t v0 = gfxLine.WIN0V >> 8;
+        uint8_t v1 = gfxLine.WIN0V & 255;
         inWindow0 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow0 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow0 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
-    if (coreOptions.layerEnable & 0x4000) {
-        uint8_t v0 = WIN1V >> 8;
-        uint8_t v1 = WIN1V & 255;
+    if (gfxLine.layerEnable & 0x4000) {
+        uint8_t v0 = gfxLine.WIN1V >> 8;
+        uint8_t v1 = gfxLine.WIN1V & 255;
         inWindow1 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow1 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow1 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG2CNT, BG2X_L, BG2X_H, BG2Y_L, BG2Y_H,
-            BG2PA, BG2PB, BG2PC, BG2PD, gfxBG2X, gfxBG2Y,
+        gfxDrawRotScreen(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H, gfxLine.BG2Y_L, gfxLine.BG2Y_H,
+            gfxLine.BG2PA, gfxLine.BG2PB, gfxLine.BG2PC, gfxLine.BG2PD, gfxBG2X, gfxBG2Y,
             changed, g_line2);
     }
 
-    if (coreOptions.layerEnable & 0x0800) {
+    if (gfxLine.layerEnable & 0x0800) {
         int changed = gfxBG3Changed;
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen(BG3CNT, BG3X_L, BG3X_H, BG3Y_L, BG3Y_H,
-            BG3PA, BG3PB, BG3PC, BG3PD, gfxBG3X, gfxBG3Y,
+        gfxDrawRotScreen(gfxLine.BG3CNT, gfxLine.BG3X_L, gfxLine.BG3X_H, gfxLine.BG3Y_L, gfxLine.BG3Y_H,
+            gfxLine.BG3PA, gfxLine.BG3PB, gfxLine.BG3PC, gfxLine.BG3PD, gfxBG3X, gfxBG3Y,
             changed, g_line3);
     }
 
@@ -304,15 +304,15 @@ void mode2RenderLineAll()
     gfxDrawOBJWin(g_lineOBJWin);
 
     uint32_t backdrop;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         backdrop = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        backdrop = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        backdrop = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
-    uint8_t inWin0Mask = WININ & 0xFF;
-    uint8_t inWin1Mask = WININ >> 8;
-    uint8_t outMask = WINOUT & 0xFF;
+    uint8_t inWin0Mask = gfxLine.WININ & 0xFF;
+    uint8_t inWin1Mask = gfxLine.WININ >> 8;
+    uint8_t outMask = gfxLine.WINOUT & 0xFF;
 
     for (int x = 0; x < 240; x++) {
         uint32_t color = backdrop;
@@ -320,7 +320,7 @@ void mode2RenderLineAll()
         uint8_t mask = outMask;
 
         if (!(g_lineOBJWin[x] & 0x80000000)) {
-            mask = WINOUT >> 8;
+            mask = gfxLine.WINOUT >> 8;
         }
 
         if (inWindow1) {
@@ -364,29 +364,29 @@ void mode2RenderLineAll()
                 top2 = 0x08;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
         } else if (mask & 32) {
             // special FX on the window
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = backdrop;
                     uint8_t top2 = 0x20;
 
@@ -411,19 +411,19 @@ void mode2RenderLineAll()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         }
@@ -432,5 +432,5 @@ void mode2RenderLineAll()
     }
     gfxBG2Changed = 0;
     gfxBG3Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
@@ -4,25 +4,25 @@
 
 void mode5RenderLine()
 {
-    if (DISPCNT & 0x0080) {
+    if (gfxLine.DISPCNT & 0x0080) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
 
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen16Bit160(BG2CNT, BG2X_L, BG2X_H,
-            BG2Y_L, BG2Y_H, BG2PA, BG2PB,
-            BG2PC, BG2PD,
+        gfxDrawRotScreen16Bit160(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H,
+            gfxLine.BG2Y_L, gfxLine.BG2Y_H, gfxLine.BG2PA, gfxLine.BG2PB,
+            gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed,
             g_line2);
     }
@@ -30,10 +30,10 @@ void mode5RenderLine()
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t background;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         background = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        background = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        background = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -60,19 +60,19 @@ void mode5RenderLine()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -81,30 +81,30 @@ void mode5RenderLine()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode5RenderLineNoWindow()
 {
-    if (DISPCNT & 0x0080) {
+    if (gfxLine.DISPCNT & 0x0080) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
 
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen16Bit160(BG2CNT, BG2X_L, BG2X_H,
-            BG2Y_L, BG2Y_H, BG2PA, BG2PB,
-            BG2PC, BG2PD,
+        gfxDrawRotScreen16Bit160(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H,
+            gfxLine.BG2Y_L, gfxLine.BG2Y_H, gfxLine.BG2PA, gfxLine.BG2PB,
+            gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed,
             g_line2);
     }
@@ -112,10 +112,10 @@ void mode5RenderLineNoWindow()
     gfxDrawSprites(g_lineOBJ);
 
     uint32_t background;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         background = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        background = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        background = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -133,11 +133,11 @@ void mode5RenderLineNoWindow()
         }
 
         if (!(color & 0x00010000)) {
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = background;
                     uint8_t top2 = 0x20;
 
@@ -155,19 +155,19 @@ void mode5RenderLineNoWindow()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         } else {
@@ -180,19 +180,19 @@ void mode5RenderLineNoWindow()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
@@ -201,30 +201,30 @@ void mode5RenderLineNoWindow()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
 
 void mode5RenderLineAll()
 {
-    if (DISPCNT & 0x0080) {
+    if (gfxLine.DISPCNT & 0x0080) {
         for (int x = 0; x < 240; x++) {
             g_lineMix[x] = 0x7fff;
         }
-        gfxLastVCOUNT = VCOUNT;
+        gfxLastVCOUNT = gfxVCOUNT;
         return;
     }
 
-    uint16_t* palette = (uint16_t*)g_paletteRAM;
+    uint16_t* palette = (uint16_t*)gfxLine.paletteRAM;
 
-    if (coreOptions.layerEnable & 0x0400) {
+    if (gfxLine.layerEnable & 0x0400) {
         int changed = gfxBG2Changed;
 
-        if (gfxLastVCOUNT > VCOUNT)
+        if (gfxLastVCOUNT > gfxVCOUNT)
             changed = 3;
 
-        gfxDrawRotScreen16Bit160(BG2CNT, BG2X_L, BG2X_H,
-            BG2Y_L, BG2Y_H, BG2PA, BG2PB,
-            BG2PC, BG2PD,
+        gfxDrawRotScreen16Bit160(gfxLine.BG2CNT, gfxLine.BG2X_L, gfxLine.BG2X_H,
+            gfxLine.BG2Y_L, gfxLine.BG2Y_H, gfxLine.BG2PA, gfxLine.BG2PB,
+            gfxLine.BG2PC, gfxLine.BG2PD,
             gfxBG2X, gfxBG2Y, changed,
             g_line2);
     }
@@ -235,34 +235,34 @@ void mode5RenderLineAll()
     bool inWindow0 = false;
     bool inWindow1 = false;
 
-    if (coreOptions.layerEnable & 0x2000) {
-        uint8_t v0 = WIN0V >> 8;
-        uint8_t v1 = WIN0V & 255;
+    if (gfxLine.layerEnable & 0x2000) {
+        uint8_t v0 = gfxLine.WIN0V >> 8;
+        uint8_t v1 = gfxLine.WIN0V & 255;
         inWindow0 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow0 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow0 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow0 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
-    if (coreOptions.layerEnable & 0x4000) {
-        uint8_t v0 = WIN1V >> 8;
-        uint8_t v1 = WIN1V & 255;
+    if (gfxLine.layerEnable & 0x4000) {
+        uint8_t v0 = gfxLine.WIN1V >> 8;
+        uint8_t v1 = gfxLine.WIN1V & 255;
         inWindow1 = ((v0 == v1) && (v0 >= 0xe8));
         if (v1 >= v0)
-            inWindow1 |= (VCOUNT >= v0 && VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 && gfxVCOUNT < v1);
         else
-            inWindow1 |= (VCOUNT >= v0 || VCOUNT < v1);
+            inWindow1 |= (gfxVCOUNT >= v0 || gfxVCOUNT < v1);
     }
 
-    uint8_t inWin0Mask = WININ & 0xFF;
-    uint8_t inWin1Mask = WININ >> 8;
-    uint8_t outMask = WINOUT & 0xFF;
+    uint8_t inWin0Mask = gfxLine.WININ & 0xFF;
+    uint8_t inWin1Mask = gfxLine.WININ >> 8;
+    uint8_t outMask = gfxLine.WINOUT & 0xFF;
 
     uint32_t background;
-    if (customBackdropColor == -1) {
+    if (gfxLine.customBackdropColor == -1) {
         background = (READ16LE(&palette[0]) | 0x30000000);
     } else {
-        background = ((customBackdropColor & 0x7FFF) | 0x30000000);
+        background = ((gfxLine.customBackdropColor & 0x7FFF) | 0x30000000);
     }
 
     for (int x = 0; x < 240; x++) {
@@ -271,7 +271,7 @@ void mode5RenderLineAll()
         uint8_t mask = outMask;
 
         if (!(g_lineOBJWin[x] & 0x80000000)) {
-            mask = WINOUT >> 8;
+            mask = gfxLine.WINOUT >> 8;
         }
 
         if (inWindow1) {
@@ -305,28 +305,28 @@ void mode5RenderLineAll()
                 top2 = 0x04;
             }
 
-            if (top2 & (BLDMOD >> 8))
+            if (top2 & (gfxLine.BLDMOD >> 8))
                 color = gfxAlphaBlend(color, back,
-                    g_coeff[COLEV & 0x1F],
-                    g_coeff[(COLEV >> 8) & 0x1F]);
+                    g_coeff[gfxLine.COLEV & 0x1F],
+                    g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
             else {
-                switch ((BLDMOD >> 6) & 3) {
+                switch ((gfxLine.BLDMOD >> 6) & 3) {
                 case 2:
-                    if (BLDMOD & top)
-                        color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 case 3:
-                    if (BLDMOD & top)
-                        color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                    if (gfxLine.BLDMOD & top)
+                        color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                     break;
                 }
             }
         } else if (mask & 32) {
-            switch ((BLDMOD >> 6) & 3) {
+            switch ((gfxLine.BLDMOD >> 6) & 3) {
             case 0:
                 break;
             case 1: {
-                if (top & BLDMOD) {
+                if (top & gfxLine.BLDMOD) {
                     uint32_t back = background;
                     uint8_t top2 = 0x20;
 
@@ -344,19 +344,19 @@ void mode5RenderLineAll()
                         }
                     }
 
-                    if (top2 & (BLDMOD >> 8))
+                    if (top2 & (gfxLine.BLDMOD >> 8))
                         color = gfxAlphaBlend(color, back,
-                            g_coeff[COLEV & 0x1F],
-                            g_coeff[(COLEV >> 8) & 0x1F]);
+                            g_coeff[gfxLine.COLEV & 0x1F],
+                            g_coeff[(gfxLine.COLEV >> 8) & 0x1F]);
                 }
             } break;
             case 2:
-                if (BLDMOD & top)
-                    color = gfxIncreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxIncreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             case 3:
-                if (BLDMOD & top)
-                    color = gfxDecreaseBrightness(color, g_coeff[COLY & 0x1F]);
+                if (gfxLine.BLDMOD & top)
+                    color = gfxDecreaseBrightness(color, g_coeff[gfxLine.COLY & 0x1F]);
                 break;
             }
         }
@@ -364,5 +364,5 @@ void mode5RenderLineAll()
         g_lineMix[x] = color;
     }
     gfxBG2Changed = 0;
-    gfxLastVCOUNT = VCOUNT;
+    gfxLastVCOUNT = gfxVCOUNT;
 }
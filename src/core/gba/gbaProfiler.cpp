@@ -0,0 +1,357 @@
+#include "core/gba/gbaProfiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
+
+#include "core/gba/gba.h"
+#include "core/gba/gbaElf.h"
+#include "core/gba/gbaGlobals.h"
+
+bool profilerEnabled = false;
+int profilerTicks = 0;
+
+namespace {
+
+// Deepest call chain that a sample records.
+constexpr size_t kMaxDepth = 64;
+// Deepest shadow call stack kept. Older frames are dropped past this.
+constexpr size_t kMaxShadowDepth = 1024;
+// How many frames a return may skip, e.g. after a longjmp.
+constexpr size_t kReturnSearchDepth = 16;
+// The IRQ vector, used as the entry of the frames of interrupt handlers.
+constexpr uint32_t kIrqVector = 0x18;
+
+struct ProfilerFrame {
+    uint32_t entry;
+    uint32_t returnAddress;
+    // SP of the caller and the mode it ran in. The frame is gone once the
+    // stack of that mode has been popped above `sp`.
+    uint32_t sp;
+    int mode;
+};
+
+struct StackHash {
+    size_t operator()(const std::vector<uint32_t>& v) const
+    {
+        size_t h = 0x811c9dc5;
+        for (uint32_t a : v)
+            h = (h ^ a) * 0x01000193;
+        return h;
+    }
+};
+
+int profilerPeriod = 0;
+std::vector<ProfilerFrame> profilerStack;
+// Sample counts by stack. A stack is made of (address, entry) pairs,
+// innermost first, where `entry` is the start of the function that `address`
+// is in, or 0 when it is not known.
+std::unordered_map<std::vector<uint32_t>, uint64_t, StackHash> profilerSamples;
+
+uint32_t profilerModeSp(int mode)
+{
+    const bool user = mode == 0x10 || mode == 0x1f;
+    if (mode == armMode || (user && (armMode == 0x10 || armMode == 0x1f)))
+        return reg[13].I;
+    switch (mode) {
+    case 0x11:
+        return reg[R13_FIQ].I;
+    case 0x12:
+        return reg[R13_IRQ].I;
+    case 0x13:
+        return reg[R13_SVC].I;
+    case 0x17:
+        return reg[R13_ABT].I;
+    case 0x1b:
+        return reg[R13_UND].I;
+    default:
+        return reg[R13_USR].I;
+    }
+}
+
+// Drops the frames that were left without a return the hooks could see,
+// e.g. through LDM or MOV PC, LR.
+void profilerTrim()
+{
+    while (!profilerStack.empty()) {
+        const ProfilerFrame& f = profilerStack.back();
+        const bool stale = f.entry == kIrqVector ? armMode != 0x12 : profilerModeSp(f.mode) > f.sp;
+        if (!stale)
+            break;
+        profilerStack.pop_back();
+    }
+}
+
+void profilerPush(uint32_t entry, uint32_t returnAddress)
+{
+    profilerTrim();
+    if (profilerStack.size() >= kMaxShadowDepth)
+        profilerStack.erase(profilerStack.begin());
+    profilerStack.push_back({ entry, returnAddress & 0xFFFFFFFE, reg[13].I, armMode });
+}
+
+bool profilerPop(uint32_t target)
+{
+    target &= 0xFFFFFFFE;
+    const size_t n = profilerStack.size();
+    for (size_t i = 0; i < n && i < kReturnSearchDepth; i++) {
+        if (profilerStack[n - 1 - i].returnAddress == target) {
+            profilerStack.resize(n - 1 - i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string profilerFrameName(uint32_t address, uint32_t entry)
+{
+    std::string name = elfGetAddressSymbol(address);
+    if (!name.empty()) {
+        const size_t plus = name.rfind('+');
+        if (plus != std::string::npos)
+            name.resize(plus);
+        return name;
+    }
+    if (entry == kIrqVector)
+        return "irq";
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), entry ? "sub_%08x" : "0x%08x", entry ? entry : address);
+    return buffer;
+}
+
+// A minimal protocol buffer writer for profile.proto.
+class ProtoWriter {
+public:
+    void Varint(uint64_t v)
+    {
+        while (v >= 0x80) {
+            data_.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        data_.push_back((uint8_t)v);
+    }
+
+    void Int(int field, uint64_t v)
+    {
+        Varint((uint64_t)field << 3);
+        Varint(v);
+    }
+
+    void Bytes(int field, const void* bytes, size_t size)
+    {
+        Varint(((uint64_t)field << 3) | 2);
+        Varint(size);
+        data_.insert(data_.end(), (const uint8_t*)bytes, (const uint8_t*)bytes + size);
+    }
+
+    void Message(int field, const ProtoWriter& m) { Bytes(field, m.data_.data(), m.data_.size()); }
+
+    void Packed(int field, const std::vector<uint64_t>& values)
+    {
+        ProtoWriter m;
+        for (uint64_t v : values)
+            m.Varint(v);
+        Message(field, m);
+    }
+
+    const std::vector<uint8_t>& data() const { return data_; }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+bool profilerSaveFolded(const char* file)
+{
+    // Merged by name, so that the call sites of a function add up.
+    std::map<std::string, uint64_t> lines;
+    for (const auto& s : profilerSamples) {
+        const std::vector<uint32_t>& stack = s.first;
+        std::string line;
+        for (size_t i = stack.size(); i >= 2; i -= 2) {
+            if (!line.empty())
+                line += ';';
+            line += profilerFrameName(stack[i - 2], stack[i - 1]);
+        }
+        lines[line] += s.second;
+    }
+
+    FILE* f = fopen(file, "w");
+    if (!f)
+        return false;
+    for (const auto& l : lines)
+        fprintf(f, "%s %llu\n", l.first.c_str(), (unsigned long long)l.second);
+    return fclose(f) == 0;
+}
+
+bool profilerSavePprof(const char* file)
+{
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint64_t> stringIds;
+    auto str = [&](const std::string& s) -> uint64_t {
+        auto it = stringIds.find(s);
+        if (it != stringIds.end())
+            return it->second;
+        strings.push_back(s);
+        return stringIds[s] = strings.size() - 1;
+    };
+    // The string table starts with "".
+    str("");
+
+    ProtoWriter profile;
+    ProtoWriter sampleType;
+    sampleType.Int(1, str("samples"));
+    sampleType.Int(2, str("count"));
+    profile.Message(1, sampleType);
+    ProtoWriter cyclesType;
+    cyclesType.Int(1, str("cpu"));
+    cyclesType.Int(2, str("cycles"));
+    profile.Message(1, cyclesType);
+
+    std::map<std::pair<uint32_t, uint32_t>, uint64_t> locations;
+    std::map<std::string, uint64_t> functions;
+    for (const auto& s : profilerSamples) {
+        const std::vector<uint32_t>& stack = s.first;
+        std::vector<uint64_t> ids;
+        for (size_t i = 0; i + 1 < stack.size(); i += 2) {
+            auto key = std::make_pair(stack[i], stack[i + 1]);
+            auto it = locations.find(key);
+            if (it == locations.end())
+                it = locations.emplace(key, locations.size() + 1).first;
+            ids.push_back(it->second);
+        }
+        ProtoWriter sample;
+        sample.Packed(1, ids);
+        sample.Packed(2, { s.second, s.second * (uint64_t)profilerPeriod });
+        profile.Message(2, sample);
+    }
+
+    ProtoWriter mapping;
+    mapping.Int(1, 1);
+    mapping.Int(3, 0x100000000ULL);
+    mapping.Int(5, str(elfHasFrameInfo() ? "elf" : "rom"));
+    mapping.Int(7, 1);
+    profile.Message(3, mapping);
+
+    for (const auto& l : locations) {
+        const std::string name = profilerFrameName(l.first.first, l.first.second);
+        auto it = functions.find(name);
+        if (it == functions.end())
+            it = functions.emplace(name, functions.size() + 1).first;
+        ProtoWriter line;
+        line.Int(1, it->second);
+        ProtoWriter location;
+        location.Int(1, l.second);
+        location.Int(2, 1);
+        location.Int(3, l.first.first);
+        location.Message(4, line);
+        profile.Message(4, location);
+    }
+    for (const auto& fn : functions) {
+        ProtoWriter function;
+        function.Int(1, fn.second);
+        function.Int(2, str(fn.first));
+        function.Int(3, str(fn.first));
+        profile.Message(5, function);
+    }
+
+    // The string table has to come after every str() call.
+    ProtoWriter periodType;
+    periodType.Int(1, str("cpu"));
+    periodType.Int(2, str("cycles"));
+    for (const std::string& s : strings)
+        profile.Bytes(6, s.data(), s.size());
+    profile.Message(11, periodType);
+    profile.Int(12, profilerPeriod);
+
+    gzFile f = gzopen(file, "wb");
+    if (!f)
+        return false;
+    const std::vector<uint8_t>& data = profile.data();
+    const bool ok = data.empty() || gzwrite(f, data.data(), (unsigned)data.size()) == (int)data.size();
+    return gzclose(f) == Z_OK && ok;
+}
+
+}  // namespace
+
+void profilerStart(int period)
+{
+    profilerPeriod = period > 0 ? period : 16384;
+    profilerTicks = profilerPeriod;
+    profilerStack.clear();
+    profilerSamples.clear();
+    profilerEnabled = true;
+}
+
+void profilerStop()
+{
+    profilerEnabled = false;
+    profilerStack.clear();
+}
+
+bool profilerSave(const char* file, ProfilerFormat format)
+{
+    if (format == PROFILER_PPROF)
+        return profilerSavePprof(file);
+    return profilerSaveFolded(file);
+}
+
+void profilerSample()
+{
+    while (profilerTicks <= 0)
+        profilerTicks += profilerPeriod;
+
+    std::vector<uint32_t> stack;
+    if (elfHasFrameInfo()) {
+        uint32_t chain[kMaxDepth];
+        const int count = elfGetCallChain(armNextPC, chain, (int)kMaxDepth);
+        stack.reserve(count * 2);
+        for (int i = 0; i < count; i++) {
+            stack.push_back(chain[i]);
+            stack.push_back(0);
+        }
+    } else {
+        profilerTrim();
+        const size_t n = profilerStack.size();
+        const size_t depth = n < kMaxDepth - 1 ? n : kMaxDepth - 1;
+        stack.reserve((depth + 1) * 2);
+        stack.push_back(armNextPC);
+        stack.push_back(n ? profilerStack[n - 1].entry : 0);
+        for (size_t i = 1; i <= depth; i++) {
+            stack.push_back(profilerStack[n - i].returnAddress);
+            stack.push_back(i < n ? profilerStack[n - i - 1].entry : 0);
+        }
+    }
+    profilerSamples[stack]++;
+}
+
+void profilerCall(uint32_t target, uint32_t returnAddress)
+{
+    profilerPush(target & 0xFFFFFFFE, returnAddress);
+}
+
+void profilerReturn(uint32_t target)
+{
+    profilerPop(target);
+}
+
+void profilerBranch(uint32_t insn, uint32_t next, uint32_t target)
+{
+    if (profilerPop(target))
+        return;
+    if ((reg[14].I & 0xFFFFFFFE) == next) {
+        profilerPush(target & 0xFFFFFFFE, next);
+    } else if (!profilerStack.empty() && profilerStack.back().entry == insn) {
+        // A call through a veneer such as _call_via_r3: charge the callee.
+        profilerStack.back().entry = target & 0xFFFFFFFE;
+    }
+}
+
+void profilerInterrupt(uint32_t interrupted)
+{
+    profilerPush(kIrqVector, interrupted);
+}
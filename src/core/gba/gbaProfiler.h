@@ -0,0 +1,62 @@
+#ifndef VBAM_CORE_GBA_GBAPROFILER_H_
+#define VBAM_CORE_GBA_GBAPROFILER_H_
+
+#include <cstdint>
+
+// A sampling profiler for the emulated CPU. Every `period` cycles, it records
+// the PC and the call chain that led to it. The chain comes from the call
+// frame information of the loaded ELF image when there is one, and from a
+// shadow call stack maintained by the branch instructions otherwise.
+
+enum ProfilerFormat {
+    // One "caller;callee count" line per stack, for flame graph tools.
+    PROFILER_FOLDED,
+    // A gzipped pprof profile.proto.
+    PROFILER_PPROF
+};
+
+#if defined(__LIBRETRO__)
+
+constexpr bool profilerEnabled = false;
+constexpr int profilerTicks = 0;
+inline void profilerTick(int) {}
+inline void profilerCall(uint32_t, uint32_t) {}
+inline void profilerReturn(uint32_t) {}
+inline void profilerBranch(uint32_t, uint32_t, uint32_t) {}
+inline void profilerInterrupt(uint32_t) {}
+
+#else
+
+// Checked by the CPU before calling any of the hooks below.
+extern bool profilerEnabled;
+// Cycles left until the next sample.
+extern int profilerTicks;
+
+void profilerStart(int period);
+void profilerStop();
+bool profilerSave(const char* file, ProfilerFormat format);
+
+// Hooks for the CPU.
+void profilerSample();
+
+// Counts `ticks` cycles towards the next sample.
+inline void profilerTick(int ticks)
+{
+    profilerTicks -= ticks;
+    if (profilerTicks <= 0)
+        profilerSample();
+}
+
+// A BL to `target` that returns to `returnAddress`.
+void profilerCall(uint32_t target, uint32_t returnAddress);
+// A return, e.g. POP {PC}, to `target`.
+void profilerReturn(uint32_t target);
+// A BX at `insn`, whose next instruction is at `next`, to `target`. It is
+// either a return, a call if LR holds `next`, or a jump through a veneer.
+void profilerBranch(uint32_t insn, uint32_t next, uint32_t target);
+// An IRQ taken while `interrupted` was the next instruction.
+void profilerInterrupt(uint32_t interrupted);
+
+#endif  // defined(__LIBRETRO__)
+
+#endif  // VBAM_CORE_GBA_GBAPROFILER_H_
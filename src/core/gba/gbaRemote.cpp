@@ -17,11 +17,13 @@
 #else  // !defined(_WIN32)
 
 #include <netdb.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #ifdef HAVE_NETINET_IN_H
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #endif // HAVE_NETINET_IN_H
 
 #ifdef HAVE_ARPA_INET_H
@@ -41,6 +43,7 @@
 #include <iosfwd>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "core/gba/gba.h"
 #include "core/gba/gbaElf.h"
@@ -62,6 +65,19 @@ int (*remoteSendFnc)(char*, int) = NULL;
 int (*remoteRecvFnc)(char*, int) = NULL;
 bool (*remoteInitFnc)() = NULL;
 void (*remoteCleanUpFnc)() = NULL;
+// Whether input can be read without blocking, so that remotePoll() can see
+// interrupt requests while the game runs. NULL if the transport can't tell.
+bool (*remotePendingFnc)() = NULL;
+
+// Largest packet accepted from the client, as advertised by qSupported.
+#define REMOTE_PACKET_SIZE 0x4000
+// How long a read waits for input before letting the frontend run, in ms.
+#define REMOTE_RECV_TIMEOUT 100
+
+// Input received but not handled yet.
+static std::string remoteInput;
+// Set once the client asked for QStartNoAckMode.
+static bool remoteNoAck = false;
 
 #ifndef SDL
 void remoteSetSockets(SOCKET l, SOCKET r)
@@ -3389,14 +3405,41 @@ void dbgExecute(std::string& cmd)
     delete[] dbgCmd;
 }
 
+// Waits up to `timeout` ms for `fd` to be readable.
+static bool remoteWaitReadable(SOCKET fd, int timeout)
+{
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(fd, &set);
+    timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    return select((int)fd + 1, &set, NULL, NULL, &tv) > 0;
+}
+
 int remoteTcpSend(char* data, int len)
 {
-    return send(remoteSocket, data, len, 0);
+    int sent = 0;
+    while (sent < len) {
+        int res = send(remoteSocket, data + sent, len - sent, 0);
+        if (res <= 0)
+            return -1;
+        sent += res;
+    }
+    return sent;
 }
 
 int remoteTcpRecv(char* data, int len)
 {
-    return recv(remoteSocket, data, len, 0);
+    if (!remoteWaitReadable(remoteSocket, REMOTE_RECV_TIMEOUT))
+        return -2;
+    int res = recv(remoteSocket, data, len, 0);
+    return res > 0 ? res : -1;
+}
+
+bool remoteTcpPending()
+{
+    return remoteSocket != -1 && remoteWaitReadable(remoteSocket, 0);
 }
 
 bool remoteTcpInit()
@@ -3457,6 +3500,8 @@ bool remoteTcpInit()
             fprintf(stderr, "Got a connection from %s %d\n",
                 inet_ntoa((in_addr)addr.sin_addr),
                 ntohs(addr.sin_port));
+            // Stepping exchanges many small packets.
+            setsockopt(s2, IPPROTO_TCP, TCP_NODELAY, (char*)&tmp, sizeof(tmp));
         } else {
 #ifdef _WIN32
             int error = WSAGetLastError();
@@ -3496,8 +3541,21 @@ int remotePipeSend(char* data, int len)
 
 int remotePipeRecv(char* data, int len)
 {
+#ifndef _WIN32
+    if (!remoteWaitReadable(0, REMOTE_RECV_TIMEOUT))
+        return -2;
+#endif // _WIN32
     int res = read(0, data, len);
-    return res;
+    return res > 0 ? res : -1;
+}
+
+bool remotePipePending()
+{
+#ifdef _WIN32
+    return false;
+#else
+    return remoteWaitReadable(0, 0);
+#endif // _WIN32
 }
 
 bool remotePipeInit()
@@ -3530,11 +3588,13 @@ void remoteSetProtocol(int p)
         remoteRecvFnc = remoteTcpRecv;
         remoteInitFnc = remoteTcpInit;
         remoteCleanUpFnc = remoteTcpCleanUp;
+        remotePendingFnc = remoteTcpPending;
     } else {
         remoteSendFnc = remotePipeSend;
         remoteRecvFnc = remotePipeRecv;
         remoteInitFnc = remotePipeInit;
         remoteCleanUpFnc = remotePipeCleanUp;
+        remotePendingFnc = remotePipePending;
     }
 }
 
@@ -3544,40 +3604,54 @@ void remoteInit()
         remoteInitFnc();
 }
 
+// Waits for the client to acknowledge the last packet. Returns false if it
+// asked for it again.
+static bool remoteWaitAck()
+{
+    for (;;) {
+        while (!remoteInput.empty()) {
+            char c = remoteInput[0];
+            // A new packet implies that the last one arrived.
+            if (c == '$')
+                return true;
+            remoteInput.erase(0, 1);
+            if (c == '+')
+                return true;
+            if (c == '-')
+                return false;
+        }
+        char buffer[256];
+        int res = remoteRecvFnc(buffer, sizeof(buffer));
+        if (res == -1)
+            return true;
+        if (res > 0)
+            remoteInput.append(buffer, res);
+    }
+}
+
 void remotePutPacket(const char* packet)
 {
     const char* hex = "0123456789abcdef";
 
     size_t count = strlen(packet);
-    char* buffer = new char[count + 5];
+    std::string buffer;
+    buffer.reserve(count + 4);
 
     unsigned char csum = 0;
-
-    char* p = buffer;
-    *p++ = '$';
-
-    for (size_t i = 0; i < count; i++) {
+    for (size_t i = 0; i < count; i++)
         csum += packet[i];
-        *p++ = packet[i];
-    }
-    *p++ = '#';
-    *p++ = hex[csum >> 4];
-    *p++ = hex[csum & 15];
-    *p++ = 0;
-    //log("send: %s\n", buffer);
 
-    char c = 0;
-    while (c != '+') {
-        remoteSendFnc(buffer, (int)count + 4);
+    buffer += '$';
+    buffer.append(packet, count);
+    buffer += '#';
+    buffer += hex[csum >> 4];
+    buffer += hex[csum & 15];
+    //log("send: %s\n", buffer.c_str());
 
-        if (remoteRecvFnc(&c, 1) < 0) {
-            delete[] buffer;
+    do {
+        if (remoteSendFnc(&buffer[0], (int)buffer.size()) < 0)
             return;
-        }
-        //    fprintf(stderr,"sent:%s recieved:%c\n",buffer,c);
-    }
-
-    delete[] buffer;
+    } while (!remoteNoAck && !remoteWaitAck());
 }
 
 void remoteOutput(const char* s, uint32_t addr)
@@ -3705,24 +3779,56 @@ void remoteMemoryWrite(char* p)
 
 void remoteMemoryRead(char* p)
 {
+    const char* hex = "0123456789abcdef";
     uint32_t address;
     int count;
     sscanf(p, "%x,%x:", &address, &count);
     //  monprintf("Memory read for %08x %d\n", address, count);
+    if (count < 0)
+        count = 0;
 
-    char* buffer = new char[(count*2)+1];
-
-    char* s = buffer;
+    std::string buffer(count * 2, '0');
     for (int i = 0; i < count; i++) {
         uint8_t b = debuggerReadByte(address);
-        sprintf(s, "%02x", b);
+        buffer[2 * i] = hex[b >> 4];
+        buffer[2 * i + 1] = hex[b & 15];
         address++;
-        s += 2;
     }
-    *s = 0;
-    remotePutPacket(buffer);
+    remotePutPacket(buffer.c_str());
+}
+
+static const char remoteMemoryMap[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" \"http://sourceware.org/gdb/gdb-memory-map.dtd\">"
+    "<memory-map>"
+    "<memory type=\"rom\" start=\"0x00000000\" length=\"0x4000\"/>"
+    "<memory type=\"ram\" start=\"0x02000000\" length=\"0x40000\"/>"
+    "<memory type=\"ram\" start=\"0x03000000\" length=\"0x8000\"/>"
+    "<memory type=\"ram\" start=\"0x04000000\" length=\"0x400\"/>"
+    "<memory type=\"ram\" start=\"0x05000000\" length=\"0x400\"/>"
+    "<memory type=\"ram\" start=\"0x06000000\" length=\"0x18000\"/>"
+    "<memory type=\"ram\" start=\"0x07000000\" length=\"0x400\"/>"
+    "<memory type=\"rom\" start=\"0x08000000\" length=\"0x6000000\"/>"
+    "<memory type=\"ram\" start=\"0x0e000000\" length=\"0x10000\"/>"
+    "</memory-map>";
+
+// qXfer:memory-map:read::OFFSET,LENGTH
+void remoteMemoryMapRead(char* p)
+{
+    unsigned int offset = 0;
+    unsigned int length = 0;
+    sscanf(p, "%x,%x", &offset, &length);
 
-    delete[] buffer;
+    const size_t size = sizeof(remoteMemoryMap) - 1;
+    if (offset >= size) {
+        remotePutPacket("l");
+        return;
+    }
+    if (length > size - offset)
+        length = (unsigned int)(size - offset);
+    std::string reply(offset + length < size ? "m" : "l");
+    reply.append(remoteMemoryMap + offset, length);
+    remotePutPacket(reply.c_str());
 }
 
 void remoteQuery(char* p)
@@ -3732,7 +3838,11 @@ void remoteQuery(char* p)
     } else if (!strncmp(p, "sThreadInfo", 11)) {
         remotePutPacket("l");
     } else if (!strncmp(p, "Supported", 9)) {
-        remotePutPacket("PacketSize=1000");
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "PacketSize=%x;qXfer:memory-map:read+;QStartNoAckMode+;vContSupported+", REMOTE_PACKET_SIZE);
+        remotePutPacket(buffer);
+    } else if (!strncmp(p, "Xfer:memory-map:read::", 22)) {
+        remoteMemoryMapRead(p + 22);
     } else if (!strncmp(p, "HostInfo", 8)) {
         remotePutPacket("cputype:12;cpusubtype:5;ostype:unknown;vendor:nintendo;endian:little;ptrsize:4;");
     } else if (!strncmp(p, "C", 1)) {
@@ -4085,6 +4195,187 @@ void remoteWriteRegister(char* p)
     remotePutPacket("OK");
 }
 
+// Takes the next complete packet out of remoteInput and acknowledges it.
+// Acknowledgments and interrupt requests before it are dropped.
+static bool remoteNextPacket(std::string& packet)
+{
+    for (;;) {
+        const size_t start = remoteInput.find('$');
+        if (start == std::string::npos) {
+            remoteInput.clear();
+            return false;
+        }
+        const size_t end = remoteInput.find('#', start);
+        if (end == std::string::npos || end + 2 >= remoteInput.size()) {
+            remoteInput.erase(0, start);
+            return false;
+        }
+
+        unsigned char csum = 0;
+        for (size_t i = start + 1; i < end; i++)
+            csum += remoteInput[i];
+        unsigned int sent = 0;
+        const bool valid = sscanf(remoteInput.c_str() + end + 1, "%2x", &sent) == 1 && sent == csum;
+
+        packet.assign(remoteInput, start + 1, end - start - 1);
+        remoteInput.erase(0, end + 3);
+        if (!remoteNoAck) {
+            char ack = valid ? '+' : '-';
+            remoteSendFnc(&ack, 1);
+        }
+        if (valid)
+            return true;
+        fprintf(stderr, "bad chksum csum=%x msg=%02x\n", csum, sent);
+    }
+}
+
+static void remoteContinue()
+{
+    remoteResumed = true;
+    debugger = false;
+}
+
+static void remoteStep()
+{
+    remoteResumed = true;
+    remoteSignal = 5;
+    CPULoop(1);
+    if (remoteResumed) {
+        remoteResumed = false;
+        remoteSendStatus();
+    }
+}
+
+// vCont;ACTION[:THREAD]... There is a single thread, so the first action
+// applies.
+static bool remoteVCont(char* p)
+{
+    switch (*p) {
+    case 'c':
+    case 'C':
+        remoteContinue();
+        return false;
+    case 's':
+    case 'S':
+        remoteStep();
+        return true;
+    default:
+        remotePutPacket("");
+        return true;
+    }
+}
+
+// Handles a packet without its framing. Returns false once the game has to
+// run again.
+static bool remoteHandlePacket(char* packet)
+{
+    char c = *packet;
+    char* p = packet + 1;
+    char type;
+    switch (c) {
+    case '?':
+        remoteSendSignal();
+        break;
+    case 'D':
+        remotePutPacket("OK");
+        remoteContinue();
+        return false;
+    case 'e':
+        remoteStepOverRange(p);
+        break;
+    case 'k':
+        remotePutPacket("OK");
+        debugger = false;
+        emulating = false;
+        return false;
+    case 'C':
+    case 'c':
+        remoteContinue();
+        return false;
+    case 's':
+        remoteStep();
+        break;
+    case 'v':
+        if (!strcmp(p, "Cont?"))
+            remotePutPacket("vCont;c;C;s;S");
+        else if (!strncmp(p, "Cont;", 5))
+            return remoteVCont(p + 5);
+        else
+            remotePutPacket("");
+        break;
+    case 'g':
+        remoteReadRegisters(p);
+        break;
+    case 'p':
+        remoteReadRegister(p);
+        break;
+    case 'P':
+        remoteWriteRegister(p);
+        break;
+    case 'M':
+        remoteMemoryWrite(p);
+        break;
+    case 'm':
+        remoteMemoryRead(p);
+        break;
+    case 'X':
+        remoteBinaryWrite(p);
+        break;
+    case 'H':
+        remotePutPacket("OK");
+        break;
+    case 'q':
+        remoteQuery(p);
+        break;
+    case 'Q':
+        if (!strcmp(p, "StartNoAckMode")) {
+            // The reply is still acknowledged.
+            remotePutPacket("OK");
+            remoteNoAck = true;
+        } else {
+            remotePutPacket("");
+        }
+        break;
+    case 'Z':
+        type = *p++;
+        if (type == '0') {
+            remoteSetBreakPoint(p);
+        } else if (type == '1') {
+            remoteSetBreakPoint(p);
+        } else if (type == '2') {
+            remoteWriteWatch(p, true);
+        } else if (type == '3') {
+            remoteSetMemoryReadBreakPoint(p);
+        } else if (type == '4') {
+            remoteSetMemoryAccessBreakPoint(p);
+        } else {
+            remotePutPacket("");
+        }
+        break;
+    case 'z':
+        type = *p++;
+        if (type == '0') {
+            remoteClearBreakPoint(p);
+        } else if (type == '1') {
+            remoteClearBreakPoint(p);
+        } else if (type == '2') {
+            remoteWriteWatch(p, false);
+        } else if (type == '3') {
+            remoteClearMemoryReadBreakPoint(p);
+        } else if (type == '4') {
+            remoteClearMemoryAccessBreakPoint(p);
+        } else {
+            remotePutPacket("");
+        }
+        break;
+    default: {
+        fprintf(stderr, "Unknown packet %s\n", packet);
+        remotePutPacket("");
+    } break;
+    }
+    return true;
+}
+
 void remoteStubMain()
 {
     if (!debugger)
@@ -4095,161 +4386,48 @@ void remoteStubMain()
         remoteResumed = false;
     }
 
-    const char* hex = "0123456789abcdef";
+    std::string packet;
     while (1) {
-        char ack;
-        char buffer[1024];
-        int res = remoteRecvFnc(buffer, 1024);
+        // Handle everything already received before reading more, so that
+        // a batch of packets costs a single read.
+        if (remoteNextPacket(packet)) {
+            if (!remoteHandlePacket(&packet[0]))
+                return;
+            continue;
+        }
 
+        char buffer[1024];
+        int res = remoteRecvFnc(buffer, sizeof(buffer));
         if (res == -1) {
             fprintf(stderr, "GDB connection lost\n");
             debugger = false;
-            break;
+            return;
         } else if (res == -2)
-            break;
-        if (res < 1024) {
-            buffer[res] = 0;
-        } else {
-            fprintf(stderr, "res=%d\n", res);
-        }
+            return;
+        remoteInput.append(buffer, res);
+    }
+}
 
-        //    fprintf(stderr, "res=%d Received %s\n",res, buffer);
-        char c = buffer[0];
-        char* p = &buffer[0];
-        int i = 0;
-        unsigned char csum = 0;
-        while (i < res) {
-            if (buffer[i] == '$') {
-                i++;
-                csum = 0;
-                c = buffer[i];
-                p = &buffer[i + 1];
-                while ((i < res) && (buffer[i] != '#')) {
-                    csum += buffer[i];
-                    i++;
-                }
-            } else if (buffer[i] == '#') {
-                buffer[i] = 0;
-                if ((i + 2) < res) {
-                    if ((buffer[i + 1] == hex[csum >> 4]) && (buffer[i + 2] == hex[csum & 0xf])) {
-                        ack = '+';
-                        remoteSendFnc(&ack, 1);
-                        //fprintf(stderr, "SentACK c=%c\n",c);
-                        //process message...
-                        char type;
-                        switch (c) {
-                        case '?':
-                            remoteSendSignal();
-                            break;
-                        case 'D':
-                            remotePutPacket("OK");
-                            remoteResumed = true;
-                            debugger = false;
-                            return;
-                        case 'e':
-                            remoteStepOverRange(p);
-                            break;
-                        case 'k':
-                            remotePutPacket("OK");
-                            debugger = false;
-                            emulating = false;
-                            return;
-                        case 'C':
-                            remoteResumed = true;
-                            debugger = false;
-                            return;
-                        case 'c':
-                            remoteResumed = true;
-                            debugger = false;
-                            return;
-                        case 's':
-                            remoteResumed = true;
-                            remoteSignal = 5;
-                            CPULoop(1);
-                            if (remoteResumed) {
-                                remoteResumed = false;
-                                remoteSendStatus();
-                            }
-                            break;
-                        case 'g':
-                            remoteReadRegisters(p);
-                            break;
-                        case 'p':
-                            remoteReadRegister(p);
-                            break;
-                        case 'P':
-                            remoteWriteRegister(p);
-                            break;
-                        case 'M':
-                            remoteMemoryWrite(p);
-                            break;
-                        case 'm':
-                            remoteMemoryRead(p);
-                            break;
-                        case 'X':
-                            remoteBinaryWrite(p);
-                            break;
-                        case 'H':
-                            remotePutPacket("OK");
-                            break;
-                        case 'q':
-                            remoteQuery(p);
-                            break;
-                        case 'Z':
-                            type = *p++;
-                            if (type == '0') {
-                                remoteSetBreakPoint(p);
-                            } else if (type == '1') {
-                                remoteSetBreakPoint(p);
-                            } else if (type == '2') {
-                                remoteWriteWatch(p, true);
-                            } else if (type == '3') {
-                                remoteSetMemoryReadBreakPoint(p);
-                            } else if (type == '4') {
-                                remoteSetMemoryAccessBreakPoint(p);
-                            } else {
-                                remotePutPacket("");
-                            }
-                            break;
-                        case 'z':
-                            type = *p++;
-                            if (type == '0') {
-                                remoteClearBreakPoint(p);
-                            } else if (type == '1') {
-                                remoteClearBreakPoint(p);
-                            } else if (type == '2') {
-                                remoteWriteWatch(p, false);
-                            } else if (type == '3') {
-                                remoteClearMemoryReadBreakPoint(p);
-                            } else if (type == '4') {
-                                remoteClearMemoryAccessBreakPoint(p);
-                            } else {
-                                remotePutPacket("");
-                            }
-                            break;
-                        default: {
-                            fprintf(stderr, "Unknown packet %s\n", --p);
-                            remotePutPacket("");
-                        } break;
-                        }
-                    } else {
-                        fprintf(stderr, "bad chksum csum=%x msg=%c%c\n", csum, buffer[i + 1], buffer[i + 2]);
-                        ack = '-';
-                        remoteSendFnc(&ack, 1);
-                        fprintf(stderr, "SentNACK\n");
-                    } //if
-                    i += 3;
-                } else {
-                    fprintf(stderr, "didn't receive chksum i=%d res=%d\n", i, res);
-                    i++;
-                } //if
-            } else {
-                if (buffer[i] != '+') { //ingnore ACKs
-                    fprintf(stderr, "not sure what to do with:%c i=%d res=%d\n", buffer[i], i, res);
-                }
-                i++;
-            } //if
-        } //while
+void remotePoll()
+{
+    if (debugger || !remotePendingFnc || !remotePendingFnc())
+        return;
+
+    remoteReadInterrupt();
+}
+
+void remoteReadInterrupt()
+{
+    char buffer[256];
+    int res = remoteRecvFnc(buffer, sizeof(buffer));
+    if (res <= 0)
+        return;
+    remoteInput.append(buffer, res);
+
+    const size_t interrupt = remoteInput.find('\x03');
+    if (interrupt != std::string::npos) {
+        remoteInput.erase(interrupt, 1);
+        remoteStubSignal(2, 0);
     }
 }
 
@@ -4266,6 +4444,8 @@ void remoteCleanUp()
 {
     if (remoteCleanUpFnc)
         remoteCleanUpFnc();
+    remoteInput.clear();
+    remoteNoAck = false;
 }
 
 std::string HexToString(char* p)
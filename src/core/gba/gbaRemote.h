@@ -74,6 +74,13 @@ void printBreakRegList(bool verbose);
 
 void remoteStubMain();
 void remoteStubSignal(int sig, int number);
+// Checks, without blocking, whether the client asked to interrupt the game.
+// Called by the CPU once per frame while the game runs.
+void remotePoll();
+// Reads the input that is pending and breaks if the client asked to interrupt
+// the game. For frontends that check for input themselves, on the thread that
+// owns the connection, rather than through remotePoll().
+void remoteReadInterrupt();
 void remoteOutput(const char* s, uint32_t addr);
 void remoteSetProtocol(int p);
 void remoteSetPort(int port);
@@ -0,0 +1,277 @@
+#include "core/gba/gbaRenderer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/base/system.h"
+#include "core/gba/gba.h"
+#include "core/gba/gbaGlobals.h"
+
+// Defined by the frontends.
+struct CoreOptions coreOptions;
+
+extern int cpuTotalTicks;
+extern int lcdTicks;
+
+namespace {
+
+constexpr size_t kPixSize = 4 * 241 * 162;
+
+// Draws frames with raster effects, i.e. writes to the display registers,
+// PRAM, OAM and VRAM between lines, as an HBlank handler or DMA would.
+class GBARendererTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        g_ioMem = (uint8_t*)calloc(1, 0x400);
+        g_paletteRAM = (uint8_t*)calloc(1, 0x400);
+        g_oam = (uint8_t*)calloc(1, 0x400);
+        g_vram = (uint8_t*)calloc(1, SIZE_VRAM);
+        g_pix = (uint8_t*)calloc(1, kPixSize);
+
+        systemColorDepth = 32;
+        for (int i = 0; i < 0x10000; i++)
+            systemColorMap32[i] = i;
+        // HBlank, where writes do not split lines
+        DISPSTAT = 2;
+    }
+
+    void TearDown() override
+    {
+        coreOptions.threadedRendering = false;
+        coreOptions.accurateRendering = false;
+        gbaSelectRenderer();
+
+        free(g_ioMem);
+        free(g_paletteRAM);
+        free(g_oam);
+        free(g_vram);
+        free(g_pix);
+        g_ioMem = g_paletteRAM = g_oam = g_vram = g_pix = nullptr;
+    }
+
+    // Returns the frames drawn by the renderer `threaded` selects, from the
+    // same emulator state and writes.
+    std::vector<uint8_t> DrawFrames(bool threaded)
+    {
+        coreOptions.threadedRendering = threaded;
+        seed_ = 1;
+        for (int i = 0; i < 0x400; i++) {
+            g_paletteRAM[i] = (uint8_t)Next();
+            g_oam[i] = (uint8_t)Next();
+        }
+        for (size_t i = 0; i < SIZE_VRAM; i++)
+            g_vram[i] = (uint8_t)Next();
+        memset(g_pix, 0, kPixSize);
+
+        CPUUpdateRegister(0x08, 0x0000); // BG0CNT
+        CPUUpdateRegister(0x0A, 0x0581); // BG1CNT, 256 colors
+        CPUUpdateRegister(0x0C, 0x4A02); // BG2CNT
+        CPUUpdateRegister(0x40, 0x1080); // WIN0H
+        CPUUpdateRegister(0x44, 0x2070); // WIN0V
+        CPUUpdateRegister(0x48, 0x1F15); // WININ
+        CPUUpdateRegister(0x4A, 0x003B); // WINOUT
+        CPUUpdateRegister(0x50, 0x0741); // BLDMOD
+        CPUUpdateRegister(0x52, 0x0808); // COLEV
+        CPUUpdateRegister(0x20, 0x0100); // BG2PA
+        CPUUpdateRegister(0x26, 0x0100); // BG2PD
+
+        std::vector<uint8_t> frames;
+        for (int frame = 0; frame < 3; frame++) {
+            gbaSelectRenderer();
+            // mode 0, then mode 1 and the window, then mode 3
+            static const uint16_t kDispcnt[] = { 0x1B00, 0x3741, 0x1403 };
+            CPUUpdateRegister(0x00, kDispcnt[frame]);
+
+            for (int y = 0; y < 160; y++) {
+                VCOUNT = (uint16_t)y;
+                WriteLine(y);
+                gbaRenderer->EndLine();
+            }
+            gbaRenderer->EndFrame();
+            frames.insert(frames.end(), g_pix, g_pix + kPixSize);
+        }
+        return frames;
+    }
+
+    // Returns a frame of BG2 rotated and scaled, drawn by the scanline
+    // renderer, or by the split line renderer with lines split at `splits`
+    // by writes that change nothing.
+    std::vector<uint8_t> DrawAffineFrame(bool split, std::initializer_list<int> splits)
+    {
+        coreOptions.accurateRendering = split;
+        gbaSelectRenderer();
+        seed_ = 1;
+        for (int i = 0; i < 0x400; i++)
+            g_paletteRAM[i] = (uint8_t)Next();
+        for (size_t i = 0; i < SIZE_VRAM; i++)
+            g_vram[i] = (uint8_t)Next();
+        memset(g_pix, 0, kPixSize);
+
+        // mode 1, BG2, written twice for BG2 to show right away
+        CPUUpdateRegister(0x00, 0x0401);
+        CPUUpdateRegister(0x00, 0x0401);
+        CPUUpdateRegister(0x0C, 0x4A02); // BG2CNT
+        CPUUpdateRegister(0x20, 0x00F0); // BG2PA
+        CPUUpdateRegister(0x22, 0x0040); // BG2PB
+        CPUUpdateRegister(0x24, 0xFFE0); // BG2PC
+        CPUUpdateRegister(0x26, 0x0110); // BG2PD
+        CPUUpdateRegister(0x28, 0x0300); // BG2X_L
+        CPUUpdateRegister(0x2C, 0x0200); // BG2Y_L
+
+        for (int y = 0; y < 160; y++) {
+            VCOUNT = (uint16_t)y;
+            for (int x : splits)
+                WriteRegisterAt(x, 0x52, COLEV); // COLEV
+            gbaRenderer->EndLine();
+        }
+        gbaRenderer->EndFrame();
+        return std::vector<uint8_t>(g_pix, g_pix + kPixSize);
+    }
+
+    // Writes `value` to the display register at `address` `x` pixels into
+    // line VCOUNT, as the CPU would 4 * `x` cycles into the line.
+    void WriteRegisterAt(int x, uint32_t address, uint16_t value)
+    {
+        HDraw(x);
+        CPUUpdateRegister(address, value);
+        DISPSTAT = 2;
+    }
+
+    // Writes `color` to palette entry `index` `x` pixels into line VCOUNT.
+    void WritePaletteAt(int x, int index, uint16_t color)
+    {
+        HDraw(x);
+        gbaRendererWrite();
+        WritePalette(index, color);
+        DISPSTAT = 2;
+    }
+
+    void WritePalette(int index, uint16_t color)
+    {
+        g_paletteRAM[index * 2] = (uint8_t)color;
+        g_paletteRAM[index * 2 + 1] = (uint8_t)(color >> 8);
+    }
+
+    uint32_t Pixel(int x, int y) const { return ((const uint32_t*)g_pix)[241 * (y + 1) + x]; }
+
+private:
+    // The line started 1008 cycles before lcdTicks runs out.
+    void HDraw(int x)
+    {
+        DISPSTAT = 0;
+        cpuTotalTicks = 0;
+        lcdTicks = 1008 - 4 * x;
+    }
+
+    void WriteLine(int y)
+    {
+        CPUUpdateRegister(0x10, (uint16_t)(y * 3)); // BG0HOFS
+        CPUUpdateRegister(0x16, (uint16_t)(Next() & 0x1FF)); // BG1VOFS
+        if (y % 8 == 0) {
+            CPUUpdateRegister(0x28, (uint16_t)(y << 4)); // BG2X_L
+            CPUUpdateRegister(0x42, (uint16_t)Next()); // WIN1H
+        }
+
+        const uint32_t color = (Next() & 0x1FF) * 2;
+        g_paletteRAM[color] = (uint8_t)Next();
+        g_oam[Next() & 0x3FF] = (uint8_t)Next();
+
+        // a few tiles, as an HBlank handler would
+        for (int i = 0; i < 4; i++) {
+            const uint32_t offset = (Next() * 2) % SIZE_VRAM;
+            WriteVram(offset, 2, (uint8_t)Next());
+        }
+        // more than a line carries, as a DMA would
+        if (y % 50 == 25)
+            WriteVram((Next() & 7) * 0x2000, 0x2000, (uint8_t)Next());
+
+        if (y == 100)
+            CPUUpdateRegister(0x00, DISPCNT & ~0x0200); // BG1 off
+    }
+
+    void WriteVram(uint32_t offset, uint32_t size, uint8_t value)
+    {
+        gbaRendererVramWrite(offset, size);
+        memset(&g_vram[offset], value, size);
+    }
+
+    uint32_t Next()
+    {
+        seed_ = seed_ * 1103515245 + 12345;
+        return seed_ >> 16;
+    }
+
+    uint32_t seed_ = 1;
+};
+
+TEST_F(GBARendererTest, ThreadedMatchesScanline)
+{
+    const std::vector<uint8_t> scanline = DrawFrames(false);
+    const std::vector<uint8_t> threaded = DrawFrames(true);
+    EXPECT_TRUE(scanline == threaded);
+}
+
+// The backdrop color changes 100 pixels into line 80.
+TEST_F(GBARendererTest, SplitsLineAtPaletteWrite)
+{
+    coreOptions.accurateRendering = true;
+    gbaSelectRenderer();
+    CPUUpdateRegister(0x00, 0x0000); // mode 0, no layers
+    WritePalette(0, 0x001F);
+
+    for (int y = 0; y < 160; y++) {
+        VCOUNT = (uint16_t)y;
+        if (y == 80)
+            WritePaletteAt(100, 0, 0x7C00);
+        gbaRenderer->EndLine();
+    }
+    gbaRenderer->EndFrame();
+
+    for (int x = 0; x < 240; x++) {
+        EXPECT_EQ(Pixel(x, 79), 0x001Fu) << x;
+        EXPECT_EQ(Pixel(x, 80), x < 100 ? 0x001Fu : 0x7C00u) << x;
+        EXPECT_EQ(Pixel(x, 81), 0x7C00u) << x;
+    }
+}
+
+// The backdrop fades to white from 60 pixels into line 20 on.
+TEST_F(GBARendererTest, SplitsLineAtRegisterWrite)
+{
+    coreOptions.accurateRendering = true;
+    gbaSelectRenderer();
+    CPUUpdateRegister(0x00, 0x0000); // mode 0, no layers
+    CPUUpdateRegister(0x50, 0x0000); // BLDMOD
+    CPUUpdateRegister(0x54, 0x0010); // COLY
+    WritePalette(0, 0x001F);
+
+    for (int y = 0; y < 160; y++) {
+        VCOUNT = (uint16_t)y;
+        if (y == 20)
+            WriteRegisterAt(60, 0x50, 0x00A0); // BLDMOD, brighten the backdrop
+        gbaRenderer->EndLine();
+    }
+    gbaRenderer->EndFrame();
+
+    for (int x = 0; x < 240; x++) {
+        EXPECT_EQ(Pixel(x, 19), 0x001Fu) << x;
+        EXPECT_EQ(Pixel(x, 20), x < 60 ? 0x001Fu : 0x7FFFu) << x;
+        EXPECT_EQ(Pixel(x, 21), 0x7FFFu) << x;
+    }
+}
+
+// Drawing part of a line does not move the affine reference points on, so
+// split lines draw as whole ones.
+TEST_F(GBARendererTest, SplitLinesKeepAffineReference)
+{
+    const std::vector<uint8_t> scanline = DrawAffineFrame(false, {});
+    const std::vector<uint8_t> split = DrawAffineFrame(true, {40, 120, 200});
+    EXPECT_TRUE(scanline == split);
+}
+
+}  // namespace
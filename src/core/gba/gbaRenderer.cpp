@@ -0,0 +1,342 @@
+#include "core/gba/gbaRenderer.h"
+
+#include <cstring>
+
+#if !defined(__LIBRETRO__)
+#include <memory>
+#endif
+
+#include "core/base/system.h"
+#include "core/gba/gbaGfx.h"
+#include "core/gba/gbaGlobals.h"
+
+#if !defined(__LIBRETRO__)
+#include "core/base/line_queue.h"
+#endif
+
+extern void (*renderLine)();
+
+namespace {
+
+// Takes the state line VCOUNT ends with, along with the reference point
+// writes since the line before.
+void TakeLine(GfxLineState& state)
+{
+    gfxSaveLine(state);
+    gfxBG2Written = 0;
+    gfxBG3Written = 0;
+}
+
+// Draws line `y` into g_lineMix with `render`, from `state`.
+void DrawLine(int y, const GfxLineState& state, void (*render)())
+{
+    gfxVCOUNT = (uint16_t)y;
+    gfxLine = state;
+    gfxBG2Changed |= state.bg2Written;
+    gfxBG3Changed |= state.bg3Written;
+    gfxPrepareLine();
+    (*render)();
+}
+
+// Draws each line in one go at HBlank, with the state it ends with.
+class ScanlineRenderer : public GBARenderer {
+public:
+    void EndLine() override
+    {
+        GfxLineState state;
+        TakeLine(state);
+        DrawLine(VCOUNT, state, renderLine);
+        gbaWriteLine(g_lineMix, VCOUNT);
+    }
+};
+
+// Draws the part of the line that is already out whenever the display state
+// is about to change, so that raster effects that write the registers, the
+// palette or OAM mid-line show where they happen. VRAM writes do not split
+// the line.
+class SplitLineRenderer : public GBARenderer {
+public:
+    void BeforeWrite(int x) override
+    {
+        // A line left behind by a skipped frame or a state load.
+        if (line_ != VCOUNT) {
+            line_ = VCOUNT;
+            done_ = 0;
+        }
+        if (x > 240)
+            x = 240;
+        if (x <= done_)
+            return;
+
+        // Drawing a line moves the affine reference points on to the next,
+        // which only the line as a whole may do.
+        const int bg2x = gfxBG2X;
+        const int bg2y = gfxBG2Y;
+        const int bg3x = gfxBG3X;
+        const int bg3y = gfxBG3Y;
+        const int bg2Changed = gfxBG2Changed;
+        const int bg3Changed = gfxBG3Changed;
+        const int lastVCOUNT = gfxLastVCOUNT;
+
+        GfxLineState state;
+        gfxSaveLine(state);
+        DrawLine(VCOUNT, state, renderLine);
+
+        gfxBG2X = bg2x;
+        gfxBG2Y = bg2y;
+        gfxBG3X = bg3x;
+        gfxBG3Y = bg3y;
+        gfxBG2Changed = bg2Changed;
+        gfxBG3Changed = bg3Changed;
+        gfxLastVCOUNT = lastVCOUNT;
+
+        memcpy(&pixels_[done_], &g_lineMix[done_], (x - done_) * sizeof(uint32_t));
+        done_ = x;
+    }
+
+    void EndLine() override
+    {
+        GfxLineState state;
+        TakeLine(state);
+        DrawLine(VCOUNT, state, renderLine);
+        if (line_ == VCOUNT)
+            memcpy(g_lineMix, pixels_, done_ * sizeof(uint32_t));
+        gbaWriteLine(g_lineMix, VCOUNT);
+        Reset();
+    }
+
+    void Reset() override
+    {
+        line_ = -1;
+        done_ = 0;
+    }
+
+private:
+    uint32_t pixels_[240];
+    // The line pixels_ holds the first done_ pixels of.
+    int line_ = -1;
+    int done_ = 0;
+};
+
+#if !defined(__LIBRETRO__)
+// Draws the lines on a thread of its own while the CPU emulates on. Each line
+// is queued with a copy of the display registers, the palette and OAM it ends
+// with, so that the CPU may change them while the line waits to be drawn.
+//
+// The worker draws from a VRAM of its own. The 32-byte tiles the CPU writes
+// are queued with the next line and copied to it before that line is drawn.
+// When more tiles changed than a line holds, e.g. after a DMA to VRAM, or
+// when VRAM may have changed outside of the CPU loop, the CPU waits for the
+// queued lines instead and copies the whole of VRAM.
+class ThreadedRenderer : public GBARenderer {
+public:
+    void BeforeVramWrite(uint32_t offset, uint32_t size) override { tiles_.Write(offset, size); }
+
+    void EndLine() override
+    {
+        Line& line = queue_.Push();
+        line.y = VCOUNT;
+        line.render = renderLine;
+
+        GfxLineState& state = line.state;
+        TakeLine(state);
+        state.paletteRAM = Copy(line.paletteRAM, g_paletteRAM);
+        state.oam = Copy(line.oam, g_oam);
+        if (!vram_)
+            vram_.reset(new uint8_t[SIZE_VRAM]);
+        state.vram = vram_.get();
+
+        if (!tiles_.Take(g_vram, line.tiles)) {
+            // the worker does not read its VRAM while it waits
+            queue_.Wait();
+            memcpy(vram_.get(), g_vram, SIZE_VRAM);
+        }
+
+        queue_.Publish();
+    }
+
+    void EndFrame() override { queue_.Wait(); }
+
+    void Flush() override
+    {
+        queue_.Wait();
+        tiles_.WriteAll();
+    }
+
+    void Reset() override { Flush(); }
+
+private:
+    // Tiles a line carries. Raster effects that stream a few tiles per
+    // line fit.
+    typedef DirtyTiles<32, SIZE_VRAM / 32, 64> Tiles;
+
+    struct Line {
+        GfxLineState state;
+        int y;
+        void (*render)();
+        Tiles::Copies tiles;
+        uint8_t paletteRAM[0x400];
+        uint8_t oam[0x400];
+    };
+
+    template <typename T, size_t N>
+    static const T* Copy(T (&to)[N], const T* from)
+    {
+        memcpy(to, from, sizeof(to));
+        return to;
+    }
+
+    void Draw(const Line& line)
+    {
+        line.tiles.Apply(vram_.get());
+        DrawLine(line.y, line.state, line.render);
+        gbaWriteLine(g_lineMix, line.y);
+    }
+
+    // The VRAM the worker draws from.
+    std::unique_ptr<uint8_t[]> vram_;
+    Tiles tiles_;
+    // More than a frame, as the CPU waits for the frame at its end anyway.
+    LineQueue<Line, 256> queue_{[this](const Line& line) { Draw(line); }};
+};
+#endif
+
+ScanlineRenderer scanlineRenderer;
+SplitLineRenderer splitLineRenderer;
+#if !defined(__LIBRETRO__)
+ThreadedRenderer threadedRenderer;
+#endif
+
+}  // namespace
+
+GBARenderer* gbaRenderer = &scanlineRenderer;
+bool gbaRendererWantsWrites = false;
+bool gbaRendererWantsVramWrites = false;
+
+void gbaSelectRenderer()
+{
+    // Mid-line changes need the line drawn right away.
+    GBARenderer* renderer = &scanlineRenderer;
+    if (coreOptions.accurateRendering)
+        renderer = &splitLineRenderer;
+#if !defined(__LIBRETRO__)
+    else if (coreOptions.threadedRendering)
+        renderer = &threadedRenderer;
+#endif
+
+    if (renderer != gbaRenderer) {
+        gbaRenderer->Flush();
+        gbaRenderer = renderer;
+        gbaRenderer->Reset();
+    }
+    gbaRendererWantsWrites = renderer == &splitLineRenderer;
+#if !defined(__LIBRETRO__)
+    gbaRendererWantsVramWrites = renderer == &threadedRenderer;
+#endif
+}
+
+void gbaWriteLine(const uint32_t* line, int y)
+{
+    switch (systemColorDepth) {
+    case 16: {
+#ifdef __LIBRETRO__
+        uint16_t* dest = (uint16_t*)g_pix + 240 * y;
+#else
+        uint16_t* dest = (uint16_t*)g_pix + 242 * (y + 1);
+#endif
+        for (int x = 0; x < 240;) {
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap16[line[x++] & 0xFFFF];
+        }
+// for filters that read past the screen
+#ifndef __LIBRETRO__
+        *dest++ = 0;
+#endif
+    } break;
+    case 24: {
+        uint8_t* dest = (uint8_t*)g_pix + 240 * y * 3;
+        for (int x = 0; x < 240;) {
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+            *((uint32_t*)dest) = systemColorMap32[line[x++] & 0xFFFF];
+            dest += 3;
+        }
+    } break;
+    case 32: {
+#ifdef __LIBRETRO__
+        uint32_t* dest = (uint32_t*)g_pix + 240 * y;
+#else
+        uint32_t* dest = (uint32_t*)g_pix + 241 * (y + 1);
+#endif
+        for (int x = 0; x < 240;) {
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+            *dest++ = systemColorMap32[line[x++] & 0xFFFF];
+        }
+    } break;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef VBAM_CORE_GBA_GBARENDERER_H_
+#define VBAM_CORE_GBA_GBARENDERER_H_
+
+#include <cstdint>
+
+// Draws the GBA screen into g_pix. The CPU loop calls the renderer at the end
+// of each visible line, when it enters HBlank, and at the end of each frame,
+// before the frame is shown. Lines of skipped frames are not drawn.
+class GBARenderer {
+public:
+    virtual ~GBARenderer() = default;
+
+    // The display registers, the palette or OAM are about to change. `x` is
+    // the pixel of line VCOUNT being drawn, or 0 outside of HDraw. Only
+    // called while gbaRendererWantsWrites is set.
+    virtual void BeforeWrite(int /*x*/) {}
+    // `size` bytes of VRAM from `offset` on are about to change. Only called
+    // while gbaRendererWantsVramWrites is set.
+    virtual void BeforeVramWrite(uint32_t /*offset*/, uint32_t /*size*/) {}
+    // Line VCOUNT has been drawn up to its last pixel.
+    virtual void EndLine() = 0;
+    // The last line of the frame has been drawn. g_pix must hold the whole
+    // frame on return.
+    virtual void EndFrame() {}
+    // Returns once the renderer no longer reads the emulator state, which
+    // may then change outside of the CPU loop.
+    virtual void Flush() {}
+    // Drops a partly drawn line, e.g. after a reset.
+    virtual void Reset() {}
+};
+
+// The renderer in use, chosen by gbaSelectRenderer().
+extern GBARenderer* gbaRenderer;
+// Checked before calling gbaRendererWriteSlow() and
+// GBARenderer::BeforeVramWrite().
+extern bool gbaRendererWantsWrites;
+extern bool gbaRendererWantsVramWrites;
+
+// Chooses the renderer from coreOptions. Called on reset and at the start of
+// each frame, with no line left to draw.
+void gbaSelectRenderer();
+
+// Converts `line`, 240 pixels as renderLine leaves them in g_lineMix, to line
+// `y` of g_pix in the system color depth.
+void gbaWriteLine(const uint32_t* line, int y);
+
+// Hooks for the CPU, on writes that may change what the rest of the line
+// looks like.
+void gbaRendererWriteSlow();
+
+inline void gbaRendererWrite()
+{
+    if (gbaRendererWantsWrites)
+        gbaRendererWriteSlow();
+}
+
+// `offset` is in VRAM, with the mirrors folded.
+inline void gbaRendererVramWrite(uint32_t offset, uint32_t size)
+{
+    if (gbaRendererWantsVramWrites)
+        gbaRenderer->BeforeVramWrite(offset, size);
+}
+
+#endif  // VBAM_CORE_GBA_GBARENDERER_H_
@@ -0,0 +1,511 @@
+#include "core/gba/gbaTrace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <zlib.h>
+
+#include "core/gba/gba.h"
+#include "core/gba/gbaGlobals.h"
+
+// The file is gzipped. It starts with "VBAT", a version byte and the initial
+// registers as varints, followed by one record per instruction:
+//   tag        bit 0: Thumb
+//              bit 1: the address is not the one after the last instruction
+//              bit 2: the opcode differs from the last one at the address
+//              bit 3: registers changed
+//              bit 4: memory was written
+//              bit 5: more memory was written than is recorded
+//              0x80 alone marks the end of a frame
+//   address    zigzag varint, from the address after the last instruction
+//   opcode     varint
+//   registers  varint mask, then a zigzag varint delta per register
+//   writes     varint count, then per write its size, the zigzag varint
+//              delta from the last written address and the value
+//   skipped    varint count and varint hash of the writes not recorded
+
+bool traceEnabled = false;
+
+namespace {
+
+constexpr uint8_t kVersion = 1;
+
+constexpr uint8_t kTagThumb = 0x01;
+constexpr uint8_t kTagAddress = 0x02;
+constexpr uint8_t kTagOpcode = 0x04;
+constexpr uint8_t kTagRegisters = 0x08;
+constexpr uint8_t kTagWrites = 0x10;
+constexpr uint8_t kTagSkipped = 0x20;
+constexpr uint8_t kTagFrame = 0x80;
+
+constexpr int kCacheSize = 65536;
+
+// Raw records in the ring: the address with the Thumb bit, the opcode, then
+// a header word with the changed registers, the write count and the frame
+// and skipped flags, then the changed registers, 3 words per write and, if
+// writes were skipped, their count and hash.
+constexpr uint32_t kRawFrame = 0x80000000;
+constexpr uint32_t kRawSkipped = 0x40000000;
+constexpr int kRawCountShift = 20;
+constexpr uint32_t kRawCountMask = 0x3F;
+constexpr int kMaxRawRecord = 3 + TRACE_REGISTERS + 3 * TRACE_MAX_WRITES + 2;
+
+// 16 MB of raw records.
+constexpr uint64_t kRingSize = 1 << 22;
+constexpr uint64_t kRingMask = kRingSize - 1;
+// Encoded bytes gathered before they are compressed.
+constexpr size_t kFlushSize = 1 << 18;
+
+uint32_t* traceRing = nullptr;
+// Words pushed by the CPU and words taken by the writer, never wrapped.
+std::atomic<uint64_t> traceHead{ 0 };
+std::atomic<uint64_t> traceTail{ 0 };
+std::atomic<bool> traceStopping{ false };
+std::thread traceThread;
+bool traceFailed = false;
+gzFile traceFile = nullptr;
+
+// The CPU side: the registers as of the last record and the writes of the
+// current instruction.
+uint32_t traceRegs[TRACE_REGISTERS];
+uint32_t traceWrites[TRACE_MAX_WRITES * 3];
+int traceWriteCount = 0;
+uint32_t traceSkippedCount = 0;
+uint32_t traceSkippedHash = 0;
+
+uint32_t traceCpsr()
+{
+    uint32_t cpsr = reg[16].I & 0x40;
+    if (N_FLAG)
+        cpsr |= 0x80000000;
+    if (Z_FLAG)
+        cpsr |= 0x40000000;
+    if (C_FLAG)
+        cpsr |= 0x20000000;
+    if (V_FLAG)
+        cpsr |= 0x10000000;
+    if (!armState)
+        cpsr |= 0x00000020;
+    if (!armIrqEnable)
+        cpsr |= 0x80;
+    return cpsr | (armMode & 0x1F);
+}
+
+void tracePush(const uint32_t* words, int count)
+{
+    const uint64_t head = traceHead.load(std::memory_order_relaxed);
+    // Waits for the writer rather than dropping instructions.
+    while (head + count - traceTail.load(std::memory_order_acquire) > kRingSize)
+        std::this_thread::yield();
+    for (int i = 0; i < count; i++)
+        traceRing[(head + i) & kRingMask] = words[i];
+    traceHead.store(head + count, std::memory_order_release);
+}
+
+uint32_t zigzag(uint32_t delta)
+{
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+uint32_t unzigzag(uint32_t v)
+{
+    return (v >> 1) ^ (0 - (v & 1));
+}
+
+uint32_t cacheIndex(uint32_t address)
+{
+    return (address >> 1) & (kCacheSize - 1);
+}
+
+class TraceEncoder {
+public:
+    TraceEncoder() : cacheAddress_(kCacheSize, 1), cacheOpcode_(kCacheSize) {}
+
+    void Header(const uint32_t* regs)
+    {
+        out_.insert(out_.end(), { 'V', 'B', 'A', 'T', kVersion });
+        for (int i = 0; i < TRACE_REGISTERS; i++) {
+            regs_[i] = regs[i];
+            Varint(regs[i]);
+        }
+    }
+
+    // Encodes the raw record at `pos` and returns its size in words.
+    int Record(uint64_t pos)
+    {
+        auto word = [pos](int i) { return traceRing[(pos + i) & kRingMask]; };
+
+        const uint32_t header = word(2);
+        if (header & kRawFrame) {
+            out_.push_back(kTagFrame);
+            return 3;
+        }
+
+        const bool thumb = word(0) & 1;
+        const uint32_t address = word(0) & ~1u;
+        const uint32_t opcode = word(1);
+        const uint32_t changed = header & ((1 << kRawCountShift) - 1);
+        const int writes = (header >> kRawCountShift) & kRawCountMask;
+
+        uint8_t tag = thumb ? kTagThumb : 0;
+        if (address != next_)
+            tag |= kTagAddress;
+        const uint32_t index = cacheIndex(address);
+        if (cacheAddress_[index] != address || cacheOpcode_[index] != opcode)
+            tag |= kTagOpcode;
+        if (changed)
+            tag |= kTagRegisters;
+        if (writes)
+            tag |= kTagWrites;
+        if (header & kRawSkipped)
+            tag |= kTagSkipped;
+        out_.push_back(tag);
+
+        if (tag & kTagAddress)
+            Varint(zigzag(address - next_));
+        next_ = address + (thumb ? 2 : 4);
+        if (tag & kTagOpcode) {
+            Varint(opcode);
+            cacheAddress_[index] = address;
+            cacheOpcode_[index] = opcode;
+        }
+
+        int n = 3;
+        if (changed) {
+            Varint(changed);
+            for (int r = 0; r < TRACE_REGISTERS; r++) {
+                if (changed & (1 << r)) {
+                    const uint32_t value = word(n++);
+                    Varint(zigzag(value - regs_[r]));
+                    regs_[r] = value;
+                }
+            }
+        }
+        if (writes) {
+            Varint(writes);
+            for (int i = 0; i < writes; i++, n += 3) {
+                Varint(word(n + 2));
+                Varint(zigzag(word(n) - lastWrite_));
+                Varint(word(n + 1));
+                lastWrite_ = word(n);
+            }
+        }
+        if (header & kRawSkipped) {
+            Varint(word(n));
+            Varint(word(n + 1));
+            n += 2;
+        }
+        return n;
+    }
+
+    bool Flush(gzFile f, bool force)
+    {
+        if (out_.empty() || (!force && out_.size() < kFlushSize))
+            return true;
+        const bool ok = gzwrite(f, out_.data(), (unsigned)out_.size()) == (int)out_.size();
+        out_.clear();
+        return ok;
+    }
+
+private:
+    void Varint(uint32_t v)
+    {
+        while (v >= 0x80) {
+            out_.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out_.push_back((uint8_t)v);
+    }
+
+    std::vector<uint8_t> out_;
+    uint32_t regs_[TRACE_REGISTERS];
+    uint32_t next_ = 0;
+    uint32_t lastWrite_ = 0;
+    std::vector<uint32_t> cacheAddress_;
+    std::vector<uint32_t> cacheOpcode_;
+};
+
+void traceWriterMain(TraceEncoder* encoder)
+{
+    uint64_t tail = traceTail.load(std::memory_order_relaxed);
+    bool ok = true;
+    for (;;) {
+        const uint64_t head = traceHead.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (traceStopping.load(std::memory_order_acquire)
+                && traceHead.load(std::memory_order_acquire) == tail)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        while (tail != head)
+            tail += encoder->Record(tail);
+        traceTail.store(tail, std::memory_order_release);
+        ok = encoder->Flush(traceFile, false) && ok;
+    }
+    ok = encoder->Flush(traceFile, true) && ok;
+    traceFailed = !ok;
+    delete encoder;
+}
+
+}  // namespace
+
+bool traceStart(const char* file)
+{
+    if (traceEnabled)
+        traceStop();
+
+    traceFile = gzopen(file, "wb1");
+    if (!traceFile)
+        return false;
+
+    if (!traceRing)
+        traceRing = new uint32_t[kRingSize];
+    traceHead.store(0);
+    traceTail.store(0);
+    traceStopping.store(false);
+    traceFailed = false;
+    traceWriteCount = 0;
+    traceSkippedCount = 0;
+
+    for (int i = 0; i < 16; i++)
+        traceRegs[i] = reg[i].I;
+    traceRegs[TRACE_CPSR] = traceCpsr();
+
+    TraceEncoder* encoder = new TraceEncoder();
+    encoder->Header(traceRegs);
+    traceThread = std::thread(traceWriterMain, encoder);
+    traceEnabled = true;
+    return true;
+}
+
+bool traceStop()
+{
+    if (!traceEnabled)
+        return true;
+    traceEnabled = false;
+    traceStopping.store(true, std::memory_order_release);
+    traceThread.join();
+    const bool ok = gzclose(traceFile) == Z_OK && !traceFailed;
+    traceFile = nullptr;
+    delete[] traceRing;
+    traceRing = nullptr;
+    return ok;
+}
+
+void traceInstruction(uint32_t address, uint32_t opcode, bool thumb)
+{
+    uint32_t record[kMaxRawRecord];
+    int n = 3;
+    uint32_t changed = 0;
+    for (int i = 0; i < 15; i++) {
+        if (reg[i].I != traceRegs[i]) {
+            traceRegs[i] = reg[i].I;
+            record[n++] = reg[i].I;
+            changed |= 1 << i;
+        }
+    }
+    const uint32_t cpsr = traceCpsr();
+    if (cpsr != traceRegs[TRACE_CPSR]) {
+        traceRegs[TRACE_CPSR] = cpsr;
+        record[n++] = cpsr;
+        changed |= 1 << TRACE_CPSR;
+    }
+    memcpy(record + n, traceWrites, traceWriteCount * 3 * sizeof(uint32_t));
+    n += traceWriteCount * 3;
+
+    record[0] = address | (thumb ? 1 : 0);
+    record[1] = opcode;
+    record[2] = changed | (traceWriteCount << kRawCountShift);
+    traceWriteCount = 0;
+    if (traceSkippedCount) {
+        record[2] |= kRawSkipped;
+        record[n++] = traceSkippedCount;
+        record[n++] = traceSkippedHash;
+        traceSkippedCount = 0;
+    }
+    tracePush(record, n);
+}
+
+void traceFrame()
+{
+    const uint32_t record[3] = { 0, 0, kRawFrame };
+    tracePush(record, 3);
+}
+
+void traceWriteSlow(uint32_t address, uint32_t value, int size)
+{
+    if (traceWriteCount == TRACE_MAX_WRITES) {
+        // FNV-1a over the words of the write, so that diffing still tells
+        // traces apart when only the skipped writes differ.
+        if (!traceSkippedCount)
+            traceSkippedHash = 2166136261u;
+        for (uint32_t word : { address, value, (uint32_t)size })
+            traceSkippedHash = (traceSkippedHash ^ word) * 16777619u;
+        traceSkippedCount++;
+        return;
+    }
+    uint32_t* w = traceWrites + traceWriteCount++ * 3;
+    w[0] = address;
+    w[1] = value;
+    w[2] = size;
+}
+
+TraceReader::TraceReader()
+    : buffer_(65536), cacheAddress_(kCacheSize, 1), cacheOpcode_(kCacheSize)
+{
+}
+
+TraceReader::~TraceReader()
+{
+    if (file_)
+        gzclose(file_);
+}
+
+bool TraceReader::Open(const char* file)
+{
+    file_ = gzopen(file, "rb");
+    if (!file_) {
+        error_ = "cannot open the file";
+        return false;
+    }
+    uint8_t magic[5] = {};
+    for (uint8_t& b : magic) {
+        if (!Byte(b))
+            break;
+    }
+    if (error_ || memcmp(magic, "VBAT", 4) || magic[4] != kVersion) {
+        error_ = "not a trace";
+        return false;
+    }
+    for (uint32_t& r : regs_) {
+        if (!Varint(r))
+            return false;
+    }
+    return true;
+}
+
+bool TraceReader::Fill()
+{
+    size_ = gzread(file_, buffer_.data(), (unsigned)buffer_.size());
+    pos_ = 0;
+    if (size_ < 0) {
+        size_ = 0;
+        error_ = "read error";
+    }
+    return size_ > 0;
+}
+
+bool TraceReader::Byte(uint8_t& b)
+{
+    if (pos_ == size_ && !Fill())
+        return false;
+    b = buffer_[pos_++];
+    return true;
+}
+
+bool TraceReader::Varint(uint32_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t b;
+        if (!Byte(b)) {
+            if (!error_)
+                error_ = "truncated trace";
+            return false;
+        }
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    error_ = "corrupt trace";
+    return false;
+}
+
+bool TraceReader::Next(TraceRecord& record)
+{
+    if (!file_ || error_)
+        return false;
+
+    uint8_t tag;
+    for (;;) {
+        if (!Byte(tag))
+            return false;
+        if (tag != kTagFrame)
+            break;
+        frame_++;
+    }
+    if (tag & 0xC0) {
+        error_ = "corrupt trace";
+        return false;
+    }
+
+    record.index = index_++;
+    record.frame = frame_;
+    record.thumb = tag & kTagThumb;
+
+    uint32_t v = 0;
+    record.address = next_;
+    if (tag & kTagAddress) {
+        if (!Varint(v))
+            return false;
+        record.address += unzigzag(v);
+    }
+    next_ = record.address + (record.thumb ? 2 : 4);
+
+    const uint32_t index = cacheIndex(record.address);
+    if (tag & kTagOpcode) {
+        if (!Varint(record.opcode))
+            return false;
+        cacheAddress_[index] = record.address;
+        cacheOpcode_[index] = record.opcode;
+    } else {
+        record.opcode = cacheOpcode_[index];
+    }
+
+    record.changed = 0;
+    if (tag & kTagRegisters) {
+        if (!Varint(record.changed))
+            return false;
+        for (int r = 0; r < TRACE_REGISTERS; r++) {
+            if (record.changed & (1 << r)) {
+                if (!Varint(v))
+                    return false;
+                regs_[r] += unzigzag(v);
+            }
+        }
+    }
+    memcpy(record.regs, regs_, sizeof(regs_));
+    record.regs[15] = record.address;
+
+    record.writeCount = 0;
+    if (tag & kTagWrites) {
+        uint32_t count;
+        if (!Varint(count))
+            return false;
+        if (count > TRACE_MAX_WRITES) {
+            error_ = "corrupt trace";
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            TraceWrite& w = record.writes[i];
+            uint32_t size, delta;
+            if (!Varint(size) || !Varint(delta) || !Varint(w.value))
+                return false;
+            w.size = (int)size;
+            w.address = lastWrite_ + unzigzag(delta);
+            lastWrite_ = w.address;
+        }
+        record.writeCount = (int)count;
+    }
+
+    record.skippedCount = 0;
+    record.skippedHash = 0;
+    if (tag & kTagSkipped) {
+        if (!Varint(record.skippedCount) || !Varint(record.skippedHash))
+            return false;
+    }
+    return true;
+}
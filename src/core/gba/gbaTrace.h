@@ -0,0 +1,112 @@
+#ifndef VBAM_CORE_GBA_GBATRACE_H_
+#define VBAM_CORE_GBA_GBATRACE_H_
+
+#if !defined(VBAM_ENABLE_TRACE)
+#error "gbaTrace.h requires VBAM_ENABLE_TRACE"
+#endif
+
+#include <cstdint>
+#include <vector>
+
+struct gzFile_s;
+
+// An execution trace of the GBA CPU, for builds configured with ENABLE_TRACE.
+// Every instruction is recorded with its address, its opcode, the registers
+// it changed and the memory it wrote. The CPU appends raw records to a
+// lock-free ring buffer, and a thread encodes them with delta and varint
+// coding into a gzipped file that TraceReader reads back.
+
+// Registers of a record: r0-r15, then the CPSR. The PC is not recorded as a
+// change, since the address of the next record implies it.
+#define TRACE_REGISTERS 17
+#define TRACE_CPSR 16
+// Memory writes recorded per instruction. STM writes at most 16, but an
+// immediate DMA started by a store or an HLE SWI such as CpuSet writes more:
+// the writes past this many are only counted and hashed.
+#define TRACE_MAX_WRITES 32
+
+struct TraceWrite {
+    uint32_t address;
+    uint32_t value;
+    // 1, 2 or 4 bytes.
+    int size;
+};
+
+struct TraceRecord {
+    // Position of the instruction in the trace and the frame it ran in.
+    uint64_t index;
+    uint32_t frame;
+    uint32_t address;
+    uint32_t opcode;
+    bool thumb;
+    // Bit n is set if register n changed.
+    uint32_t changed;
+    // The registers after the instruction, except r15 which holds `address`.
+    uint32_t regs[TRACE_REGISTERS];
+    int writeCount;
+    TraceWrite writes[TRACE_MAX_WRITES];
+    // The writes past TRACE_MAX_WRITES, and a hash of their addresses,
+    // values and sizes.
+    uint32_t skippedCount;
+    uint32_t skippedHash;
+};
+
+// Checked by the CPU before calling the hooks below.
+extern bool traceEnabled;
+
+// Starts recording to `file`, from the current state of the CPU.
+bool traceStart(const char* file);
+// Waits for the recorded instructions to be written and closes the file.
+// Returns false if writing failed.
+bool traceStop();
+
+// Hooks for the CPU.
+// An instruction at `address` has executed.
+void traceInstruction(uint32_t address, uint32_t opcode, bool thumb);
+// The frame ended.
+void traceFrame();
+void traceWriteSlow(uint32_t address, uint32_t value, int size);
+
+// A CPU write of `size` bytes.
+inline void traceWrite(uint32_t address, uint32_t value, int size)
+{
+    if (traceEnabled)
+        traceWriteSlow(address, value, size);
+}
+
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool Open(const char* file);
+    // Reads the next instruction. Returns false at the end of the trace or
+    // if it is corrupt, see error().
+    bool Next(TraceRecord& record);
+    const char* error() const { return error_; }
+
+private:
+    bool Fill();
+    bool Byte(uint8_t& b);
+    bool Varint(uint32_t& v);
+
+    gzFile_s* file_ = nullptr;
+    std::vector<uint8_t> buffer_;
+    int pos_ = 0;
+    int size_ = 0;
+    const char* error_ = nullptr;
+
+    uint64_t index_ = 0;
+    uint32_t frame_ = 0;
+    uint32_t next_ = 0;
+    uint32_t regs_[TRACE_REGISTERS] = {};
+    uint32_t lastWrite_ = 0;
+    // The last instruction seen at each address hash, as address and opcode.
+    std::vector<uint32_t> cacheAddress_;
+    std::vector<uint32_t> cacheOpcode_;
+};
+
+#endif  // VBAM_CORE_GBA_GBATRACE_H_
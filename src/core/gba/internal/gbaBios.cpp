@@ -8,6 +8,110 @@
 #include "core/gba/gbaGlobals.h"
 #include "core/gba/gbaInline.h"
 
+namespace {
+
+// The plain memory around the addresses that a BIOS routine reads or writes
+// in units of `size` bytes, so that most of its accesses can skip the full
+// memory handlers. Unaligned accesses and anything outside of plain memory
+// still go through CPURead*/CPUWrite*.
+class BiosWindow {
+public:
+    BiosWindow(int size, bool read)
+        : size_(size)
+        , read_(read)
+    {
+    }
+
+    // Returns the host memory for [address, address + bytes), or NULL if any
+    // of it needs the memory handlers.
+    uint8_t* Span(uint32_t address, uint32_t bytes)
+    {
+        if (address & (size_ - 1))
+            return NULL;
+        if (address < lo_ || address >= hi_ || bytes > hi_ - address) {
+            uint8_t* freeze;
+            uint8_t* host = CPUGetHostMemory(address, size_, read_, lo_, hi_, freeze);
+            host_ = host ? host - (address - lo_) : NULL;
+            freeze_ = freeze ? freeze - (address - lo_) : NULL;
+            if (!host || bytes > hi_ - address)
+                return NULL;
+        }
+        if (!host_)
+            return NULL;
+#ifdef VBAM_ENABLE_DEBUGGER
+        // Frozen addresses go through the cheat engine.
+        if (!read_ && freeze_) {
+            for (uint32_t i = 0; i < bytes; i++) {
+                if (freeze_[address - lo_ + i])
+                    return NULL;
+            }
+        }
+#endif
+        return host_ + (address - lo_);
+    }
+
+    uint8_t ReadByte(uint32_t address)
+    {
+        const uint8_t* p = Span(address, 1);
+        return p ? *p : CPUReadByte(address);
+    }
+
+    uint32_t ReadHalfWord(uint32_t address)
+    {
+        const uint8_t* p = Span(address, 2);
+        return p ? READ16LE((const uint16_t*)p) : CPUReadHalfWord(address);
+    }
+
+    uint32_t ReadMemory(uint32_t address)
+    {
+        const uint8_t* p = Span(address, 4);
+        return p ? READ32LE((const uint32_t*)p) : CPUReadMemory(address);
+    }
+
+    void WriteByte(uint32_t address, uint8_t value)
+    {
+        uint8_t* p = Span(address, 1);
+        if (p)
+            *p = value;
+        else
+            CPUWriteByte(address, value);
+    }
+
+    void WriteHalfWord(uint32_t address, uint16_t value)
+    {
+        uint8_t* p = Span(address, 2);
+        if (p)
+            WRITE16LE((uint16_t*)p, value);
+        else
+            CPUWriteHalfWord(address, value);
+    }
+
+    void WriteMemory(uint32_t address, uint32_t value)
+    {
+        uint8_t* p = Span(address, 4);
+        if (p)
+            WRITE32LE((uint32_t*)p, value);
+        else
+            CPUWriteMemory(address, value);
+    }
+
+private:
+    const int size_;
+    const bool read_;
+    uint32_t lo_ = 0;
+    uint32_t hi_ = 0;
+    uint8_t* host_ = NULL;
+    uint8_t* freeze_ = NULL;
+};
+
+// Whether the host ranges [a, a + bytes) and [b, b + bytes) are disjoint.
+bool BIOS_Disjoint(const uint8_t* a, const uint8_t* b, uint32_t bytes)
+{
+    return a + bytes <= b || b + bytes <= a;
+}
+
+} // namespace
+
 int16_t sineTable[256] = {
     (int16_t)0x0000u, (int16_t)0x0192u, (int16_t)0x0323u, (int16_t)0x04B5u, (int16_t)0x0645u, (int16_t)0x07D5u, (int16_t)0x0964u, (int16_t)0x0AF1u,
     (int16_t)0x0C7Cu, (int16_t)0x0E05u, (int16_t)0x0F8Cu, (int16_t)0x1111u, (int16_t)0x1294u, (int16_t)0x1413u, (int16_t)0x158Fu, (int16_t)0x1708u,
@@ -156,6 +260,8 @@ void BIOS_BitUnPack()
     base &= 0x7fffffff;
     int dataSize = CPUReadByte(header + 3);
 
+    BiosWindow src(1, true);
+    BiosWindow dst(4, false);
     int data = 0;
     int bitwritecount = 0;
     while (1) {
@@ -163,7 +269,7 @@ void BIOS_BitUnPack()
         if (len < 0)
             break;
         int mask = 0xff >> revbits;
-        uint8_t b = CPUReadByte(source);
+        uint8_t b = src.ReadByte(source);
         source++;
         int bitcount = 0;
         while (1) {
@@ -177,7 +283,7 @@ void BIOS_BitUnPack()
             data |= temp << bitwritecount;
             bitwritecount += dataSize;
             if (bitwritecount >= 32) {
-                CPUWriteMemory(dest, data);
+                dst.WriteMemory(dest, data);
                 dest += 4;
                 data = 0;
                 bitwritecount = 0;
@@ -274,36 +380,64 @@ void BIOS_CpuSet()
         // needed for 32-bit mode!
         source &= 0xFFFFFFFC;
         dest &= 0xFFFFFFFC;
+        BiosWindow src(4, true);
+        BiosWindow dst(4, false);
         // fill ?
         if ((cnt >> 24) & 1) {
-            uint32_t value = (source > 0x0EFFFFFF ? 0x1CAD1CAD : CPUReadMemory(source));
+            uint32_t value = (source > 0x0EFFFFFF ? 0x1CAD1CAD : src.ReadMemory(source));
+            uint8_t* to = dst.Span(dest, count * 4);
+            if (to) {
+                for (int i = 0; i < count; i++)
+                    WRITE32LE((uint32_t*)(to + i * 4), value);
+                return;
+            }
             while (count) {
-                CPUWriteMemory(dest, value);
+                dst.WriteMemory(dest, value);
                 dest += 4;
                 count--;
             }
         } else {
             // copy
+            const uint8_t* from = src.Span(source, count * 4);
+            uint8_t* to = dst.Span(dest, count * 4);
+            if (from && to && BIOS_Disjoint(from, to, count * 4)) {
+                memcpy(to, from, count * 4);
+                return;
+            }
             while (count) {
-                CPUWriteMemory(dest, (source > 0x0EFFFFFF ? 0x1CAD1CAD : CPUReadMemory(source)));
+                dst.WriteMemory(dest, (source > 0x0EFFFFFF ? 0x1CAD1CAD : src.ReadMemory(source)));
                 source += 4;
                 dest += 4;
                 count--;
             }
         }
     } else {
+        BiosWindow src(2, true);
+        BiosWindow dst(2, false);
         // 16-bit fill?
         if ((cnt >> 24) & 1) {
-            uint16_t value = (source > 0x0EFFFFFF ? 0x1CAD : DowncastU16(CPUReadHalfWord(source)));
+            uint16_t value = (source > 0x0EFFFFFF ? 0x1CAD : DowncastU16(src.ReadHalfWord(source)));
+            uint8_t* to = dst.Span(dest, count * 2);
+            if (to) {
+                for (int i = 0; i < count; i++)
+                    WRITE16LE((uint16_t*)(to + i * 2), value);
+                return;
+            }
             while (count) {
-                CPUWriteHalfWord(dest, value);
+                dst.WriteHalfWord(dest, value);
                 dest += 2;
                 count--;
             }
         } else {
             // copy
+            const uint8_t* from = src.Span(source, count * 2);
+            uint8_t* to = dst.Span(dest, count * 2);
+            if (from && to && BIOS_Disjoint(from, to, count * 2)) {
+                memcpy(to, from, count * 2);
+                return;
+            }
             while (count) {
-                CPUWriteHalfWord(dest, (source > 0x0EFFFFFF ? 0x1CAD : DowncastU16(CPUReadHalfWord(source))));
+                dst.WriteHalfWord(dest, (source > 0x0EFFFFFF ? 0x1CAD : DowncastU16(src.ReadHalfWord(source))));
                 source += 2;
                 dest += 2;
                 count--;
@@ -333,24 +467,42 @@ void BIOS_CpuFastSet()
     dest &= 0xFFFFFFFC;
 
     int count = cnt & 0x1FFFFF;
+    const uint32_t bytes = ((count + 7) & ~7) * 4;
+    BiosWindow src(4, true);
+    BiosWindow dst(4, false);
 
     // fill?
     if ((cnt >> 24) & 1) {
+        uint8_t* to = dst.Span(dest, bytes);
+        if (count > 0 && to) {
+            for (uint32_t i = 0; i < bytes; i += 32) {
+                uint32_t value = (source > 0x0EFFFFFF ? 0xBAFFFFFB : src.ReadMemory(source));
+                for (int j = 0; j < 8; j++)
+                    WRITE32LE((uint32_t*)(to + i + j * 4), value);
+            }
+            return;
+        }
         while (count > 0) {
             // BIOS always transfers 32 bytes at a time
-            uint32_t value = (source > 0x0EFFFFFF ? 0xBAFFFFFB : CPUReadMemory(source));
+            uint32_t value = (source > 0x0EFFFFFF ? 0xBAFFFFFB : src.ReadMemory(source));
             for (int i = 0; i < 8; i++) {
-                CPUWriteMemory(dest, value);
+                dst.WriteMemory(dest, value);
                 dest += 4;
             }
             count -= 8;
         }
     } else {
         // copy
+        const uint8_t* from = src.Span(source, bytes);
+        uint8_t* to = dst.Span(dest, bytes);
+        if (count > 0 && from && to && BIOS_Disjoint(from, to, bytes)) {
+            memcpy(to, from, bytes);
+            return;
+        }
         while (count > 0) {
             // BIOS always transfers 32 bytes at a time
             for (int i = 0; i < 8; i++) {
-                CPUWriteMemory(dest, (source > 0x0EFFFFFF ? 0xBAFFFFFB : CPUReadMemory(source)));
+                dst.WriteMemory(dest, (source > 0x0EFFFFFF ? 0xBAFFFFFB : src.ReadMemory(source)));
                 source += 4;
                 dest += 4;
             }
@@ -377,16 +529,18 @@ void BIOS_Diff8bitUnFilterWram()
     if (((source & 0xe000000) == 0) || (((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0))
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow out(1, false);
     int len = header >> 8;
 
-    uint8_t data = CPUReadByte(source++);
-    CPUWriteByte(dest++, data);
+    uint8_t data = in.ReadByte(source++);
+    out.WriteByte(dest++, data);
     len--;
 
     while (len > 0) {
-        uint8_t diff = CPUReadByte(source++);
+        uint8_t diff = in.ReadByte(source++);
         data += diff;
-        CPUWriteByte(dest++, data);
+        out.WriteByte(dest++, data);
         len--;
     }
 }
@@ -409,21 +563,23 @@ void BIOS_Diff8bitUnFilterVram()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow out(2, false);
     int len = header >> 8;
 
-    uint8_t data = CPUReadByte(source++);
+    uint8_t data = in.ReadByte(source++);
     uint16_t writeData = data;
     int shift = 8;
     int bytes = 1;
 
     while (len >= 2) {
-        uint8_t diff = CPUReadByte(source++);
+        uint8_t diff = in.ReadByte(source++);
         data += diff;
         writeData |= (data << shift);
         bytes++;
         shift += 8;
         if (bytes == 2) {
-            CPUWriteHalfWord(dest, writeData);
+            out.WriteHalfWord(dest, writeData);
             dest += 2;
             len -= 2;
             bytes = 0;
@@ -451,19 +607,21 @@ void BIOS_Diff16bitUnFilter()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(2, true);
+    BiosWindow out(2, false);
     int len = header >> 8;
 
-    uint16_t data = DowncastU16(CPUReadHalfWord(source));
+    uint16_t data = DowncastU16(in.ReadHalfWord(source));
     source += 2;
-    CPUWriteHalfWord(dest, data);
+    out.WriteHalfWord(dest, data);
     dest += 2;
     len -= 2;
 
     while (len >= 2) {
-        uint16_t diff = DowncastU16(CPUReadHalfWord(source));
+        uint16_t diff = DowncastU16(in.ReadHalfWord(source));
         source += 2;
         data += diff;
-        CPUWriteHalfWord(dest, data);
+        out.WriteHalfWord(dest, data);
         dest += 2;
         len -= 2;
     }
@@ -535,7 +693,10 @@ void BIOS_HuffUnComp()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
-    uint8_t treeSize = CPUReadByte(source++);
+    BiosWindow tree(1, true);
+    BiosWindow bits(4, true);
+    BiosWindow out(4, false);
+    uint8_t treeSize = tree.ReadByte(source++);
 
     uint32_t treeStart = source;
 
@@ -544,11 +705,11 @@ void BIOS_HuffUnComp()
     int len = header >> 8;
 
     uint32_t mask = 0x80000000;
-    uint32_t data = CPUReadMemory(source);
+    uint32_t data = bits.ReadMemory(source);
     source += 4;
 
     int pos = 0;
-    uint8_t rootNode = CPUReadByte(treeStart);
+    uint8_t rootNode = tree.ReadByte(treeStart);
     uint8_t currentNode = rootNode;
     bool writeData = false;
     int byteShift = 0;
@@ -567,12 +728,12 @@ void BIOS_HuffUnComp()
                 // right
                 if (currentNode & 0x40)
                     writeData = true;
-                currentNode = CPUReadByte(treeStart + pos + 1);
+                currentNode = tree.ReadByte(treeStart + pos + 1);
             } else {
                 // left
                 if (currentNode & 0x80)
                     writeData = true;
-                currentNode = CPUReadByte(treeStart + pos);
+                currentNode = tree.ReadByte(treeStart + pos);
             }
 
             if (writeData) {
@@ -587,7 +748,7 @@ void BIOS_HuffUnComp()
                 if (byteCount == 4) {
                     byteCount = 0;
                     byteShift = 0;
-                    CPUWriteMemory(dest, writeValue);
+                    out.WriteMemory(dest, writeValue);
                     writeValue = 0;
                     dest += 4;
                     len -= 4;
@@ -596,7 +757,7 @@ void BIOS_HuffUnComp()
             mask >>= 1;
             if (mask == 0) {
                 mask = 0x80000000;
-                data = CPUReadMemory(source);
+                data = bits.ReadMemory(source);
                 source += 4;
             }
         }
@@ -614,12 +775,12 @@ void BIOS_HuffUnComp()
                 // right
                 if (currentNode & 0x40)
                     writeData = true;
-                currentNode = CPUReadByte(treeStart + pos + 1);
+                currentNode = tree.ReadByte(treeStart + pos + 1);
             } else {
                 // left
                 if (currentNode & 0x80)
                     writeData = true;
-                currentNode = CPUReadByte(treeStart + pos);
+                currentNode = tree.ReadByte(treeStart + pos);
             }
 
             if (writeData) {
@@ -640,7 +801,7 @@ void BIOS_HuffUnComp()
                     if (byteCount == 4) {
                         byteCount = 0;
                         byteShift = 0;
-                        CPUWriteMemory(dest, writeValue);
+                        out.WriteMemory(dest, writeValue);
                         dest += 4;
                         writeValue = 0;
                         len -= 4;
@@ -653,7 +814,7 @@ void BIOS_HuffUnComp()
             mask >>= 1;
             if (mask == 0) {
                 mask = 0x80000000;
-                data = CPUReadMemory(source);
+                data = bits.ReadMemory(source);
                 source += 4;
             }
         }
@@ -680,6 +841,9 @@ void BIOS_LZ77UnCompVram()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow window(1, true);
+    BiosWindow out(2, false);
     int byteCount = 0;
     int byteShift = 0;
     uint32_t writeValue = 0;
@@ -687,22 +851,22 @@ void BIOS_LZ77UnCompVram()
     int len = header >> 8;
 
     while (len > 0) {
-        uint8_t d = CPUReadByte(source++);
+        uint8_t d = in.ReadByte(source++);
 
         for (int i = 0; i < 8; i++) {
             if (d & 0x80) {
-                uint16_t data = CPUReadByte(source++) << 8;
-                data |= CPUReadByte(source++);
+                uint16_t data = in.ReadByte(source++) << 8;
+                data |= in.ReadByte(source++);
                 int length = (data >> 12) + 3;
                 int offset = (data & 0x0FFF);
                 uint32_t windowOffset = dest + byteCount - offset - 1;
                 for (int i2 = 0; i2 < length; i2++) {
-                    writeValue |= (CPUReadByte(windowOffset++) << byteShift);
+                    writeValue |= (window.ReadByte(windowOffset++) << byteShift);
                     byteShift += 8;
                     byteCount++;
 
                     if (byteCount == 2) {
-                        CPUWriteHalfWord(dest, DowncastU16(writeValue));
+                        out.WriteHalfWord(dest, DowncastU16(writeValue));
                         dest += 2;
                         byteCount = 0;
                         byteShift = 0;
@@ -711,11 +875,11 @@ void BIOS_LZ77UnCompVram()
                     len--;
                 }
             } else {
-                writeValue |= (CPUReadByte(source++) << byteShift);
+                writeValue |= (in.ReadByte(source++) << byteShift);
                 byteShift += 8;
                 byteCount++;
                 if (byteCount == 2) {
-                    CPUWriteHalfWord(dest, DowncastU16(writeValue));
+                    out.WriteHalfWord(dest, DowncastU16(writeValue));
                     dest += 2;
                     byteCount = 0;
                     byteShift = 0;
@@ -757,24 +921,42 @@ void BIOS_LZ77UnCompWram()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow window(1, true);
+    BiosWindow out(1, false);
     int len = header >> 8;
 
     while (len > 0) {
-        uint8_t d = CPUReadByte(source++);
+        uint8_t d = in.ReadByte(source++);
 
         for (int i = 0; i < 8; i++) {
             if (d & 0x80) {
-                uint16_t data = CPUReadByte(source++) << 8;
-                data |= CPUReadByte(source++);
+                uint16_t data = in.ReadByte(source++) << 8;
+                data |= in.ReadByte(source++);
                 int length = (data >> 12) + 3;
                 int offset = (data & 0x0FFF);
                 uint32_t windowOffset = dest - offset - 1;
-                for (int i2 = 0; i2 < length; i2++) {
-                    CPUWriteByte(dest++, CPUReadByte(windowOffset++));
-                    len--;
+                uint8_t* to = out.Span(dest, length);
+                const uint8_t* from = window.Span(windowOffset, length);
+                if (to && from) {
+                    // A window that overlaps the output repeats the bytes
+                    // that were just written, so copy those one at a time.
+                    if (BIOS_Disjoint(to, from, length)) {
+                        memcpy(to, from, length);
+                    } else {
+                        for (int i2 = 0; i2 < length; i2++)
+                            to[i2] = from[i2];
+                    }
+                    dest += length;
+                    len -= length;
+                } else {
+                    for (int i2 = 0; i2 < length; i2++) {
+                        out.WriteByte(dest++, window.ReadByte(windowOffset++));
+                        len--;
+                    }
                 }
             } else {
-                CPUWriteByte(dest++, CPUReadByte(source++));
+                out.WriteByte(dest++, in.ReadByte(source++));
                 len--;
             }
 
@@ -860,6 +1042,7 @@ void BIOS_RegisterRamReset(uint32_t flags)
         }
         if (flags & 0x08) {
             // clear VRAM
+            gbaRendererVramWrite(0, 0x18000);
             memset(g_vram, 0, 0x18000);
         }
         if (flags & 0x10) {
@@ -947,16 +1130,18 @@ void BIOS_RLUnCompVram()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow out(2, false);
     int len = header >> 8;
     int byteCount = 0;
     int byteShift = 0;
     uint32_t writeValue = 0;
 
     while (len > 0) {
-        uint8_t d = CPUReadByte(source++);
+        uint8_t d = in.ReadByte(source++);
         int l = d & 0x7F;
         if (d & 0x80) {
-            uint8_t data = CPUReadByte(source++);
+            uint8_t data = in.ReadByte(source++);
             l += 3;
             for (int i = 0; i < l; i++) {
                 writeValue |= (data << byteShift);
@@ -964,7 +1149,7 @@ void BIOS_RLUnCompVram()
                 byteCount++;
 
                 if (byteCount == 2) {
-                    CPUWriteHalfWord(dest, DowncastU16(writeValue));
+                    out.WriteHalfWord(dest, DowncastU16(writeValue));
                     dest += 2;
                     byteCount = 0;
                     byteShift = 0;
@@ -977,11 +1162,11 @@ void BIOS_RLUnCompVram()
         } else {
             l++;
             for (int i = 0; i < l; i++) {
-                writeValue |= (CPUReadByte(source++) << byteShift);
+                writeValue |= (in.ReadByte(source++) << byteShift);
                 byteShift += 8;
                 byteCount++;
                 if (byteCount == 2) {
-                    CPUWriteHalfWord(dest, DowncastU16(writeValue));
+                    out.WriteHalfWord(dest, DowncastU16(writeValue));
                     dest += 2;
                     byteCount = 0;
                     byteShift = 0;
@@ -1015,24 +1200,48 @@ void BIOS_RLUnCompWram()
     if (((source & 0xe000000) == 0) || ((source + ((header >> 8) & 0x1fffff)) & 0xe000000) == 0)
         return;
 
+    BiosWindow in(1, true);
+    BiosWindow out(1, false);
     int len = header >> 8;
 
     while (len > 0) {
-        uint8_t d = CPUReadByte(source++);
+        uint8_t d = in.ReadByte(source++);
         int l = d & 0x7F;
         if (d & 0x80) {
-            uint8_t data = CPUReadByte(source++);
+            uint8_t data = in.ReadByte(source++);
             l += 3;
+            const int n = l < len ? l : len;
+            uint8_t* to = out.Span(dest, n);
+            if (to) {
+                memset(to, data, n);
+                dest += n;
+                len -= n;
+                if (len == 0)
+                    return;
+                continue;
+            }
             for (int i = 0; i < l; i++) {
-                CPUWriteByte(dest++, data);
+                out.WriteByte(dest++, data);
                 len--;
                 if (len == 0)
                     return;
             }
         } else {
             l++;
+            const int n = l < len ? l : len;
+            uint8_t* to = out.Span(dest, n);
+            const uint8_t* from = in.Span(source, n);
+            if (to && from && BIOS_Disjoint(to, from, n)) {
+                memcpy(to, from, n);
+                source += n;
+                dest += n;
+                len -= n;
+                if (len == 0)
+                    return;
+                continue;
+            }
             for (int i = 0; i < l; i++) {
-                CPUWriteByte(dest++, CPUReadByte(source++));
+                out.WriteByte(dest++, in.ReadByte(source++));
                 len--;
                 if (len == 0)
                     return;
@@ -0,0 +1,408 @@
+// vbam-encode: headless, non-realtime A/V capture.
+//
+// Runs a ROM as fast as the host allows, optionally replaying an input movie,
+// and feeds every emulated frame to recording::MediaRecorder with an
+// explicit timestamp. Nothing here waits for wall-clock time: the speed is
+// bounded only by emulation and by the encoder, which uses libavcodec
+// threading on all cores.
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "components/av_recording/av_recording.h"
+#include "components/filters_agb/filters_agb.h"
+#include "core/base/file_util.h"
+#include "core/base/message.h"
+#include "core/base/movie.h"
+#include "core/base/system.h"
+#include "core/gb/gb.h"
+#include "core/gb/gbGlobals.h"
+#include "core/gba/gba.h"
+#include "core/gba/gbaFlash.h"
+#include "core/gba/gbaGlobals.h"
+#include "core/gba/gbaSound.h"
+
+namespace {
+
+// GBA and GB share the same frame rate: 16777216 Hz / 280896 cycles per
+// frame, or 4194304 Hz / 70224 cycles per frame.
+constexpr int kFrameRateNum = 16777216;
+constexpr int kFrameRateDen = 280896;
+
+// The core needs a sound driver to produce samples; the samples are routed
+// to the recorder through systemOnWriteDataToSoundBuffer() instead.
+class NullSoundDriver : public SoundDriver {
+public:
+    bool init(long) override { return true; }
+    void pause() override {}
+    void reset() override {}
+    void resume() override {}
+    void write(uint16_t*, int) override {}
+    void setThrottle(unsigned short) override {}
+};
+
+// Reads the keystroke log written by the wx frontend's "Record game" (VMV).
+// All values are little-endian 32-bit ints:
+//   <version> = 1 or 2
+//   for every joypad change and once at end of movie {
+//      <timestamp> = frames since start of movie (v1) or since the
+//                    previous change (v2)
+//      <joypad>    = default joypad reading at that time
+//   }
+// The matching save state is stored next to it, as <name>.vm0.
+class VmvReader {
+public:
+    ~VmvReader() {
+        if (file_)
+            fclose(file_);
+    }
+
+    bool Open(const char* fname) {
+        file_ = fopen(fname, "rb");
+        if (!file_ || !ReadU32(&version_) || version_ < 1 || version_ > 2)
+            return false;
+        if (!ReadEvent())
+            return false;
+        // Events recorded at frame 0 apply before the first frame.
+        Apply();
+        return true;
+    }
+
+    // Returns the joypad for the current frame. `ended` is set once the
+    // last recorded event has been reached.
+    uint32_t Joypad() const { return joypad_; }
+    bool ended() const { return ended_; }
+
+    // Called once per emulated frame, mirroring the wx playback logic.
+    void NextFrame() {
+        frame_++;
+        Apply();
+    }
+
+private:
+    void Apply() {
+        while (!ended_ && frame_ >= next_frame_) {
+            joypad_ = next_joypad_;
+            if (version_ == 2)
+                frame_ = 0;
+            if (!ReadEvent()) {
+                ended_ = true;
+                return;
+            }
+            if (version_ == 2)
+                break;
+        }
+    }
+
+    bool ReadU32(uint32_t* value) {
+        uint8_t buf[4];
+        if (fread(buf, 1, sizeof(buf), file_) != sizeof(buf))
+            return false;
+        *value = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        return true;
+    }
+
+    bool ReadEvent() { return ReadU32(&next_frame_) && ReadU32(&next_joypad_); }
+
+    FILE* file_ = nullptr;
+    uint32_t version_ = 0;
+    uint32_t frame_ = 0;
+    uint32_t joypad_ = 0;
+    uint32_t next_frame_ = 0;
+    uint32_t next_joypad_ = 0;
+    bool ended_ = false;
+};
+
+recording::MediaRecorder g_recorder;
+std::unique_ptr<VmvReader> g_movie;
+// Whether the movie is played by the core, see core/base/movie.h.
+bool g_core_movie = false;
+// Number of frames the core has presented, used as the video pts.
+int64_t g_frames_presented = 0;
+// Stop after this many frames; 0 means "until the movie ends".
+int64_t g_frame_limit = 0;
+bool g_done = false;
+
+void MarkFramePresented() {
+    g_frames_presented++;
+    if (g_frame_limit && g_frames_presented >= g_frame_limit)
+        g_done = true;
+    if (g_movie && g_movie->ended())
+        g_done = true;
+    if (g_core_movie && (movieGetState() != MOVIE_PLAYING || movieGetFrame() >= movieGetLength()))
+        g_done = true;
+}
+
+void Usage() {
+    fprintf(stderr,
+            "Usage: vbam-encode [options] <rom> <output>\n"
+            "\n"
+            "Options:\n"
+            "  --movie <file>      replay a movie recorded with --movie-record, or a\n"
+            "                      VMV movie (state from <file>.vm0)\n"
+            "  --frames <n>        stop after <n> frames\n"
+            "  --bios <file>       use a BIOS file\n"
+            "  --threads <n>       encoder threads, 0 for one per core (default)\n"
+            "\n"
+            "The output format is guessed from the <output> extension.\n"
+            "Without --movie, --frames is required.\n");
+}
+
+}  // namespace
+
+struct CoreOptions coreOptions;
+
+void systemMessage(int, const char* msg, ...) {
+    va_list valist;
+    va_start(valist, msg);
+    vfprintf(stderr, msg, valist);
+    fprintf(stderr, "\n");
+    va_end(valist);
+}
+
+void log(const char*, ...) {}
+
+bool systemPauseOnFrame() {
+    // Returning true ends the current emuMain() call at a frame boundary.
+    return g_done;
+}
+
+void systemGbPrint(uint8_t*, int, int, int, int, int) {}
+
+void systemScreenCapture(int) {}
+
+void systemDrawScreen() {
+    if (g_recorder.AddFrame(g_pix, g_frames_presented) != recording::MRET_OK) {
+        fprintf(stderr, "Error encoding frame %lld\n", (long long)g_frames_presented);
+        g_done = true;
+    }
+    MarkFramePresented();
+}
+
+void systemSendScreen() {
+    // Skipped frame: nothing to encode, but time still passes.
+    MarkFramePresented();
+}
+
+bool systemReadJoypads() {
+    return true;
+}
+
+uint32_t systemReadJoypad(int) {
+    return g_movie ? g_movie->Joypad() : 0;
+}
+
+uint32_t systemGetClock() {
+    return 0;
+}
+
+void systemSetTitle(const char*) {}
+
+std::unique_ptr<SoundDriver> systemSoundInit() {
+    return std::make_unique<NullSoundDriver>();
+}
+
+void systemOnWriteDataToSoundBuffer(const uint16_t* finalWave, int length) {
+    if (g_recorder.AddFrame(finalWave, length) != recording::MRET_OK)
+        g_done = true;
+}
+
+void systemOnSoundShutdown() {}
+
+void systemScreenMessage(const char*) {}
+
+void systemUpdateMotionSensor() {}
+
+int systemGetSensorX() {
+    return 0;
+}
+
+int systemGetSensorY() {
+    return 0;
+}
+
+int systemGetSensorZ() {
+    return 0;
+}
+
+uint8_t systemGetSensorDarkness() {
+    return 0xE8;
+}
+
+void systemCartridgeRumble(bool) {}
+
+void systemPossibleCartridgeRumble(bool) {}
+
+void updateRumbleFrame() {}
+
+bool systemCanChangeSoundQuality() {
+    return false;
+}
+
+void systemShowSpeed(int) {}
+
+void system10Frames() {}
+
+void systemFrame() {
+    if (g_movie)
+        g_movie->NextFrame();
+}
+
+void systemGbBorderOn() {}
+
+void (*dbgOutput)(const char* s, uint32_t addr);
+void (*dbgSignal)(int sig, int number);
+
+uint16_t systemColorMap16[0x10000];
+uint32_t systemColorMap32[0x10000];
+uint16_t systemGbPalette[24];
+int systemRedShift;
+int systemGreenShift;
+int systemBlueShift;
+int systemColorDepth;
+int systemVerbose;
+int systemFrameSkip;
+int systemSaveUpdateCounter;
+int systemSpeed;
+
+int emulating = 0;
+
+int main(int argc, char** argv) {
+    const char* movie_file = nullptr;
+    const char* bios_file = nullptr;
+    int encoder_threads = 0;
+    const char* positional[2] = {nullptr, nullptr};
+    int num_positional = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "--movie") && has_value) {
+            movie_file = argv[++i];
+        } else if (!strcmp(argv[i], "--frames") && has_value) {
+            g_frame_limit = strtoll(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--bios") && has_value) {
+            bios_file = argv[++i];
+        } else if (!strcmp(argv[i], "--threads") && has_value) {
+            encoder_threads = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && num_positional < 2) {
+            positional[num_positional++] = argv[i];
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+
+    if (num_positional != 2 || (!movie_file && g_frame_limit <= 0)) {
+        Usage();
+        return 1;
+    }
+    const char* rom_file = positional[0];
+    const char* output_file = positional[1];
+
+    // The recorder takes 32-bit RGBA with a 1-pixel border, which is what
+    // the core draws with systemColorDepth == 32.
+    systemColorDepth = 32;
+#if defined(__BIG_ENDIAN__) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    systemRedShift = 27;
+    systemGreenShift = 19;
+    systemBlueShift = 11;
+#else
+    systemRedShift = 3;
+    systemGreenShift = 11;
+    systemBlueShift = 19;
+#endif
+    gbafilter_update_colors(false);
+
+    // Every frame is rendered and encoded.
+    systemFrameSkip = 0;
+    gbFrameSkip = 0;
+    coreOptions.useBios = bios_file != nullptr;
+
+    soundInit();
+
+    struct EmulatedSystem emulator;
+    int width = 0, height = 0;
+
+    const IMAGE_TYPE type = utilFindType(rom_file);
+    if (type == IMAGE_GB) {
+        if (!gbLoadRom(rom_file)) {
+            systemMessage(0, "Failed to load file %s", rom_file);
+            return 1;
+        }
+        gbGetHardwareType();
+        if (gbHardware & 7)
+            gbCPUInit(bios_file, coreOptions.useBios);
+        gbBorderOn = false;
+        gbBorderLineSkip = 160;
+        gbBorderColumnSkip = 0;
+        gbBorderRowSkip = 0;
+        emulator = GBSystem;
+        gbReset();
+        width = 160;
+        height = 144;
+    } else if (type == IMAGE_GBA) {
+        const int size = CPULoadRom(rom_file);
+        if (size == 0) {
+            systemMessage(0, "Failed to load file %s", rom_file);
+            return 1;
+        }
+        if (coreOptions.cpuSaveType == 0)
+            flashDetectSaveType(size);
+        else
+            coreOptions.saveType = coreOptions.cpuSaveType;
+        doMirroring(coreOptions.mirroringEnable);
+        emulator = GBASystem;
+        CPUInit(bios_file, coreOptions.useBios);
+        CPUReset();
+        width = 240;
+        height = 160;
+    } else {
+        systemMessage(0, "Unknown file type %s", rom_file);
+        return 1;
+    }
+
+    if (movie_file && movieStartPlayback(movie_file, &emulator)) {
+        g_core_movie = true;
+    } else if (movie_file) {
+        g_movie.reset(new VmvReader());
+        if (!g_movie->Open(movie_file)) {
+            systemMessage(0, "Cannot open movie file %s", movie_file);
+            return 1;
+        }
+        std::string state_file = movie_file;
+        state_file[state_file.size() - 1] = '0';
+        if (!emulator.emuReadState(state_file.c_str())) {
+            systemMessage(0, "Cannot read movie state %s", state_file.c_str());
+            return 1;
+        }
+    }
+
+    g_recorder.SetSampleRate(soundGetSampleRate());
+    g_recorder.SetFrameRate(kFrameRateNum, kFrameRateDen);
+    g_recorder.SetEncoderThreads(encoder_threads);
+    recording::MediaRet ret = g_recorder.Record(output_file, width, height, 32);
+    if (ret != recording::MRET_OK) {
+        systemMessage(0, "Cannot start recording to %s (error %d)", output_file, ret);
+        return 1;
+    }
+
+    emulating = 1;
+    while (!g_done && emulating)
+        emulator.emuMain(emulator.emuCount);
+    emulating = 0;
+
+    g_recorder.Stop();
+
+    const recording::EncoderStats stats = g_recorder.GetStats();
+    fprintf(stdout, "Encoded %lld frames (%llu producer stalls, %llu ms waiting)\n",
+            (long long)g_frames_presented, (unsigned long long)stats.producerStalls,
+            (unsigned long long)(stats.producerStallUsec / 1000));
+
+    soundShutdown();
+    emulator.emuCleanUp();
+    return 0;
+}
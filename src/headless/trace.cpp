@@ -0,0 +1,176 @@
+// vbam-trace: prints and compares GBA execution traces.
+//
+// The traces are recorded with `vbam --trace=FILE` in builds configured with
+// ENABLE_TRACE. Comparing the traces of two runs of the same ROM and input
+// finds the first instruction where they diverge, e.g. to debug a desync.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#include "core/gba/gbaTrace.h"
+
+namespace {
+
+const char* const kRegisterNames[TRACE_REGISTERS] = {
+    "r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8",
+    "r9", "r10", "r11", "r12", "sp", "lr", "pc", "cpsr",
+};
+
+void Usage() {
+    fprintf(stderr,
+            "Usage: vbam-trace show TRACE [FIRST [COUNT]]\n"
+            "       vbam-trace diff TRACE1 TRACE2 [CONTEXT]\n"
+            "\n"
+            "show  Prints COUNT instructions (all by default) from FIRST on.\n"
+            "diff  Finds the first instruction where the traces differ and\n"
+            "      prints it with CONTEXT instructions before it (8). Exits\n"
+            "      with 1 if the traces differ, 0 otherwise.\n");
+}
+
+void PrintRecord(const char* prefix, const TraceRecord& r) {
+    printf("%s%" PRIu64 " frame %u  %08x  ", prefix, r.index, r.frame,
+           r.address);
+    if (r.thumb)
+        printf("    %04x", r.opcode);
+    else
+        printf("%08x", r.opcode);
+    for (int i = 0; i < TRACE_REGISTERS; i++) {
+        if (r.changed & (1 << i))
+            printf("  %s=%08x", kRegisterNames[i], r.regs[i]);
+    }
+    for (int i = 0; i < r.writeCount; i++) {
+        const TraceWrite& w = r.writes[i];
+        printf("  [%08x]%d=%0*x", w.address, w.size * 8, w.size * 2, w.value);
+    }
+    if (r.skippedCount)
+        printf("  +%u writes (hash %08x)", r.skippedCount, r.skippedHash);
+    printf("\n");
+}
+
+// The first difference between two records, or nullptr.
+const char* Compare(const TraceRecord& a, const TraceRecord& b) {
+    if (a.address != b.address || a.thumb != b.thumb)
+        return "address";
+    if (a.opcode != b.opcode)
+        return "opcode";
+    for (int i = 0; i < TRACE_REGISTERS; i++) {
+        if (a.regs[i] != b.regs[i])
+            return kRegisterNames[i];
+    }
+    if (a.writeCount != b.writeCount)
+        return "memory writes";
+    for (int i = 0; i < a.writeCount; i++) {
+        if (a.writes[i].address != b.writes[i].address ||
+            a.writes[i].value != b.writes[i].value ||
+            a.writes[i].size != b.writes[i].size)
+            return "memory writes";
+    }
+    if (a.skippedCount != b.skippedCount || a.skippedHash != b.skippedHash)
+        return "memory writes past the recorded ones";
+    if (a.frame != b.frame)
+        return "frame";
+    return nullptr;
+}
+
+bool Open(TraceReader& reader, const char* file) {
+    if (reader.Open(file))
+        return true;
+    fprintf(stderr, "%s: %s\n", file, reader.error());
+    return false;
+}
+
+int Show(const char* file, uint64_t first, uint64_t count) {
+    TraceReader reader;
+    if (!Open(reader, file))
+        return 2;
+
+    TraceRecord record;
+    while (count && reader.Next(record)) {
+        if (record.index < first)
+            continue;
+        PrintRecord("", record);
+        count--;
+    }
+    if (reader.error()) {
+        fprintf(stderr, "%s: %s\n", file, reader.error());
+        return 2;
+    }
+    return 0;
+}
+
+int Diff(const char* file1, const char* file2, size_t context) {
+    TraceReader reader1;
+    TraceReader reader2;
+    if (!Open(reader1, file1) || !Open(reader2, file2))
+        return 2;
+
+    std::deque<TraceRecord> history;
+    TraceRecord a;
+    TraceRecord b;
+    uint64_t count = 0;
+    // Instructions whose writes were partly compared by hash only.
+    uint64_t skipped = 0;
+    for (;;) {
+        const bool more1 = reader1.Next(a);
+        const bool more2 = reader2.Next(b);
+        if (reader1.error() || reader2.error()) {
+            fprintf(stderr, "%s: %s\n", reader1.error() ? file1 : file2,
+                    reader1.error() ? reader1.error() : reader2.error());
+            return 2;
+        }
+        if (!more1 && !more2) {
+            printf("The traces are identical (%" PRIu64 " instructions)\n",
+                   count);
+            if (skipped)
+                printf("%" PRIu64 " instructions wrote more than %d times; "
+                       "their other writes were compared by hash\n",
+                       skipped, TRACE_MAX_WRITES);
+            return 0;
+        }
+        if (!more1 || !more2) {
+            printf("%s ends after %" PRIu64 " instructions\n",
+                   more1 ? file2 : file1, count);
+            return 1;
+        }
+
+        const char* difference = Compare(a, b);
+        if (difference) {
+            printf("The traces diverge at instruction %" PRIu64 " (%s)\n\n",
+                   a.index, difference);
+            for (const TraceRecord& r : history)
+                PrintRecord("  ", r);
+            PrintRecord("< ", a);
+            PrintRecord("> ", b);
+            return 1;
+        }
+
+        count++;
+        if (a.skippedCount)
+            skipped++;
+        if (context) {
+            if (history.size() == context)
+                history.pop_front();
+            history.push_back(a);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && argc <= 5 && !strcmp(argv[1], "show")) {
+        const uint64_t first = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+        const uint64_t count =
+            argc > 4 ? strtoull(argv[4], nullptr, 10) : UINT64_MAX;
+        return Show(argv[2], first, count);
+    }
+    if (argc >= 4 && argc <= 5 && !strcmp(argv[1], "diff")) {
+        const size_t context = argc > 4 ? strtoul(argv[4], nullptr, 10) : 8;
+        return Diff(argv[2], argv[3], context);
+    }
+    Usage();
+    return 2;
+}
@@ -1471,6 +1471,13 @@ void retro_run(void)
     updateInput_SolarSensor();
     updateInput_MotionSensors();
 
+    // Frames the frontend does not show, e.g. for run-ahead, are not rendered.
+    int av_enable = 0;
+    if (environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable))
+        coreOptions.skipRender = !(av_enable & 1);
+    else
+        coreOptions.skipRender = false;
+
     has_frame = 0;
 
     while (!has_frame)
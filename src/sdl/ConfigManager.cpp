@@ -42,14 +42,22 @@
 
 #include "components/user_config/user_config.h"
 #include "core/base/file_util.h"
+#include "core/base/movie.h"
 #include "core/gb/gbGlobals.h"
 #include "core/gb/gbSound.h"
 #include "core/gba/gba.h"
 #include "core/gba/gbaFlash.h"
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+#include "core/gba/gbaMemStats.h"
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
 #include "core/gba/gbaPrint.h"
+#include "core/gba/gbaProfiler.h"
 #include "core/gba/gbaRemote.h"
 #include "core/gba/gbaRtc.h"
 #include "core/gba/gbaSound.h"
+#if defined(VBAM_ENABLE_TRACE)
+#include "core/gba/gbaTrace.h"
+#endif  // defined(VBAM_ENABLE_TRACE)
 #include "sdl/filters.h"
 #include "sdl/iniparser.h"
 
@@ -87,13 +95,19 @@ enum named_opts
 	OPT_GB_FRAME_SKIP,
 	OPT_GB_PALETTE_OPTION,
 	OPT_IFB_TYPE,
+	OPT_MEMORY_STATS,
+	OPT_MOVIE_KEYFRAMES,
+	OPT_MOVIE_PLAY,
+	OPT_MOVIE_RECORD,
 	OPT_OPT_FLASH_SIZE,
+	OPT_PROFILE_OUTPUT,
 	OPT_REWIND_TIMER,
 	OPT_RTC_ENABLED,
 	OPT_SAVE_DIR,
 	OPT_SCREEN_SHOT_DIR,
 	OPT_SHOW_SPEED,
 	OPT_SHOW_SPEED_TRANSPARENT,
+	OPT_TRACE,
 	OPT_SKIP_BIOS,
 	OPT_SOUND_FILTERING,
 	OPT_SPEEDUP_THROTTLE,
@@ -117,6 +131,11 @@ const char* batteryDir;
 const char* biosFileNameGB;
 const char* biosFileNameGBA;
 const char* biosFileNameGBC;
+const char* memoryStatsFile;
+const char* moviePlayFile;
+const char* movieRecordFile;
+const char* profileOutput;
+const char* traceFile;
 const char* saveDir;
 const char* screenShotDir;
 int agbPrint;
@@ -129,6 +148,7 @@ int filter = kStretch2x;
 int frameSkip = 1;
 int fullScreen;
 int ifbType = kIFBNone;
+int movieKeyframes = MOVIE_DEFAULT_KEYFRAME_INTERVAL;
 int openGL;
 int optFlashSize;
 int optPrintUsage;
@@ -197,6 +217,10 @@ struct option argOptions[] = {
 	{ "no-agb-print", no_argument, &agbPrint, 0 },
 	{ "no-auto-frameskip", no_argument, &autoFrameSkip, 0 },
 	{ "no-debug", no_argument, 0, 'N' },
+	{ "memory-stats", required_argument, 0, OPT_MEMORY_STATS },
+	{ "movie-keyframes", required_argument, 0, OPT_MOVIE_KEYFRAMES },
+	{ "movie-play", required_argument, 0, OPT_MOVIE_PLAY },
+	{ "movie-record", required_argument, 0, OPT_MOVIE_RECORD },
 	{ "no-opengl", no_argument, &openGL, 0 },
 	{ "no-patch", no_argument, &autoPatch, 0 },
 	{ "no-pause-when-inactive", no_argument, &pauseWhenInactive, 0 },
@@ -209,6 +233,7 @@ struct option argOptions[] = {
 	{ "patch", required_argument, 0, 'i' },
 	{ "pause-when-inactive", no_argument, &pauseWhenInactive, 1 },
 	{ "profile", optional_argument, 0, 'p' },
+	{ "profile-output", required_argument, 0, OPT_PROFILE_OUTPUT },
 	{ "rewind-timer", required_argument, 0, OPT_REWIND_TIMER },
 	{ "rtc", no_argument, &coreOptions.rtcEnabled, 1 },
 	{ "rtc-enabled", required_argument, 0, OPT_RTC_ENABLED },
@@ -230,6 +255,7 @@ struct option argOptions[] = {
 	{ "skip-save-game-cheats", no_argument, &coreOptions.skipSaveGameCheats, 1 },
 	{ "sound-filtering", required_argument, 0, OPT_SOUND_FILTERING },
 	{ "throttle", required_argument, 0, 'T' },
+	{ "trace", required_argument, 0, OPT_TRACE },
 	{ "speedup-throttle", required_argument, 0, OPT_SPEEDUP_THROTTLE },
 	{ "speedup-frame-skip", required_argument, 0, OPT_SPEEDUP_FRAME_SKIP },
 	{ "no-speedup-throttle-frame-skip", no_argument, 0, OPT_NO_SPEEDUP_THROTTLE_FRAME_SKIP },
@@ -343,6 +369,7 @@ void LoadConfig()
 	coreOptions.skipBios = ReadPref("skipBios", 0);
 	coreOptions.skipSaveGameBattery = ReadPref("skipSaveGameBattery", 1);
 	coreOptions.skipSaveGameCheats = ReadPref("skipSaveGameCheats", 0);
+	coreOptions.threadedRendering = ReadPref("threadedRendering", 0);
 	soundFiltering = (float)ReadPref("gbaSoundFiltering", 50) / 100.0f;
 	g_gbaSoundInterpolation = ReadPref("gbaSoundInterpolation", 1);
 	coreOptions.throttle = ReadPref("throttle", 100);
@@ -765,15 +792,20 @@ int ReadOpts(int argc, char ** argv)
 				ifbType = kIFBNone;
 			}
 			break;
-		case 'p':
-#ifdef PROFILING
+		case 'p': {
+			// samples per second of emulated time, at most one per cycle
+			long hz = 1000;
 			if (optarg) {
-				cpuEnableProfiling(atoi(optarg));
+				char* end = nullptr;
+				long value = strtol(optarg, &end, 10);
+				if (end == optarg || *end != '\0' || value < 1 || value > 16777216)
+					log("Invalid profiler rate %s, expected 1-16777216 Hz. Defaulting to 1000 Hz\n", optarg);
+				else
+					hz = value;
 			}
-			else
-				cpuEnableProfiling(100);
-#endif
+			profilerStart((int)(16777216 / hz));
 			break;
+		}
 		case 'S':
 			optFlashSize = atoi(optarg);
 			if (optFlashSize < 0 || optFlashSize > 1)
@@ -957,6 +989,45 @@ int ReadOpts(int argc, char ** argv)
 			batteryDir = optarg;
 			break;
 
+		case OPT_PROFILE_OUTPUT:
+			// --profile-output
+			profileOutput = optarg;
+			break;
+
+		case OPT_MEMORY_STATS:
+			// --memory-stats
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+			memoryStatsFile = optarg;
+			memStatsEnable(true);
+#else
+			fprintf(stderr, "--memory-stats requires a build with ENABLE_MEMORY_STATS\n");
+#endif
+			break;
+
+		case OPT_MOVIE_KEYFRAMES:
+			// --movie-keyframes
+			movieKeyframes = atoi(optarg);
+			break;
+
+		case OPT_MOVIE_PLAY:
+			// --movie-play
+			moviePlayFile = optarg;
+			break;
+
+		case OPT_MOVIE_RECORD:
+			// --movie-record
+			movieRecordFile = optarg;
+			break;
+
+		case OPT_TRACE:
+			// --trace
+#if defined(VBAM_ENABLE_TRACE)
+			traceFile = optarg;
+#else
+			fprintf(stderr, "--trace requires a build with ENABLE_TRACE\n");
+#endif
+			break;
+
 		case OPT_CPU_SAVE_TYPE:
 			// --cpu-save-type
 			if (optarg) {
@@ -8,6 +8,11 @@
 extern const char *biosFileNameGB;
 extern const char *biosFileNameGBA;
 extern const char *biosFileNameGBC;
+extern const char *profileOutput;
+extern const char *memoryStatsFile;
+extern const char *moviePlayFile;
+extern const char *movieRecordFile;
+extern const char *traceFile;
 extern int agbPrint;
 extern int autoFireMaxCount;
 extern int autoFrameSkip;
@@ -18,6 +23,7 @@ extern int filter;
 extern int frameSkip;
 extern int fullScreen;
 extern int ifbType;
+extern int movieKeyframes;
 extern int openGL;
 extern int optFlashSize;
 extern int optPrintUsage;
@@ -98,6 +98,7 @@
 #include "components/user_config/user_config.h"
 #include "core/base/file_util.h"
 #include "core/base/message.h"
+#include "core/base/movie.h"
 #include "core/base/patch.h"
 #include "core/base/version.h"
 #include "core/gb/gb.h"
@@ -108,8 +109,15 @@
 #include "core/gba/gbaCheats.h"
 #include "core/gba/gbaFlash.h"
 #include "core/gba/gbaGlobals.h"
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+#include "core/gba/gbaMemStats.h"
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+#include "core/gba/gbaProfiler.h"
 #include "core/gba/gbaRtc.h"
 #include "core/gba/gbaSound.h"
+#if defined(VBAM_ENABLE_TRACE)
+#include "core/gba/gbaTrace.h"
+#endif  // defined(VBAM_ENABLE_TRACE)
 #include "sdl/ConfigManager.h"
 #include "sdl/audio_sdl.h"
 #include "sdl/filters.h"
@@ -141,6 +149,7 @@ struct EmulatedSystem emulator = {
     NULL,
     NULL,
     NULL,
+    NULL,
     false,
     0
 };
@@ -559,6 +568,8 @@ void sdlOpenGLInit(int w, int h)
 
 static void sdlApplyPerImagePreferences()
 {
+    coreOptions.accurateRendering = false;
+
     FILE* f = sdlFindFile("vba-over.ini");
     if (!f) {
         fprintf(stdout, "vba-over.ini NOT FOUND (using emulator settings)\n");
@@ -638,6 +649,8 @@ static void sdlApplyPerImagePreferences()
                     coreOptions.cpuSaveType = save;
             } else if (!strcmp(token, "mirroringEnabled")) {
                 coreOptions.mirroringEnable = (atoi(value) == 0 ? false : true);
+            } else if (!strcmp(token, "accurateRendering")) {
+                coreOptions.accurateRendering = (atoi(value) == 0 ? false : true);
             }
         }
     }
@@ -785,6 +798,23 @@ void sdlWriteBattery()
     freeSafe(gameDir);
 }
 
+// Writes the samples of --profile, as pprof if the file is named like one and
+// as folded stacks otherwise.
+static void sdlWriteProfile()
+{
+    const char* file = profileOutput ? profileOutput : "vbam-profile.folded";
+    size_t len = strlen(file);
+    ProfilerFormat format = PROFILER_FOLDED;
+    if (len > 6 && (strcmp(file + len - 6, ".pb.gz") == 0 || strcmp(file + len - 6, ".pprof") == 0))
+        format = PROFILER_PPROF;
+
+    profilerStop();
+    if (profilerSave(file, format))
+        systemMessage(0, "Wrote profile '%s'", file);
+    else
+        systemMessage(0, "Error writing profile '%s'", file);
+}
+
 void sdlReadBattery()
 {
     char buffer[2048];
@@ -1475,7 +1505,7 @@ Options:\n\
     printf("\
   -h, --help                   Print this help\n\
   -i, --patch=PATCH            Apply given patch\n\
-  -p, --profile=[HERTZ]        Enable profiling\n\
+  -p, --profile=[HERTZ]        Sample the CPU HERTZ times per second (1000)\n\
   -s, --frameskip=FRAMESKIP    Set frame skip (0...9)\n\
   -t, --save-type=TYPE         Set the available save type\n\
       --save-auto               0 - Automatic (EEPROM, SRAM, FLASH)\n\
@@ -1499,6 +1529,13 @@ Options:\n\
 Long options only:\n\
       --agb-print              Enable AGBPrint support\n\
       --auto-frameskip         Enable auto frameskipping\n\
+      --memory-stats=FILE      Write the memory and cycle counters of the\n\
+                               last 300 frames to FILE as CSV on exit\n\
+                               (ENABLE_MEMORY_STATS builds only)\n\
+      --movie-keyframes=N      Store a save state every N frames of a\n\
+                               recorded movie (600)\n\
+      --movie-play=FILE        Play the input movie FILE\n\
+      --movie-record=FILE      Record the input to the movie FILE\n\
       --no-agb-print           Disable AGBPrint support\n\
       --no-auto-frameskip      Disable auto frameskipping\n\
       --no-patch               Do not automatically apply patch\n\
@@ -1507,9 +1544,14 @@ Long options only:\n\
       --no-show-speed          Don't show emulation speed\n\
       --no-throttle            Disable throttle\n\
       --pause-when-inactive    Pause when inactive\n\
+      --profile-output=FILE    Write the --profile samples to FILE, as pprof\n\
+                               if it ends in .pb.gz or .pprof and as folded\n\
+                               stacks otherwise (vbam-profile.folded)\n\
       --rtc                    Enable RTC support\n\
       --show-speed-normal      Show emulation speed\n\
       --show-speed-detailed    Show detailed speed data\n\
+      --trace=FILE             Record every GBA instruction to FILE, for\n\
+                               vbam-trace (ENABLE_TRACE builds only)\n\
       --cheat 'CHEAT'          Add a cheat\n\
 ");
 }
@@ -1871,6 +1913,21 @@ int main(int argc, char** argv)
 
     ifbFunction = initIFBFilter(ifbType, systemColorDepth);
 
+#if defined(VBAM_ENABLE_TRACE)
+    // Started once the battery is loaded, so that runs of the same ROM and
+    // input give the same trace.
+    if (traceFile && cartridgeType == IMAGE_GBA && !traceStart(traceFile))
+        systemMessage(0, "Error writing trace '%s'", traceFile);
+#endif  // defined(VBAM_ENABLE_TRACE)
+
+    if (movieRecordFile) {
+        if (!movieStartRecording(movieRecordFile, &emulator, movieKeyframes))
+            systemMessage(0, "Error recording movie '%s'", movieRecordFile);
+    } else if (moviePlayFile) {
+        if (!movieStartPlayback(moviePlayFile, &emulator))
+            systemMessage(0, "Cannot play movie '%s'", moviePlayFile);
+    }
+
     emulating = 1;
     renderedFrames = 0;
 
@@ -1934,6 +1991,31 @@ int main(int argc, char** argv)
         SDL_GL_DeleteContext(glcontext);
     }
 
+    if (profilerEnabled)
+        sdlWriteProfile();
+
+#if defined(VBAM_ENABLE_MEMORY_STATS)
+    if (memoryStatsFile) {
+        if (memStatsWriteCsv(memoryStatsFile))
+            systemMessage(0, "Wrote memory statistics '%s'", memoryStatsFile);
+        else
+            systemMessage(0, "Error writing memory statistics '%s'", memoryStatsFile);
+    }
+#endif  // defined(VBAM_ENABLE_MEMORY_STATS)
+
+    // Only a recording can fail to stop.
+    if (!movieStop())
+        systemMessage(0, "Error writing movie '%s'", movieRecordFile);
+
+#if defined(VBAM_ENABLE_TRACE)
+    if (traceEnabled) {
+        if (traceStop())
+            systemMessage(0, "Wrote trace '%s'", traceFile);
+        else
+            systemMessage(0, "Error writing trace '%s'", traceFile);
+    }
+#endif  // defined(VBAM_ENABLE_TRACE)
+
     if (gbRom != NULL || g_rom != NULL) {
         sdlWriteBattery();
         emulator.emuCleanUp();
@@ -1846,8 +1846,8 @@ void MainFrame::GDBBreak()
                 remotePort = gopts.gdb_port;
                 emulating = 1;
                 dbgMain = remoteStubMain;
-                dbgSignal = remoteStubSignal;
-                dbgOutput = remoteOutput;
+                dbgSignal = debugDeferSignal;
+                dbgOutput = debugDeferOutput;
                 cmd_enable &= ~(CMDEN_NGDB_ANY | CMDEN_NGDB_GBA);
                 cmd_enable |= CMDEN_GDB;
                 enable_menus();
@@ -2044,8 +2044,12 @@ EVT_HANDLER(GameBoyAdvanceConfigure, "Game Boy Advance options...")
                 fis.Read(sos);
             }
 
+            // not in the dialog, so kept as it is
+            bool accurate_rendering = false;
+
             if (cfg->HasGroup(s)) {
                 cfg->SetPath(s);
+                accurate_rendering = cfg->Read(wxT("accurateRendering"), (long)0) != 0;
 
                 if (cfg->Read(wxT("path"), wxEmptyString) == fn.GetPath()) {
                     // EOL can be either \n (unix), \r\n (dos), or \r (old mac)
@@ -2115,6 +2119,11 @@ EVT_HANDLER(GameBoyAdvanceConfigure, "Game Boy Advance options...")
             if ((sel = ovmir->GetSelection()) > 0)
                 appendval("mirroringEnabled");
 
+            if (accurate_rendering) {
+                sel = 2;
+                appendval("accurateRendering");
+            }
+
             cfg->SetPath(wxT("/"));
             vba_over.append(wxTextFile::GetEOL());
             fn.Mkdir(0777, wxPATH_MKDIR_FULL);
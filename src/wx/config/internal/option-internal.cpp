@@ -144,6 +144,7 @@ std::array<Option, kNbOptions>& Option::All() {
 #endif
         double video_scale = 3;
         bool retain_aspect = true;
+        int32_t viewer_refresh_rate = 15;
 
         /// GB
         wxString gb_bios = wxEmptyString;
@@ -248,6 +249,7 @@ std::array<Option, kNbOptions>& Option::All() {
         Option(OptionID::kDispRenderMethod, &g_owned_opts.render_method),
         Option(OptionID::kDispScale, &g_owned_opts.video_scale, 1, 6),
         Option(OptionID::kDispStretch, &g_owned_opts.retain_aspect),
+        Option(OptionID::kDispViewerRefreshRate, &g_owned_opts.viewer_refresh_rate, 1, 60),
 
         /// GB
         Option(OptionID::kGBBiosFile, &g_owned_opts.gb_bios),
@@ -327,6 +329,7 @@ std::array<Option, kNbOptions>& Option::All() {
         Option(OptionID::kPrefSkipBios, &coreOptions.skipBios),
         Option(OptionID::kPrefSkipSaveGameCheats, &coreOptions.skipSaveGameCheats, 0, 1),
         Option(OptionID::kPrefSkipSaveGameBattery, &coreOptions.skipSaveGameBattery, 0, 1),
+        Option(OptionID::kPrefThreadedRendering, &coreOptions.threadedRendering),
         Option(OptionID::kPrefThrottle, &coreOptions.throttle, 0, 450),
         Option(OptionID::kPrefSpeedupThrottle, &coreOptions.speedup_throttle, 0, 450),
         Option(OptionID::kPrefSpeedupFrameSkip, &coreOptions.speedup_frame_skip, 0, 40),
@@ -390,6 +393,8 @@ const std::array<OptionData, kNbOptions + 1> kAllOptionsData = {
                _("Render method; if unsupported, simple method will be used")},
     OptionData{"Display/Scale", "", _("Default scale factor")},
     OptionData{"Display/Stretch", "RetainAspect", _("Retain aspect ratio when resizing")},
+    OptionData{"Display/ViewerRefreshRate", "",
+               _("Maximum number of times per second the auto-updating viewers are refreshed")},
 
     /// GB
     OptionData{"GB/BiosFile", "", _("BIOS file to use for Game Boy, if enabled")},
@@ -522,6 +527,8 @@ const std::array<OptionData, kNbOptions + 1> kAllOptionsData = {
                _("Do not overwrite cheat list when loading state")},
     OptionData{"preferences/skipSaveGameBattery", "",
                _("Do not overwrite native (battery) save when loading state")},
+    OptionData{"preferences/threadedRendering", "",
+               _("Draw the screen on a separate thread")},
     OptionData{"preferences/throttle", "",
                _("Throttle game speed, even when accelerated (0-450 %, 0 = no "
                  "throttle)")},
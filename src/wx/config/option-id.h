@@ -16,6 +16,7 @@ enum class OptionID {
     kDispRenderMethod,
     kDispScale,
     kDispStretch,
+    kDispViewerRefreshRate,
 
     /// GB
     kGBBiosFile,
@@ -95,6 +96,7 @@ enum class OptionID {
     kPrefSkipBios,
     kPrefSkipSaveGameCheats,
     kPrefSkipSaveGameBattery,
+    kPrefThreadedRendering,
     kPrefThrottle,
     kPrefSpeedupThrottle,
     kPrefSpeedupFrameSkip,
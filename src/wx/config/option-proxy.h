@@ -20,6 +20,7 @@ static constexpr std::array<Option::Type, kNbOptions> kOptionsTypes = {
     /*kDispRenderMethod*/ Option::Type::kRenderMethod,
     /*kDispScale*/ Option::Type::kDouble,
     /*kDispStretch*/ Option::Type::kBool,
+    /*kDispViewerRefreshRate*/ Option::Type::kInt,
 
     /// GB
     /*kGBBiosFile*/ Option::Type::kString,
@@ -99,6 +100,7 @@ static constexpr std::array<Option::Type, kNbOptions> kOptionsTypes = {
     /*kPrefSkipBios*/ Option::Type::kBool,
     /*kPrefSkipSaveGameCheats*/ Option::Type::kInt,
     /*kPrefSkipSaveGameBattery*/ Option::Type::kInt,
+    /*kPrefThreadedRendering*/ Option::Type::kBool,
     /*kPrefThrottle*/ Option::Type::kUnsigned,
     /*kPrefSpeedupThrottle*/ Option::Type::kUnsigned,
     /*kPrefSpeedupFrameSkip*/ Option::Type::kUnsigned,
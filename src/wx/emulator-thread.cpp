@@ -0,0 +1,218 @@
+#include "wx/emulator-thread.h"
+
+#include <cstring>
+#include <utility>
+
+void FrameMailbox::Resize(size_t size)
+{
+    for (std::vector<uint8_t>& buffer : buffers_)
+        buffer.assign(size, 0);
+    back_ = 0;
+    front_ = 1;
+    middle_.store(2);
+}
+
+void FrameMailbox::Publish()
+{
+    back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & ~kFresh;
+}
+
+const uint8_t* FrameMailbox::Fetch()
+{
+    if (!(middle_.load(std::memory_order_relaxed) & kFresh))
+        return nullptr;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~kFresh;
+    return buffers_[front_].data();
+}
+
+bool CommandQueue::Push(EmulatorCommand command)
+{
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity)
+        return false;
+    commands_[tail % kCapacity] = std::move(command);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool CommandQueue::Pop(EmulatorCommand& command)
+{
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+        return false;
+    command = std::move(commands_[head % kCapacity]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool CommandQueue::Empty() const
+{
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+class EmulatorThread::Worker : public wxThread {
+public:
+    explicit Worker(EmulatorThread* owner) : wxThread(wxTHREAD_JOINABLE), owner_(owner) {}
+
+    ExitCode Entry() override
+    {
+        owner_->Run();
+        return 0;
+    }
+
+private:
+    EmulatorThread* owner_;
+};
+
+EmulatorThread::EmulatorThread(Delegate* delegate)
+    : delegate_(delegate), condition_(mutex_) {}
+
+EmulatorThread::~EmulatorThread()
+{
+    Stop();
+}
+
+bool EmulatorThread::Start(size_t frame_size, bool paused)
+{
+    Stop();
+    mailbox_.Resize(frame_size);
+    present_pending_ = false;
+    paused_ = paused;
+    memset(joypads_, 0, sizeof(joypads_));
+    stop_ = false;
+    parked_ = false;
+
+    worker_.reset(new Worker(this));
+    if (worker_->Run() != wxTHREAD_NO_ERROR) {
+        worker_.reset();
+        return false;
+    }
+
+    // Started inside a park, e.g. by a menu command: keep it parked.
+    if (park_depth_) {
+        wxMutexLocker lock(mutex_);
+        while (!parked_)
+            condition_.Wait();
+    }
+    return true;
+}
+
+void EmulatorThread::Stop()
+{
+    if (!worker_)
+        return;
+
+    {
+        wxMutexLocker lock(mutex_);
+        stop_ = true;
+        condition_.Broadcast();
+    }
+    worker_->Wait();
+    worker_.reset();
+
+    EmulatorCommand command;
+    while (commands_.Pop(command)) {
+    }
+}
+
+bool EmulatorThread::Send(EmulatorCommand command)
+{
+    if (!worker_ || !commands_.Push(std::move(command)))
+        return false;
+
+    wxMutexLocker lock(mutex_);
+    condition_.Broadcast();
+    return true;
+}
+
+void EmulatorThread::Park()
+{
+    if (park_depth_++)
+        return;
+
+    wxMutexLocker lock(mutex_);
+    park_requested_ = true;
+    condition_.Broadcast();
+    while (worker_ && !parked_)
+        condition_.Wait();
+}
+
+void EmulatorThread::Unpark()
+{
+    if (--park_depth_)
+        return;
+
+    wxMutexLocker lock(mutex_);
+    park_requested_ = false;
+    condition_.Broadcast();
+}
+
+const uint8_t* EmulatorThread::FetchFrame()
+{
+    // Cleared first, so that a frame published from now on is announced.
+    present_pending_ = false;
+    return mailbox_.Fetch();
+}
+
+void EmulatorThread::PublishFrame(const uint8_t* pix)
+{
+    memcpy(mailbox_.back(), pix, mailbox_.size());
+    mailbox_.Publish();
+    if (!present_pending_.exchange(true))
+        delegate_->OnFramePublished();
+}
+
+void EmulatorThread::PauseNow()
+{
+    SetPaused(true);
+}
+
+void EmulatorThread::Run()
+{
+    while (!stop_) {
+        if (park_requested_) {
+            wxMutexLocker lock(mutex_);
+            parked_ = true;
+            condition_.Broadcast();
+            while (park_requested_ && !stop_)
+                condition_.Wait();
+            parked_ = false;
+            continue;
+        }
+
+        RunCommands();
+
+        if (paused_ || !delegate_->EmulateFrame()) {
+            // Any command, park or stop wakes the thread up.
+            wxMutexLocker lock(mutex_);
+            if (commands_.Empty() && !park_requested_ && !stop_)
+                condition_.Wait();
+        }
+    }
+}
+
+void EmulatorThread::RunCommands()
+{
+    EmulatorCommand command;
+    while (commands_.Pop(command)) {
+        switch (command.type) {
+        case EmulatorCommand::kPause:
+            SetPaused(true);
+            break;
+        case EmulatorCommand::kResume:
+            SetPaused(false);
+            break;
+        case EmulatorCommand::kJoypads:
+            memcpy(joypads_, command.joypads, sizeof(joypads_));
+            break;
+        }
+    }
+}
+
+void EmulatorThread::SetPaused(bool paused)
+{
+    if (paused_ == paused)
+        return;
+    paused_ = paused;
+    delegate_->OnPauseChanged(paused);
+}
@@ -0,0 +1,165 @@
+#ifndef VBAM_WX_EMULATOR_THREAD_H_
+#define VBAM_WX_EMULATOR_THREAD_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <wx/thread.h>
+
+// The wx frontend runs the emulator on its own thread. The GUI thread talks
+// to it through a lock-free command queue (pause, input) and gets the
+// emulated frames from a triple-buffered mailbox, so that menus, dialogs and
+// repaints no longer take time from emulation.
+//
+// Anything else on the GUI thread that uses the emulator state, state loads
+// and saves included, parks the emulation thread between two frames first,
+// see EmulatorThread::Parked.
+
+// Three frame buffers: the emulation thread fills one while the GUI thread
+// reads another, and the third holds the newest complete frame. Neither side
+// waits; frames published faster than the GUI presents them are dropped.
+class FrameMailbox {
+public:
+    // Only while neither thread uses the mailbox.
+    void Resize(size_t size);
+    size_t size() const { return buffers_[0].size(); }
+
+    // Emulation thread: the buffer to fill, then Publish().
+    uint8_t* back() { return buffers_[back_].data(); }
+    void Publish();
+
+    // GUI thread: the newest frame published since the last call, or
+    // nullptr. The frame stays valid until the next call.
+    const uint8_t* Fetch();
+
+private:
+    // Set in `middle_` when it holds a frame the GUI has not fetched yet.
+    static constexpr int kFresh = 4;
+
+    std::vector<uint8_t> buffers_[3];
+    int back_ = 0;
+    int front_ = 1;
+    std::atomic<int> middle_{2};
+};
+
+struct EmulatorCommand {
+    enum Type {
+        kPause,
+        kResume,
+        // Replaces the joypads the emulator reads.
+        kJoypads,
+    };
+
+    Type type = kPause;
+    uint32_t joypads[4] = {};
+};
+
+// A bounded queue with a single producer, the GUI thread, and a single
+// consumer, the emulation thread.
+class CommandQueue {
+public:
+    // Returns false if the queue is full.
+    bool Push(EmulatorCommand command);
+    bool Pop(EmulatorCommand& command);
+    bool Empty() const;
+
+private:
+    static constexpr size_t kCapacity = 256;
+
+    std::array<EmulatorCommand, kCapacity> commands_;
+    // The next command to pop and the next slot to push, counting up.
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+class EmulatorThread {
+public:
+    // The emulator side, called on the emulation thread.
+    class Delegate {
+    public:
+        virtual ~Delegate() = default;
+
+        // Emulates one frame. Returns false if there was nothing to emulate;
+        // the thread then waits for the next command or Unpark().
+        virtual bool EmulateFrame() = 0;
+        virtual void OnPauseChanged(bool paused) = 0;
+        // A frame is waiting in the mailbox. Not called again until the GUI
+        // thread fetches it.
+        virtual void OnFramePublished() = 0;
+    };
+
+    // Parks the emulation thread for the lifetime of the object. Parks nest
+    // and may span Stop() and Start().
+    class Parked {
+    public:
+        explicit Parked(EmulatorThread& thread) : thread_(thread) { thread_.Park(); }
+        ~Parked() { thread_.Unpark(); }
+
+        Parked(const Parked&) = delete;
+        Parked& operator=(const Parked&) = delete;
+
+    private:
+        EmulatorThread& thread_;
+    };
+
+    explicit EmulatorThread(Delegate* delegate);
+    ~EmulatorThread();
+
+    EmulatorThread(const EmulatorThread&) = delete;
+    EmulatorThread& operator=(const EmulatorThread&) = delete;
+
+    // GUI thread.
+    // Starts emulating, with frames of `frame_size` bytes.
+    bool Start(size_t frame_size, bool paused);
+    // Waits for the current frame to end and drops the pending commands.
+    void Stop();
+    bool IsRunning() const { return worker_ != nullptr; }
+    // Returns false if the thread is not running or the queue is full.
+    bool Send(EmulatorCommand command);
+    void Park();
+    void Unpark();
+    // The newest frame, see FrameMailbox::Fetch().
+    const uint8_t* FetchFrame();
+
+    // Emulation thread.
+    // Copies the frame to the mailbox.
+    void PublishFrame(const uint8_t* pix);
+    // Pauses after the current frame, for frame advance.
+    void PauseNow();
+    // The joypad from the last kJoypads command.
+    uint32_t GetJoypad(int joy) const { return joypads_[joy & 3]; }
+
+private:
+    class Worker;
+
+    void Run();
+    void RunCommands();
+    void SetPaused(bool paused);
+
+    Delegate* const delegate_;
+    std::unique_ptr<Worker> worker_;
+    CommandQueue commands_;
+    FrameMailbox mailbox_;
+    std::atomic<bool> present_pending_{false};
+
+    // Owned by the emulation thread.
+    bool paused_ = false;
+    uint32_t joypads_[4] = {};
+
+    // Owned by the GUI thread.
+    int park_depth_ = 0;
+
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> park_requested_{false};
+    // The thread sleeps on `condition_` while parked, paused or idle.
+    wxMutex mutex_;
+    wxCondition condition_;
+    // Guarded by `mutex_`.
+    bool parked_ = false;
+};
+
+#endif  // VBAM_WX_EMULATOR_THREAD_H_
@@ -0,0 +1,129 @@
+#include "wx/frame-pacer.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "core/base/system.h"
+
+// Defined by the frontends.
+struct CoreOptions coreOptions;
+
+namespace {
+
+// The frame rate of both the GBA and the GB, 16777216 / 280896 Hz.
+constexpr double kFrameMs = 1000.0 * 280896 / 16777216;
+
+// Drives a pacer with a fake clock.
+class FramePacerTest : public testing::Test {
+protected:
+    FramePacerTest() : pacer_([this] { return time_; }) { coreOptions.throttle = 100; }
+
+    // Emulates a frame that takes `cpu_ms` of CPU time and ends `wall_ms`
+    // after the last one. Returns whether the next frame is rendered.
+    bool Frame(double cpu_ms, double wall_ms)
+    {
+        time_.cpu_ms += cpu_ms;
+        time_.wall_ms += wall_ms;
+        return pacer_.OnFrame();
+    }
+
+    // Emulates `count` frames throttled to full speed, each taking `cpu_ms`
+    // when rendered. Returns how many of them were rendered.
+    int ThrottledFrames(int count, double cpu_ms)
+    {
+        int rendered = 0;
+        for (int i = 0; i < count; i++) {
+            if (Frame(cpu_ms, kFrameMs))
+                rendered++;
+        }
+        return rendered;
+    }
+
+    FramePacer::Time time_{1000, 1000};
+    FramePacer pacer_;
+};
+
+TEST_F(FramePacerTest, RendersFramesOnSchedule)
+{
+    EXPECT_EQ(ThrottledFrames(120, 5), 120);
+}
+
+// Frames that take longer to render than a frame lasts are skipped, so that
+// emulation keeps up, but not more than kMaxSkip in a row.
+TEST_F(FramePacerTest, SkipsFramesToKeepUp)
+{
+    constexpr int kFrames = 600;
+    bool render = Frame(0, 0);
+    int rendered = 0;
+    int skipped = 0;
+    int most_skipped = 0;
+    const double start_ms = time_.wall_ms;
+    for (int i = 0; i < kFrames; i++) {
+        // not throttled by the sound driver, as emulation is behind
+        const double cost_ms = render ? 25 : 2;
+        render = Frame(cost_ms, cost_ms);
+        rendered += render;
+        skipped = render ? 0 : skipped + 1;
+        most_skipped = std::max(most_skipped, skipped);
+    }
+
+    EXPECT_GT(rendered, kFrames / 2);
+    EXPECT_LT(rendered, kFrames);
+    EXPECT_LE(most_skipped, FramePacer::kMaxSkip);
+    EXPECT_LE((time_.wall_ms - start_ms) / kFrames, kFrameMs * 1.05);
+}
+
+// However long rendering takes, a frame is rendered after kMaxSkip skipped
+// ones.
+TEST_F(FramePacerTest, RendersAfterMaxSkip)
+{
+    ASSERT_TRUE(Frame(0, 0));
+    ASSERT_TRUE(Frame(0, 0));
+    for (int round = 0; round < 5; round++) {
+        EXPECT_FALSE(Frame(1000, 1000));
+        for (int i = 1; i < FramePacer::kMaxSkip; i++)
+            EXPECT_FALSE(Frame(1, 1));
+        EXPECT_TRUE(Frame(1, 1));
+    }
+}
+
+// After a pause, the frames the pause took are not made up for by skipping.
+TEST_F(FramePacerTest, ResetForgetsSchedule)
+{
+    FramePacer unreset([this] { return time_; });
+    for (int i = 0; i < 60; i++) {
+        ASSERT_TRUE(Frame(5, kFrameMs));
+        ASSERT_TRUE(unreset.OnFrame());
+    }
+
+    time_.wall_ms += 10 * kFrameMs;
+    EXPECT_FALSE(Frame(5, kFrameMs));
+    EXPECT_FALSE(unreset.OnFrame());
+
+    pacer_.Reset();
+    EXPECT_TRUE(Frame(5, kFrameMs));
+}
+
+// No more frames are rendered than the display refreshes.
+TEST_F(FramePacerTest, CapsToDisplayRate)
+{
+    pacer_.SetDisplayRate(30);
+    // warm up: the first frame is rendered with no credit to spare
+    ThrottledFrames(2, 5);
+    EXPECT_NEAR(ThrottledFrames(120, 5), 120 * 30 * kFrameMs / 1000, 1);
+
+    pacer_.SetDisplayRate(144);
+    EXPECT_EQ(ThrottledFrames(120, 5), 120);
+}
+
+// Nor more than the GUI takes to present.
+TEST_F(FramePacerTest, CapsToPresentTime)
+{
+    pacer_.SetDisplayRate(60);
+    pacer_.OnPresent(0, 40);
+    ThrottledFrames(2, 5);
+    EXPECT_NEAR(ThrottledFrames(120, 5), 120 * kFrameMs / 40, 1);
+}
+
+}  // namespace
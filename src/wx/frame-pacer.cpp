@@ -0,0 +1,144 @@
+#include "wx/frame-pacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "core/base/system.h"
+
+namespace {
+
+// The frame rate of both the GBA and the GB, 16777216 / 280896 Hz.
+constexpr double kFrameMs = 1000.0 * 280896 / 16777216;
+// Weight of the newest frame in the running averages.
+constexpr double kSmoothing = 0.1;
+// Further behind than this, e.g. after a breakpoint, start over.
+constexpr int kResyncFrames = 30;
+
+// The CPU time of the calling thread. Unlike the wall clock, it leaves out
+// the time the emulation thread waits on the sound driver to throttle.
+double ThreadCpuMs()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 10000.0;
+#else
+    timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+FramePacer::Time Now()
+{
+    const auto wall = std::chrono::steady_clock::now().time_since_epoch();
+    return {std::chrono::duration<double, std::milli>(wall).count(), ThreadCpuMs()};
+}
+
+void Average(double& average, double value)
+{
+    average = average ? average + (value - average) * kSmoothing : value;
+}
+
+}  // namespace
+
+FramePacer::FramePacer() : FramePacer(Now) {}
+
+FramePacer::FramePacer(TimeSource time_source) : time_source_(std::move(time_source)) {}
+
+bool FramePacer::OnFrame()
+{
+    const Time now = time_source_();
+
+    if (started_)
+        Average(rendering_ ? render_ms_ : skip_ms_, now.cpu_ms - frame_start_ms_);
+
+    frame_start_ms_ = now.cpu_ms;
+
+    // unthrottled: no deadlines, only what the display can show
+    const bool throttled = coreOptions.throttle != 0;
+    const double frame_ms = throttled ? kFrameMs * 100 / coreOptions.throttle : kFrameMs;
+
+    if (!started_ || !throttled || now.wall_ms - deadline_ms_ > kResyncFrames * frame_ms)
+        deadline_ms_ = now.wall_ms;
+
+    started_ = true;
+    deadline_ms_ += frame_ms;
+
+    // time left to emulate the next frame on schedule
+    const double slack_ms = deadline_ms_ - now.wall_ms;
+
+    // When the GUI shares the only core, filtering takes from the same time.
+    static const bool shared_core = std::thread::hardware_concurrency() < 2;
+    const double render_cost_ms = render_ms_ + (shared_core ? filter_ms_.load() : 0);
+
+    // The GUI shows at most one frame per refresh, and no faster than it
+    // presents them.
+    const int display_hz = display_hz_.load();
+    const double present_ms = present_ms_.load();
+    double present_hz = display_hz > 0 ? display_hz : 1000.0 / kFrameMs;
+
+    if (present_ms > 0)
+        present_hz = std::min(present_hz, 1000.0 / present_ms);
+
+    // The part of a frame left over when one is shown carries on, so that
+    // e.g. 25 frames a second are shown rather than every third frame, but
+    // frames skipped for time do not bank more than one.
+    const double credit = present_hz * frame_ms / 1000;
+    present_credit_ = std::min(present_credit_ + credit, 1.0 + credit);
+
+    rendering_ = skipped_ >= kMaxSkip ||
+                 (present_credit_ > 0.999 && (!throttled || render_cost_ms <= slack_ms));
+
+    if (rendering_) {
+        present_credit_ -= 1;
+        skipped_ = 0;
+    } else {
+        skipped_++;
+    }
+
+    return rendering_;
+}
+
+void FramePacer::Reset()
+{
+    started_ = false;
+    rendering_ = true;
+    skipped_ = 0;
+    present_credit_ = 0;
+}
+
+void FramePacer::OnPresent(double filter_ms, double present_ms)
+{
+    // only written here, so the read-modify-write is safe
+    double filter = filter_ms_.load();
+    double present = present_ms_.load();
+    Average(filter, filter_ms);
+    Average(present, present_ms);
+    filter_ms_ = filter;
+    present_ms_ = present;
+}
+
+void FramePacer::SetDisplayRate(int hz)
+{
+    display_hz_ = hz;
+}
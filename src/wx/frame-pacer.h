@@ -0,0 +1,69 @@
+#ifndef VBAM_WX_FRAME_PACER_H_
+#define VBAM_WX_FRAME_PACER_H_
+
+#include <atomic>
+#include <functional>
+
+// Automatic frame skipping (frame skip -1). Once per emulated frame, decides
+// whether the core renders the next one, from what the recent frames cost:
+//   - the emulation thread CPU time of rendered and of skipped frames, which
+//     leaves out the time spent waiting on the sound driver,
+//   - the time the GUI thread takes to filter and present a frame,
+//   - the refresh rate of the display the window is on.
+// A frame is skipped when rendering it would miss its deadline, or when the
+// display or the GUI could not show it anyway.
+class FramePacer {
+public:
+    // The most frames skipped in a row, as with a fixed frame skip.
+    static constexpr int kMaxSkip = 9;
+
+    // The times OnFrame() goes by, in ms from an arbitrary start: the wall
+    // clock and the CPU time of the emulation thread.
+    struct Time {
+        double wall_ms;
+        double cpu_ms;
+    };
+    using TimeSource = std::function<Time()>;
+
+    // Reads the steady clock and the CPU time of the calling thread.
+    FramePacer();
+    // For tests.
+    explicit FramePacer(TimeSource time_source);
+
+    // Emulation thread.
+    // Called at the end of each emulated frame. Returns true if the next
+    // frame should be rendered.
+    bool OnFrame();
+    // Forgets the schedule, e.g. after a pause.
+    void Reset();
+
+    // GUI thread.
+    void OnPresent(double filter_ms, double present_ms);
+    // 0 if unknown.
+    void SetDisplayRate(int hz);
+
+private:
+    const TimeSource time_source_;
+
+    // Owned by the emulation thread.
+    bool started_ = false;
+    // The wall clock deadline of the frame being emulated.
+    double deadline_ms_ = 0;
+    // Thread CPU time at the start of the frame being emulated.
+    double frame_start_ms_ = 0;
+    // Whether the frame being emulated is rendered.
+    bool rendering_ = true;
+    int skipped_ = 0;
+    // Running averages of the CPU time of a frame.
+    double render_ms_ = 0;
+    double skip_ms_ = 0;
+    // Frames the GUI can show, accumulated over the emulated frames.
+    double present_credit_ = 0;
+
+    // Written by the GUI thread.
+    std::atomic<double> filter_ms_{0};
+    std::atomic<double> present_ms_{0};
+    std::atomic<int> display_hz_{0};
+};
+
+#endif  // VBAM_WX_FRAME_PACER_H_
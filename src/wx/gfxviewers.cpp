@@ -116,6 +116,10 @@ public:
         selx = sely = -1;
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewVram) | ViewMask(kViewPalette) | ViewMask(kViewIo);
+    }
     void Update()
     {
         mode = DISPCNT & 7;
@@ -642,6 +646,10 @@ public:
         selx = sely = -1;
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewVram) | ViewMask(kViewPalette) | ViewMask(kViewIo);
+    }
     void Update()
     {
         uint8_t *bank0, *bank1;
@@ -826,6 +834,12 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        // draws the sprites over the screen
+        return ViewMask(kViewVram) | ViewMask(kViewOam) | ViewMask(kViewPalette) | ViewMask(kViewIo) |
+               ViewMask(kViewScreen);
+    }
     void Update()
     {
         BMPSize(544, 496);
@@ -1070,6 +1084,10 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewVram) | ViewMask(kViewOam) | ViewMask(kViewPalette) | ViewMask(kViewIo);
+    }
     void Update()
     {
         uint8_t* bmp = image.GetData();
@@ -1282,6 +1300,10 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewPalette);
+    }
     void Update()
     {
         if (g_paletteRAM) {
@@ -1404,6 +1426,10 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewPalette);
+    }
     void Update()
     {
         uint16_t* pp = gbPalette;
@@ -1525,6 +1551,10 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewVram) | ViewMask(kViewPalette);
+    }
     void Update()
     {
         // Following copied almost verbatim from TileView.cpp
@@ -1714,6 +1744,10 @@ public:
         Fit();
         Update();
     }
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewVram) | ViewMask(kViewPalette) | ViewMask(kViewIo);
+    }
     void Update()
     {
         // following copied almost verbatim from GBTileView.cpp
@@ -798,7 +798,7 @@ public:
 
     // for enable/disable
     wxRadioButton *old_rb, *val_rb;
-    wxControl *update_b, *clear_b, *add_b;
+    wxControl *update_b, *clear_b, *undo_b, *add_b;
 
     bool isgb;
 
@@ -840,41 +840,7 @@ public:
             cheatSearchValue(&cheatSearchData, op, size, fmt == CFVFMT_SD,
                 SignedValue());
 
-        Deselect();
-        list->addrs.clear();
-        list->count8 = list->count16 = list->count32 = 0;
-        list->cap_size = size;
-
-        for (int i = 0; i < cheatSearchData.count; i++) {
-            CheatSearchBlock* block = &cheatSearchData.blocks[i];
-
-            for (int j = 0; j < block->size; j += (1 << size)) {
-                if (IS_BIT_SET(block->bits, j)) {
-                    list->addrs.push_back((i << 28) + j);
-
-                    if (!(j & 1))
-                        list->count16++;
-
-                    if (!(j & 3))
-                        list->count32++;
-
-// since listctrl is virtual, it should be able to handle
-// at least 256k results, which is about the most you
-// will ever get
-/*
-
-                                        if (list->addrs.size() > 1000)
-                                        {
-                                                wxLogError(_("Search produced %d results.  Please refine better"),
-                                                           list->addrs.size());
-                                                list->addrs.clear();
-                                                return;
-                                        }
-
-*/
-                }
-            }
-        }
+        ShowResults();
 
         if (list->addrs.empty()) {
             wxLogError(_("Search produced no results"));
@@ -891,22 +857,52 @@ public:
             update_b->Disable();
             clear_b->Disable();
         } else {
-            switch (size) {
-            case BITS_32:
-                list->count16 = list->count32 * 2;
-
-            // fall through
-            case BITS_16:
-                list->count8 = list->count16 * 2;
-                break;
-
-            case BITS_8:
-                list->count8 = list->addrs.size();
-            }
-
             old_rb->Enable();
             update_b->Enable();
             clear_b->Enable();
+            undo_b->Enable();
+        }
+    }
+
+    void UndoSearch(wxCommandEvent& ev)
+    {
+        (void)ev; // unused params
+        if (!cheatSearchUndo(&cheatSearchData))
+            return;
+
+        ShowResults();
+        undo_b->Enable(!cheatSearchData.history.empty());
+    }
+
+    // fill the list with the current candidates
+    void ShowResults()
+    {
+        Deselect();
+        list->addrs.clear();
+        list->count8 = list->count16 = list->count32 = 0;
+        list->cap_size = size;
+
+        for (uint32_t addr : cheatSearchGetResults(&cheatSearchData, size)) {
+            list->addrs.push_back(addr);
+
+            if (!(addr & 1))
+                list->count16++;
+
+            if (!(addr & 3))
+                list->count32++;
+        }
+
+        switch (size) {
+        case BITS_32:
+            list->count16 = list->count32 * 2;
+
+        // fall through
+        case BITS_16:
+            list->count8 = list->count16 * 2;
+            break;
+
+        case BITS_8:
+            list->count8 = list->addrs.size();
         }
 
         list->SetItemCount(list->addrs.size());
@@ -1001,6 +997,8 @@ public:
             update_b->Disable();
             clear_b->Disable();
         }
+
+        undo_b->Disable();
     }
 
     void Deselect()
@@ -2232,6 +2230,8 @@ bool MainFrame::BindControls()
             cf_enbutton("Update", update_b);
             cf_button("Clear", ResetSearch);
             cf_enbutton("Clear", clear_b);
+            cf_button("Undo", UndoSearch);
+            cf_enbutton("Undo", undo_b);
             cf_button("AddCheat", AddCheatB);
             cf_enbutton("AddCheat", add_b);
             d->Connect(wxEVT_COMMAND_LIST_ITEM_ACTIVATED,
@@ -433,6 +433,10 @@ void update_shortcut_opts() {
 
     if (game_bindings_changed) {
         wxGetApp().emulated_gamepad()->Reset();
+
+        if (wxGetApp().frame && wxGetApp().frame->GetPanel()) {
+            wxGetApp().frame->GetPanel()->SendJoypads();
+        }
     }
 
     cfg->Flush();
@@ -1,8 +1,10 @@
 #include "wx/wxvbam.h"
 
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #ifdef __WXGTK__
     #include <X11/Xlib.h>
@@ -28,6 +30,7 @@
 #include "core/base/check.h"
 #include "core/base/file_util.h"
 #include "core/base/patch.h"
+#include "core/base/sizes.h"
 #include "core/base/system.h"
 #include "core/base/version.h"
 #include "core/gb/gb.h"
@@ -121,6 +124,47 @@ long GetSampleRate() {
 
 #define out_16 (systemColorDepth == 16)
 
+using FilterFunc = void (*)(uint8_t*, uint32_t, uint8_t*, uint8_t*, uint32_t, int, int);
+
+// The xBRZ filters split the frame into jobs on the shared job pool
+// themselves and compute the blend info of each line once per frame. They
+// run on the whole frame once the filter threads are done with their bands:
+// each band would compute the blend info at its edges again, and the job
+// batches of the bands would only run one at a time on the pool.
+FilterFunc GetWholeFrameFilter() {
+    switch (OPTION(kDispFilter)) {
+        case config::Filter::kXbrz2x:
+            return xbrz2x32;
+        case config::Filter::kXbrz3x:
+            return xbrz3x32;
+        case config::Filter::kXbrz4x:
+            return xbrz4x32;
+        case config::Filter::kXbrz5x:
+            return xbrz5x32;
+        case config::Filter::kXbrz6x:
+            return xbrz6x32;
+        default:
+            return nullptr;
+    }
+}
+
+// The pitch of the frames drawn by the core.
+int GetFilterInStride(int width) {
+    const int inbpp = systemColorDepth >> 3;
+    const int inrb = systemColorDepth == 16   ? 2
+                     : systemColorDepth == 24 ? 0
+                                              : 1;
+    return (width + inrb) * inbpp;
+}
+
+// The offset of filtered line `y` in the output buffer.
+int GetFilterOutOffset(int outstride, int y, double scale) {
+    // FIXME: fugly hack
+    if (OPTION(kDispRenderMethod) == config::RenderMethod::kOpenGL)
+        return (int)std::ceil(outstride * (y + 1) * scale);
+    return (int)std::ceil(outstride * (y + (1 / scale)) * scale);
+}
+
 }  // namespace
 
 int emulating;
@@ -143,6 +187,11 @@ GameArea::GameArea()
       paused(false),
       pointer_blanked(false),
       mouse_active_time(0),
+      emulator_thread_(this),
+      battery_writer_([](const std::string& file) {
+          const wxString fn = wxString::FromUTF8(file.c_str());
+          wxGetApp().CallAfter([fn]() { wxLogError(_("Error writing battery %s"), fn.mb_str()); });
+      }),
       render_observer_({config::OptionID::kDispBilinear, config::OptionID::kDispFilter,
                         config::OptionID::kDispRenderMethod, config::OptionID::kDispIFB,
                         config::OptionID::kDispStretch, config::OptionID::kPrefVsync},
@@ -394,6 +443,7 @@ void GameArea::LoadGame(const wxString& name)
                 coreOptions.saveType = ovSaveType;
 
             coreOptions.mirroringEnable = cfg->Read(wxT("mirroringEnabled"), (long)1);
+            coreOptions.accurateRendering = cfg->Read(wxT("accurateRendering"), (long)0);
             cfg->SetPath(wxT("/"));
         } else {
             rtcEnable(coreOptions.rtcEnabled);
@@ -408,6 +458,7 @@ void GameArea::LoadGame(const wxString& name)
                 coreOptions.saveType = coreOptions.cpuSaveType;
 
             coreOptions.mirroringEnable = false;
+            coreOptions.accurateRendering = false;
         }
 
         doMirroring(coreOptions.mirroringEnable);
@@ -575,6 +626,19 @@ void GameArea::LoadGame(const wxString& name)
         mf->GDBBreak();
     }
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+    // the size of g_pix, as allocated by the cores
+    present_size_ = loaded == IMAGE_GB ? kGBPixSize : 4 * 241 * 162;
+    present_pix_ = (uint8_t*)calloc(1, present_size_);
+
+    if (!present_pix_ || !emulator_thread_.Start(present_size_, paused)) {
+        wxLogError(_("Could not start the emulation thread"));
+        UnloadGame();
+        return;
+    }
+
+    UpdateDisplayRate();
+    SendJoypads();
 }
 
 void GameArea::SetFrameTitle()
@@ -633,6 +697,8 @@ void GameArea::UnloadGame(bool destruct)
     if (!emulating)
         return;
 
+    emulator_thread_.Stop();
+
     // last opportunity to autosave cheats
     if (OPTION(kPrefAutoSaveLoadCheatList) && cheats_dirty) {
         wxFileName cfn = loaded_game;
@@ -658,6 +724,9 @@ void GameArea::UnloadGame(bool destruct)
         SaveBattery();
     }
 
+    // the next game may be this one again, with the same battery file
+    battery_writer_.Flush();
+
     MainFrame* mf = wxGetApp().frame;
 #ifndef NO_FFMPEG
     snd_rec.Stop();
@@ -668,6 +737,7 @@ void GameArea::UnloadGame(bool destruct)
 
 #if defined(VBAM_ENABLE_DEBUGGER)
     debugger = false;
+    gdb_break_ = false;
     remoteCleanUp();
     mf->cmd_enable |= CMDEN_NGDB_ANY;
 #endif  // VBAM_ENABLE_DEBUGGER
@@ -689,6 +759,9 @@ void GameArea::UnloadGame(bool destruct)
     emusys = NULL;
     soundShutdown();
 
+    free(present_pix_);
+    present_pix_ = nullptr;
+
     disableKeyboardBackgroundInput();
 
     if (destruct)
@@ -733,6 +806,7 @@ bool GameArea::LoadState(int slot)
 
 bool GameArea::LoadState(const wxFileName& fname)
 {
+    EmulatorThread::Parked parked(emulator_thread_);
     // FIXME: first save to backup state if not backup state
     bool ret = emusys->emuReadState(UTF8(fname.GetFullPath()));
 
@@ -780,6 +854,7 @@ bool GameArea::SaveState(int slot)
 
 bool GameArea::SaveState(const wxFileName& fname)
 {
+    EmulatorThread::Parked parked(emulator_thread_);
     // FIXME: first copy to backup state if not backup state
     bool ret = emusys->emuWriteState(UTF8(fname.GetFullPath()));
     wxGetApp().frame->update_state_ts(true);
@@ -811,8 +886,12 @@ void GameArea::SaveBattery()
     // FIXME: add option to support ring of backups
     // of course some games just write battery way too often for such
     // a thing to be useful
-    if (!emusys->emuWriteBattery(UTF8(fn)))
+    std::vector<uint8_t> image;
+
+    if (!emusys->emuWriteBatteryMem(image))
         wxLogError(_("Error writing battery %s"), fn.mb_str());
+    else if (!image.empty())
+        battery_writer_.Write(UTF8(fn).data(), std::move(image));
 
     systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 }
@@ -1068,6 +1147,7 @@ GameArea::~GameArea()
 void GameArea::OnKillFocus(wxFocusEvent& ev)
 {
     wxGetApp().emulated_gamepad()->Reset();
+    SendJoypads();
     ev.Skip();
 }
 
@@ -1078,8 +1158,11 @@ void GameArea::Pause()
 
     // don't pause when linked
 #ifndef NO_LINK
-    if (GetLinkMode() != LINK_DISCONNECTED)
+    if (GetLinkMode() != LINK_DISCONNECTED) {
+        // undo the pause of a frame advance, see systemPauseOnFrame()
+        emulator_thread_.Send({EmulatorCommand::kResume});
         return;
+    }
 #endif
 
     paused = was_paused = true;
@@ -1089,8 +1172,12 @@ void GameArea::Pause()
     // input to remain pressed, because they could be released
     // outside of the game zone and we would not know about it.
     wxGetApp().emulated_gamepad()->Reset();
+    SendJoypads();
 
-    if (loaded != IMAGE_UNKNOWN)
+    // the emulation thread pauses the sound itself, see OnPauseChanged()
+    if (emulator_thread_.IsRunning())
+        emulator_thread_.Send({EmulatorCommand::kPause});
+    else if (loaded != IMAGE_UNKNOWN)
         soundPause();
 }
 
@@ -1103,13 +1190,128 @@ void GameArea::Resume()
     SuspendScreenSaver();
     SetExtraStyle(GetExtraStyle() | wxWS_EX_PROCESS_IDLE);
 
-    if (loaded != IMAGE_UNKNOWN)
+    if (emulator_thread_.IsRunning())
+        emulator_thread_.Send({EmulatorCommand::kResume});
+    else if (loaded != IMAGE_UNKNOWN)
         soundResume();
 
     SetFocus();
 }
 
-void GameArea::OnIdle(wxIdleEvent& event)
+void GameArea::SendJoypads()
+{
+    EmulatorCommand command{EmulatorCommand::kJoypads};
+
+    for (int i = 0; i < 4; i++)
+        command.joypads[i] = wxGetApp().emulated_gamepad()->GetJoypad(i);
+
+    emulator_thread_.Send(std::move(command));
+}
+
+bool GameArea::EmulateFrame()
+{
+#if defined(VBAM_ENABLE_DEBUGGER)
+    // the GDB stub runs the game from OnIdle(), on the GUI thread, which
+    // is woken up in case it has nothing else to do
+    if (debugger) {
+        if (!gdb_break_.exchange(true))
+            wxWakeUpIdle();
+        return false;
+    }
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+    emusys->emuMain(emusys->emuCount);
+#ifndef NO_LINK
+
+    if (loaded == IMAGE_GBA && GetLinkMode() != LINK_DISCONNECTED)
+        CheckLinkConnection();
+
+#endif
+
+    if (do_rewind)
+        WriteRewindState();
+
+    return true;
+}
+
+void GameArea::OnPauseChanged(bool paused_now)
+{
+    if (paused_now)
+        soundPause();
+    else
+        soundResume();
+}
+
+void GameArea::OnFramePublished()
+{
+    CallAfter(&GameArea::PresentFrame);
+}
+
+void GameArea::PresentFrame()
+{
+    // fetch even without a panel, so that the next frame is announced
+    const uint8_t* frame = emulator_thread_.IsRunning() ? emulator_thread_.FetchFrame() : nullptr;
+
+    if (!frame || !panel)
+        return;
+
+    memcpy(present_pix_, frame, present_size_);
+
+    wxGetApp().frame->UpdateViewers();
+
+    const auto start = std::chrono::steady_clock::now();
+    panel->DrawArea(&present_pix_);
+    frame_pacer_.OnPresent(panel->filter_ms(), std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+void GameArea::UpdateDisplayRate()
+{
+    const int display = wxDisplay::GetFromWindow(this);
+    frame_pacer_.SetDisplayRate(display == wxNOT_FOUND ? 0 : wxDisplay(display).GetCurrentMode().refresh);
+}
+
+void GameArea::WriteRewindState()
+{
+    do_rewind = false;
+
+    if (!emusys->emuWriteMemState)
+        return;
+
+    if (!rewind_mem) {
+        rewind_mem = (char*)malloc(NUM_REWINDS * REWIND_SIZE);
+        num_rewind_states = next_rewind_state = 0;
+    }
+
+    if (!rewind_mem) {
+        wxLogError(_("No memory for rewinding"));
+        CallAfter([]() { wxGetApp().frame->Close(true); });
+        return;
+    }
+
+    long resize;
+
+    if (!emusys->emuWriteMemState(&rewind_mem[REWIND_SIZE * next_rewind_state],
+            REWIND_SIZE, resize /* actual size */))
+        // if you see a lot of these, maybe increase REWIND_SIZE
+        wxLogInfo(_("Error writing rewind state"));
+    else {
+        if (!num_rewind_states) {
+            CallAfter([]() {
+                MainFrame* mf = wxGetApp().frame;
+                mf->cmd_enable |= CMDEN_REWIND;
+                mf->enable_menus();
+            });
+        }
+
+        if (num_rewind_states < NUM_REWINDS)
+            ++num_rewind_states;
+
+        next_rewind_state = (next_rewind_state + 1) % NUM_REWINDS;
+    }
+}
+
+void GameArea::OnIdle([[maybe_unused]] wxIdleEvent& event)
 {
     wxString pl = wxGetApp().pending_load;
     MainFrame* mf = wxGetApp().frame;
@@ -1121,11 +1323,14 @@ void GameArea::OnIdle(wxIdleEvent& event)
         LoadGame(pl);
 
 #if defined(VBAM_ENABLE_DEBUGGER)
+        bool gdb_break = false;
         if (OPTION(kPrefGDBBreakOnLoad)) {
+            EmulatorThread::Parked parked(emulator_thread_);
             mf->GDBBreak();
+            gdb_break = debugger;
         }
 
-        if (debugger && loaded != IMAGE_GBA) {
+        if (gdb_break && loaded != IMAGE_GBA) {
             wxLogError(_("Not a valid Game Boy Advance cartridge"));
             UnloadGame();
         }
@@ -1149,6 +1354,7 @@ void GameArea::OnIdle(wxIdleEvent& event)
         return;
 
     if (schedule_audio_restart_) {
+        EmulatorThread::Parked parked(emulator_thread_);
         soundShutdown();
         if (!soundInit()) {
             wxLogError(_("Could not initialize the sound driver!"));
@@ -1255,12 +1461,30 @@ void GameArea::OnIdle(wxIdleEvent& event)
     if (!paused) {
         HidePointer();
         HideMenuBar();
-        event.RequestMore();
 
+        // the emulation thread runs the game, this only draws its frames
+        // (see PresentFrame()), except for the GDB stub, which stays here:
+        // GDB is only talked to on this thread
 #if defined(VBAM_ENABLE_DEBUGGER)
-        if (debugger) {
+        if (!gdb_break_ && debugInputPending()) {
+            EmulatorThread::Parked parked(emulator_thread_);
+            if (!debugger)
+                remoteReadInterrupt();
+            gdb_break_ = debugger;
+        }
+
+        if (gdb_break_) {
+            event.RequestMore();
             was_paused = true;
-            dbgMain();
+
+            {
+                EmulatorThread::Parked parked(emulator_thread_);
+                if (debugger) {
+                    debugReportSignal();
+                    dbgMain();
+                }
+                gdb_break_ = debugger;
+            }
 
             if (!emulating) {
                 emulating = true;
@@ -1271,14 +1495,6 @@ void GameArea::OnIdle(wxIdleEvent& event)
             return;
         }
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
-
-        emusys->emuMain(emusys->emuCount);
-#ifndef NO_LINK
-
-        if (loaded == IMAGE_GBA && GetLinkMode() != LINK_DISCONNECTED)
-            CheckLinkConnection();
-
-#endif
     } else {
         was_paused = true;
 
@@ -1287,39 +1503,6 @@ void GameArea::OnIdle(wxIdleEvent& event)
 
         ShowMenuBar();
     }
-
-    if (do_rewind && emusys->emuWriteMemState) {
-        if (!rewind_mem) {
-            rewind_mem = (char*)malloc(NUM_REWINDS * REWIND_SIZE);
-            num_rewind_states = next_rewind_state = 0;
-        }
-
-        if (!rewind_mem) {
-            wxLogError(_("No memory for rewinding"));
-            wxGetApp().frame->Close(true);
-            return;
-        }
-
-        long resize;
-
-        if (!emusys->emuWriteMemState(&rewind_mem[REWIND_SIZE * next_rewind_state],
-                REWIND_SIZE, resize /* actual size */))
-            // if you see a lot of these, maybe increase REWIND_SIZE
-            wxLogInfo(_("Error writing rewind state"));
-        else {
-            if (!num_rewind_states) {
-                mf->cmd_enable |= CMDEN_REWIND;
-                mf->enable_menus();
-            }
-
-            if (num_rewind_states < NUM_REWINDS)
-                ++num_rewind_states;
-
-            next_rewind_state = (next_rewind_state + 1) % NUM_REWINDS;
-        }
-
-        do_rewind = false;
-    }
 }
 
 static void draw_black_background(wxWindow* win) {
@@ -1352,6 +1535,7 @@ void GameArea::OnUserInput(widgets::UserInputEvent& event) {
     }
 
     if (emulated_key_pressed) {
+        SendJoypads();
         wxWakeUpIdle();
 
 #if defined(__WXGTK__) && defined(HAVE_X11) && !defined(HAVE_XSS)
@@ -1545,22 +1729,12 @@ public:
         // threadno == -1 means just do a dummy round on the border line
         const int procy = height_ * threadno_ / nthreads_;
         height_ = height_ * (threadno_ + 1) / nthreads_ - procy;
-        const int inbpp = systemColorDepth >> 3;
-        const int inrb = systemColorDepth == 16   ? 2
-                         : systemColorDepth == 24 ? 0
-                                                  : 1;
-        const int instride = (width_ + inrb) * inbpp;
+        const int instride = GetFilterInStride(width_);
         const int outbpp = out_16 ? 2 : systemColorDepth == 24 ? 3 : 4;
         const int outrb = systemColorDepth == 24 ? 0 : 4;
         const int outstride = std::ceil(width_ * outbpp * scale_) + outrb;
         delta_ += instride * procy;
-
-        // FIXME: fugly hack
-        if (OPTION(kDispRenderMethod) == config::RenderMethod::kOpenGL) {
-            dst_ += (int)std::ceil(outstride * (procy + 1) * scale_);
-        } else {
-            dst_ += (int)std::ceil(outstride * (procy + (1 / scale_)) * scale_);
-        }
+        dst_ += GetFilterOutOffset(outstride, procy, scale_);
 
         while (nthreads_ == 1 || sig_.Wait() == wxCOND_NO_ERROR) {
             if (!src_ /* && nthreads > 1 */) {
@@ -1575,7 +1749,7 @@ public:
             // added procy param to provide offset into accum buffers
             ApplyInterframe(instride, procy);
 
-            if (OPTION(kDispFilter) == config::Filter::kNone) {
+            if (OPTION(kDispFilter) == config::Filter::kNone || GetWholeFrameFilter()) {
                 if (nthreads_ == 1)
                     return 0;
 
@@ -1713,31 +1887,6 @@ private:
                           height_);
                 break;
 
-            case config::Filter::kXbrz2x:
-                xbrz2x32(src_, instride, delta_, dst_, outstride, width_,
-                         height_);
-                break;
-
-            case config::Filter::kXbrz3x:
-                xbrz3x32(src_, instride, delta_, dst_, outstride, width_,
-                         height_);
-                break;
-
-            case config::Filter::kXbrz4x:
-                xbrz4x32(src_, instride, delta_, dst_, outstride, width_,
-                         height_);
-                break;
-
-            case config::Filter::kXbrz5x:
-                xbrz5x32(src_, instride, delta_, dst_, outstride, width_,
-                         height_);
-                break;
-
-            case config::Filter::kXbrz6x:
-                xbrz6x32(src_, instride, delta_, dst_, outstride, width_,
-                         height_);
-                break;
-
             case config::Filter::kPlugin:
                 // MFC interface did not do plugins in parallel
                 // Probably because it's almost certain they carry state
@@ -1765,6 +1914,12 @@ private:
                 rpi_->Output(&outdesc);
                 break;
 
+            // Run by DrawArea(), see GetWholeFrameFilter().
+            case config::Filter::kXbrz2x:
+            case config::Filter::kXbrz3x:
+            case config::Filter::kXbrz4x:
+            case config::Filter::kXbrz5x:
+            case config::Filter::kXbrz6x:
             case config::Filter::kNone:
             case config::Filter::kLast:
                 VBAM_NOTREACHED();
@@ -1805,6 +1960,8 @@ void DrawingPanelBase::DrawArea(uint8_t** data)
     // FIXME: filters race condition?
     const int max_threads = 1;
 
+    const auto filter_start = std::chrono::steady_clock::now();
+
     // First, apply filters, if applicable, in parallel, if enabled
     // FIXME: && (gopts.ifb != FF_MOTION_BLUR || !renderer_can_motion_blur)
     if (OPTION(kDispFilter) != config::Filter::kNone ||
@@ -1877,8 +2034,17 @@ void DrawingPanelBase::DrawArea(uint8_t** data)
             for (int i = 0; i < nthreads; i++)
                 filt_done.Wait();
         }
+
+        if (const FilterFunc filter = GetWholeFrameFilter()) {
+            const int instride = GetFilterInStride(width);
+            filter(*data + instride, instride, delta, todraw + GetFilterOutOffset(outstride, 0, scale),
+                   outstride, width, height);
+        }
     }
 
+    filter_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - filter_start).count();
+
     // swap buffers now that src has been processed
     if (OPTION(kDispFilter) == config::Filter::kNone) {
         *data = pixbuf1;
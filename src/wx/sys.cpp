@@ -47,6 +47,32 @@ bool turbo;
 // and this is from MFC interface
 bool soundBufferLow;
 
+namespace {
+
+// The core calls the functions below on the emulation thread while a game
+// runs, and on the GUI thread otherwise. This runs `fn` on the GUI thread:
+// now, or once the GUI gets to it.
+template <typename F>
+void RunOnGuiThread(F fn)
+{
+    if (wxIsMainThread())
+        fn();
+    else
+        wxGetApp().CallAfter(fn);
+}
+
+// The emulation thread reads the copy of the gamepad sent to it with every
+// change, see GameArea::SendJoypads().
+uint32_t GetEmulatedJoypad(int joy)
+{
+    if (wxIsMainThread())
+        return wxGetApp().emulated_gamepad()->GetJoypad(joy);
+
+    return wxGetApp().frame->GetPanel()->emulator_thread().GetJoypad(joy);
+}
+
+}  // namespace
+
 void systemMessage(int id, const char* fmt, ...)
 {
     (void)id; // unused params
@@ -96,7 +122,6 @@ void systemDrawScreen()
 {
     frames++;
     MainFrame* mf = wxGetApp().frame;
-    mf->UpdateViewers();
     // FIXME: Sm60FPS crap and sondBufferLow crap
     GameArea* ga = mf->GetPanel();
 #ifndef NO_FFMPEG
@@ -106,6 +131,14 @@ void systemDrawScreen()
 
 #endif
 
+    if (!wxIsMainThread()) {
+        // the GUI draws it and updates the viewers
+        ga->emulator_thread().PublishFrame(g_pix);
+        return;
+    }
+
+    mf->UpdateViewers();
+
     if (ga && ga->panel)
         ga->panel->DrawArea(&g_pix);
 }
@@ -323,10 +356,13 @@ void systemStopGamePlayback()
 
     game_file.Close();
     game_playback = false;
-    MainFrame* mf = wxGetApp().frame;
-    mf->cmd_enable &= ~CMDEN_GPLAY;
-    mf->cmd_enable |= CMDEN_NGREC | CMDEN_NGPLAY;
-    mf->enable_menus();
+    // called by systemReadJoypad() at the end of the recording
+    RunOnGuiThread([]() {
+        MainFrame* mf = wxGetApp().frame;
+        mf->cmd_enable &= ~CMDEN_GPLAY;
+        mf->cmd_enable |= CMDEN_NGREC | CMDEN_NGPLAY;
+        mf->enable_menus();
+    });
 }
 
 // updates the joystick data (done in background using wxJoyPoller)
@@ -341,7 +377,7 @@ uint32_t systemReadJoypad(int joy)
     if (joy < 0 || joy > 3)
         joy = OPTION(kJoyDefault) - 1;
 
-    uint32_t ret = wxGetApp().emulated_gamepad()->GetJoypad(joy);
+    uint32_t ret = GetEmulatedJoypad(joy);
 
     if (turbo)
         ret |= KEYM_SPEED;
@@ -453,26 +489,35 @@ uint32_t systemReadJoypad(int joy)
 
 void systemShowSpeed(int speed)
 {
-    MainFrame* f = wxGetApp().frame;
+    // automatic frame skip changes it every frame, show the average
+    int frame_skip = systemFrameSkip;
+
+    if (OPTION(kPrefFrameSkip) == -1)
+        frame_skip = frames ? (60 - frames) / frames : FramePacer::kMaxSkip;
+
     wxString s;
-    s.Printf(_("%d %% (%d, %d fps)"), speed, systemFrameSkip, frames * speed / 100);
+    s.Printf(_("%d %% (%d, %d fps)"), speed, frame_skip, frames * speed / 100);
+    frames = 0;
 
-    switch (OPTION(kPrefShowSpeed)) {
-    case SS_NONE:
-        f->GetPanel()->osdstat.clear();
-        break;
+    RunOnGuiThread([speed, s]() {
+        MainFrame* f = wxGetApp().frame;
 
-    case SS_PERCENT:
-        f->GetPanel()->osdstat.Printf("%d %%", speed);
-        break;
+        switch (OPTION(kPrefShowSpeed)) {
+        case SS_NONE:
+            f->GetPanel()->osdstat.clear();
+            break;
 
-    case SS_DETAILED:
-        f->GetPanel()->osdstat = s;
-        break;
-    }
+        case SS_PERCENT:
+            f->GetPanel()->osdstat.Printf("%d %%", speed);
+            break;
 
-    wxGetApp().frame->SetStatusText(s, 1);
-    frames = 0;
+        case SS_DETAILED:
+            f->GetPanel()->osdstat = s;
+            break;
+        }
+
+        f->SetStatusText(s, 1);
+    });
 }
 
 int systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
@@ -480,54 +525,6 @@ int systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 void system10Frames() {
     GameArea* panel = wxGetApp().frame->GetPanel();
 
-    if (OPTION(kPrefFrameSkip) == -1) {
-        // We keep a rolling mean of the last second and use this value to
-        // adjust the systemFrameSkip value dynamically.
-
-        // Target time in ms for 10 frames at 60 FPS.
-        constexpr int kTarget = 10 * 1000 / 60;
-
-        static uint32_t prevclock = 0;
-        static int speedadj = 0;
-        static int last_second[6] = {kTarget, kTarget, kTarget,
-                                    kTarget, kTarget, kTarget};
-        static size_t last_index = 0;
-
-        const uint32_t timestamp = systemGetClock();
-
-        if (!panel->was_paused && prevclock) {
-            last_second[last_index] = systemGetClock() - prevclock;
-            last_index = (last_index + 1) % 6;
-
-            int average = 0;
-            for (size_t i = 0; i < 6; i++) {
-                average += last_second[i];
-            }
-            average /= 6;
-
-            const int speed = (kTarget * 100) / average;
-
-            // why 98??
-            if (speed >= 98)
-                speedadj++;
-            else if (speed < 80)
-                speedadj -= (90 - speed) / 10;
-            else
-                speedadj--;
-
-            if (speedadj >= 3) {
-                speedadj = 0;
-                systemFrameSkip = std::max(systemFrameSkip - 1, 0);
-            } else if (speedadj <= -2) {
-                speedadj += 2;
-                systemFrameSkip = std::min(systemFrameSkip + 1, 9);
-            }
-        }
-
-        prevclock = timestamp;
-        panel->was_paused = false;
-    }
-
     if (gopts.rewind_interval) {
         if (!panel->rewind_time)
             panel->rewind_time = gopts.rewind_interval * 6;
@@ -545,6 +542,15 @@ void systemFrame()
 {
     if (game_recording || game_playback)
         game_frame++;
+
+    if (OPTION(kPrefFrameSkip) == -1) {
+        GameArea* panel = wxGetApp().frame->GetPanel();
+
+        if (panel->was_paused.exchange(false))
+            panel->frame_pacer().Reset();
+
+        systemFrameSkip = panel->frame_pacer().OnFrame() ? 0 : FramePacer::kMaxSkip;
+    }
 }
 
 // technically, num is ignored in favor of finding the first
@@ -597,7 +603,7 @@ uint32_t systemGetClock()
 
 void systemCartridgeRumble(bool b)
 {
-    wxGetApp().sdl_poller()->SetRumble(b);
+    RunOnGuiThread([b]() { wxGetApp().sdl_poller()->SetRumble(b); });
 }
 
 static uint8_t sensorDarkness = 0xE8; // total darkness (including daylight on rainy days)
@@ -663,7 +669,7 @@ void systemUpdateSolarSensor()
 void systemUpdateMotionSensor()
 {
     for (int i = 0; i < 4; i++) {
-        const uint32_t joy_value = wxGetApp().emulated_gamepad()->GetJoypad(i);
+        const uint32_t joy_value = GetEmulatedJoypad(i);
 
         if (!sensorx[i])
             sensorx[i] = 2047;
@@ -1039,6 +1045,17 @@ void PrintDialog::DoPrint(wxCommandEvent&)
 
 void systemGbPrint(uint8_t* data, int len, int pages, int feed, int pal, int cont)
 {
+    if (!wxIsMainThread()) {
+        // the printer dialog blocks the game, as it did before it had a
+        // thread of its own
+        std::vector<uint8_t> copy(data, data + len);
+        wxGetApp().CallAfter([copy, len, pages, feed, pal, cont]() mutable {
+            EmulatorThread::Parked parked(wxGetApp().frame->GetPanel()->emulator_thread());
+            systemGbPrint(copy.data(), len, pages, feed, pal, cont);
+        });
+        return;
+    }
+
     (void)pages; // unused params
     (void)cont; // unused params
     ModalPause mp; // this might take a while, so signal a pause
@@ -1171,6 +1188,11 @@ void systemGbPrint(uint8_t* data, int len, int pages, int feed, int pal, int con
 
 void systemScreenMessage(const wxString& msg)
 {
+    if (!wxIsMainThread()) {
+        wxGetApp().CallAfter([msg]() { systemScreenMessage(msg); });
+        return;
+    }
+
     if (wxGetApp().frame && wxGetApp().frame->IsShown()) {
         wxPuts(UTF8(msg)); // show **something** on terminal
         MainFrame* f = wxGetApp().frame;
@@ -1209,8 +1231,16 @@ bool systemPauseOnFrame()
 {
     if (pause_next) {
         pause_next = false;
-        MainFrame* fr = wxGetApp().frame;
-        fr->GetPanel()->Pause();
+        GameArea* panel = wxGetApp().frame->GetPanel();
+
+        if (wxIsMainThread()) {
+            panel->Pause();
+        } else {
+            // stop right after this frame; the GUI catches up
+            panel->emulator_thread().PauseNow();
+            panel->CallAfter(&GameArea::Pause);
+        }
+
         return true;
     }
 
@@ -1219,10 +1249,15 @@ bool systemPauseOnFrame()
 
 void systemGbBorderOn()
 {
-    GameArea* panel = wxGetApp().frame->GetPanel();
+    RunOnGuiThread([]() {
+        GameArea* panel = wxGetApp().frame->GetPanel();
 
-    if (panel)
-        panel->AddBorder();
+        if (panel) {
+            // the border changes the layout the core draws to
+            EmulatorThread::Parked parked(panel->emulator_thread());
+            panel->AddBorder();
+        }
+    });
 }
 
 class SoundDriver;
@@ -1255,6 +1290,10 @@ extern int (*remoteSendFnc)(char*, int);
 extern int (*remoteRecvFnc)(char*, int);
 extern void (*remoteCleanUpFnc)();
 
+// Whether GDB sent anything, checked by debugInputPending(). The core does not
+// get it, so that it never reads the connection from the emulation thread.
+static bool (*debugPendingFnc)() = NULL;
+
 #ifndef __WXMSW__
 #include <errno.h>
 #include <fcntl.h>
@@ -1278,6 +1317,14 @@ static int debugReadPty(char* buf, int len)
     }
 }
 
+static bool debugPendingPty()
+{
+    struct pollfd fd;
+    fd.fd = pty_master;
+    fd.events = POLLIN;
+    return poll(&fd, 1, 0) > 0;
+}
+
 static int debugWritePty(/* const */ char* buf, int len)
 {
     return write(pty_master, buf, len);
@@ -1315,6 +1362,7 @@ bool debugOpenPty()
     remoteSendFnc = debugWritePty;
     remoteRecvFnc = debugReadPty;
     remoteCleanUpFnc = debugClosePty;
+    debugPendingFnc = debugPendingPty;
     return true;
 }
 
@@ -1363,6 +1411,11 @@ static int debugReadSock(char* buf, int len)
     return debug_remote->LastCount();
 }
 
+static bool debugPendingSock()
+{
+    return debug_remote && debug_remote->WaitForRead(0, 0);
+}
+
 static int debugWriteSock(char* buf, int len)
 {
     debug_remote->SetFlags(wxSOCKET_WAITALL | wxSOCKET_BLOCK);
@@ -1394,6 +1447,7 @@ bool debugStartListen(int port)
     remoteSendFnc = debugWriteSock;
     remoteRecvFnc = debugReadSock;
     remoteCleanUpFnc = debugCloseSock;
+    debugPendingFnc = debugPendingSock;
 
     if (debug_server->IsOk())
         return true;
@@ -1415,6 +1469,56 @@ bool debugWaitSocket()
     return debug_remote != NULL;
 }
 
+bool debugInputPending()
+{
+    return debugPendingFnc && debugPendingFnc();
+}
+
+// The stub only talks to GDB from the GUI thread, so breaks and output from
+// the emulation thread are handed over to it.
+static int debug_signal = 0;
+static int debug_signal_number = 0;
+
+void debugDeferSignal(int sig, int number)
+{
+    if (wxIsMainThread()) {
+        remoteStubSignal(sig, number);
+        return;
+    }
+
+    // read by debugReportSignal() once the emulation thread is parked
+    debug_signal = sig;
+    debug_signal_number = number;
+    debugger = true;
+}
+
+void debugReportSignal()
+{
+    if (!debug_signal)
+        return;
+
+    remoteStubSignal(debug_signal, debug_signal_number);
+    debug_signal = 0;
+}
+
+void debugDeferOutput(const char* s, uint32_t addr)
+{
+    std::string text;
+
+    if (s) {
+        text = s;
+    } else {
+        for (char c; (c = map[addr >> 24].address[addr & map[addr >> 24].mask]); addr++)
+            text += c;
+    }
+
+    RunOnGuiThread([text]() {
+        // GDB may have disconnected in the meantime
+        if (dbgOutput == debugDeferOutput)
+            remoteOutput(text.c_str(), 0);
+    });
+}
+
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
 void log(const char* defaultMsg, ...)
@@ -1425,15 +1529,18 @@ void log(const char* defaultMsg, ...)
     vsnprintf(buf, 2048, defaultMsg, valist);
     wxString msg = wxString(buf, wxConvUTF8);
     va_end(valist);
-    wxGetApp().log.append(msg);
 
-    if (wxGetApp().IsMainLoopRunning()) {
-        LogDialog* d = wxGetApp().frame->logdlg.get();
+    RunOnGuiThread([msg]() {
+        wxGetApp().log.append(msg);
 
-        if (d && d->IsShown()) {
-            d->Update();
-        }
+        if (wxGetApp().IsMainLoopRunning()) {
+            LogDialog* d = wxGetApp().frame->logdlg.get();
 
-        systemScreenMessage(msg);
-    }
+            if (d && d->IsShown()) {
+                d->Update();
+            }
+
+            systemScreenMessage(msg);
+        }
+    });
 }
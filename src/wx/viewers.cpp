@@ -454,6 +454,10 @@ public:
         Update(sel);
     }
 
+    uint32_t Watched() const
+    {
+        return ViewMask(kViewIo);
+    }
     void Update() { Update(addr_->GetSelection()); }
 
     void Update(int sel)
@@ -1,10 +1,125 @@
 #include "wx/viewsupt.h"
 
+#include <cstring>
+
+#include "core/base/sizes.h"
+#include "core/gb/gbGlobals.h"
+#include "core/gba/gbaGlobals.h"
 #include "wx/config/option-proxy.h"
 #include "wx/config/user-input.h"
 #include "wx/wxvbam.h"
 
+namespace {
+
+uint64_t Fingerprint(const uint8_t* data, size_t size)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0x100000001b3ull;
+        h ^= h >> 32;
+    }
+
+    for (; i < size; i++)
+        h = (h ^ data[i]) * 0x100000001b3ull;
+
+    return h;
+}
+
+}  // namespace
+
 namespace Viewers {
+uint64_t RegionFingerprints::Get(ViewedRegion region)
+{
+    if (computed_ & ViewMask(region))
+        return values_[region];
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    if (wxGetApp().frame->GetPanel()->game_type() == IMAGE_GBA) {
+        switch (region) {
+        case kViewVram:
+            data = g_vram;
+            size = 0x20000;
+            break;
+        case kViewOam:
+            data = g_oam;
+            size = 0x400;
+            break;
+        case kViewPalette:
+            data = g_paletteRAM;
+            size = 0x400;
+            break;
+        case kViewScreen:
+            data = g_pix;
+            size = 4 * 241 * 162;
+            break;
+        default:
+            data = g_ioMem;
+            size = 0x400;
+            break;
+        }
+    } else if (gbMemory) {
+        switch (region) {
+        case kViewVram:
+            data = gbVram ? gbVram : gbMemory + 0x8000;
+            size = gbVram ? kGBVRamSize : 0x2000;
+            break;
+        case kViewOam:
+            data = gbMemory + 0xfe00;
+            size = 0xa0;
+            break;
+        case kViewPalette:
+            data = (const uint8_t*)gbPalette;
+            size = sizeof(gbPalette);
+            break;
+        case kViewScreen:
+            data = g_pix;
+            size = kGBPixSize;
+            break;
+        default:
+            data = gbMemory + 0xff00;
+            size = 0x100;
+            break;
+        }
+    }
+
+    values_[region] = data ? Fingerprint(data, size) : 0;
+    computed_ |= ViewMask(region);
+    return values_[region];
+}
+
+bool Viewer::WatchedChanged(RegionFingerprints& fingerprints)
+{
+    const uint32_t watched = Watched();
+
+    if (watched == kViewAll)
+        return true;
+
+    bool changed = !fingerprinted_;
+    fingerprinted_ = true;
+
+    for (int i = 0; i < kNbViewedRegions; i++) {
+        const ViewedRegion region = static_cast<ViewedRegion>(i);
+
+        if (!(watched & ViewMask(region)))
+            continue;
+
+        const uint64_t value = fingerprints.Get(region);
+
+        if (value != fingerprints_[i]) {
+            fingerprints_[i] = value;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 
 void Viewer::CloseDlg(wxCloseEvent& ev)
 {
@@ -67,10 +182,32 @@ END_EVENT_TABLE()
 
 void MainFrame::UpdateViewers()
 {
+    if (popups.empty())
+        return;
+
+    // the frames in between are dropped, but the last one is always shown
+    const wxLongLong now = wxGetLocalTimeMillis();
+    const long interval = 1000 / OPTION(kDispViewerRefreshRate);
+    const long elapsed = (now - viewers_updated_).ToLong();
+
+    if (elapsed >= 0 && elapsed < interval) {
+        if (!viewers_timer_.IsRunning())
+            viewers_timer_.StartOnce(interval - elapsed);
+
+        return;
+    }
+
+    viewers_updated_ = now;
+    viewers_timer_.Stop();
+
+    // the viewers read the emulator state
+    EmulatorThread::Parked parked(panel->emulator_thread());
+    Viewers::RegionFingerprints fingerprints;
+
     for (dialog_list_t::iterator i = popups.begin(); i != popups.end(); ++i) {
         Viewers::Viewer* d = static_cast<Viewers::Viewer*>(*i);
 
-        if (d->auto_update)
+        if (d->auto_update && d->WatchedChanged(fingerprints))
             d->Update();
     }
 }
@@ -20,10 +20,40 @@
 
 // avoid exporting too much stuff
 namespace Viewers {
+// The parts of the emulated machine the viewers show. Auto-updating
+// viewers are only updated when one of the regions they watch changed.
+enum ViewedRegion {
+    kViewVram,
+    kViewOam,
+    kViewPalette,
+    kViewIo,
+    kViewScreen,
+    kNbViewedRegions
+};
+
+// Viewer::Watched() masks
+constexpr uint32_t ViewMask(ViewedRegion region)
+{
+    return 1u << region;
+}
+// also reads other state, e.g. the CPU registers: always update
+constexpr uint32_t kViewAll = ~0u;
+
+// Fingerprints of the viewed regions, computed on first use.
+class RegionFingerprints {
+public:
+    uint64_t Get(ViewedRegion region);
+
+private:
+    uint64_t values_[kNbViewedRegions];
+    uint32_t computed_ = 0;
+};
+
 // common to all viewers:
 //   - track in MainFrame::popups
 //   - wxID_CLOSE button closes window
-//   - AutoUpdate checkbox toggles calling Update() every screen refresh
+//   - AutoUpdate checkbox toggles calling Update() every screen refresh,
+//     at most kDispViewerRefreshRate times a second
 class Viewer : public wxDialog {
 public:
     void CloseDlg(wxCloseEvent& ev);
@@ -32,6 +62,13 @@ public:
     {
     }
     virtual void Update() = 0;
+    // ViewMask() of what Update() reads
+    virtual uint32_t Watched() const
+    {
+        return kViewAll;
+    }
+    // true if a watched region changed since the last call
+    bool WatchedChanged(RegionFingerprints& fingerprints);
     bool auto_update;
 
     // A lot of viewers have GUI elements to set parameters.  Almost all
@@ -54,6 +91,10 @@ protected:
         auto_update = ev.IsChecked();
     }
 
+private:
+    uint64_t fingerprints_[kNbViewedRegions] = {};
+    bool fingerprinted_ = false;
+
     DECLARE_EVENT_TABLE()
 };
 
@@ -50,6 +50,8 @@
 #include "core/gba/gbaRemote.h"
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
+extern int emulating;
+
 namespace {
 
 // Resets the accelerator text for `menu_item` to the first keyboard input.
@@ -83,7 +85,7 @@ static const char kDotDir[] = "visualboyadvance-m";
 
 #if defined(VBAM_ENABLE_DEBUGGER)
 void(*dbgMain)() = remoteStubMain;
-void(*dbgSignal)(int, int) = remoteStubSignal;
+void(*dbgSignal)(int, int) = debugDeferSignal;
 void(*dbgOutput)(const char *, uint32_t) = debuggerOutput;
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
@@ -868,7 +870,9 @@ MainFrame::MainFrame()
 #endif
       keep_on_top_styler_(this),
       status_bar_observer_(config::OptionID::kGenStatusBar,
-                           std::bind(&MainFrame::OnStatusBarChanged, this)) {
+                           std::bind(&MainFrame::OnStatusBarChanged, this)),
+      viewers_timer_(this) {
+    Bind(wxEVT_TIMER, [this](wxTimerEvent&) { UpdateViewers(); }, viewers_timer_.GetId());
 }
 
 MainFrame::~MainFrame() {
@@ -900,8 +904,6 @@ EVT_DROP_FILES(MainFrame::OnDropFile)
 
 // for window geometry
 EVT_MOVE(MainFrame::OnMove)
-EVT_MOVE_START(MainFrame::OnMoveStart)
-EVT_MOVE_END(MainFrame::OnMoveEnd)
 EVT_SIZE(MainFrame::OnSize)
 
 #if defined(__WXMSW__)
@@ -968,20 +970,9 @@ void MainFrame::OnMove(wxMoveEvent&) {
         OPTION(kGeomWindowX) = window_pos.x;
         OPTION(kGeomWindowY) = window_pos.y;
     }
-}
 
-// On Windows pause sound when moving and resizing the window to prevent dsound
-// from looping.
-void MainFrame::OnMoveStart(wxMoveEvent&) {
-#ifdef __WXMSW__
-    soundPause();
-#endif
-}
-
-void MainFrame::OnMoveEnd(wxMoveEvent&) {
-#ifdef __WXMSW__
-    soundResume();
-#endif
+    // the window may be on another display now
+    panel->UpdateDisplayRate();
 }
 
 void MainFrame::OnSize(wxSizeEvent& event)
@@ -1185,14 +1176,8 @@ void MainFrame::MenuPopped(wxMenuEvent& evt) {
     evt.Skip();
 }
 
-// On Windows, opening the menubar will stop the app, but DirectSound will
-// loop, so we pause audio here.
 void MainFrame::SetMenusOpened(bool state) {
     menus_opened = state;
-    if (menus_opened)
-        soundPause();
-    else if (!paused)
-        soundResume();
 }
 
 #endif  // defined(__WXMSW__)
@@ -1344,6 +1329,20 @@ void MainFrame::IdentifyRom()
     }
 }
 
+void wxvbamApp::CallEventHandler(wxEvtHandler* handler,
+                                  wxEventFunctor& functor,
+                                  wxEvent& event) const {
+    if (emulating && event.IsCommandEvent()) {
+        // Menu commands and dialog controls may use the emulator state, so
+        // they run between two frames of the emulation thread.
+        EmulatorThread::Parked parked(frame->GetPanel()->emulator_thread());
+        wxApp::CallEventHandler(handler, functor, event);
+        return;
+    }
+
+    wxApp::CallEventHandler(handler, functor, event);
+}
+
 int wxvbamApp::FilterEvent(wxEvent& event)
 {
     if (!frame) {
@@ -1,6 +1,7 @@
 #ifndef VBAM_WX_WXVBAM_H_
 #define VBAM_WX_WXVBAM_H_
 
+#include <atomic>
 #include <cstdio>
 #include <ctime>
 #include <list>
@@ -12,12 +13,15 @@
 #include <wx/propdlg.h>
 #include <wx/datetime.h>
 
+#include "core/base/battery_writer.h"
 #include "core/base/system.h"
 #include "wx/config/bindings.h"
 #include "wx/config/emulated-gamepad.h"
 #include "wx/config/option-observer.h"
 #include "wx/config/option.h"
 #include "wx/dialogs/base-dialog.h"
+#include "wx/emulator-thread.h"
+#include "wx/frame-pacer.h"
 #include "wx/widgets/dpi-support.h"
 #include "wx/widgets/event-handler-provider.h"
 #include "wx/widgets/keep-on-top-styler.h"
@@ -75,6 +79,10 @@ public:
     bool OnCmdLineParsed(wxCmdLineParser&) final;
     // without this, global accels don't always work
     int FilterEvent(wxEvent&) final;
+    // Parks the emulation thread for command events.
+    void CallEventHandler(wxEvtHandler* handler,
+                          wxEventFunctor& functor,
+                          wxEvent& event) const final;
     // Handle most exceptions
     bool OnExceptionInMainLoop() override {
         try {
@@ -225,8 +233,8 @@ public:
 
 #if defined(__WXMSW__)
 
-    // On Windows, we need to disable the audio loop when the menu is open. We also disable
-    // shortcuts to prevent issues. This is not necessary on other systems.
+    // On Windows, we disable shortcuts while the menu is open to prevent
+    // issues. This is not necessary on other systems.
     void MenuPopped(wxMenuEvent& evt);
 
 #endif  // defined(__WXMSW__)
@@ -335,6 +343,11 @@ private:
     const widgets::KeepOnTopStyler keep_on_top_styler_;
     const config::OptionsObserver status_bar_observer_;
 
+    // UpdateViewers() throttling: the last update, and a timer for the
+    // update of a frame that came too early
+    wxLongLong viewers_updated_ = 0;
+    wxTimer viewers_timer_;
+
     // wxFrame override.
     void SetStatusBar(wxStatusBar* menuBar) override;
 
@@ -351,8 +364,6 @@ private:
     void OnMenu(wxContextMenuEvent&);
     // window geometry
     void OnMove(wxMoveEvent& event);
-    void OnMoveStart(wxMoveEvent& event);
-    void OnMoveEnd(wxMoveEvent& event);
     void OnSize(wxSizeEvent& event);
     // Load a named wxDialog from the XRC file
     wxDialog* LoadXRCDialog(const char* name);
@@ -398,7 +409,7 @@ class DrawingPanelBase;
 #include <windows.h>
 #endif
 
-class GameArea : public wxPanel {
+class GameArea : public wxPanel, private EmulatorThread::Delegate {
 public:
     GameArea();
     virtual ~GameArea();
@@ -437,6 +448,8 @@ public:
     }
     void recompute_dirs();
 
+    // While a game runs, these park the emulation thread between two frames
+    // and return whether the state was loaded or saved.
     bool LoadState();
     bool LoadState(int slot);
     bool LoadState(const wxFileName& fname);
@@ -445,7 +458,7 @@ public:
     bool SaveState(int slot);
     bool SaveState(const wxFileName& fname);
 
-    // save to default location
+    // save to default location, in the background
     void SaveBattery();
 
     // true if file at default location may not match memory
@@ -463,8 +476,19 @@ public:
     void Pause();
     void Resume();
 
-    // true if paused since last reset of flag
-    bool was_paused;
+    // Runs the loaded game. GUI code that uses the emulator state while a
+    // game runs has to park it, see EmulatorThread::Parked.
+    EmulatorThread& emulator_thread() { return emulator_thread_; }
+    // Drives systemFrameSkip with automatic frame skip.
+    FramePacer& frame_pacer() { return frame_pacer_; }
+    // Tells it the refresh rate of the display the window is on.
+    void UpdateDisplayRate();
+    // Sends the emulated gamepad state to the emulation thread.
+    void SendJoypads();
+
+    // true if paused since last reset of flag. Set by the GUI thread and
+    // cleared by the emulation thread.
+    std::atomic<bool> was_paused;
 
     // osdstat is always displayed at top-left of screen
     wxString osdstat;
@@ -475,7 +499,7 @@ public:
 
     // Rewind: count down to 0 and rewind
     uint32_t rewind_time;
-    // Rewind: flag to OnIdle to do a rewind
+    // Rewind: flag to save a rewind state after the next frame
     bool do_rewind;
     // Rewind: rewind states
     char* rewind_mem; // should be uint8_t, really
@@ -573,8 +597,31 @@ private:
     void OnAudioRateChanged();
     void OnVolumeChanged(config::Option* option);
 
+    // EmulatorThread::Delegate implementation.
+    bool EmulateFrame() override;
+    void OnPauseChanged(bool paused) override;
+    void OnFramePublished() override;
+
+    void WriteRewindState();
+    // Draws the newest frame from the emulation thread.
+    void PresentFrame();
+
     bool schedule_audio_restart_ = false;
 
+#if defined(VBAM_ENABLE_DEBUGGER)
+    // Set by the emulation thread once it stops for GDB, cleared by OnIdle()
+    // once GDB lets the game run again.
+    std::atomic<bool> gdb_break_{false};
+#endif  // defined(VBAM_ENABLE_DEBUGGER)
+
+    EmulatorThread emulator_thread_;
+    FramePacer frame_pacer_;
+    // The frame being drawn. DrawArea() may swap it with its own buffers.
+    uint8_t* present_pix_ = nullptr;
+    size_t present_size_ = 0;
+
+    BatteryWriter battery_writer_;
+
     const config::OptionsObserver render_observer_;
     const config::OptionsObserver scale_observer_;
     const config::OptionsObserver gb_border_observer_;
@@ -599,6 +646,8 @@ public:
     DrawingPanelBase(int _width, int _height);
     ~DrawingPanelBase();
     void DrawArea(uint8_t** pixels);
+    // The time the last DrawArea() spent in filters.
+    double filter_ms() const { return filter_ms_; }
 
     virtual void PaintEv(wxPaintEvent& ev);
     virtual void EraseBackground(wxEraseEvent& ev);
@@ -621,6 +670,7 @@ protected:
     RENDER_PLUGIN_INFO* rpi_; // also flag indicating plugin loaded
     // largest buffer required is 32-bit * (max width + 1) * (max height + 2)
     uint8_t delta[257 * 4 * 226];
+    double filter_ms_ = 0;
 };
 
 // base class with a wxPanel when a subclass (such as wxGLCanvas) is not being used
@@ -653,12 +703,22 @@ extern void remoteStubMain();
 extern void remoteCleanUp();
 extern void remoteStubSignal(int, int);
 extern void remoteOutput(const char*, uint32_t);
+extern void remoteReadInterrupt();
 
 extern bool debugOpenPty();
 extern const wxString& debugGetSlavePty();
 extern bool debugWaitPty();
 extern bool debugStartListen(int port);
 extern bool debugWaitSocket();
+// Whether GDB sent input, checked on the GUI thread while the game runs.
+extern bool debugInputPending();
+// dbgSignal and dbgOutput while GDB is connected. Called on the emulation
+// thread, they leave talking to GDB to the GUI thread.
+extern void debugDeferSignal(int sig, int number);
+extern void debugDeferOutput(const char* s, uint32_t addr);
+// Tells GDB about the break deferred by debugDeferSignal(), if any. Called
+// with the emulation thread parked.
+extern void debugReportSignal();
 #endif  // defined(VBAM_ENABLE_DEBUGGER)
 
 // supported movie format for game recording